@@ -0,0 +1,241 @@
+/*
+ * File:	appsettings.cpp
+ * Author:	Jim Diamond
+ * Date:	2026-10-19
+ * Version:	1.3
+ *
+ * Purpose:	Implement the AppSettings class (see appsettings.h).
+ *
+ * Modification history:
+ * Oct 19, 2026 (JD V1.0)
+ *  (a) Initial version.
+ * Oct 19, 2026 (JD V1.1)
+ *  (a) Load the batchPainting setting.
+ * Oct 19, 2026 (JD V1.2)
+ *  (a) Load the draft quality settings.
+ * Oct 19, 2026 (JD V1.3)
+ *  (a) Load the edgeBundling setting.
+ */
+
+#include "appsettings.h"
+#include "defuns.h"
+
+#include <QCoreApplication>
+
+// Used if the user has never set the grid cell size; this matches
+// the initial value of the spin box in the settings dialog.
+#define DEFAULT_GRID_CELL_SIZE	25
+
+
+
+/*
+ * Name:	instance()
+ * Purpose:	Return the (one and only) settings cache, creating and
+ *		loading it if needed.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	A pointer to the settings cache.
+ * Assumptions:	The QApplication exists; the first call is made from
+ *		the GUI thread.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+AppSettings *
+AppSettings::instance()
+{
+    static AppSettings * theSettings = nullptr;
+
+    if (theSettings == nullptr)
+	theSettings = new AppSettings(QCoreApplication::instance());
+    return theSettings;
+}
+
+
+
+/*
+ * Name:	AppSettings()
+ * Purpose:	Constructor; load the values from "settings".
+ * Arguments:	The parent QObject.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	reload() emits signals, but nothing can be connected
+ *		to this object yet.
+ */
+
+AppSettings::AppSettings(QObject * parent)
+    : QObject(parent), mUseDefaultResolution(true),
+      mHasCustomResolution(false), mCustomResolution(0),
+      mDefaultResolution(0), mGridCellSize(DEFAULT_GRID_CELL_SIZE),
+      mJpgBgColour(Qt::white), mOtherImageBgColour(Qt::transparent),
+      mBatchPainting(false), mEdgeBundling(false),
+      mDraftItemThreshold(DEFAULT_DRAFT_ITEM_THRESHOLD),
+      mDraftSettleDelay(DEFAULT_DRAFT_SETTLE_DELAY), mDraftHideLabels(true)
+{
+    reload();
+}
+
+
+
+/*
+ * Name:	reload()
+ * Purpose:	Re-read the cached values from "settings".
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	The cached values.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Connected to SettingsDialog::saveDone().  Each change
+ *		signal is only emitted if one of its values actually
+ *		changed.
+ *		The defaults for missing values are those which the
+ *		code used before this class existed: use the screen
+ *		DPI, a white JPEG background and a transparent
+ *		background for other image types, and no batch painting.
+ *		The draft quality defaults are in appsettings.h.
+ */
+
+void
+AppSettings::reload()
+{
+    bool useDefault = !settings.contains("useDefaultResolution")
+	|| settings.value("useDefaultResolution").toBool();
+    bool hasCustom = settings.contains("customResolution");
+    int custom = settings.value("customResolution").toInt();
+    int defaultDPI = settings.value("defaultResolution").toInt();
+    int cellSize = DEFAULT_GRID_CELL_SIZE;
+    if (settings.contains("gridCellSize")
+	&& settings.value("gridCellSize").toInt() > 0)
+	cellSize = settings.value("gridCellSize").toInt();
+
+    QColor jpgColour(Qt::white);
+    if (settings.contains("jpgBgColour"))
+	jpgColour = QColor(settings.value("jpgBgColour").toString());
+    QColor otherColour(Qt::transparent);
+    if (settings.contains("otherImageBgColour"))
+	otherColour = QColor(settings.value("otherImageBgColour").toString());
+    bool batch = settings.value("batchPainting", false).toBool();
+    bool bundle = settings.value("edgeBundling", false).toBool();
+    int draftThreshold = settings.value("draftItemThreshold",
+					DEFAULT_DRAFT_ITEM_THRESHOLD).toInt();
+    int draftDelay = settings.value("draftSettleDelay",
+				    DEFAULT_DRAFT_SETTLE_DELAY).toInt();
+    bool draftHide = settings.value("draftHideLabels", true).toBool();
+
+    bool resolutionDiffers = useDefault != mUseDefaultResolution
+	|| hasCustom != mHasCustomResolution
+	|| custom != mCustomResolution
+	|| defaultDPI != mDefaultResolution;
+    bool gridDiffers = cellSize != mGridCellSize;
+    bool coloursDiffer = jpgColour != mJpgBgColour
+	|| otherColour != mOtherImageBgColour;
+    bool renderingDiffers = batch != mBatchPainting
+	|| bundle != mEdgeBundling
+	|| draftThreshold != mDraftItemThreshold
+	|| draftDelay != mDraftSettleDelay
+	|| draftHide != mDraftHideLabels;
+
+    mUseDefaultResolution = useDefault;
+    mHasCustomResolution = hasCustom;
+    mCustomResolution = custom;
+    mDefaultResolution = defaultDPI;
+    mGridCellSize = cellSize;
+    mJpgBgColour = jpgColour;
+    mOtherImageBgColour = otherColour;
+    mBatchPainting = batch;
+    mEdgeBundling = bundle;
+    mDraftItemThreshold = draftThreshold;
+    mDraftSettleDelay = draftDelay;
+    mDraftHideLabels = draftHide;
+
+    if (resolutionDiffers)
+	emit resolutionChanged();
+    if (gridDiffers)
+	emit gridChanged();
+    if (coloursDiffer)
+	emit bgColoursChanged();
+    if (renderingDiffers)
+	emit renderingChanged();
+}
+
+
+
+/*
+ * Name:	setDefaultResolution()
+ * Purpose:	Record the physical DPI of the screen.
+ * Arguments:	The DPI.
+ * Outputs:	Nothing.
+ * Modifies:	The cached and the saved default resolution.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Unfortunately qreal QVariants can't convert... so we
+ *		store an int.
+ */
+
+void
+AppSettings::setDefaultResolution(int dpi)
+{
+    settings.setValue("defaultResolution", dpi);
+    if (dpi == mDefaultResolution)
+	return;
+
+    mDefaultResolution = dpi;
+    emit resolutionChanged();
+}
+
+
+
+/*
+ * Name:	setJpgBgColour()
+ * Purpose:	Set the background colour for JPEG images.
+ * Arguments:	The new colour.
+ * Outputs:	Nothing.
+ * Modifies:	The cached and the saved colour.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	JPEG has no alpha channel, so only the RGB part is saved.
+ */
+
+void
+AppSettings::setJpgBgColour(QColor colour)
+{
+    settings.setValue("jpgBgColour", colour.name());
+    colour.setAlpha(255);
+    if (colour == mJpgBgColour)
+	return;
+
+    mJpgBgColour = colour;
+    emit bgColoursChanged();
+}
+
+
+
+/*
+ * Name:	setOtherImageBgColour()
+ * Purpose:	Set the background colour for non-JPEG images.
+ * Arguments:	The new colour.
+ * Outputs:	Nothing.
+ * Modifies:	The cached and the saved colour.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	The alpha channel is saved too.
+ */
+
+void
+AppSettings::setOtherImageBgColour(QColor colour)
+{
+    settings.setValue("otherImageBgColour", colour.name(QColor::HexArgb));
+    if (colour == mOtherImageBgColour)
+	return;
+
+    mOtherImageBgColour = colour;
+    emit bgColoursChanged();
+}
@@ -0,0 +1,94 @@
+/*
+ * File:	appsettings.h
+ * Author:	Jim Diamond
+ * Date:	2026-10-19
+ * Version:	1.3
+ *
+ * Purpose:	Define the AppSettings class, a typed in-memory copy of
+ *		the (QSettings) values which are needed in paint and
+ *		export code.
+ *
+ * Notes:	A QSettings lookup takes a lock and converts a string
+ *		key and a QVariant on every call, which adds up when it
+ *		is done once per grid dot.  The values here are read
+ *		from the global "settings" once, re-read (via reload())
+ *		when the settings dialog is OK'd, and otherwise are
+ *		just plain fields.  Anything which caches something
+ *		derived from these values should connect to the
+ *		appropriate xxxChanged() signal.
+ *		"settings" remains the persistent store; code which
+ *		changes a value here also writes it there.
+ *
+ * Modification history:
+ * Oct 19, 2026 (JD V1.0)
+ *  (a) Initial version.
+ * Oct 19, 2026 (JD V1.1)
+ *  (a) Add the batchPainting setting and renderingChanged().
+ * Oct 19, 2026 (JD V1.2)
+ *  (a) Add the draft quality settings.
+ * Oct 19, 2026 (JD V1.3)
+ *  (a) Add edgeBundling().
+ */
+
+#ifndef APPSETTINGS_H
+#define APPSETTINGS_H
+
+#include <QColor>
+#include <QObject>
+
+// Defaults for the "draft quality" settings (see CanvasView).
+#define DEFAULT_DRAFT_ITEM_THRESHOLD	2000
+#define DEFAULT_DRAFT_SETTLE_DELAY	250
+
+
+class AppSettings : public QObject
+{
+    Q_OBJECT
+
+  public:
+    static AppSettings * instance();
+
+    bool useDefaultResolution() const { return mUseDefaultResolution; }
+    bool hasCustomResolution() const { return mHasCustomResolution; }
+    int customResolution() const { return mCustomResolution; }
+    int defaultResolution() const { return mDefaultResolution; }
+    int gridCellSize() const { return mGridCellSize; }
+    QColor jpgBgColour() const { return mJpgBgColour; }
+    QColor otherImageBgColour() const { return mOtherImageBgColour; }
+    bool batchPainting() const { return mBatchPainting; }
+    bool edgeBundling() const { return mEdgeBundling; }
+    int draftItemThreshold() const { return mDraftItemThreshold; }
+    int draftSettleDelay() const { return mDraftSettleDelay; }
+    bool draftHideLabels() const { return mDraftHideLabels; }
+
+    void setDefaultResolution(int dpi);
+    void setJpgBgColour(QColor colour);
+    void setOtherImageBgColour(QColor colour);
+
+  public slots:
+    void reload();
+
+  signals:
+    void resolutionChanged();
+    void gridChanged();
+    void bgColoursChanged();
+    void renderingChanged();
+
+  private:
+    explicit AppSettings(QObject * parent);
+
+    bool mUseDefaultResolution;
+    bool mHasCustomResolution;
+    int mCustomResolution;
+    int mDefaultResolution;
+    int mGridCellSize;
+    QColor mJpgBgColour;
+    QColor mOtherImageBgColour;
+    bool mBatchPainting;
+    bool mEdgeBundling;
+    int mDraftItemThreshold;
+    int mDraftSettleDelay;
+    bool mDraftHideLabels;
+};
+
+#endif // APPSETTINGS_H
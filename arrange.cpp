@@ -0,0 +1,268 @@
+/*
+ * File:	arrange.cpp
+ * Author:	Jim Diamond
+ * Date:	2026-10-19
+ * Version:	1.0
+ *
+ * Purpose:	Implement the Arrange class (see arrange.h).
+ *
+ * Modification history:
+ * Oct 19, 2026 (JD V1.0)
+ *  (a) Initial version.
+ */
+
+#include "arrange.h"
+#include "node.h"
+
+#include <QRectF>
+#include <QVector>
+#include <qmath.h>
+
+#include <algorithm>
+
+// If the nodes are all (nearly) on top of each other, put them on a
+// circle of this radius (in pixels) instead.
+#define MIN_CIRCLE_RADIUS	50
+
+
+
+/*
+ * Name:	targets()
+ * Purpose:	Work out where each node goes for an arrangement.
+ * Arguments:	The nodes and the operation.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The new centre of each node, in scene coordinates, in
+ *		the same order as the nodes.
+ * Assumptions:	There are at least minimumNodes(op) nodes.
+ * Bugs:	None known.
+ * Notes:	"Align left" etc. line up the node centres, not their
+ *		edges.  "Mirror" flips the nodes about the centre of
+ *		their bounding box.  "On a line" uses a horizontal line
+ *		if the nodes are spread out more horizontally than
+ *		vertically, otherwise a vertical one.
+ */
+
+QList<QPointF>
+Arrange::targets(QList<Node *> nodes, Operation op)
+{
+    QList<QPointF> from;
+    QPointF centroid(0, 0);
+
+    foreach (Node * node, nodes)
+    {
+	from.append(node->scenePos());
+	centroid += node->scenePos();
+    }
+    if (from.isEmpty())
+	return from;
+    centroid /= from.count();
+
+    qreal minX = from.at(0).x(), maxX = minX;
+    qreal minY = from.at(0).y(), maxY = minY;
+    foreach (QPointF p, from)
+    {
+	minX = qMin(minX, p.x());
+	maxX = qMax(maxX, p.x());
+	minY = qMin(minY, p.y());
+	maxY = qMax(maxY, p.y());
+    }
+
+    QList<QPointF> to = from;
+    switch (op)
+    {
+      case AlignLeft:
+	for (int i = 0; i < to.count(); i++)
+	    to[i].setX(minX);
+	break;
+
+      case AlignRight:
+	for (int i = 0; i < to.count(); i++)
+	    to[i].setX(maxX);
+	break;
+
+      case AlignTop:
+	for (int i = 0; i < to.count(); i++)
+	    to[i].setY(minY);
+	break;
+
+      case AlignBottom:
+	for (int i = 0; i < to.count(); i++)
+	    to[i].setY(maxY);
+	break;
+
+      case AlignHCentre:
+	for (int i = 0; i < to.count(); i++)
+	    to[i].setX((minX + maxX) / 2);
+	break;
+
+      case AlignVCentre:
+	for (int i = 0; i < to.count(); i++)
+	    to[i].setY((minY + maxY) / 2);
+	break;
+
+      case DistributeH:
+	to = distribute(from, true);
+	break;
+
+      case DistributeV:
+	to = distribute(from, false);
+	break;
+
+      case OnCircle:
+	to = onCircle(from, centroid);
+	break;
+
+      case OnLine:
+	if (maxX - minX >= maxY - minY)
+	{
+	    to = distribute(from, true);
+	    for (int i = 0; i < to.count(); i++)
+		to[i].setY(centroid.y());
+	}
+	else
+	{
+	    to = distribute(from, false);
+	    for (int i = 0; i < to.count(); i++)
+		to[i].setX(centroid.x());
+	}
+	break;
+
+      case MirrorH:
+	for (int i = 0; i < to.count(); i++)
+	    to[i].setX(minX + maxX - to.at(i).x());
+	break;
+
+      case MirrorV:
+	for (int i = 0; i < to.count(); i++)
+	    to[i].setY(minY + maxY - to.at(i).y());
+	break;
+    }
+
+    return to;
+}
+
+
+
+/*
+ * Name:	minimumNodes()
+ * Purpose:	Say how many nodes an operation needs to do anything.
+ * Arguments:	The operation.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The number of nodes.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Distributing two nodes leaves them where they are.
+ */
+
+int
+Arrange::minimumNodes(Operation op)
+{
+    switch (op)
+    {
+      case DistributeH:
+      case DistributeV:
+      case OnCircle:
+	return 3;
+      default:
+	return 2;
+    }
+}
+
+
+
+/*
+ * Name:	distribute()
+ * Purpose:	Space points evenly in x (or y), keeping their order.
+ * Arguments:	The points, and whether to space them horizontally.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The spaced-out points, in the same order as given.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	The two outermost points stay where they are, and the
+ *		other coordinate is left alone.
+ */
+
+QList<QPointF>
+Arrange::distribute(QList<QPointF> from, bool horizontal)
+{
+    int n = from.count();
+    QVector<int> order(n);
+
+    for (int i = 0; i < n; i++)
+	order[i] = i;
+    std::sort(order.begin(), order.end(), [&](int a, int b) {
+	return horizontal ? from.at(a).x() < from.at(b).x()
+			  : from.at(a).y() < from.at(b).y();
+    });
+
+    QList<QPointF> to = from;
+    if (n < 2)
+	return to;
+
+    qreal first = horizontal ? from.at(order.first()).x()
+			     : from.at(order.first()).y();
+    qreal last = horizontal ? from.at(order.last()).x()
+			    : from.at(order.last()).y();
+    qreal step = (last - first) / (n - 1);
+    for (int k = 0; k < n; k++)
+    {
+	if (horizontal)
+	    to[order.at(k)].setX(first + k * step);
+	else
+	    to[order.at(k)].setY(first + k * step);
+    }
+
+    return to;
+}
+
+
+
+/*
+ * Name:	onCircle()
+ * Purpose:	Put points evenly around a circle.
+ * Arguments:	The points and the centre of the circle.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The new points, in the same order as given.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	The points keep their order around the centre, so that
+ *		a roughly circular arrangement is just tidied up.  The
+ *		radius is the average distance from the centre.
+ */
+
+QList<QPointF>
+Arrange::onCircle(QList<QPointF> from, QPointF centre)
+{
+    int n = from.count();
+    QVector<int> order(n);
+    QVector<qreal> angle(n);
+    qreal radius = 0;
+
+    for (int i = 0; i < n; i++)
+    {
+	QPointF d = from.at(i) - centre;
+	order[i] = i;
+	angle[i] = qAtan2(d.y(), d.x());
+	radius += qSqrt(d.x() * d.x() + d.y() * d.y());
+    }
+    radius /= n;
+    if (radius < MIN_CIRCLE_RADIUS)
+	radius = MIN_CIRCLE_RADIUS;
+    std::sort(order.begin(), order.end(),
+	      [&](int a, int b) { return angle.at(a) < angle.at(b); });
+
+    QList<QPointF> to = from;
+    qreal start = angle.at(order.first());
+    for (int k = 0; k < n; k++)
+    {
+	qreal theta = start + 2 * M_PI * k / n;
+	to[order.at(k)] = centre + QPointF(radius * qCos(theta),
+					   radius * qSin(theta));
+    }
+
+    return to;
+}
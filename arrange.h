@@ -0,0 +1,48 @@
+/*
+ * File:	arrange.h
+ * Author:	Jim Diamond
+ * Date:	2026-10-19
+ * Version:	1.0
+ *
+ * Purpose:	Define the Arrange class, which works out where to put
+ *		a set of nodes to line them up, space them evenly, put
+ *		them on a circle or a line, or mirror them.
+ *
+ * Notes:	Only the target positions are computed here, all at
+ *		once; CanvasScene::moveNodes() then moves every node
+ *		in one batch.
+ *		All positions are node centres in scene coordinates,
+ *		so nodes in different graphs (or rotated graphs) can be
+ *		arranged together.
+ *
+ * Modification history:
+ * Oct 19, 2026 (JD V1.0)
+ *  (a) Initial version.
+ */
+
+#ifndef ARRANGE_H
+#define ARRANGE_H
+
+#include <QList>
+#include <QPointF>
+
+class Node;
+
+class Arrange
+{
+  public:
+    enum Operation { AlignLeft, AlignRight, AlignTop, AlignBottom,
+		     AlignHCentre, AlignVCentre,
+		     DistributeH, DistributeV,
+		     OnCircle, OnLine,
+		     MirrorH, MirrorV };
+
+    static QList<QPointF> targets(QList<Node *> nodes, Operation op);
+    static int minimumNodes(Operation op);
+
+  private:
+    static QList<QPointF> distribute(QList<QPointF> from, bool horizontal);
+    static QList<QPointF> onCircle(QList<QPointF> from, QPointF centre);
+};
+
+#endif // ARRANGE_H
@@ -2,7 +2,7 @@
  * File:    canvasscene.cpp
  * Author:  Rachel Bood
  * Date:    2014/11/07
- * Version: 1.29
+ * Version: 1.40
  *
  * Purpose: Initializes a QGraphicsScene to implement a drag and drop feature.
  *          still very much a WIP
@@ -136,14 +136,71 @@
  * Nov 16, 2020 (JD V1.29)
  *  (a) Animate the moving of the second graph for joins.  Without this,
  *	the joining can be very jarring, especially for the 4-node join.
+ * Oct 19, 2026 (JD V1.30)
+ *  (a) Get the grid cell size and the default resolution from the
+ *	AppSettings cache rather than from "settings".  drawBackground()
+ *	used to look up the resolution once per grid dot; now the
+ *	"big dots" decision is made by updateGridDotSize() when the
+ *	resolution changes.
+ *  (b) Initialize the cell size from the saved setting rather than
+ *	always starting at 25, and connect to AppSettings::gridChanged()
+ *	instead of relying on mainwindow to pass on saveDone().
+ * Oct 19, 2026 (JD V1.31)
+ *  (a) drawBackground() doesn't draw grid dots which would be less
+ *	than 2 pixels apart.
+ * Oct 19, 2026 (JD V1.32)
+ *  (a) While a node is dragged in edit mode, snap it into line with
+ *	the nearest other node horizontally and/or vertically, and draw
+ *	guides (in drawForeground()) to show it.  The other nodes'
+ *	positions are sorted once when the drag starts, so that each
+ *	mouse move only needs binary searches.  Alt turns this off.
+ *  (b) Snap-to-grid on release leaves an aligned coordinate alone.
+ * Oct 19, 2026 (JD V1.33)
+ *  (a) Add moveNodes(), which moves many nodes as one batch, adjusting
+ *	each affected edge once, and records them as one undo step.
+ *  (b) Escape undoes a whole batch move at once, and frees the undo
+ *	entries it uses.
+ * Oct 19, 2026 (JD V1.34)
+ *  (a) When automatic edge label placement is on, re-place the
+ *	labels near nodes moved by a drag or by moveNodes().
+ *  (b) Reset "moved" at the end of every drag, not just when
+ *	snapping to the grid.
+ * Oct 19, 2026 (JD V1.35)
+ *  (a) Move the incremental work after moving nodes into
+ *	nodesMoved(), which now also re-checks edges through nodes
+ *	(see edgechecker.h) and emits clashesChanged().
+ * Oct 19, 2026 (JD V1.36)
+ *  (a) setNodePositions() is now static, for the script engine.
+ * Oct 19, 2026 (JD V1.37)
+ *  (a) Keep the bounds of the scene's contents up to date from the
+ *	graphs' extents (see Graph::sceneExtent()), rather than
+ *	having itemsBoundingRect() look at every item: add
+ *	contentBounds(), contentBoundsOf(), extentChanged() and
+ *	friends.  The scene rect (and so the scroll bars) grows to
+ *	hold the contents.
+ *  (b) setNodePositions() invalidates the moved nodes' graphs' extents.
+ * Oct 19, 2026 (JD V1.38)
+ *  (a) Tell the session recorder about graphs dropped on the canvas.
+ * Oct 19, 2026 (JD V1.39)
+ *  (a) Add forgetNodes(), which takes nodes which are leaving the
+ *	scene out of undoPositions, and use it when deleting a node.
+ *	(The old loop skipped the entry after each one it removed,
+ *	and leaked them all.)
+ * Oct 19, 2026 (JD V1.40)
+ *  (a) After a graph is dragged, tidy up after the nodes of the
+ *	graphs inside it too, not just its own nodes.
  */
 
+#include "appsettings.h"
 #include "canvasscene.h"
 #include "canvasview.h"
 #include "defuns.h"
 #include "edge.h"
+#include "edgechecker.h"
 #include "graph.h"
+#include "labelplacer.h"
 #include "node.h"
+#include "sessionrecorder.h"
 
 #include <QtDebug>
 #include <QGraphicsSceneMouseEvent>
@@ -157,15 +214,29 @@
 #include <QtGui>
 #include <QThread>
 
+#include <algorithm>
+
 // If the default resolution (DPI) is >= this value, draw each grid
 // dot as a 2x2 block instead of a single pixel.
 #define GRID_DOT_DPI_THRESHOLD 120
 
+// A dragged node snaps into line with another node when it is within
+// this many (screen) pixels of it, horizontally or vertically.
+#define ALIGN_SNAP_PIXELS	6
+
 CanvasScene::CanvasScene()
-    :  mCellSize(25, 25)
 {
     setItemIndexMethod(QGraphicsScene::NoIndex);
 
+    AppSettings * appSettings = AppSettings::instance();
+    mCellSize = QSize(appSettings->gridCellSize(),
+		      appSettings->gridCellSize());
+    bigGridDots = appSettings->defaultResolution() > GRID_DOT_DPI_THRESHOLD;
+    connect(appSettings, SIGNAL(gridChanged()),
+	    this, SLOT(updateCellSize()));
+    connect(appSettings, SIGNAL(resolutionChanged()),
+	    this, SLOT(updateGridDotSize()));
+
     connectNode1a = nullptr;
     connectNode2a = nullptr;
     connectNode1b = nullptr;
@@ -175,6 +246,10 @@ CanvasScene::CanvasScene()
     mDragged = nullptr;
     snapToGrid = true;
     undoPositions = QList<undo_Node_Pos*>();
+    alignedX = alignedY = false;
+    lastUndoGroup = 0;
+    contentBoundsValid = false;
+    sceneRectUpdateQueued = false;
 }
 
 
@@ -188,15 +263,43 @@ CanvasScene::CanvasScene()
  * Returns:	Nothing.
  * Assumptions:	?
  * Bugs:	None known.
- * Notes:	None.
+ * Notes:	Connected to AppSettings::gridChanged().
  */
 
 void
 CanvasScene::updateCellSize()
 {
-    QSize newCellSize(settings.value("gridCellSize").toInt(),
-		      settings.value("gridCellSize").toInt());
-    mCellSize = newCellSize;
+    int cellSize = AppSettings::instance()->gridCellSize();
+
+    mCellSize = QSize(cellSize, cellSize);
+    update();
+}
+
+
+
+/*
+ * Name:	updateGridDotSize()
+ * Purpose:	Decide whether grid dots are one pixel or 2x2 pixels.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	bigGridDots, and the look of the grid.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Connected to AppSettings::resolutionChanged() so that
+ *		drawBackground() doesn't have to work this out for
+ *		every dot.
+ */
+
+void
+CanvasScene::updateGridDotSize()
+{
+    bool big = AppSettings::instance()->defaultResolution()
+	> GRID_DOT_DPI_THRESHOLD;
+
+    if (big == bigGridDots)
+	return;
+    bigGridDots = big;
     update();
 }
 
@@ -237,6 +340,7 @@ CanvasScene::dropEvent(QGraphicsSceneDragDropEvent * event)
 	addItem(graphItem);
 	canvasGraphList.append(graphItem);
 	graphItem->isMoved();
+	SessionRecorder::graphAdded(graphItem);
 	clearSelection();
 	emit graphDropped();
     }
@@ -247,7 +351,10 @@ CanvasScene::dropEvent(QGraphicsSceneDragDropEvent * event)
 void
 CanvasScene::drawBackground(QPainter * painter, const QRectF &rect)
 {
-    if (snapToGrid)
+    // Dots less than 2 pixels apart just make a grey smudge (e.g.,
+    // when zoomed far out, or in the minimap), so don't draw them.
+    if (snapToGrid
+	&& painter->worldTransform().m11() * mCellSize.width() >= 2)
     {
 	qreal left = int(rect.left()) - (int(rect.left()) % mCellSize.width());
 	qreal top = int(rect.top()) - (int(rect.top()) % mCellSize.height());
@@ -256,8 +363,7 @@ CanvasScene::drawBackground(QPainter * painter, const QRectF &rect)
 	    for (qreal y = top; y < rect.bottom(); y += mCellSize.height())
 	    {
 		painter->drawPoint(QPointF(x, y));
-		if (settings.value("defaultResolution").toInt()
-		    > GRID_DOT_DPI_THRESHOLD)
+		if (bigGridDots)
 		{
 		    painter->drawPoint(QPointF(x+1, y));
 		    painter->drawPoint(QPointF(x, y+1));
@@ -271,6 +377,38 @@ CanvasScene::drawBackground(QPainter * painter, const QRectF &rect)
 
 
 
+/*
+ * Name:	drawForeground()
+ * Purpose:	Draw the alignment guides, if any.
+ * Arguments:	The painter and the area to draw.
+ * Outputs:	The guides.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	The guides are one pixel wide at any zoom level.
+ */
+
+void
+CanvasScene::drawForeground(QPainter * painter, const QRectF &rect)
+{
+    Q_UNUSED(rect);
+
+    if (!alignedX && !alignedY)
+	return;
+
+    QPen pen(QColor(255, 0, 255), 0, Qt::DashLine);
+    painter->save();
+    painter->setPen(pen);
+    if (alignedX)
+	painter->drawLine(xGuide);
+    if (alignedY)
+	painter->drawLine(yGuide);
+    painter->restore();
+}
+
+
+
 /* Apparently this is not called in Freestyle mode, but is called in
  * the other modes */
 
@@ -371,11 +509,7 @@ CanvasScene::mousePressEvent(QGraphicsSceneMouseEvent * event)
 
 			// Removes node from undolist if deleted.
 			// Safety precaution to avoid null pointers.
-			for (int i = 0; i < undoPositions.length(); i++)
-			{
-			    if (undoPositions.at(i)->node == node)
-				undoPositions.removeAt(i);
-			}
+			forgetNodes(this, QList<Node *>() << node);
 
 			// Delete all edges incident to node to be deleted
 			QList<Node *> adjacentNodes;
@@ -481,6 +615,7 @@ CanvasScene::mousePressEvent(QGraphicsSceneMouseEvent * event)
 			undoPos->node = qgraphicsitem_cast<Node *>(mDragged);
 			undoPos->pos = mDragged->pos();
 			undoPositions.append(undoPos);
+			buildAlignmentIndex();
 			if (snapToGrid)
 			{
 			    mDragOffset = event->scenePos() - mDragged->pos();
@@ -582,8 +717,15 @@ CanvasScene::mouseMoveEvent(QGraphicsSceneMouseEvent * event)
 	    qDeb() << "\tnode pos set to mDragged->mapToParent(above) = "
 		   << mDragged->mapToParent(
 		       mDragged->mapFromScene(event->scenePos()));
+
+	    // Holding Alt turns off snapping to other nodes.
+	    QPointF pos = event->scenePos();
+	    if (event->modifiers() & Qt::AltModifier)
+		clearAlignment();
+	    else
+		pos = alignedPos(pos);
 	    mDragged->setPos(mDragged->mapToParent(
-				 mDragged->mapFromScene(event->scenePos())));
+				 mDragged->mapFromScene(pos)));
 	}
     }
 }
@@ -595,6 +737,8 @@ CanvasScene::mouseReleaseEvent(QGraphicsSceneMouseEvent * event)
 {
     // qDeb() << "CS::mouseReleaseEvent(" << event->screenPos() << ")";
 
+    bool dropped = mDragged && moved;
+
     if (mDragged && snapToGrid && moved
 	&& (getMode() == CanvasView::drag || getMode() == CanvasView::edit))
     {
@@ -613,25 +757,547 @@ CanvasScene::mouseReleaseEvent(QGraphicsSceneMouseEvent * event)
 	}
 	else if (mDragged->type() == Node::Type)
 	{
+	    // A node lined up with another node stays lined up.
 	    qDeb() << "\tsnapToGrid processing a node";
 	    x = round(mDragged->pos().x() / mCellSize.width())
 		* mCellSize.width();
 	    y = round(mDragged->pos().y() / mCellSize.height())
 		* mCellSize.height();
-	    mDragged->setPos(x , y);
+	    mDragged->setPos(alignedX ? mDragged->pos().x() : x,
+			     alignedY ? mDragged->pos().y() : y);
 	}
 	moved = false;
 
 	if (getMode() == CanvasView::edit)
 	    emit somethingChanged();
     }
+
+    // Tidy up after the nodes which were dragged.
+    if (dropped)
+    {
+	QList<Node *> nodes;
+	if (mDragged->type() == Node::Type)
+	    nodes.append(qgraphicsitem_cast<Node *>(mDragged));
+	else if (mDragged->type() == Graph::Type)
+	{
+	    // A joined graph may hold other graphs.
+	    QList<QGraphicsItem *> toVisit = mDragged->childItems();
+	    while (!toVisit.isEmpty())
+	    {
+		QGraphicsItem * child = toVisit.takeFirst();
+		if (child->type() == Node::Type)
+		    nodes.append(qgraphicsitem_cast<Node *>(child));
+		else if (child->type() == Graph::Type)
+		    toVisit.append(child->childItems());
+	    }
+	}
+	nodesMoved(nodes);
+    }
+    moved = false;
     mDragged = nullptr;
+    clearAlignment();
     clearSelection();
     QGraphicsScene::mouseReleaseEvent(event);
 }
 
 
 
+/*
+ * Name:	moveNodes()
+ * Purpose:	Move many nodes at once, as one undoable step.
+ * Arguments:	The nodes and their new positions (in scene coordinates).
+ * Outputs:	Nothing.
+ * Modifies:	The nodes' positions, their edges and undoPositions.
+ * Returns:	Nothing.
+ * Assumptions:	The lists are the same length; the nodes are on the canvas.
+ * Bugs:	None known.
+ * Notes:	Used by the arrange tools (see arrange.h).  Escape puts
+ *		all of the nodes back where they were.
+ */
+
+void
+CanvasScene::moveNodes(QList<Node *> nodes, QList<QPointF> scenePositions)
+{
+    QList<QPointF> positions;
+
+    lastUndoGroup++;
+    for (int i = 0; i < nodes.count(); i++)
+    {
+	Node * node = nodes.at(i);
+	undo_Node_Pos * undoPos = new undo_Node_Pos();
+	undoPos->node = node;
+	undoPos->pos = node->pos();
+	undoPos->group = lastUndoGroup;
+	undoPositions.append(undoPos);
+
+	if (node->parentItem() != nullptr)
+	    positions.append(node->parentItem()
+			     ->mapFromScene(scenePositions.at(i)));
+	else
+	    positions.append(scenePositions.at(i));
+    }
+
+    setNodePositions(nodes, positions);
+    nodesMoved(nodes);
+    emit somethingChanged();
+}
+
+
+
+/*
+ * Name:	nodesMoved()
+ * Purpose:	Do the incremental checks which follow moving nodes.
+ * Arguments:	The nodes which moved.
+ * Outputs:	clashesChanged(), if edges are being checked.
+ * Modifies:	Edge label placements and edge clash highlighting.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Each of these only looks at the items near the moved
+ *		nodes, and only if the user has turned it on.  See
+ *		labelplacer.h and edgechecker.h.
+ */
+
+void
+CanvasScene::nodesMoved(QList<Node *> nodes)
+{
+    if (LabelPlacer::isEnabled())
+	LabelPlacer::placeNear(nodes);
+
+    if (EdgeChecker::isEnabled())
+    {
+	EdgeChecker::highlight(EdgeChecker::findNear(nodes));
+	emit clashesChanged(EdgeChecker::highlightedEdges());
+    }
+}
+
+
+
+/*
+ * Name:	setNodePositions()
+ * Purpose:	Move nodes without each move re-adjusting its edges.
+ * Arguments:	The nodes and their new positions (in their parents'
+ *		coordinates).
+ * Outputs:	Nothing.
+ * Modifies:	The nodes' positions and their edges.
+ * Returns:	Nothing.
+ * Assumptions:	The lists are the same length.
+ * Bugs:	None known.
+ * Notes:	Node::itemChange() adjusts every edge of a node each
+ *		time it moves, so an edge between two moved nodes would
+ *		be adjusted twice, and so on.  Instead, geometry change
+ *		notifications are turned off during the moves, and each
+ *		edge touching a moved node is adjusted exactly once
+ *		afterwards.
+ *		Static and public so that the script engine (see
+ *		scriptengine.h) can place nodes in any scene.
+ *		Since the nodes don't report their moves, their graphs'
+ *		extents are found again when next needed.
+ */
+
+void
+CanvasScene::setNodePositions(QList<Node *> nodes, QList<QPointF> positions)
+{
+    QSet<Edge *> edges;
+
+    for (int i = 0; i < nodes.count(); i++)
+    {
+	Node * node = nodes.at(i);
+	node->setFlag(QGraphicsItem::ItemSendsGeometryChanges, false);
+	node->setPos(positions.at(i));
+	node->setFlag(QGraphicsItem::ItemSendsGeometryChanges, true);
+	foreach (Edge * edge, node->edgeList)
+	    edges.insert(edge);
+    }
+
+    foreach (Edge * edge, edges)
+	edge->adjust();
+
+    foreach (Node * node, nodes)
+	Graph::invalidateExtentOf(node);
+}
+
+
+
+/*
+ * Name:	forgetNodes()
+ * Purpose:	Forget any moves of some nodes which Escape could undo.
+ * Arguments:	The scene and the nodes.
+ * Outputs:	Nothing.
+ * Modifies:	The scene's undoPositions.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Must be called for any node which is about to be
+ *		deleted or taken out of the scene, else Escape would
+ *		move it.  Static so that code which takes nodes off the
+ *		canvas (see graphops.h and metanode.h) can call it with
+ *		whichever scene the nodes are in; other scenes have no
+ *		undo list, so they are ignored.
+ */
+
+void
+CanvasScene::forgetNodes(QGraphicsScene * scene, QList<Node *> nodes)
+{
+    CanvasScene * canvasScene = qobject_cast<CanvasScene *>(scene);
+    if (canvasScene == nullptr)
+	return;
+
+    QList<undo_Node_Pos *> & undoList = canvasScene->undoPositions;
+    for (int i = undoList.length() - 1; i >= 0; i--)
+    {
+	if (nodes.contains(undoList.at(i)->node))
+	    delete undoList.takeAt(i);
+    }
+}
+
+
+
+/*
+ * Name:	contentBounds()
+ * Purpose:	Return the bounds of everything in the scene.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	mContentBounds and contentBoundsValid.
+ * Returns:	The bounds (empty if the scene is).
+ * Assumptions:	Every item worth bounding is in a graph.
+ * Bugs:	None known.
+ * Notes:	Unlike itemsBoundingRect(), this doesn't look at every
+ *		item: the bounds are grown as graphs grow and move (see
+ *		extentChanged()), and when they might have shrunk they
+ *		are found again from the top-level graphs' extents,
+ *		each of which is itself kept up to date (see
+ *		Graph::sceneExtent()).
+ */
+
+QRectF
+CanvasScene::contentBounds()
+{
+    if (!contentBoundsValid)
+    {
+	mContentBounds = QRectF();
+	foreach (Graph * graph, graphs)
+	    if (graph->parentItem() == nullptr)
+		mContentBounds |= graph->sceneExtent();
+	contentBoundsValid = true;
+    }
+    return mContentBounds;
+}
+
+
+
+/*
+ * Name:	extentChanged()
+ * Purpose:	Update the content bounds when a graph's extent changes.
+ * Arguments:	The graph's old and new extents.
+ * Outputs:	Nothing.
+ * Modifies:	mContentBounds and contentBoundsValid.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	As for Graph::childMoved(): growing is O(1), and a
+ *		graph which leaves the edge of the bounds may have
+ *		shrunk them, so they are found again when next needed.
+ */
+
+void
+CanvasScene::extentChanged(QRectF oldExtent, QRectF newExtent)
+{
+    if (contentBoundsValid)
+    {
+	if (!oldExtent.isNull() && !newExtent.contains(oldExtent)
+	    && !strictlyInside(oldExtent, mContentBounds))
+	    contentBoundsValid = false;
+	else
+	    mContentBounds |= newExtent;
+    }
+    queueSceneRectUpdate();
+}
+
+
+
+/*
+ * Name:	invalidateContentBounds()
+ * Purpose:	Note that the content bounds must be found again.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	contentBoundsValid.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Called when a graph no longer knows its extent.
+ */
+
+void
+CanvasScene::invalidateContentBounds()
+{
+    contentBoundsValid = false;
+    queueSceneRectUpdate();
+}
+
+
+
+/*
+ * Name:	addGraph(), removeGraph()
+ * Purpose:	Keep track of the graphs in the scene.
+ * Arguments:	The graph.
+ * Outputs:	Nothing.
+ * Modifies:	graphs and the content bounds.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Called by Graph::itemChange() and ~Graph().
+ */
+
+void
+CanvasScene::addGraph(Graph * graph)
+{
+    graphs.insert(graph);
+    invalidateContentBounds();
+}
+
+
+
+void
+CanvasScene::removeGraph(Graph * graph)
+{
+    if (graphs.remove(graph))
+	invalidateContentBounds();
+}
+
+
+
+/*
+ * Name:	contentBoundsOf()
+ * Purpose:	Return the bounds of everything in a scene.
+ * Arguments:	The scene.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The bounds.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	For code (such as exports) which may be given either
+ *		the canvas scene or a plain QGraphicsScene.
+ */
+
+QRectF
+CanvasScene::contentBoundsOf(QGraphicsScene * scene)
+{
+    CanvasScene * canvasScene = qobject_cast<CanvasScene *>(scene);
+    if (canvasScene != nullptr)
+	return canvasScene->contentBounds();
+    return scene->itemsBoundingRect();
+}
+
+
+
+/*
+ * Name:	strictlyInside()
+ * Purpose:	Say whether a rectangle is inside another one without
+ *		touching its edges.
+ * Arguments:	The two rectangles.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	True iff inner is strictly inside outer.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Removing a rectangle which is strictly inside the
+ *		bounds can't shrink them.
+ */
+
+bool
+CanvasScene::strictlyInside(QRectF inner, QRectF outer)
+{
+    return inner.left() > outer.left() && inner.right() < outer.right()
+	&& inner.top() > outer.top() && inner.bottom() < outer.bottom();
+}
+
+
+
+/*
+ * Name:	queueSceneRectUpdate(), updateSceneRect()
+ * Purpose:	Grow the scene rect to hold everything in the scene,
+ *		once control returns to the event loop.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	The scene rect.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	The scene rect is what the views' scroll bars cover.
+ *		It only grows, as Qt's own (unset) scene rect does,
+ *		but without Qt's scan of every item; many changes
+ *		in a row cost one update.
+ */
+
+void
+CanvasScene::queueSceneRectUpdate()
+{
+    if (sceneRectUpdateQueued)
+	return;
+    sceneRectUpdateQueued = true;
+    QMetaObject::invokeMethod(this, "updateSceneRect", Qt::QueuedConnection);
+}
+
+
+
+void
+CanvasScene::updateSceneRect()
+{
+    sceneRectUpdateQueued = false;
+    QRectF bounds = contentBounds();
+    if (!bounds.isEmpty() && !sceneRect().contains(bounds))
+	setSceneRect(sceneRect() | bounds);
+}
+
+
+
+/*
+ * Name:	buildAlignmentIndex()
+ * Purpose:	Record where the other canvas nodes are, sorted by x and
+ *		by y, so that alignedPos() can find the nearest ones by
+ *		binary search.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	alignByX, alignByY.
+ * Returns:	Nothing.
+ * Assumptions:	mDragged is the node about to be dragged.
+ * Bugs:	None known.
+ * Notes:	Done once when a node drag starts, so each mouse move
+ *		costs O(log n) instead of a scan of every node.
+ */
+
+void
+CanvasScene::buildAlignmentIndex()
+{
+    alignByX.clear();
+    foreach (QGraphicsItem * item, items())
+	if (item->type() == Node::Type && item != mDragged)
+	    alignByX.append(item->scenePos());
+
+    alignByY = alignByX;
+    std::sort(alignByX.begin(), alignByX.end(),
+	      [](const QPointF & a, const QPointF & b) { return a.x() < b.x(); });
+    std::sort(alignByY.begin(), alignByY.end(),
+	      [](const QPointF & a, const QPointF & b) { return a.y() < b.y(); });
+}
+
+
+
+/*
+ * Name:	nearestAlong()
+ * Purpose:	Find the point whose x (or y) is closest to a value.
+ * Arguments:	The points, sorted by x (or y), a function to get x (or
+ *		y), the value and the greatest distance allowed.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The index of the closest point, or -1 if there is none
+ *		close enough.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	A binary search, so O(log n).
+ */
+
+static int
+nearestAlong(const QVector<QPointF> & points, qreal (QPointF::*coord)() const,
+	     qreal value, qreal tolerance)
+{
+    QVector<QPointF>::const_iterator it = std::lower_bound(
+	points.constBegin(), points.constEnd(), value,
+	[coord](const QPointF & p, qreal v) { return (p.*coord)() < v; });
+
+    int best = -1;
+    qreal bestDistance = tolerance;
+    if (it != points.constEnd()
+	&& qAbs(((*it).*coord)() - value) <= bestDistance)
+    {
+	best = it - points.constBegin();
+	bestDistance = qAbs(((*it).*coord)() - value);
+    }
+    if (it != points.constBegin()
+	&& qAbs(((*(it - 1)).*coord)() - value) < bestDistance)
+	best = it - 1 - points.constBegin();
+    return best;
+}
+
+
+
+/*
+ * Name:	alignedPos()
+ * Purpose:	Snap a dragged node's position into line with the
+ *		nearest other nodes, and set up the guides to show it.
+ * Arguments:	Where (in scene coordinates) the node would go.
+ * Outputs:	Nothing.
+ * Modifies:	The guides, and the areas of the scene they cover.
+ * Returns:	Where the node should go.
+ * Assumptions:	buildAlignmentIndex() has been called for this drag.
+ * Bugs:	None known.
+ * Notes:	The snap distance is in screen pixels, so it depends
+ *		on the zoom level.  Each guide runs from the node it
+ *		lines up with to the dragged node.
+ */
+
+QPointF
+CanvasScene::alignedPos(QPointF pos)
+{
+    clearAlignment();
+
+    qreal scale = views().isEmpty() ? 1 : views().first()->transform().m11();
+    qreal tolerance = ALIGN_SNAP_PIXELS / scale;
+
+    int i = nearestAlong(alignByX, &QPointF::x, pos.x(), tolerance);
+    int j = nearestAlong(alignByY, &QPointF::y, pos.y(), tolerance);
+    if (i >= 0)
+	pos.setX(alignByX.at(i).x());
+    if (j >= 0)
+	pos.setY(alignByY.at(j).y());
+
+    if (i >= 0)
+    {
+	alignedX = true;
+	xGuide = QLineF(alignByX.at(i), pos);
+	update(QRectF(xGuide.p1(), xGuide.p2()).normalized()
+	       .adjusted(-1, -1, 1, 1));
+    }
+    if (j >= 0)
+    {
+	alignedY = true;
+	yGuide = QLineF(alignByY.at(j), pos);
+	update(QRectF(yGuide.p1(), yGuide.p2()).normalized()
+	       .adjusted(-1, -1, 1, 1));
+    }
+
+    return pos;
+}
+
+
+
+/*
+ * Name:	clearAlignment()
+ * Purpose:	Take away the alignment guides.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	The guides, and the areas of the scene they covered.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	The sorted indices are kept until the next drag starts.
+ */
+
+void
+CanvasScene::clearAlignment()
+{
+    if (alignedX)
+	update(QRectF(xGuide.p1(), xGuide.p2()).normalized()
+	       .adjusted(-1, -1, 1, 1));
+    if (alignedY)
+	update(QRectF(yGuide.p1(), yGuide.p2()).normalized()
+	       .adjusted(-1, -1, 1, 1));
+    alignedX = alignedY = false;
+}
+
+
+
 void
 CanvasScene::mouseDoubleClickEvent(QGraphicsSceneMouseEvent * event)
 {
@@ -1093,8 +1759,19 @@ CanvasScene::keyReleaseEvent(QKeyEvent * event)
       case Qt::Key_Escape:
 	if (undoPositions.length() > 0)
 	{
-	    undoPositions.last()->node->setPos(undoPositions.last()->pos);
-	    undoPositions.removeLast();
+	    // A batch move (see moveNodes()) is undone all at once.
+	    int group = undoPositions.last()->group;
+	    QList<Node *> nodes;
+	    QList<QPointF> positions;
+	    do
+	    {
+		undo_Node_Pos * undoPos = undoPositions.takeLast();
+		nodes.append(undoPos->node);
+		positions.append(undoPos->pos);
+		delete undoPos;
+	    } while (group != 0 && undoPositions.length() > 0
+		     && undoPositions.last()->group == group);
+	    setNodePositions(nodes, positions);
 
 	    emit somethingChanged();
 	}
@@ -2,7 +2,7 @@
  * File:	canvasscene.h
  * Author:	Rachel Bood
  * Date:	?
- * Version:	1.11
+ * Version:	1.18
  *
  * Purpose:
  *
@@ -37,6 +37,21 @@
  *  (a) Update signature of updateCellSize().
  * Sep 11, 2020 (IC V1.11)
  *  (a) #include graphmimedata.h.
+ * Oct 19, 2026 (JD V1.12)
+ *  (a) Add updateGridDotSize() and bigGridDots.
+ * Oct 19, 2026 (JD V1.13)
+ *  (a) Add drawForeground() and the alignment guide members.
+ * Oct 19, 2026 (JD V1.14)
+ *  (a) Add moveNodes(), setNodePositions(), lastUndoGroup, and a group
+ *	field in undo_Node_Pos.
+ * Oct 19, 2026 (JD V1.15)
+ *  (a) Add nodesMoved() and the clashesChanged() signal.
+ * Oct 19, 2026 (JD V1.16)
+ *  (a) Make setNodePositions() public and static.
+ * Oct 19, 2026 (JD V1.17)
+ *  (a) Add the content bounds members and functions.
+ * Oct 19, 2026 (JD V1.18)
+ *  (a) Add forgetNodes().
  */
 
 #ifndef CANVASSCENE_H
@@ -48,6 +63,9 @@
 #include "graphmimedata.h"
 
 #include <QGraphicsScene>
+#include <QLineF>
+#include <QSet>
+#include <QVector>
 
 class CanvasScene : public QGraphicsScene
 {
@@ -58,6 +76,7 @@ public:
     {
         QPointF pos;
         Node * node;
+        int group;			// Non-zero: undo with the same group.
     } undo_Node_Pos;
 
     CanvasScene();
@@ -66,20 +85,38 @@ public:
     int getMode() const;
     void setCanvasMode(int mode);
     void searchAndSeparate(QList<Node *> adjacentNodes);
+    void moveNodes(QList<Node *> nodes, QList<QPointF> scenePositions);
+    static void setNodePositions(QList<Node *> nodes,
+				 QList<QPointF> positions);
+    static void forgetNodes(QGraphicsScene * scene, QList<Node *> nodes);
+
+    QRectF contentBounds();
+    void extentChanged(QRectF oldExtent, QRectF newExtent);
+    void invalidateContentBounds();
+    void addGraph(Graph * graph);
+    void removeGraph(Graph * graph);
+    static QRectF contentBoundsOf(QGraphicsScene * scene);
+    static bool strictlyInside(QRectF inner, QRectF outer);
 
 public slots:
     void updateCellSize();
+    void updateGridDotSize();
+
+private slots:
+    void updateSceneRect();
 
 signals:
     void graphDropped();
     void graphJoined();
     void graphSeparated();
     void somethingChanged();
+    void clashesChanged(int edges);
 
 protected:
     void dragMoveEvent (QGraphicsSceneDragDropEvent * event);
     void dropEvent (QGraphicsSceneDragDropEvent * event);
     void drawBackground(QPainter * painter, const QRectF &rect);
+    void drawForeground(QPainter * painter, const QRectF &rect);
     void mousePressEvent(QGraphicsSceneMouseEvent * event);
     void mouseMoveEvent(QGraphicsSceneMouseEvent * event);
     void mouseReleaseEvent(QGraphicsSceneMouseEvent * event);
@@ -91,12 +128,30 @@ private:
     bool snapToGrid;
     bool moved = false;
     QSize mCellSize;                    // The size of the cells in the grid.
+    bool bigGridDots;			// Draw grid dots as 2x2 blocks?
     QGraphicsItem * mDragged;		// The item being dragged.
     Node * connectNode1a, * connectNode1b; // The first Nodes to be joined.
     Node * connectNode2a, * connectNode2b; // The second Nodes to be joined.
     QPointF mDragOffset;
     QList<undo_Node_Pos *> undoPositions;
     // The distance from the top left of the item to the mouse position.
+
+    void nodesMoved(QList<Node *> nodes);
+    int lastUndoGroup;
+
+    void buildAlignmentIndex();
+    QPointF alignedPos(QPointF pos);
+    void clearAlignment();
+    QVector<QPointF> alignByX;		// Centres of the other nodes,
+    QVector<QPointF> alignByY;		// sorted by x and by y.
+    QLineF xGuide, yGuide;		// Alignment guides being shown...
+    bool alignedX, alignedY;		// ... if these are set.
+
+    QSet<Graph *> graphs;		// Every graph in the scene.
+    QRectF mContentBounds;		// The union of the top-level
+    bool contentBoundsValid;		// graphs' extents, if valid.
+    bool sceneRectUpdateQueued;
+    void queueSceneRectUpdate();
 };
 
 #endif // CANVASSCENE_H
@@ -2,7 +2,7 @@
  * File:    canvasview.cpp
  * Author:  Rachel Bood
  * Date:    2014/11/07
- * Version: 1.30
+ * Version: 1.37
  *
  * Purpose: Initializes a QGraphicsView that is used to house the
  *	    QGraphicsScene.
@@ -115,13 +115,40 @@
  *	origin to be in the geographic center of the node centers, so
  *	that if/when it is rotated via the Edit Canvas Graph tab, it
  *	doesn't orbit around the scene origin.
+ * Oct 19, 2026 (JD V1.31)
+ *  (a) Draw the canvas at draft quality (no antialiasing and,
+ *	optionally, no labels) while the user is panning, zooming or
+ *	dragging, if the scene holds enough items.  Full quality is
+ *	restored once nothing has happened for a (settable) while.
+ * Oct 19, 2026 (JD V1.32)
+ *  (a) Double-clicking a meta-node (see metanode.h) expands it.
+ * Oct 19, 2026 (JD V1.33)
+ *  (a) clearCanvas() clears any view filter first, so the filtered-out
+ *	items are deleted along with everything else.
+ * Oct 19, 2026 (JD V1.34)
+ *  (a) Add setResolution(); the screen resolution is now part of the
+ *	view transform, rather than being baked into scene coordinates.
+ * Oct 19, 2026 (JD V1.35)
+ *  (a) Add zoomToFit() (Ctrl-0), which uses the scene's content bounds.
+ * Oct 19, 2026 (JD V1.36)
+ *  (a) Tell the session recorder about mode changes, freestyle
+ *	parameter changes, and mouse and key events.  Add
+ *	keyReleaseEvent() so that key releases (e.g., 'j' in join
+ *	mode) can be recorded.
+ * Oct 19, 2026 (JD V1.37)
+ *  (a) Update a comment in clearCanvas(): the view filter now hides
+ *	items rather than taking them away.
  */
 
 #include "canvasview.h"
+#include "appsettings.h"
 #include "defuns.h"
 #include "edge.h"
 #include "graph.h"
+#include "metanode.h"
 #include "node.h"
+#include "sessionrecorder.h"
+#include "viewfilter.h"
 
 #include <math.h>
 #include <QKeyEvent>
@@ -159,6 +186,14 @@ QList<QGraphicsItem *> canvasGraphList;
 CanvasView::CanvasView(QWidget * parent)
 : QGraphicsView(parent), timerId(0)
 {
+    // This must be set up before the scene is, since setting the
+    // scene may scroll the view.
+    draftQuality = false;
+    resolutionScaleX = resolutionScaleY = 1;
+    draftTimer = new QTimer(this);
+    draftTimer->setSingleShot(true);
+    connect(draftTimer, SIGNAL(timeout()), this, SLOT(endDraftQuality()));
+
     aScene = new CanvasScene();
     aScene->setSceneRect(rect());
     setViewportUpdateMode(BoundingRectViewportUpdate); // Updates the canvas
@@ -215,6 +250,7 @@ CanvasView::setUpNodeParams(qreal nodeDiameter, bool numberedLabels,
     nodeParams->fillColour = nodeFillColour;
     nodeParams->outlineColour = nodeOutLineColour;
     nodeParams->nodeThickness = nodeThickness;
+    SessionRecorder::nodeParamsChanged(this);
 }
 
 
@@ -246,12 +282,15 @@ CanvasView::createNode(QPointF pos)
  * Assumptions: ?
  * Bugs:	?
  * Notes:	Unhandled key events are passed on to QGraphicsView.
+ *		Ctrl-= zooms in, Ctrl-- zooms out, and Ctrl-0 zooms
+ *		to fit everything on the canvas.
  */
 
 void
 CanvasView::keyPressEvent(QKeyEvent * event)
 {
     qDeb() << "CV:keyPressEvent(" << event->key() << ") called.";
+    SessionRecorder::keyEvent(event);
 
     if (event->modifiers().testFlag(Qt::ControlModifier))
     {
@@ -263,6 +302,9 @@ CanvasView::keyPressEvent(QKeyEvent * event)
 	  case Qt::Key_Minus:
 	    zoomOut();
 	    break;
+	  case Qt::Key_0:
+	    zoomToFit();
+	    break;
 	  default:
 	    QGraphicsView::keyPressEvent(event);
 	}
@@ -273,6 +315,28 @@ CanvasView::keyPressEvent(QKeyEvent * event)
 
 
 
+/*
+ * Name:	keyReleaseEvent
+ * Purpose:	Record key releases for the session recorder.
+ * Arguments:	QKeyEvent
+ * Output:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions: None.
+ * Bugs:	None known.
+ * Notes:	The release is then handled by QGraphicsView (and so
+ *		by CanvasScene::keyReleaseEvent()) as before.
+ */
+
+void
+CanvasView::keyReleaseEvent(QKeyEvent * event)
+{
+    SessionRecorder::keyEvent(event);
+    QGraphicsView::keyReleaseEvent(event);
+}
+
+
+
 /*
  * Name:	wheelEvent
  * Purpose:	Perform the appropriate action for wheel scroll.
@@ -314,7 +378,8 @@ CanvasView::wheelEvent(QWheelEvent * event)
  * Returns:	Nothing.
  * Assumptions: None.
  * Bugs:	?
- * Notes:	None.
+ * Notes:	The zoom limits are relative to the current resolution
+ *		(see setResolution()).
  */
 
 void
@@ -323,9 +388,10 @@ CanvasView::scaleView(qreal scaleFactor)
     qDeb() << "CV::scaleView(" << scaleFactor << ") called";
 
     qreal factor = transform().scale(scaleFactor, scaleFactor)
-		.mapRect(QRectF(0, 0, 1, 1)).width();
+		.mapRect(QRectF(0, 0, 1, 1)).width() / resolutionScaleX;
     if (factor < MIN_ZOOM_LEVEL || factor > MAX_ZOOM_LEVEL)
 	return;
+    startDraftQuality();
     scale(scaleFactor, scaleFactor);
 
     // Determine how displayed zoom value needs to update
@@ -359,6 +425,73 @@ CanvasView::zoomOut()
 
 
 
+/*
+ * Name:	zoomToFit()
+ * Purpose:	Zoom and scroll so that everything on the canvas shows.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	The view's transform and scroll position.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Uses the scene's incrementally-kept content bounds
+ *		(see CanvasScene::contentBounds()), so it doesn't
+ *		look at every item.  The zoom stays within the usual
+ *		limits.
+ */
+
+void
+CanvasView::zoomToFit()
+{
+    QRectF bounds = aScene->contentBounds();
+    if (bounds.isEmpty())
+	return;
+
+    startDraftQuality();
+    fitInView(bounds, Qt::KeepAspectRatio);
+    qreal factor = transform().mapRect(QRectF(0, 0, 1, 1)).width()
+	/ resolutionScaleX;
+    if (factor < MIN_ZOOM_LEVEL)
+	scale(MIN_ZOOM_LEVEL / factor, MIN_ZOOM_LEVEL / factor);
+    else if (factor > MAX_ZOOM_LEVEL)
+	scale(MAX_ZOOM_LEVEL / factor, MAX_ZOOM_LEVEL / factor);
+    centerOn(bounds.center());
+
+    zoomValue = qBound(MIN_ZOOM_LEVEL, factor, MAX_ZOOM_LEVEL) * 100;
+    zoomDisplayText = "Zoom: " + QString::number(zoomValue, 'f', 0) + "%";
+    emit zoomChanged(zoomDisplayText);
+}
+
+
+
+/*
+ * Name:	setResolution()
+ * Purpose:	Show the scene at the given screen resolution.
+ * Arguments:	The horizontal and vertical dots per inch.
+ * Outputs:	Nothing.
+ * Modifies:	The view's transform.
+ * Returns:	Nothing.
+ * Assumptions:	dpiX and dpiY are positive.
+ * Bugs:	None known.
+ * Notes:	Scene coordinates are in units of 1/SCENE_DPI inch, so
+ *		the resolution is just part of the view transform; a
+ *		change is one update of that transform, whatever is on
+ *		the canvas, and the user's zoom level is kept.
+ */
+
+void
+CanvasView::setResolution(qreal dpiX, qreal dpiY)
+{
+    qreal scaleX = dpiX / SCENE_DPI;
+    qreal scaleY = dpiY / SCENE_DPI;
+
+    scale(scaleX / resolutionScaleX, scaleY / resolutionScaleY);
+    resolutionScaleX = scaleX;
+    resolutionScaleY = scaleY;
+}
+
+
+
 /*
  * Name:	setMode()
  * Purpose:	Set up for one of the different canvas "modes".
@@ -463,6 +596,7 @@ CanvasView::setMode(int m)
 	node2 = nullptr;
     }
     aScene->setCanvasMode(m);
+    SessionRecorder::modeChanged(m);
 }
 
 
@@ -486,6 +620,7 @@ CanvasView::mouseDoubleClickEvent(QMouseEvent * event)
 {
     qDeb() << "CV::mouseDoubleClickEvent("
 	   << event->screenPos() << ") in mode " << getModeName(getMode());
+    SessionRecorder::mouseEvent(this, event);
 
     QPointF pt;
 
@@ -511,6 +646,24 @@ CanvasView::mouseDoubleClickEvent(QMouseEvent * event)
 	break;
 
       default:
+	// Double-clicking a meta-node expands it.
+	foreach (QGraphicsItem * item, items(event->pos()))
+	{
+	    if (item->type() != Node::Type)
+		continue;
+	    Node * node = qgraphicsitem_cast<Node *>(item);
+	    if (!MetaNode::isMetaNode(node))
+		continue;
+
+	    qDeb() << "\tdefault: expanding a meta-node";
+	    selectedList.removeOne(node);
+	    if (MetaNode::expand(node))
+	    {
+		emit selectedListChanged();
+		emit aScene->somethingChanged();
+		return;
+	    }
+	}
 	qDeb() << "\tdefault: call QGV:mouseDoubleClickEvent()";
 	QGraphicsView::mouseDoubleClickEvent(event);
     }
@@ -523,6 +676,7 @@ CanvasView::mousePressEvent(QMouseEvent * event) // Should this be in CS?
 {
     qDeb() << "CV::mousePressEvent(" << event->screenPos() << ")"
 	   << " mode is " << getModeName(getMode());
+    SessionRecorder::mouseEvent(this, event);
 
     QList<QGraphicsItem *> itemList = this->scene()->items(
 	this->mapToScene(event->pos()),
@@ -670,10 +824,17 @@ void
 CanvasView::mouseMoveEvent(QMouseEvent * event)
 {
     //	qDeb() << "CV::mouseMoveEvent";
+    SessionRecorder::mouseEvent(this, event);
     if (getMode() == CanvasView::select)
 	selectionBand->setGeometry(QRect(origin, event->pos()).normalized());
     else
+    {
+	// Something (e.g., a graph) is being dragged around.
+	if (event->buttons() != Qt::NoButton
+	    && aScene->mouseGrabberItem() != nullptr)
+	    startDraftQuality();
 	QGraphicsView::mouseMoveEvent(event);
+    }
 }
 
 
@@ -697,6 +858,7 @@ void
 CanvasView::mouseReleaseEvent(QMouseEvent * event)
 {
     //	qDeb() << "CV::mouseReleaseEvent(" << event->pos() << ")";
+    SessionRecorder::mouseEvent(this, event);
 
     if (getMode() == CanvasView::select)
     {
@@ -925,6 +1087,7 @@ CanvasView::setUpEdgeParams(qreal edgeSize, QString edgeLabel,
     edgeParams->LabelSize = edgeLabelSize;
     edgeParams->colour = edgeLineColour;
     edgeParams->isNumbered = numberedLabels;
+    SessionRecorder::edgeParamsChanged(this);
 }
 
 
@@ -974,6 +1137,9 @@ void
 CanvasView::clearCanvas()
 {
     QList<Graph *> graphList;
+
+    // The view filter's hidden items go with the rest.
+    ViewFilter::clear();
     foreach (QGraphicsItem * item, aScene->items())
     {
 	if (item != nullptr || item != 0)
@@ -1002,3 +1168,91 @@ CanvasView::clearCanvas()
     canvasGraphList.clear();
     emit selectedListChanged();
 }
+
+
+
+/*
+ * Name:	scrollContentsBy()
+ * Purpose:	Scroll (pan) the canvas.
+ * Arguments:	The distances to scroll.
+ * Output:	Nothing.
+ * Modifies:	The visible part of the scene.
+ * Returns:	Nothing.
+ * Assumptions: None.
+ * Bugs:	None known.
+ * Notes:	Called for scroll bar moves, wheel scrolling and
+ *		keyboard scrolling alike, so this is the one place to
+ *		notice that the user is panning.
+ */
+
+void
+CanvasView::scrollContentsBy(int dx, int dy)
+{
+    startDraftQuality();
+    QGraphicsView::scrollContentsBy(dx, dy);
+}
+
+
+
+/*
+ * Name:	startDraftQuality()
+ * Purpose:	Note that the user is panning, zooming or dragging, and
+ *		if the scene is big enough, draw it at draft quality
+ *		until the interaction is over.
+ * Arguments:	None.
+ * Output:	Nothing.
+ * Modifies:	draftQuality, the render hints and draftTimer.
+ * Returns:	Nothing.
+ * Assumptions: None.
+ * Bugs:	None known.
+ * Notes:	Draft quality means no antialiasing and (optionally)
+ *		no labels (see HTML_Label::paint()).
+ *		The interaction is deemed to be over when
+ *		draftSettleDelay ms pass without another call.  The
+ *		scene is only counted once per interaction: while the
+ *		timer is running we just restart it.
+ */
+
+void
+CanvasView::startDraftQuality()
+{
+    AppSettings * appSettings = AppSettings::instance();
+
+    if (!draftTimer->isActive() && !draftQuality)
+    {
+	int threshold = appSettings->draftItemThreshold();
+	if (threshold > 0 && aScene->items().count() >= threshold)
+	{
+	    draftQuality = true;
+	    setRenderHint(QPainter::Antialiasing, false);
+	    setRenderHint(QPainter::SmoothPixmapTransform, false);
+	}
+    }
+    draftTimer->start(appSettings->draftSettleDelay());
+}
+
+
+
+/*
+ * Name:	endDraftQuality()
+ * Purpose:	Go back to drawing at full quality.
+ * Arguments:	None.
+ * Output:	Nothing.
+ * Modifies:	draftQuality and the render hints.
+ * Returns:	Nothing.
+ * Assumptions: None.
+ * Bugs:	None known.
+ * Notes:	Called when draftTimer fires.  The whole viewport is
+ *		redrawn, since all of it was drawn at draft quality.
+ */
+
+void
+CanvasView::endDraftQuality()
+{
+    if (!draftQuality)
+	return;
+
+    draftQuality = false;
+    setRenderHints(QPainter::Antialiasing | QPainter::SmoothPixmapTransform);
+    viewport()->update();
+}
@@ -2,7 +2,7 @@
  * File:    canvasview.h
  * Author:  Rachel Bood
  * Date:    2014/11/07 (?)
- * Version: 1.12
+ * Version: 1.16
  *
  * Purpose: Define the CanvasView class.
  *
@@ -44,6 +44,15 @@
  *	canvas graph tab.
  * Oct 18, 2020 (JD V1.12)
  *  (a) Fix a spurious "color" spelling.
+ * Oct 19, 2026 (JD V1.13)
+ *  (a) Add the draft quality members and scrollContentsBy().
+ * Oct 19, 2026 (JD V1.14)
+ *  (a) Add setResolution() and the resolution scale members.
+ * Oct 19, 2026 (JD V1.15)
+ *  (a) Add zoomToFit().
+ * Oct 19, 2026 (JD V1.16)
+ *  (a) Add getNodeParams(), getEdgeParams() and keyReleaseEvent(),
+ *	for the session recorder.
  */
 
 
@@ -57,6 +66,7 @@
 #include <QGraphicsView>
 #include <QGraphicsSceneMouseEvent>
 #include <QRubberBand>
+#include <QTimer>
 
 class Node;
 class Edge;
@@ -100,6 +110,8 @@ class CanvasView: public QGraphicsView
     void setUpEdgeParams(qreal edgeSize, QString edgeLabel,
 			 qreal edgeLabelSize, QColor edgeLineColour,
 			 bool numberedLabels);
+    const Node_Params & getNodeParams() const { return *nodeParams; }
+    const Edge_Params & getEdgeParams() const { return *edgeParams; }
 
     Node * createNode(QPointF pos);
     Edge * createEdge(Node * source, Node * destination);
@@ -107,12 +119,15 @@ class CanvasView: public QGraphicsView
     int getMode() const;
     static QString getModeName(int mode);
     void setMode(int m);
+    bool isDraftQuality() const { return draftQuality; }
+    void setResolution(qreal dpiX, qreal dpiY);
 
     public slots:
 	void snapToGrid(bool snap);
 	void clearCanvas();
 	void zoomIn();
 	void zoomOut();
+	void zoomToFit();
 
   signals:
 	void setKeyStatusLabelText(QString text);
@@ -129,10 +144,22 @@ class CanvasView: public QGraphicsView
 	void mouseMoveEvent(QMouseEvent * event);
 	void mouseReleaseEvent(QMouseEvent * event);
 	void keyPressEvent(QKeyEvent * event);
+	void keyReleaseEvent(QKeyEvent * event);
 	virtual void scaleView(qreal scaleFactor);
 	virtual void wheelEvent(QWheelEvent *event);
+	void scrollContentsBy(int dx, int dy);
+
+  private slots:
+	void endDraftQuality();
 
   private:
+	void startDraftQuality();
+	bool draftQuality;		// Drawing without antialiasing?
+	QTimer * draftTimer;		// Restores full quality when it fires.
+
+	qreal resolutionScaleX;		// Screen pixels per scene unit...
+	qreal resolutionScaleY;		// ... at 100% zoom.
+
 	int modeType;
 	int timerId;
 	CanvasScene * aScene;
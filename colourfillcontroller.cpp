@@ -2,7 +2,7 @@
  * File:    colourfillcontroller.cpp
  * Author:  Rachel Bood 100088769
  * Date:    2014 (?)
- * Version: 1.3
+ * Version: 1.4
  *
  * Purpose:
  *
@@ -15,9 +15,12 @@
  *  (a) Fix bug in setNodeFillColour() which would clobber the old
  *	colour of a node when getColor() was called and then cancelled,
  *	replacing the old colour with black.
+ * Oct 19, 2026 (JD V1.4)
+ *  (a) Tell the session recorder about fill colour changes.
  */
 
 #include "colourfillcontroller.h"
+#include "sessionrecorder.h"
 #include <QColorDialog>
 
 
@@ -53,6 +56,8 @@ ColourFillController::setNodeFillColour()
 	    QString s("background: " + colour.name() + "; " + BUTTON_STYLE);
 	    button->setStyleSheet(s);
 	    node->setFillColour(colour);
+	    SessionRecorder::styleChanged(QList<QGraphicsItem *>() << node,
+					  "fill");
 	}
 
     }
@@ -2,7 +2,7 @@
  * File:    colourlinecontroller.cpp
  * Author:  Rachel Bood 100088769
  * Date:    2014 (?)
- * Version: 1.3
+ * Version: 1.4
  *
  * Purpose:
  *
@@ -15,9 +15,12 @@
  *  (a) Fix bug in setNodeOutlineColour() and setEdgeLineColour()
  *	which would clobber the old colour when getColor() was called
  *	and then cancelled, replacing the old colour with black.
+ * Oct 19, 2026 (JD V1.4)
+ *  (a) Tell the session recorder about colour changes.
  */
 
 #include "colourlinecontroller.h"
+#include "sessionrecorder.h"
 
 #include <QColorDialog>
 #include <QtCore>
@@ -77,6 +80,8 @@ ColourLineController::setEdgeLineColour()
 	    QString s("background: " + colour.name() + "; " + BUTTON_STYLE);
 	    button->setStyleSheet(s);
 	    edge->setColour(colour);
+	    SessionRecorder::styleChanged(QList<QGraphicsItem *>() << edge,
+					  "colour");
 	}
     }
 }
@@ -95,6 +100,8 @@ ColourLineController::setNodeOutlineColour()
 	    QString s("background: " + colour.name() + "; " + BUTTON_STYLE);
 	    button->setStyleSheet(s);
 	    node->setLineColour(colour);
+	    SessionRecorder::styleChanged(QList<QGraphicsItem *>() << node,
+					  "outline");
 	}
     }
 }
@@ -2,7 +2,7 @@
  * File:	defuns.h
  * Author:	Jim Diamond
  * Date:	2019-12-10
- * Version:	1.11
+ * Version:	1.12
  *
  * Purpose:	Hold definitions that are needed by multiple classes
  *		and yet don't seem to meaningfully fit anywhere else.
@@ -49,6 +49,8 @@
  *      of all graphs on the canvas (aside from empty freestyle graphs).
  *  (b) Added canvas_widget_ID enum for the widgets in the "edit
  *	canvas" tab.
+ * Oct 19, 2026 (JD V1.12)
+ *  (a) Add SCENE_DPI.
  */
 
 #ifndef DEFUNS_H
@@ -76,6 +78,12 @@
 
 extern QSettings settings;
 extern qreal currentPhysicalDPI, currentPhysicalDPI_X, currentPhysicalDPI_Y;
+
+// Scene coordinates (positions, diameters, pen widths, ...) are in
+// units of 1/SCENE_DPI inch, whatever the screen.  The current
+// resolution (currentPhysicalDPI_X/_Y) is applied only by the views'
+// transforms (see CanvasView::setResolution()) and by image exports.
+#define SCENE_DPI	96.
 extern QList<QGraphicsItem *> selectedList;
 extern QList<QGraphicsItem *> canvasGraphList;
 
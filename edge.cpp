@@ -2,7 +2,7 @@
  * File:    edge.cpp
  * Author:  Rachel Bood
  * Date:    2014/11/07
- * Version: 1.18
+ * Version: 1.27
  *
  * Purpose: creates an edge for the users graph
  *
@@ -87,11 +87,43 @@
  * Nov 11, 2020 (JD V1.18)
  *  (a) Removed rotation attribute.  Modified code accordingly.
  *  (b) Improved some comments.
+ * Oct 19, 2026 (JD V1.19)
+ *  (a) Add setEdgeLabelHtml(); see node.cpp.
+ * Oct 19, 2026 (JD V1.20)
+ *  (a) Allocate edges from an ItemPool (see itempool.h).
+ * Oct 19, 2026 (JD V1.21)
+ *  (a) Add getPen() and getLine(), split out of paint().
+ *  (b) paint() doesn't draw the line if the edge's graph is
+ *	batch painting (see Graph::paintBatched()).
+ * Oct 19, 2026 (JD V1.22)
+ *  (a) Keep the LabelIndex up to date when the label is set.
+ * Oct 19, 2026 (JD V1.23)
+ *  (a) Add the edge label placement (see labelplacer.h); paint()
+ *	now puts the label where labelPos and labelSide say, which is
+ *	the middle of the line by default.
+ * Oct 19, 2026 (JD V1.24)
+ *  (a) adjust() invalidates the graph's edge bundles, and paint()
+ *	leaves the line to the graph if it has bundled its edges.
+ * Oct 19, 2026 (JD V1.25)
+ *  (a) Add style classes (see styleclass.h): setStyleClass(),
+ *	getStyleClass(), leaveStyleClass() and a destructor.  The colour
+ *	and pen width come from the edge's class, if it has one.
+ * Oct 19, 2026 (JD V1.26)
+ *  (a) Tell the graph when the label changes size or is placed, so
+ *	that its extent (see Graph::sceneExtent()) stays correct.
+ *  (b) adjust() moves the label, not just paint().
+ * Oct 19, 2026 (JD V1.27)
+ *  (a) Add itemChange(), which tells the label index (see
+ *	labelindex.h) when the edge joins or leaves a scene.
  */
 
 #include "edge.h"
+#include "graph.h"
 #include "node.h"
 #include "canvasview.h"
+#include "itempool.h"
+#include "labelindex.h"
+#include "styleclass.h"
 
 #include <QTextDocument>
 #include <math.h>
@@ -142,6 +174,9 @@ Edge::Edge(Node * sourceNode, Node * destNode)
     setHandlesChildEvents(true);
     htmlLabel = new HTML_Label(this);
     checked = 0;
+    labelPos = 0.5;
+    labelSide = 0;
+    styleClass = nullptr;
 
     connect(htmlLabel, SIGNAL(editDone(QString)),
 	    this, SLOT(setEdgeLabel(QString)));
@@ -149,6 +184,55 @@ Edge::Edge(Node * sourceNode, Node * destNode)
 
 
 
+/*
+ * Name:	~Edge
+ * Purpose:	Destructor for Edge class.
+ * Arguments:	None.
+ * Output:	Nothing.
+ * Modifies:	The edge's style class, if any.
+ * Returns:	Nothing.
+ * Assumptions: None.
+ * Bugs:	None known.
+ * Notes:	The edge is not taken out of its nodes' edge lists
+ *		here; the callers which delete edges already do that.
+ */
+
+Edge::~Edge()
+{
+    if (styleClass != nullptr)
+	styleClass->removeMember(this);
+}
+
+
+
+/*
+ * Name:	operator new / operator delete
+ * Purpose:	Allocate and free Edge objects from a pool.
+ * Arguments:	The size (and, for delete, the pointer).
+ * Outputs:	Nothing.
+ * Modifies:	The Edge pool.
+ * Returns:	new: the storage.
+ * Assumptions: Only called on the GUI thread.
+ * Bugs:	None known.
+ * Notes:	See itempool.h.  Complete graphs have a lot of these.
+ */
+
+void *
+Edge::operator new(size_t size)
+{
+    return ItemPool<Edge>::allocate(size);
+}
+
+
+
+void
+Edge::operator delete(void * p, size_t size)
+{
+    ItemPool<Edge>::release(p, size);
+}
+
+
+
 /*
  * Name:	sourceNode()
  * Purpose:	Getter function for the sourceNode of the edge.
@@ -346,12 +430,37 @@ void
 Edge::setEdgeLabel(QString aLabel)
 {
     label = aLabel;
+    LabelIndex::setLabel(this, aLabel);
     htmlLabel->texLabelText = aLabel;
     labelToHtml();
 }
 
 
 
+/*
+ * Name:	setEdgeLabelHtml()
+ * Purpose:	Sets the label of the edge, given its HTML version.
+ * Arguments:	The label and HTML_Label::strToHtml() of the label.
+ * Output:	Nothing.
+ * Modifies:	The text in the edge label (both "text" and "label" fields).
+ * Returns:	Nothing.
+ * Assumptions: html really is strToHtml(aLabel).
+ * Bugs:	None known.
+ * Notes:	See Node::setNodeLabelHtml().
+ */
+
+void
+Edge::setEdgeLabelHtml(QString aLabel, QString html)
+{
+    label = aLabel;
+    LabelIndex::setLabel(this, aLabel);
+    htmlLabel->texLabelText = aLabel;
+    htmlLabel->setHtml(html);
+    Graph::invalidateExtentOf(this);
+}
+
+
+
 /*
  * Name:	labelToHtml()
  * Purpose:	Call strToHtml() to parse the label string, turn it
@@ -378,6 +487,7 @@ Edge::labelToHtml()
 
     QString html = HTML_Label::strToHtml(label);
     htmlLabel->setHtml(html);
+    Graph::invalidateExtentOf(this);
 
     qDeb() <<  "labelToHtml setting htmlLabel to /" << html
 	   << "/ for /" << label << "/";
@@ -431,6 +541,8 @@ Edge::getLabel()
  *		nodes) edge?
  * Notes:	This function gets called a *lot*; thus its debug
  *		stmts might be mostly or wholly commented out.
+ *		It also tells our graph that its edge bundles (if
+ *		any) are out of date.
  */
 
 void
@@ -464,6 +576,15 @@ Edge::adjust()
     }
     edgeLine = line;
     createSelectionPolygon();
+
+    // Move the label now rather than when the edge is next painted,
+    // so that the graph's extent (see Node::sceneExtent()) includes
+    // it where it will be.
+    htmlLabel->setPos(labelRect(labelPos, labelSide).topLeft());
+
+    Graph * graph = qgraphicsitem_cast<Graph *>(parentItem());
+    if (graph != nullptr)
+	graph->invalidateBundles();
 }
 
 
@@ -617,6 +738,8 @@ Edge::getSourceRadius()
 void
 Edge::setPenWidth(qreal aPenWidth)
 {
+    if (styleClass != nullptr && styleClass->values().penWidth != aPenWidth)
+	leaveStyleClass();
     penSize = aPenWidth;
     update();
 }
@@ -640,6 +763,8 @@ Edge::setPenWidth(qreal aPenWidth)
 qreal
 Edge::getPenWidth()
 {
+    if (styleClass != nullptr)
+	return styleClass->values().penWidth;
     return penSize;
 }
 
@@ -706,6 +831,8 @@ Edge::getRotation()
 void
 Edge::setColour(QColor colour)
 {
+    if (styleClass != nullptr && styleClass->values().edgeColour != colour)
+	leaveStyleClass();
     edgeColour = colour;
     update();
 }
@@ -727,6 +854,8 @@ Edge::setColour(QColor colour)
 QColor
 Edge::getColour()
 {
+    if (styleClass != nullptr)
+	return styleClass->values().edgeColour;
     return edgeColour;
 }
 
@@ -747,10 +876,14 @@ Edge::getColour()
 void
 Edge::setEdgeLabelSize(qreal edgeLabelSize)
 {
+    if (styleClass != nullptr
+	&& styleClass->values().labelSize != edgeLabelSize)
+	leaveStyleClass();
     QFont font = htmlLabel->font();
     font.setPointSize(edgeLabelSize);
     htmlLabel->setFont(font);
     labelSize = edgeLabelSize;
+    Graph::invalidateExtentOf(this);
 }
 
 
@@ -845,6 +978,241 @@ Edge::shape() const
 
 
 
+/*
+ * Name:	getPen()
+ * Purpose:	Returns the pen used to draw the edge.
+ * Arguments:	None.
+ * Output:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	A QPen.
+ * Assumptions: None.
+ * Bugs:	None known.
+ * Notes:	Used by paint() and by Graph::paint() when the graph
+ *		draws its edges in batches.
+ */
+
+QPen
+Edge::getPen() const
+{
+    QPen pen;
+    if (styleClass != nullptr)
+    {
+	pen.setColor(styleClass->values().edgeColour);
+	pen.setWidthF(styleClass->values().penWidth);
+    }
+    else
+    {
+	pen.setColor(edgeColour);
+	pen.setWidthF(penSize);
+    }
+    pen.setCapStyle(Qt::RoundCap);
+    pen.setJoinStyle(Qt::RoundJoin);
+
+    if (penStyle == 1)
+	pen.setStyle(Qt::DashLine);
+    else
+	pen.setStyle(Qt::SolidLine);
+
+    return pen;
+}
+
+
+
+/*
+ * Name:	setStyleClass()
+ * Purpose:	Put this edge into a style class (or take it out).
+ * Arguments:	The class, or nullptr for none.
+ * Output:	Nothing.
+ * Modifies:	The edge's class and, from the class, its label size.
+ * Returns:	Nothing.
+ * Assumptions: None.
+ * Bugs:	None known.
+ * Notes:	While the edge is in a class, its colour and pen width
+ *		come from the class's edge colour and pen width (see
+ *		styleclass.h).
+ */
+
+void
+Edge::setStyleClass(StyleClass * aStyleClass)
+{
+    if (aStyleClass == styleClass)
+	return;
+
+    if (styleClass != nullptr)
+	leaveStyleClass();
+    if (aStyleClass == nullptr)
+	return;
+
+    styleClass = aStyleClass;
+    styleClass->addMember(this);
+    setEdgeLabelSize(styleClass->values().labelSize);
+    update();
+}
+
+
+
+/*
+ * Name:	getStyleClass()
+ * Purpose:	Returns the style class of this edge.
+ * Arguments:	None.
+ * Output:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The class, or nullptr if the edge is not in one.
+ * Assumptions: None.
+ * Bugs:	None.
+ * Notes:	None.
+ */
+
+StyleClass *
+Edge::getStyleClass() const
+{
+    return styleClass;
+}
+
+
+
+/*
+ * Name:	leaveStyleClass()
+ * Purpose:	Take this edge out of its style class.
+ * Arguments:	None.
+ * Output:	Nothing.
+ * Modifies:	The edge's class, colour and pen width.
+ * Returns:	Nothing.
+ * Assumptions: The edge is in a class.
+ * Bugs:	None known.
+ * Notes:	The class's values are copied into the edge first, so
+ *		it looks the same.
+ */
+
+void
+Edge::leaveStyleClass()
+{
+    edgeColour = styleClass->values().edgeColour;
+    penSize = styleClass->values().penWidth;
+    styleClass->removeMember(this);
+    styleClass = nullptr;
+}
+
+
+
+/*
+ * Name:	getLine()
+ * Purpose:	Returns the visible part of the edge.
+ * Arguments:	None.
+ * Output:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The line from the source node's edge to the dest
+ *		node's edge, in the edge's coordinates.
+ * Assumptions: adjust() has been called since the nodes last moved.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+QLineF
+Edge::getLine() const
+{
+    return QLineF(sourcePoint, destPoint);
+}
+
+
+
+/*
+ * Name:	setLabelPlacement()
+ * Purpose:	Say where the edge label goes.
+ * Arguments:	How far along the edge (0 is the source end, 1 the
+ *		dest end) and which side of it the label is on.
+ * Output:	Nothing.
+ * Modifies:	labelPos, labelSide and the label's position.
+ * Returns:	Nothing.
+ * Assumptions: None.
+ * Bugs:	None known.
+ * Notes:	"side" is 0 for a label centred on the line, 1 for one
+ *		to the left of it (looking from the source to the dest)
+ *		and -1 for one to the right.  The default is (0.5, 0),
+ *		the middle of the line.  See labelplacer.h.
+ *		The graph is told where the label went, since the
+ *		label may now stick out of it.
+ */
+
+void
+Edge::setLabelPlacement(qreal pos, int side)
+{
+    labelPos = qBound(qreal(0.), pos, qreal(1.));
+    labelSide = qBound(-1, side, 1);
+
+    QRectF before = htmlLabel->sceneBoundingRect();
+    htmlLabel->setPos(labelRect(labelPos, labelSide).topLeft());
+    Graph * graph = qgraphicsitem_cast<Graph *>(parentItem());
+    if (graph != nullptr)
+	graph->childMoved(before, htmlLabel->sceneBoundingRect());
+}
+
+
+
+/*
+ * Name:	getLabelPos(), getLabelSide()
+ * Purpose:	Return the label placement.
+ * Arguments:	None.
+ * Output:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	labelPos or labelSide.
+ * Assumptions: None.
+ * Bugs:	None known.
+ * Notes:	See setLabelPlacement().
+ */
+
+qreal
+Edge::getLabelPos() const
+{
+    return labelPos;
+}
+
+
+
+int
+Edge::getLabelSide() const
+{
+    return labelSide;
+}
+
+
+
+/*
+ * Name:	labelRect()
+ * Purpose:	Work out where the label would be for a given placement.
+ * Arguments:	The placement (see setLabelPlacement()).
+ * Output:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The label's rectangle, in the edge's coordinates.
+ * Assumptions: None.
+ * Bugs:	None known.
+ * Notes:	A label beside the line is moved off it just far enough
+ *		that its box clears the line.
+ */
+
+QRectF
+Edge::labelRect(qreal pos, int side) const
+{
+    QLineF line = getLine();
+    QRectF box = htmlLabel->boundingRect();
+    QPointF centre = line.pointAt(pos);
+
+    if (side != 0 && line.length() > 0)
+    {
+	QLineF normal = line.normalVector().unitVector();
+	QPointF n = normal.p2() - normal.p1();
+	qreal reach = qAbs(n.x()) * box.width() / 2.
+	    + qAbs(n.y()) * box.height() / 2. + getPen().widthF() / 2.;
+	centre += side * reach * n;
+    }
+
+    return QRectF(centre.x() - box.width() / 2.,
+		  centre.y() - box.height() / 2.,
+		  box.width(), box.height());
+}
+
+
+
 /*
  * Name:	paint()
  * Purpose:	Paints an edge between two nodes.
@@ -856,6 +1224,8 @@ Edge::shape() const
  * Bugs:	None.
  * Notes:	QWidget * and QStyleOptionGraphicsItem * are not used in my
  *		implementation of this function.
+ *		If the edge's graph is batch painting or has bundled
+ *		its edges, the line is drawn by Graph::paint(), not here.
  */
 
 void
@@ -869,34 +1239,48 @@ Edge::paint(QPainter * painter, const QStyleOptionGraphicsItem * option,
     if (!source || !dest)
 	return;
 
-    QLineF line(sourcePoint, destPoint);
+    QLineF line = getLine();
     if (qFuzzyCompare(line.length(), qreal(0.)))
 	return;
 
-    // Set the style and draw the line.
-    QPen pen;
-    pen.setColor(edgeColour);
-    pen.setWidthF(penSize);
-    pen.setCapStyle(Qt::RoundCap);
-    pen.setJoinStyle(Qt::RoundJoin);
-
-    if (penStyle == 1)
-	pen.setStyle(Qt::DashLine);
-    else
-	pen.setStyle(Qt::SolidLine);
+    // Set the style and draw the line, unless our graph draws all of
+    // its edges in one go (batched or bundled).
+    Graph * graph = qgraphicsitem_cast<Graph *>(parentItem());
+    if (graph == nullptr || !graph->drawsEdges())
+    {
+	painter->setPen(getPen());
+	painter->drawLine(line);
 
-    painter->setPen(pen);
-    painter->drawLine(line);
+	// Debug statement to view the edge's bounding shape.
+	if (debug)
+	    painter->drawPolygon(selectionPolygon);
+    }
     edgeLine = line;
 
-    // Debug statement to view the edge's bounding shape.
-    if (debug)
-	painter->drawPolygon(selectionPolygon);
+    htmlLabel->setPos(labelRect(labelPos, labelSide).topLeft());
+}
+
+
+
+/*
+ * Name:	itemChange()
+ * Purpose:	Notice the edge joining or leaving a scene.
+ * Arguments:	The change and its value.
+ * Output:	Nothing.
+ * Modifies:	The label index.
+ * Returns:	As for QGraphicsItem::itemChange().
+ * Assumptions: None.
+ * Bugs:	None known.
+ * Notes:	Only edges on the canvas can be found by their labels.
+ */
+
+QVariant
+Edge::itemChange(GraphicsItemChange change, const QVariant &value)
+{
+    if (change == ItemSceneHasChanged)
+	LabelIndex::sceneChanged(this);
 
-    htmlLabel->setPos((line.p2().rx() + line.p1().rx()) / 2.
-		      - htmlLabel->boundingRect().width() / 2.,
-		      (line.p2().ry() + line.p1().ry()) / 2.
-		      - htmlLabel->boundingRect().height() / 2.);
+    return QGraphicsItem::itemChange(change, value);
 }
 
 
@@ -2,7 +2,7 @@
  * File:    edge.h
  * Author:  Rachel Bood
  * Date:    2014/11/07 (?)
- * Version: 1.14
+ * Version: 1.20
  *
  * Purpose: creates an edge for the users graph
  * Modification history:
@@ -55,6 +55,20 @@
  *  (a) Fix spelling.
  * Nov 11, 2020 (JD V1.14)
  *  (a) Removed rotation attribute.
+ * Oct 19, 2026 (JD V1.15)
+ *  (a) Add setEdgeLabelHtml().
+ * Oct 19, 2026 (JD V1.16)
+ *  (a) Add class-specific operator new and delete (see itempool.h).
+ * Oct 19, 2026 (JD V1.17)
+ *  (a) Add getPen() and getLine().
+ * Oct 19, 2026 (JD V1.18)
+ *  (a) Add setLabelPlacement(), getLabelPos(), getLabelSide() and
+ *	labelRect(), and the labelPos and labelSide members.
+ * Oct 19, 2026 (JD V1.19)
+ *  (a) Add ~Edge(), setStyleClass(), getStyleClass(),
+ *	leaveStyleClass() and styleClass.
+ * Oct 19, 2026 (JD V1.20)
+ *  (a) Add itemChange().
  */
 
 #ifndef EDGE_H
@@ -65,6 +79,7 @@
 #include <QGraphicsItem>
 #include <QGraphicsObject>
 #include <QList>
+#include <QPen>
 #include <QGraphicsSimpleTextItem>
 #include <QGraphicsSceneMouseEvent>
 #include <QTextDocument>
@@ -72,6 +87,7 @@
 class Node;
 class CanvasView;
 class PreView;
+class StyleClass;
 
 class Edge: public QGraphicsObject
 {
@@ -79,6 +95,10 @@ class Edge: public QGraphicsObject
 
 public:
     Edge(Node * sourceNode, Node * destNode);
+    ~Edge();
+
+    static void * operator new(size_t size);
+    static void operator delete(void * p, size_t size);
 
     void setDestRadius(qreal aRadius);
     qreal getDestRadius();
@@ -94,10 +114,21 @@ public:
 
     void setColour(QColor colour);
     QColor getColour();
+    QPen getPen() const;
+    QLineF getLine() const;
+
+    void setStyleClass(StyleClass * aStyleClass);
+    StyleClass * getStyleClass() const;
+
+    void setLabelPlacement(qreal pos, int side);
+    qreal getLabelPos() const;
+    int getLabelSide() const;
+    QRectF labelRect(qreal pos, int side) const;
 
     void setEdgeLabel(int number);
     void setEdgeLabel(QString aLabel, int number);
     void setEdgeLabel(QString aLabel, QString subscript);
+    void setEdgeLabelHtml(QString aLabel, QString html);
     void setEdgeLabelSize(qreal edgeLabelSize);
     qreal getLabelSize();
 
@@ -121,8 +152,6 @@ public:
 
     void chosen(int group1);
 
-     //~Edge(); deconstructor a WIP
-
     HTML_Label * htmlLabel;
     int causedConnect;
     int checked;
@@ -131,6 +160,7 @@ public slots:
     void setEdgeLabel(QString aLabel);
 
 protected:
+    QVariant itemChange(GraphicsItemChange change, const QVariant &value);
     void paint(QPainter * painter, const QStyleOptionGraphicsItem * option,
 	       QWidget * widget);
     bool eventFilter(QObject * obj, QEvent * event);
@@ -145,8 +175,12 @@ private:
     QString	label;
     int		penStyle;
     qreal	labelSize, penSize;
+    qreal	labelPos;	// Where the label is along the line (0..1).
+    int		labelSide;	// 0: on the line; 1: left of it; -1: right.
     QColor	edgeColour;
+    StyleClass	* styleClass;
     void	labelToHtml();
+    void	leaveStyleClass();
 };
 
 #endif // EDGE_H
@@ -0,0 +1,250 @@
+/*
+ * File:	edgebundler.cpp
+ * Author:	Jim Diamond
+ * Date:	2026-10-19
+ * Version:	1.0
+ *
+ * Purpose:	Implement the EdgeBundler class (see edgebundler.h).
+ *
+ * Modification history:
+ * Oct 19, 2026 (JD V1.0)
+ *  (a) Initial version.
+ */
+
+#include "edgebundler.h"
+#include "jobscheduler.h"
+
+#include <qmath.h>
+
+// The tuning constants suggested by Holten and van Wijk.  Points
+// move at most STEP pixels per compatible edge per iteration; the
+// step is halved and the number of iterations cut each cycle.
+#define CYCLES		5
+#define FIRST_ITERATIONS 90
+#define ITERATION_RATE	(2. / 3.)
+#define FIRST_STEP	0.1
+#define STIFFNESS	0.1
+#define THRESHOLD	0.6
+
+// The number of edges given to each parallelFor() chunk.
+#define GRAIN_SIZE	64
+
+
+
+/*
+ * Name:	bundle()
+ * Purpose:	Bundle some edges.
+ * Arguments:	The edges, as straight lines, and the job's token.
+ * Outputs:	Nothing.
+ * Modifies:	The token's progress.
+ * Returns:	A polyline for each line, in the same order, or an
+ *		empty vector if the job was cancelled.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Each iteration computes all new points from the old
+ *		ones, so the edges can be done in parallel.  The
+ *		polylines written to must not be implicitly shared,
+ *		or the first write in each thread would detach them.
+ *		Zero-length lines are left alone.
+ */
+
+QVector<QPolygonF>
+EdgeBundler::bundle(QVector<QLineF> lines, JobToken & token)
+{
+    int n = lines.count();
+    QVector<QVector<Partner>> partners(n);
+    QVector<QPolygonF> current(n);
+
+    JobScheduler * scheduler = JobScheduler::instance();
+    scheduler->parallelFor(n, GRAIN_SIZE, [&](int begin, int end) {
+	for (int i = begin; i < end; i++)
+	{
+	    if (token.isCancelled() || lines.at(i).length() == 0)
+		continue;
+	    for (int j = 0; j < n; j++)
+	    {
+		if (j == i || lines.at(j).length() == 0
+		    || compatibility(lines.at(i), lines.at(j)) < THRESHOLD)
+		    continue;
+		QPointF p = lines.at(i).p2() - lines.at(i).p1();
+		QPointF q = lines.at(j).p2() - lines.at(j).p1();
+		Partner partner;
+		partner.other = j;
+		partner.reversed = QPointF::dotProduct(p, q) < 0;
+		partners[i].append(partner);
+	    }
+	}
+    });
+    if (token.isCancelled())
+	return QVector<QPolygonF>();
+
+    for (int i = 0; i < n; i++)
+    {
+	current[i] << lines.at(i).p1() << lines.at(i).center()
+		   << lines.at(i).p2();
+    }
+
+    qreal step = FIRST_STEP;
+    qreal iterations = FIRST_ITERATIONS;
+    for (int cycle = 0; cycle < CYCLES; cycle++)
+    {
+	// Give each thread its own unshared polylines to write into.
+	QVector<QPolygonF> next(n);
+	for (int i = 0; i < n; i++)
+	{
+	    next[i] = current.at(i);
+	    next[i].detach();
+	}
+
+	for (int iteration = 0; iteration < int(iterations); iteration++)
+	{
+	    if (token.isCancelled())
+		return QVector<QPolygonF>();
+
+	    scheduler->parallelFor(n, GRAIN_SIZE, [&](int begin, int end) {
+		for (int i = begin; i < end; i++)
+		{
+		    const QPolygonF & points = current.at(i);
+		    int last = points.count() - 1;
+		    qreal length = lines.at(i).length();
+		    if (length == 0)
+			continue;
+		    qreal spring = STIFFNESS / (length * last);
+
+		    for (int k = 1; k < last; k++)
+		    {
+			QPointF p = points.at(k);
+			QPointF force = spring * (points.at(k - 1) - p
+						  + points.at(k + 1) - p);
+			const QVector<Partner> & mine = partners.at(i);
+			for (int m = 0; m < mine.count(); m++)
+			{
+			    const QPolygonF & other = current.at(mine.at(m).other);
+			    QPointF pull = other.at(mine.at(m).reversed
+						    ? last - k : k) - p;
+			    qreal distance = qSqrt(pull.x() * pull.x()
+						   + pull.y() * pull.y());
+			    if (distance > 1e-6)
+				force += pull / distance;
+			}
+			next[i][k] = p + step * force;
+		    }
+		}
+	    });
+	    current.swap(next);
+	}
+
+	token.setProgress(100 * (cycle + 1) / CYCLES);
+	step /= 2;
+	iterations *= ITERATION_RATE;
+	if (cycle < CYCLES - 1)
+	    current = subdivide(current);
+    }
+
+    return current;
+}
+
+
+
+/*
+ * Name:	compatibility()
+ * Purpose:	Say how well two edges would bundle together.
+ * Arguments:	The two edges.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	A number from 0 (not at all) to 1 (perfectly).
+ * Assumptions:	Neither line has zero length.
+ * Bugs:	None known.
+ * Notes:	The product of Holten and van Wijk's angle, scale,
+ *		position and visibility measures.  Direction doesn't
+ *		matter, since our edges are undirected.
+ */
+
+qreal
+EdgeBundler::compatibility(QLineF p, QLineF q)
+{
+    qreal lp = p.length();
+    qreal lq = q.length();
+    QPointF dp = p.p2() - p.p1();
+    QPointF dq = q.p2() - q.p1();
+
+    qreal angle = qAbs(QPointF::dotProduct(dp, dq)) / (lp * lq);
+    if (angle < THRESHOLD)
+	return angle;
+
+    qreal average = (lp + lq) / 2;
+    qreal scale = 2 / (average / qMin(lp, lq) + qMax(lp, lq) / average);
+    qreal position = average
+	/ (average + QLineF(p.center(), q.center()).length());
+    qreal result = angle * scale * position;
+    if (result < THRESHOLD)
+	return result;
+
+    return result * qMin(visibility(p, q), visibility(q, p));
+}
+
+
+
+/*
+ * Name:	visibility()
+ * Purpose:	Say how much of one edge lies beside another.
+ * Arguments:	The two edges.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	1 if q projected onto p's line is centred on p, falling
+ *		off to 0 as it moves off either end.
+ * Assumptions:	p does not have zero length.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+qreal
+EdgeBundler::visibility(QLineF p, QLineF q)
+{
+    QPointF d = p.p2() - p.p1();
+    qreal lengthSquared = QPointF::dotProduct(d, d);
+    qreal t1 = QPointF::dotProduct(q.p1() - p.p1(), d) / lengthSquared;
+    qreal t2 = QPointF::dotProduct(q.p2() - p.p1(), d) / lengthSquared;
+    QLineF shadow(p.pointAt(t1), p.pointAt(t2));
+
+    if (shadow.length() == 0)
+	return 0;
+    qreal offCentre = QLineF(p.center(), shadow.center()).length();
+    return qMax(qreal(0.), 1 - 2 * offCentre / shadow.length());
+}
+
+
+
+/*
+ * Name:	subdivide()
+ * Purpose:	Double the number of segments of each polyline.
+ * Arguments:	The polylines.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The new polylines.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	A point is put in the middle of each segment, so all
+ *		polylines keep the same number of points.
+ */
+
+QVector<QPolygonF>
+EdgeBundler::subdivide(const QVector<QPolygonF> & polylines)
+{
+    QVector<QPolygonF> result(polylines.count());
+
+    for (int i = 0; i < polylines.count(); i++)
+    {
+	const QPolygonF & points = polylines.at(i);
+	QPolygonF & out = result[i];
+	out.reserve(2 * points.count() - 1);
+	for (int k = 0; k < points.count(); k++)
+	{
+	    if (k > 0)
+		out << (points.at(k - 1) + points.at(k)) / 2;
+	    out << points.at(k);
+	}
+    }
+
+    return result;
+}
@@ -0,0 +1,57 @@
+/*
+ * File:	edgebundler.h
+ * Author:	Jim Diamond
+ * Date:	2026-10-19
+ * Version:	1.0
+ *
+ * Purpose:	Define the EdgeBundler class, which bends the edges of
+ *		a dense drawing into bundles, using force-directed edge
+ *		bundling (Holten and van Wijk, 2009).
+ *
+ * Notes:	Each edge becomes a polyline whose inner points are
+ *		pulled towards the matching points of "compatible"
+ *		edges (roughly parallel edges of similar length which
+ *		are close together and overlap when projected onto
+ *		each other), while a spring keeps each polyline from
+ *		wandering too far from its straight line.  The number
+ *		of points is doubled each cycle.
+ *		bundle() works only on plain lines, so it can run on a
+ *		worker thread; each pass is spread over the workers
+ *		with JobScheduler::parallelFor().  The caller (Graph)
+ *		caches the result.
+ *		Finding the compatible pairs takes time proportional
+ *		to the square of the number of edges.
+ *
+ * Modification history:
+ * Oct 19, 2026 (JD V1.0)
+ *  (a) Initial version.
+ */
+
+#ifndef EDGEBUNDLER_H
+#define EDGEBUNDLER_H
+
+#include <QLineF>
+#include <QPolygonF>
+#include <QVector>
+
+class JobToken;
+
+class EdgeBundler
+{
+  public:
+    static QVector<QPolygonF> bundle(QVector<QLineF> lines,
+				     JobToken & token);
+
+  private:
+    typedef struct
+    {
+	int other;		// Index of the compatible edge.
+	bool reversed;		// It runs the other way.
+    } Partner;
+
+    static qreal compatibility(QLineF p, QLineF q);
+    static qreal visibility(QLineF p, QLineF q);
+    static QVector<QPolygonF> subdivide(const QVector<QPolygonF> & polylines);
+};
+
+#endif // EDGEBUNDLER_H
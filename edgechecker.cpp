@@ -0,0 +1,383 @@
+/*
+ * File:	edgechecker.cpp
+ * Author:	Jim Diamond
+ * Date:	2026-10-19
+ * Version:	1.0
+ *
+ * Purpose:	Implement the EdgeChecker class (see edgechecker.h).
+ *
+ * Modification history:
+ * Oct 19, 2026 (JD V1.0)
+ *  (a) Initial version.
+ */
+
+#include "edgechecker.h"
+#include "defuns.h"
+#include "edge.h"
+#include "node.h"
+#include "rectgrid.h"
+
+#include <QGraphicsScene>
+#include <QHash>
+#include <QSet>
+#include <qmath.h>
+
+// The size (in pixels) of a square of the node grid.
+#define GRID_CELL_SIZE	50
+
+// How far (in pixels) a moved node's outline is put from the line.
+#define CLEARANCE	4
+
+QList<QPointer<QGraphicsObject>> EdgeChecker::highlighted;
+bool EdgeChecker::enabled = false;
+
+
+
+/*
+ * Name:	findAll()
+ * Purpose:	Find every edge on the canvas which passes through a
+ *		node it is not attached to.
+ * Arguments:	The scene.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The clashes; an edge appears once for each node it
+ *		passes through.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+QList<EdgeChecker::Clash>
+EdgeChecker::findAll(QGraphicsScene * scene)
+{
+    QList<Edge *> edges;
+    QList<Node *> nodes;
+
+    foreach (QGraphicsItem * item, scene->items())
+    {
+	if (item->type() == Node::Type)
+	    nodes.append(qgraphicsitem_cast<Node *>(item));
+	else if (item->type() == Edge::Type)
+	    edges.append(qgraphicsitem_cast<Edge *>(item));
+    }
+
+    return find(edges, nodes);
+}
+
+
+
+/*
+ * Name:	findNear()
+ * Purpose:	Re-check the part of the canvas affected by moving some
+ *		nodes.
+ * Arguments:	The nodes which moved.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The clashes of the edges which were checked.
+ * Assumptions:	The nodes are all in the same scene.
+ * Bugs:	None known.
+ * Notes:	The edges checked are those of the moved nodes, those
+ *		passing over the moved nodes, and those which are
+ *		highlighted now, since moving a node may have cleared
+ *		them.  So the result can be given straight to
+ *		highlight().
+ */
+
+QList<EdgeChecker::Clash>
+EdgeChecker::findNear(QList<Node *> moved)
+{
+    QList<Clash> clashes;
+
+    if (moved.isEmpty() || moved.first()->scene() == nullptr)
+	return clashes;
+
+    QGraphicsScene * scene = moved.first()->scene();
+    QSet<Edge *> edges;
+    QRectF movedArea;
+
+    foreach (Node * node, moved)
+    {
+	movedArea |= node->sceneBoundingRect();
+	foreach (Edge * edge, node->edgeList)
+	    edges.insert(edge);
+    }
+    foreach (QGraphicsItem * item,
+	     scene->items(movedArea, Qt::IntersectsItemBoundingRect))
+    {
+	if (item->type() == Edge::Type)
+	    edges.insert(qgraphicsitem_cast<Edge *>(item));
+    }
+    foreach (QPointer<QGraphicsObject> item, highlighted)
+    {
+	if (!item.isNull() && item->type() == Edge::Type
+	    && item->scene() == scene)
+	    edges.insert(qgraphicsitem_cast<Edge *>(item.data()));
+    }
+    if (edges.isEmpty())
+	return clashes;
+
+    // Only the nodes which these edges could pass through.
+    QRectF area;
+    foreach (Edge * edge, edges)
+    {
+	QLineF line = centreLine(edge);
+	area |= QRectF(line.p1(), line.p2()).normalized();
+    }
+    QList<Node *> nodes;
+    foreach (QGraphicsItem * item,
+	     scene->items(area, Qt::IntersectsItemBoundingRect))
+    {
+	if (item->type() == Node::Type)
+	    nodes.append(qgraphicsitem_cast<Node *>(item));
+    }
+
+    return find(edges.values(), nodes);
+}
+
+
+
+/*
+ * Name:	highlight()
+ * Purpose:	Show which edges pass through which nodes.
+ * Arguments:	The clashes.
+ * Outputs:	Nothing.
+ * Modifies:	The pen style of the clashing edges and nodes, and of
+ *		those highlighted before.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Replaces the previous highlighting.  Selected items
+ *		are left alone, since chosen() shows the selection too.
+ */
+
+void
+EdgeChecker::highlight(QList<Clash> clashes)
+{
+    foreach (QPointer<QGraphicsObject> item, highlighted)
+    {
+	if (item.isNull() || selectedList.contains(item.data()))
+	    continue;
+	if (item->type() == Node::Type)
+	    qgraphicsitem_cast<Node *>(item.data())->chosen(0);
+	else
+	    qgraphicsitem_cast<Edge *>(item.data())->chosen(0);
+    }
+    highlighted.clear();
+
+    QSet<QGraphicsObject *> done;
+    foreach (Clash clash, clashes)
+    {
+	if (!done.contains(clash.edge))
+	{
+	    done.insert(clash.edge);
+	    clash.edge->chosen(1);
+	    highlighted.append(clash.edge);
+	}
+	if (!done.contains(clash.node))
+	{
+	    done.insert(clash.node);
+	    clash.node->chosen(1);
+	    highlighted.append(clash.node);
+	}
+    }
+}
+
+
+
+/*
+ * Name:	highlightedEdges()
+ * Purpose:	Say how many edges are highlighted as clashing.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The number of edges.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+int
+EdgeChecker::highlightedEdges()
+{
+    int count = 0;
+
+    foreach (QPointer<QGraphicsObject> item, highlighted)
+	if (!item.isNull() && item->type() == Edge::Type)
+	    count++;
+    return count;
+}
+
+
+
+/*
+ * Name:	fixes()
+ * Purpose:	Work out where to move nodes so that no edge passes
+ *		through them.
+ * Arguments:	The clashes, and lists for the answer.
+ * Outputs:	Nothing.
+ * Modifies:	*nodes and *positions.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	Moving a node may put it on some other edge, or move
+ *		its own edges onto other nodes.
+ * Notes:	Each node is pushed straight out from the nearest point
+ *		of each edge through it, just far enough to clear it;
+ *		a node on several edges gets the sum of the pushes.
+ *		The positions are node centres in scene coordinates,
+ *		as CanvasScene::moveNodes() wants.
+ */
+
+void
+EdgeChecker::fixes(QList<Clash> clashes, QList<Node *> * nodes,
+		   QList<QPointF> * positions)
+{
+    QHash<Node *, QPointF> push;
+
+    foreach (Clash clash, clashes)
+    {
+	QLineF line = centreLine(clash.edge);
+	QPointF centre = clash.node->scenePos();
+	QPointF nearest = nearestPoint(line, centre);
+	qreal distance = QLineF(nearest, centre).length();
+	qreal needed = radius(clash.node) + clash.edge->getPenWidth() / 2.
+	    + CLEARANCE;
+
+	// A node dead on the line goes off to the left of it.
+	QLineF unit = distance < 1e-6 ? line.normalVector().unitVector()
+				       : QLineF(nearest, centre).unitVector();
+	push[clash.node] += (needed - distance) * (unit.p2() - unit.p1());
+    }
+
+    nodes->clear();
+    positions->clear();
+    QHash<Node *, QPointF>::const_iterator it;
+    for (it = push.constBegin(); it != push.constEnd(); ++it)
+    {
+	nodes->append(it.key());
+	positions->append(it.key()->scenePos() + it.value());
+    }
+}
+
+
+
+/*
+ * Name:	find()
+ * Purpose:	Find which of some edges pass through which of some
+ *		nodes.
+ * Arguments:	The edges and the nodes.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The clashes.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	An edge never clashes with its own nodes.
+ */
+
+QList<EdgeChecker::Clash>
+EdgeChecker::find(QList<Edge *> edges, QList<Node *> nodes)
+{
+    QList<Clash> clashes;
+    RectGrid grid(GRID_CELL_SIZE);
+
+    foreach (Node * node, nodes)
+    {
+	QPointF centre = node->scenePos();
+	qreal r = radius(node);
+	grid.insert(QRectF(centre.x() - r, centre.y() - r, 2 * r, 2 * r));
+    }
+
+    foreach (Edge * edge, edges)
+    {
+	QLineF line = centreLine(edge);
+	if (line.length() == 0)
+	    continue;
+
+	foreach (int index, grid.along(line))
+	{
+	    Node * node = nodes.at(index);
+	    if (node == edge->sourceNode() || node == edge->destNode())
+		continue;
+
+	    QPointF centre = node->scenePos();
+	    QLineF gap(nearestPoint(line, centre), centre);
+	    if (gap.length() < radius(node))
+	    {
+		Clash clash;
+		clash.edge = edge;
+		clash.node = node;
+		clashes.append(clash);
+	    }
+	}
+    }
+
+    return clashes;
+}
+
+
+
+/*
+ * Name:	centreLine()
+ * Purpose:	Get the line between the centres of an edge's nodes.
+ * Arguments:	The edge.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The line, in scene coordinates.
+ * Assumptions:	The edge has both of its nodes.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+QLineF
+EdgeChecker::centreLine(Edge * edge)
+{
+    return QLineF(edge->sourceNode()->scenePos(),
+		  edge->destNode()->scenePos());
+}
+
+
+
+/*
+ * Name:	nearestPoint()
+ * Purpose:	Find the point of a line segment nearest a point.
+ * Arguments:	The segment and the point.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The nearest point of the segment.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+QPointF
+EdgeChecker::nearestPoint(QLineF line, QPointF point)
+{
+    qreal lengthSquared = line.dx() * line.dx() + line.dy() * line.dy();
+
+    if (lengthSquared == 0)
+	return line.p1();
+
+    qreal t = ((point.x() - line.x1()) * line.dx()
+	       + (point.y() - line.y1()) * line.dy()) / lengthSquared;
+    return line.pointAt(qBound(qreal(0.), t, qreal(1.)));
+}
+
+
+
+/*
+ * Name:	radius()
+ * Purpose:	Get the radius of a node as drawn.
+ * Arguments:	The node.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The radius, in scene pixels.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Half the width of its bounding box, which includes the
+ *		outline (and a little more).
+ */
+
+qreal
+EdgeChecker::radius(Node * node)
+{
+    return node->sceneBoundingRect().width() / 2.;
+}
@@ -0,0 +1,70 @@
+/*
+ * File:	edgechecker.h
+ * Author:	Jim Diamond
+ * Date:	2026-10-19
+ * Version:	1.0
+ *
+ * Purpose:	Define the EdgeChecker class, which finds edges drawn
+ *		through nodes they are not attached to, and works out
+ *		where to move those nodes so that they are clear.
+ *
+ * Notes:	An edge is taken as the straight line between the
+ *		centres of its nodes, and a node as a circle just big
+ *		enough to hold its outline.  The nodes are put in a
+ *		RectGrid, and each edge is only tested against the
+ *		nodes in the grid cells it passes through.
+ *		findNear() only tests the edges of some moved nodes,
+ *		the edges passing near them and the edges already
+ *		highlighted, so it is cheap enough to run after every
+ *		drag.
+ *		The fix moves the offending nodes (not the edges) out
+ *		from the line; it may make new clashes, which another
+ *		check will find.
+ *
+ * Modification history:
+ * Oct 19, 2026 (JD V1.0)
+ *  (a) Initial version.
+ */
+
+#ifndef EDGECHECKER_H
+#define EDGECHECKER_H
+
+#include <QList>
+#include <QLineF>
+#include <QPointer>
+#include <QPointF>
+
+class Edge;
+class Node;
+class QGraphicsObject;
+class QGraphicsScene;
+
+class EdgeChecker
+{
+  public:
+    typedef struct
+    {
+	Edge * edge;
+	Node * node;		// A node the edge passes through.
+    } Clash;
+
+    static void setEnabled(bool on) { enabled = on; }
+    static bool isEnabled() { return enabled; }
+    static QList<Clash> findAll(QGraphicsScene * scene);
+    static QList<Clash> findNear(QList<Node *> moved);
+    static void highlight(QList<Clash> clashes);
+    static int highlightedEdges();
+    static void fixes(QList<Clash> clashes, QList<Node *> * nodes,
+		      QList<QPointF> * positions);
+
+  private:
+    static QList<Clash> find(QList<Edge *> edges, QList<Node *> nodes);
+    static QLineF centreLine(Edge * edge);
+    static QPointF nearestPoint(QLineF line, QPointF point);
+    static qreal radius(Node * node);
+
+    static QList<QPointer<QGraphicsObject>> highlighted;
+    static bool enabled;
+};
+
+#endif // EDGECHECKER_H
@@ -2,7 +2,7 @@
  * File:	file-io.cpp
  * Author:	Jim Diamond
  * Date:	2020-10-22
- * Version:	1.1
+ * Version:	1.18
  *
  * Purpose:	Implement the functions which read .grphc files and
  *		the functions which write files	graph files (text or
@@ -33,23 +33,105 @@
  * Oct 29, 2020 (JD V1.1)
  *  (a) Do not clear the promptSave (i.e., the graph has not been
  *	saved) flag for output file types other than .grphc.
+ * Oct 19, 2026 (JD V1.2)
+ *  (a) inputCustomGraph() collects the node and edge labels in a
+ *	LabelBatch so that they are converted to HTML in parallel
+ *	once the whole file has been read.
+ * Oct 19, 2026 (JD V1.3)
+ *  (a) saveTikZ() and saveGraphIc() now take a snapshot of the nodes
+ *	and edges, format ranges of nodes (and their edges) into
+ *	separate buffers on the worker threads, and then write the
+ *	buffers out in order.  The output is byte-for-byte the same as
+ *	before.  The order-dependent choice of which item
+ *	\definecolor's an unnamed colour is made in a serial pass first
+ *	(see nameColour()).
+ * Oct 19, 2026 (JD V1.4)
+ *  (a) saveGraph() gets the image background colours from the
+ *	AppSettings cache.
+ * Oct 19, 2026 (JD V1.5)
+ *  (a) saveGraph() expands any meta-nodes first, since the nodes
+ *	they stand for are not in the scene.
+ * Oct 19, 2026 (JD V1.6)
+ *  (a) Clear any view filter before saving the canvas.
+ * Oct 19, 2026 (JD V1.7)
+ *  (a) saveTikZ() writes out edge label placements (see
+ *	labelplacer.h) with pos= and auto/swap.
+ * Oct 19, 2026 (JD V1.8)
+ *  (a) Save and load style classes (see styleclass.h) in .grphc
+ *	files as "#%style" lines, which older versions read as
+ *	comments, and a "style=<name>" field before the label.
+ *  (b) saveTikZ() turns each style class into class-<name> styles,
+ *	and its members just use those styles.
+ * Oct 19, 2026 (JD V1.9)
+ *  (a) Add exportGraph(), which saves a scene to a file chosen by
+ *	its extension without any dialogs, for the script engine.
+ *  (b) Factor renderImage(), renderSvg() and numberNodes() out of
+ *	saveGraph() so that exportGraph() can share them.
+ * Oct 19, 2026 (JD V1.10)
+ *  (a) Split readGraphIc() out of inputCustomGraph(), returning
+ *	errors instead of showing them, and add readEdgelist().
+ *  (b) Add writeGraph(), which writes to any QIODevice; exportGraph()
+ *	uses it.  renderImage() now returns a QImage and renderSvg()
+ *	writes to a device, so the render service (see
+ *	renderservice.h) can keep its output in memory.
+ * Oct 19, 2026 (JD V1.11)
+ *  (a) Scene coordinates are now in 1/SCENE_DPI inch whatever the
+ *	screen resolution, so convert positions, pen widths and sizes
+ *	with SCENE_DPI rather than currentPhysicalDPI_X/_Y.
+ *  (b) renderImage() takes the image resolution, which is a scale on
+ *	the painter; images are still exported at the current
+ *	resolution.  SVGs record SCENE_DPI as their resolution.
+ * Oct 19, 2026 (JD V1.12)
+ *  (a) Exports get the bounds of the drawing from
+ *	CanvasScene::contentBoundsOf() instead of itemsBoundingRect().
+ * Oct 19, 2026 (JD V1.13)
+ *  (a) saveGraph() tells the session recorder about each save.
+ * Oct 19, 2026 (JD V1.14)
+ *  (a) saveGraph() no longer expands the meta-nodes for good (even
+ *	when the user cancels the dialog): once the file name is
+ *	known it reveals them, writes the file, and conceals them
+ *	again (see metanode.h).
+ * Oct 19, 2026 (JD V1.15)
+ *  (a) saveGraph() and exportGraph() no longer clear the view
+ *	filter, which now hides items rather than taking them out of
+ *	the scene (see viewfilter.h).
+ * Oct 19, 2026 (JD V1.16)
+ *  (a) Save and load edge label placements (see labelplacer.h) in
+ *	.grphc files as optional "pos=" and "side=" fields before the
+ *	style field, if any; add placementField().
+ * Oct 19, 2026 (JD V1.17)
+ *  (a) exportGraph() reveals the meta-nodes while it writes, as
+ *	saveGraph() does, rather than expanding them for good.
+ * Oct 19, 2026 (JD V1.18)
+ *  (a) readEdgelist() rejects node counts above a limit given by
+ *	the caller, rather than making however many nodes it is
+ *	asked for.
  */
 
 #include <QDate>
 #include <QDir>
 #include <QFileDialog>
+#include <QFileInfo>
 #include <QImageWriter>
 #include <QMessageBox>
 #include <QPainter>
+#include <QSet>
 #include <QtSvg/QSvgGenerator>
 
 #include <unordered_map>
 
+#include "appsettings.h"
 #include "basicgraphs.h"
+#include "canvasscene.h"
 #include "defuns.h"
 #include "edge.h"
 #include "graph.h"
 #include "file-io.h"
+#include "jobscheduler.h"
+#include "labelbatch.h"
+#include "metanode.h"
+#include "sessionrecorder.h"
+#include "styleclass.h"
 
 #define TIKZ_SAVE_FILE		"TikZ (*.tikz)"
 #define EDGES_SAVE_FILE		"Edge list (*.edges)"
@@ -64,6 +146,11 @@
 // Similar for vertex precision in .grphc output:
 #define VP_PREC_GRPHC  4
 
+// The number of nodes (with their edges) which saveTikZ() and
+// saveGraphIc() format into one buffer.  Each buffer is one job for
+// the worker threads.
+#define FORMAT_GRAIN_SIZE  512
+
 static QString fileDirectory;
 
 
@@ -83,6 +170,11 @@ static QString fileDirectory;
  *		in the styles v/.style, e/.style and l/.style.	Then
  *		when drawing a particular vertex or edge, anything not
  *		matching the default is output, over-riding the style.
+ *		For large graphs the time goes into formatting, so
+ *		the node and edge text is formatted in chunks on the
+ *		worker threads from a snapshot of the items, and the
+ *		chunks are written out in order.  The output is the
+ *		same as formatting everything serially.
  */
 
 bool
@@ -99,7 +191,7 @@ File_IO::saveTikZ(QTextStream &outfile, QVector<Node *> nodes)
     // a key.  Go figure.  So store the .name() of the colour.  Note
     // that .name() without a format specification doesn't get the
     // alpha channel, so if we ever allow alpha channels in node or
-    // edge colours, this will need updating.
+    // edge colours, this will need updating.  See nameColour().
     QHash<QString, QString> unnamedColours;
 
     // Output the boilerplate TikZ picture code:
@@ -108,6 +200,16 @@ File_IO::saveTikZ(QTextStream &outfile, QVector<Node *> nodes)
     // Find and output the default node and edge details:
     findDefaults(nodes, &nodeDefaults, &edgeDefaults);
 
+    // Take a snapshot of what we need to know about the nodes and
+    // edges, so that the formatting below can be done on the worker
+    // threads without touching any QGraphicsItems.
+    QVector<nodeSnapshot> nodeSnaps;
+    QVector<edgeSnapshot> edgeSnaps;
+    takeSnapshot(nodes, &nodeSnaps, &edgeSnaps);
+
+    // Find the style classes in use, in order of first use.
+    QStringList classNames = usedStyleClasses(nodeSnaps, edgeSnaps);
+
     // Define the default styles.
     // If the line or fill colour is a TikZ "known" colour,
     // use the name.  Otherwise \define a colour.
@@ -151,7 +253,7 @@ File_IO::saveTikZ(QTextStream &outfile, QVector<Node *> nodes)
 	    << "font=\\fontsize{" << nodeDefaults.labelSize
 	    << "}{1}\\selectfont,\n"
 	    << "\tline width="
-	    << QString::number(nodeDefaults.penSize / currentPhysicalDPI_X,
+	    << QString::number(nodeDefaults.penSize / SCENE_DPI,
 			       'f', VT_PREC_TIKZ) << "in},\n";
 
 
@@ -176,10 +278,51 @@ File_IO::saveTikZ(QTextStream &outfile, QVector<Node *> nodes)
     }
 
     outfile << ", line width="
-	    << QString::number(edgeDefaults.penSize / currentPhysicalDPI_X,
+	    << QString::number(edgeDefaults.penSize / SCENE_DPI,
 			       'f', ET_PREC_TIKZ) << "in},\n"
 	    << "    l/.style={font=\\fontsize{" << edgeDefaults.labelSize
-	    << "}{1}\\selectfont}]\n";
+	    << "}{1}\\selectfont}";
+
+    // Each style class becomes three styles: class-<name> for its
+    // nodes, and class-<name>-e and class-<name>-l for its edges and
+    // their labels.  Their colours are named here (before any node
+    // or edge colours) so that the \definecolor's come first.
+    QString classColours;
+    QTextStream classColourOut(&classColours);
+    for (int k = 0; k < classNames.count(); k++)
+    {
+	const StyleClass::Values & v
+	    = StyleClass::find(classNames.at(k))->values();
+	QString name[3];
+	QColor colour[3] = { v.fillColour, v.lineColour, v.edgeColour };
+	const char * suffix[3] = { "fillClr", "lineClr", "edgeClr" };
+	for (int c = 0; c < 3; c++)
+	{
+	    bool define;
+	    nameColour(colour[c], "c" + QString::number(k) + suffix[c],
+		       &unnamedColours, &name[c], &define);
+	    if (define)
+		classColourOut << "\\definecolor{" << name[c] << "} {RGB} {"
+			       << QString::number(colour[c].red())
+			       << "," << QString::number(colour[c].green())
+			       << "," << QString::number(colour[c].blue())
+			       << "}\n";
+	}
+	QString penWidth = QString::number(v.penWidth / SCENE_DPI,
+					   'f', VT_PREC_TIKZ);
+	outfile << ",\n    class-" << classNames.at(k) << "/.style={fill="
+		<< name[0] << ", draw=" << name[1]
+		<< ", minimum size=" << QString::number(v.diameter) << "in,\n"
+		<< "\tline width=" << penWidth << "in, "
+		<< "font=\\fontsize{" << QString::number(v.labelSize)
+		<< "}{1}\\selectfont},\n"
+		<< "    class-" << classNames.at(k) << "-e/.style={draw="
+		<< name[2] << ", line width=" << penWidth << "in},\n"
+		<< "    class-" << classNames.at(k) << "-l/.style={"
+		<< "font=\\fontsize{" << QString::number(v.labelSize)
+		<< "}{1}\\selectfont}";
+    }
+    outfile << "]\n";
 
     // We have now finished the generic style.
     // Output default colours, if needed.
@@ -207,22 +350,20 @@ File_IO::saveTikZ(QTextStream &outfile, QVector<Node *> nodes)
 		<< "," << QString::number(defEdgeLineColour.blue())
 		<< "}\n";
     }
-
-    QString edgeStyles = "";
+    classColourOut.flush();
+    outfile << classColours;
 
     // Nodes: find center of graph, output graph centered on (0, 0)
     qreal minx = 0, maxx = 0, miny = 0, maxy = 0;
-    if (nodes.count() > 0)
+    if (nodeSnaps.count() > 0)
     {
-	Node * node = nodes.at(0);
-	minx = maxx = node->scenePos().rx();
-	miny = maxy = node->scenePos().ry();
+	minx = maxx = nodeSnaps.at(0).x;
+	miny = maxy = nodeSnaps.at(0).y;
     }
-    for (int i = 1; i < nodes.count(); i++)
+    for (int i = 1; i < nodeSnaps.count(); i++)
     {
-	Node * node = nodes.at(i);
-	qreal x = node->scenePos().rx();
-	qreal y = node->scenePos().ry();
+	qreal x = nodeSnaps.at(i).x;
+	qreal y = nodeSnaps.at(i).y;
 	if (x > maxx)
 	    maxx = x;
 	else if (x < minx)
@@ -235,6 +376,44 @@ File_IO::saveTikZ(QTextStream &outfile, QVector<Node *> nodes)
     qreal midx = (maxx + minx) / 2.;
     qreal midy = (maxy + miny) / 2.;
 
+    // Decide what each non-default colour is called.  Which item
+    // gets to \definecolor an unnamed colour depends on the order
+    // in which the colours are seen, so this is done serially, in
+    // output order (all nodes, then all edges).  It is only hash
+    // lookups, so it is cheap compared to the formatting.
+    QVector<tikzColours> nodeColours(nodeSnaps.count());
+    QVector<tikzColours> edgeColours(edgeSnaps.count());
+    for (int i = 0; i < nodeSnaps.count(); i++)
+    {
+	const nodeSnapshot & node = nodeSnaps.at(i);
+	tikzColours & c = nodeColours[i];
+	if (!node.styleClass.isEmpty())
+	    continue;
+	if (node.fillColour != defNodeFillColour)
+	    nameColour(node.fillColour, "n" + QString::number(i) + "fillClr",
+		       &unnamedColours, &c.fill, &c.defineFill);
+	if (node.lineColour != defNodeLineColour)
+	    nameColour(node.lineColour, "n" + QString::number(i) + "lineClr",
+		       &unnamedColours, &c.line, &c.defineLine);
+    }
+    for (int i = 0; i < nodeSnaps.count(); i++)
+    {
+	const nodeSnapshot & node = nodeSnaps.at(i);
+	for (int j = node.firstEdge; j < node.firstEdge + node.numEdges; j++)
+	{
+	    const edgeSnapshot & edge = edgeSnaps.at(j);
+	    if (((edge.sourceID == i && edge.destID > i)
+		 || (edge.destID == i && edge.sourceID > i))
+		&& edge.styleClass.isEmpty()
+		&& edge.colour != defEdgeLineColour)
+		nameColour(edge.colour,
+			   "e" + QString::number(edge.sourceID) + "_"
+			   + QString::number(edge.destID) + "lineClr",
+			   &unnamedColours, &edgeColours[j].line,
+			   &edgeColours[j].defineLine);
+	}
+    }
+
     // Sample output for a node:
     //	\definecolor{n<n>lineClr} {RGB} {R,G,B}	  (if not default)
     //	\definecolor{n<n>fillClr} {RGB} {R,G,B}	  (if not default)
@@ -243,144 +422,104 @@ File_IO::saveTikZ(QTextStream &outfile, QVector<Node *> nodes)
     // to the \node options (or to the 'n' style above).
     // Note that TikZ is OK with a spurious ',' at the end of the options;
     // this fact is used to simplify the code below.
-    for (int i = 0; i < nodes.count(); i++)
+    auto formatNode = [&](QTextStream & out, int i)
     {
+	const nodeSnapshot & node = nodeSnaps.at(i);
+	const tikzColours & c = nodeColours.at(i);
 	QString fillColour = "";
 	QString lineColour = "";
-	Node * node = nodes.at(i);
 	bool doNewLine = false;
+	// A node in a style class gets everything from the class style.
+	bool plain = node.styleClass.isEmpty();
 
-	if (node->getFillColour() != defNodeFillColour)
+	if (plain && node.fillColour != defNodeFillColour)
 	{
-	    // Is this colour known to TikZ?
-	    fillColour = lookupColour(node->getFillColour());
-	    QString qtname = node->getFillColour().name();
-	    if (fillColour == nullptr)
-	    {
-		// Not known to TikZ... have we seen it yet?
-		if (unnamedColours.contains(qtname))
-		{
-		    qDeb() << "\thot diggity... found " << node->getFillColour()
-			   << " == " << qtname;
-		    fillColour = unnamedColours.value(qtname);
-		}
-	    }
-	    if (fillColour == nullptr)
-	    {
-		// We have not seen this colour before.
-		// \definecolor it for TikZ *and* add it to the hash
-		// of known colour names.
-		qDeb() << "\tdid not find " << node->getFillColour()
-		       << ";\n\t\tadding it to hash as " << qtname;
-		fillColour = "n" + QString::number(i) + "fillClr";
-		unnamedColours[qtname] = fillColour;
-		outfile << "\\definecolor{" << fillColour << "} {RGB} {"
-			<< QString::number(node->getFillColour().red())
-			<< "," << QString::number(node->getFillColour().green())
-			<< "," << QString::number(node->getFillColour().blue())
-			<< "}\n";
-	    }
+	    if (c.defineFill)
+		out << "\\definecolor{" << c.fill << "} {RGB} {"
+		    << QString::number(node.fillColour.red())
+		    << "," << QString::number(node.fillColour.green())
+		    << "," << QString::number(node.fillColour.blue())
+		    << "}\n";
 	    // Wrap the fillColour with the TikZ syntax for later consumption:
-	    fillColour = ", fill=" + fillColour;
+	    fillColour = ", fill=" + c.fill;
 	    doNewLine = true;
 	}
-	if (node->getLineColour() != defNodeLineColour)
+	if (plain && node.lineColour != defNodeLineColour)
 	{
-	    // Is this colour known to TikZ?
-	    lineColour = lookupColour(node->getLineColour());
-	    QString qtname = node->getLineColour().name();
-	    if (lineColour == nullptr)
-	    {
-		// Not known to TikZ... have we seen it yet?
-		if (unnamedColours.contains(qtname))
-		{
-		    qDeb() << "\thot diggity... found " << node->getLineColour()
-			   << " == " << qtname;
-		    lineColour = unnamedColours.value(qtname);
-		}
-	    }
-	    if (lineColour == nullptr)
-	    {
-		qDeb() << "\tdid not find " << node->getLineColour()
-		       << ";\n\t\tadding it to hash as " << qtname;
-		lineColour = "n" + QString::number(i) + "lineClr";
-		unnamedColours[qtname] = lineColour;
-		outfile << "\\definecolor{" << lineColour << "}{RGB}{"
-			<< QString::number(node->getLineColour().red())
-			<< "," << QString::number(node->getLineColour().green())
-			<< "," << QString::number(node->getLineColour().blue())
-			<< "}\n";
-	    }
-	    lineColour = ", draw=" + lineColour;
+	    if (c.defineLine)
+		out << "\\definecolor{" << c.line << "}{RGB}{"
+		    << QString::number(node.lineColour.red())
+		    << "," << QString::number(node.lineColour.green())
+		    << "," << QString::number(node.lineColour.blue())
+		    << "}\n";
+	    lineColour = ", draw=" + c.line;
 	    doNewLine = true;
 	}
 
 	// Use (x,y) coordinate system for node positions.
-	outfile << "\\node (v" << QString::number(i) << ") at ("
-		<< QString::number((node->scenePos().rx() - midx)
-				   / currentPhysicalDPI_X,
-				   'f', VP_PREC_TIKZ)
-		<< ","
-		<< QString::number((node->scenePos().ry() - midy)
-				   / -currentPhysicalDPI_Y,
-				   'f', VP_PREC_TIKZ)
-		<< ") [n";
-	outfile << fillColour << lineColour;
-	if (node->getDiameter() != nodeDefaults.nodeDiameter)
+	out << "\\node (v" << QString::number(i) << ") at ("
+	    << QString::number((node.x - midx) / SCENE_DPI,
+			       'f', VP_PREC_TIKZ)
+	    << ","
+	    << QString::number((node.y - midy) / -SCENE_DPI,
+			       'f', VP_PREC_TIKZ)
+	    << ") [n";
+	if (!plain)
+	    out << ", class-" << node.styleClass;
+	out << fillColour << lineColour;
+	if (plain && node.diameter != nodeDefaults.nodeDiameter)
 	{
-	    outfile << ", minimum size=" << QString::number(node->getDiameter())
-		    << "in";
+	    out << ", minimum size=" << QString::number(node.diameter) << "in";
 	    doNewLine = true;
 	}
 
-	if (node->getPenWidth() != nodeDefaults.penSize)
+	if (plain && node.penWidth != nodeDefaults.penSize)
 	{
-	    outfile << ", line width="
-		    << QString::number(node->getPenWidth()
-				       / currentPhysicalDPI_X,
-				       'f', VT_PREC_TIKZ)
-		    << "in";
+	    out << ", line width="
+		<< QString::number(node.penWidth / SCENE_DPI,
+				   'f', VT_PREC_TIKZ)
+		<< "in";
 	    doNewLine = true;
 	}
 
 	// Output the node label and its font size if and only if
 	// there is a node label.
-	if (node->getLabel().length() > 0)
+	if (node.label.length() > 0)
 	{
-	    if (node->getLabelSize() != nodeDefaults.labelSize)
+	    if (plain && node.labelSize != nodeDefaults.labelSize)
 	    {
 		if (doNewLine)
-		    outfile << ",\n\t";
+		    out << ",\n\t";
 		else
-		    outfile << ", ";
-		outfile << "font=\\fontsize{"
-			<< QString::number(node->getLabelSize()) // Font size
-			<< "}{1}\\selectfont";
+		    out << ", ";
+		out << "font=\\fontsize{"
+		    << QString::number(node.labelSize) // Font size
+		    << "}{1}\\selectfont";
 	    }
 
-	    QString thisLabel = node->getLabel();
 	    // TODO: this check just checks for a '^', but
 	    // if a subscript itself has a superscript
 	    // and there is no (top-level) superscript, we would
 	    // fail to add the "^{}" text.
-	    if (thisLabel.indexOf('^') != -1 || thisLabel.indexOf('_') == -1)
-		outfile << "] {$" << thisLabel << "$};\n";
+	    if (node.label.indexOf('^') != -1 || node.label.indexOf('_') == -1)
+		out << "] {$" << node.label << "$};\n";
 	    else
-		outfile << "] {$" << thisLabel << "^{}$};\n";
+		out << "] {$" << node.label << "^{}$};\n";
 	}
 	else
-	    outfile << "] {$$};\n";
-    }
+	    out << "] {$$};\n";
+    };
 
     // Sample output for an edge:
     //	\definecolor{e<n>_<m>lineClr} {RGB} {R,G,B}   (if not default)
-    //	\path (v<n>) edge[e, diff from defaults] node[l, diff from defaults]
+    //	\path (v<n>) edge[e, diff from defaults] node[l, diff from defaults,
+    //		placement if not the middle]
     //		{$<edge label>} (v_<m>);
-    for (int i = 0; i < nodes.count(); i++)
+    auto formatEdges = [&](QTextStream & out, int i)
     {
+	const nodeSnapshot & node = nodeSnaps.at(i);
 	bool wroteExtra = false;
-	qDebu("\tNode %d has %d edges", i, nodes.at(i)->edgeList.count());
-	for (int j = 0; j < nodes.at(i)->edgeList.count(); j++)
+	for (int j = node.firstEdge; j < node.firstEdge + node.numEdges; j++)
 	{
 	    // TODO: is it possible that with various and sundry
 	    // operations on graphs neither the sourceID nor the
@@ -388,95 +527,114 @@ File_IO::saveTikZ(QTextStream &outfile, QVector<Node *> nodes)
 	    // i, and thus some edge won't be printed?	If so,
 	    // should we just test "sourceID < destID in the if
 	    // test immediately below?
-	    Edge * edge = nodes.at(i)->edgeList.at(j);
-	    int sourceID = edge->sourceNode()->getID();
-	    int destID = edge->destNode()->getID();
+	    const edgeSnapshot & edge = edgeSnaps.at(j);
+	    int sourceID = edge.sourceID;
+	    int destID = edge.destID;
 	    if ((sourceID == i && destID > i)
 		|| (destID == i && sourceID > i))
 	    {
-		qDebu("\ti %d j %d srcID %d dstID %d", i, j, sourceID, destID);
-		qDebu("\tlabel = /%s/", edge->getLabel().toLatin1().data());
 		QString lineColour = "";
-		if (edge->getColour() != defEdgeLineColour)
+		bool plain = edge.styleClass.isEmpty();
+		if (!plain)
+		    lineColour = ", class-" + edge.styleClass + "-e";
+		else if (edge.colour != defEdgeLineColour)
 		{
-		    qDebu("E %d,%d: colour non-default", sourceID, destID);
-		    lineColour = lookupColour(edge->getColour());
-		    QString qtname = edge->getColour().name();
-		    if (lineColour == nullptr)
-		    {
-			if (unnamedColours.contains(qtname))
-			{
-			    qDeb() << "\thot diggity... found "
-				   << edge->getColour()
-				   << " == " << qtname;
-			    lineColour = unnamedColours.value(qtname);
-			}
-		    }
-		    if (lineColour == nullptr)
-		    {
-			qDeb() << "\tdid not find " << edge->getColour()
-			       << ";\n\t\tadding it to hash as " << qtname;
-			lineColour = "e" + QString::number(sourceID) + "_"
-			    + QString::number(destID) + "lineClr";
-			unnamedColours[qtname] = lineColour;
-			outfile << "\\definecolor{" << lineColour << "}{RGB}{"
-				<< QString::number(edge->getColour().red())
-				<< ","
-				<< QString::number(edge->getColour().green())
-				<< ","
-				<< QString::number(edge->getColour().blue())
-				<< "}\n";
-		    }
-		    lineColour = ", draw=" + lineColour;
+		    const tikzColours & c = edgeColours.at(j);
+		    if (c.defineLine)
+			out << "\\definecolor{" << c.line << "}{RGB}{"
+			    << QString::number(edge.colour.red())
+			    << ","
+			    << QString::number(edge.colour.green())
+			    << ","
+			    << QString::number(edge.colour.blue())
+			    << "}\n";
+		    lineColour = ", draw=" + c.line;
 		    wroteExtra = true;
-		    qDebu("\tSETTING lineColour = /%s/",
-			  lineColour.toLatin1().data());
 		}
 
-		outfile << "\\path (v"
-			<< QString::number(sourceID)
-			<< ") edge[e" << lineColour;
-		if (edge->getPenWidth() != edgeDefaults.penSize)
+		out << "\\path (v"
+		    << QString::number(sourceID)
+		    << ") edge[e" << lineColour;
+		if (plain && edge.penWidth != edgeDefaults.penSize)
 		{
-		    outfile << ", line width="
-			    << QString::number(edge->getPenWidth()
-					       / currentPhysicalDPI_X,
-					       'f', ET_PREC_TIKZ)
-			    << "in";
+		    out << ", line width="
+			<< QString::number(edge.penWidth / SCENE_DPI,
+					   'f', ET_PREC_TIKZ)
+			<< "in";
 		    wroteExtra = true;
 		}
 
 		// Output a \n iff we have both a non-default line
 		// width and a non-default label size.
-		if (edge->getLabel().length() > 0
-		    && edge->getLabelSize() != edgeDefaults.labelSize
+		if (edge.label.length() > 0
+		    && plain && edge.labelSize != edgeDefaults.labelSize
 		    && wroteExtra)
-		    outfile << "]\n\tnode[l";
+		    out << "]\n\tnode[l";
 		else
-		    outfile << "] node[l";
+		    out << "] node[l";
+		if (!plain)
+		    out << ", class-" << edge.styleClass << "-l";
 
 		// Output edge label size (and the "select font" info)
 		// if and only if the edge has a label.
-		if (edge->getLabel().length() > 0)
+		if (edge.label.length() > 0)
 		{
-		    if (edge->getLabelSize() != edgeDefaults.labelSize)
+		    if (plain && edge.labelSize != edgeDefaults.labelSize)
 		    {
-			outfile << ", font=\\fontsize{"
-				<< QString::number(edge->getLabelSize())
-				<< "}{1}\\selectfont";
+			out << ", font=\\fontsize{"
+			    << QString::number(edge.labelSize)
+			    << "}{1}\\selectfont";
 		    }
-		    outfile << "] {$" << edge->getLabel() << "$}";
+
+		    // Output the label placement, if it isn't the
+		    // middle of the line.  TikZ's "auto" puts the
+		    // label on the left, as Edge does for side 1.
+		    if (edge.labelPos != 0.5)
+			out << ", pos="
+			    << QString::number(edge.labelPos, 'f', 2);
+		    if (edge.labelSide > 0)
+			out << ", auto";
+		    else if (edge.labelSide < 0)
+			out << ", auto, swap";
+		    out << "] {$" << edge.label << "$}";
 		}
 		else
-		    outfile << "] {$$}";
+		    out << "] {$$}";
 
 		// Finally, output the other end of the edge:
-		outfile << " (v"
-			<< QString::number(destID)
-			<< ");\n";
+		out << " (v"
+		    << QString::number(destID)
+		    << ");\n";
 	    }
 	}
-    }
+    };
+
+    // Format ranges of nodes (and then their edges) into separate
+    // buffers in parallel, then write the buffers out in order.
+    int chunks = (nodeSnaps.count() + FORMAT_GRAIN_SIZE - 1)
+	/ FORMAT_GRAIN_SIZE;
+    QVector<QString> nodeText(chunks), edgeText(chunks);
+    JobScheduler::instance()->parallelFor(
+	chunks, 1,
+	[&](int begin, int end)
+	{
+	    for (int c = begin; c < end; c++)
+	    {
+		int last = qMin((c + 1) * FORMAT_GRAIN_SIZE, nodeSnaps.count());
+		QTextStream nodeOut(&nodeText[c]);
+		QTextStream edgeOut(&edgeText[c]);
+		for (int i = c * FORMAT_GRAIN_SIZE; i < last; i++)
+		{
+		    formatNode(nodeOut, i);
+		    formatEdges(edgeOut, i);
+		}
+	    }
+	});
+
+    for (int c = 0; c < chunks; c++)
+	outfile << nodeText.at(c);
+    for (int c = 0; c < chunks; c++)
+	outfile << edgeText.at(c);
 
     outfile << "\\end{tikzpicture}\n";
 
@@ -499,6 +657,7 @@ File_IO::saveTikZ(QTextStream &outfile, QVector<Node *> nodes)
  *		the label is empty, but if outputExtra = T these
  *		are output (this is a debugging aid), as well as some
  *		extra info.
+ *		Formatted in parallel chunks, as in saveTikZ().
  */
 
 bool
@@ -517,6 +676,40 @@ File_IO::saveGraphIc(QTextStream &outfile, QVector<Node *> nodes,
     outfile << dateTime.toString("yyyy-MM-dd hh:mm:ss") << "\n";
     outfile << "# Do NOT edit or delete the above line!" << "\n\n";
 
+    QVector<nodeSnapshot> nodeSnaps;
+    QVector<edgeSnapshot> edgeSnaps;
+    takeSnapshot(nodes, &nodeSnaps, &edgeSnaps);
+
+    // The style classes are written as special comments, so that
+    // older versions of this program still read the file.  Every
+    // node and edge line has all of its own values as well.
+    QStringList classNames = usedStyleClasses(nodeSnaps, edgeSnaps);
+    if (classNames.count() > 0)
+    {
+	outfile << "# The style classes; the format is:\n"
+		<< "# #%style name fill=r,g,b outline=r,g,b diameter=d "
+		<< "pen=pen_width\n"
+		<< "#	label=label_font_size edge=r,g,b\n";
+	foreach (QString name, classNames)
+	{
+	    const StyleClass::Values & v = StyleClass::find(name)->values();
+	    outfile << "#%style " << name
+		    << " fill=" << QString::number(v.fillColour.redF())
+		    << "," << QString::number(v.fillColour.greenF())
+		    << "," << QString::number(v.fillColour.blueF())
+		    << " outline=" << QString::number(v.lineColour.redF())
+		    << "," << QString::number(v.lineColour.greenF())
+		    << "," << QString::number(v.lineColour.blueF())
+		    << " diameter=" << QString::number(v.diameter)
+		    << " pen=" << QString::number(v.penWidth)
+		    << " label=" << QString::number(v.labelSize)
+		    << " edge=" << QString::number(v.edgeColour.redF())
+		    << "," << QString::number(v.edgeColour.greenF())
+		    << "," << QString::number(v.edgeColour.blueF()) << "\n";
+	}
+	outfile << "\n";
+    }
+
     outfile << "# The number of nodes in this graph:\n";
     outfile << nodes.count() << "\n\n";
 
@@ -524,7 +717,7 @@ File_IO::saveGraphIc(QTextStream &outfile, QVector<Node *> nodes,
 
     outfile << "# The node descriptions; the format is:\n";
     outfile << "# x,y, diameter, pen_width, fill r,g,b,\n";
-    outfile << "#      outline r,g,b, label_font_size, <label>\n";
+    outfile << "#      outline r,g,b, label_font_size, [style=name,] <label>\n";
 
     // In some cases I have created a graph where all the
     // coordinates are negative and "large", and the graph is not
@@ -533,17 +726,15 @@ File_IO::saveGraphIc(QTextStream &outfile, QVector<Node *> nodes,
     // canvas.	Thus the graph is effectively lost.  Avoid this by
     // centering the graph on (0, 0) when writing it out.
     qreal minx = 0, maxx = 0, miny = 0, maxy = 0;
-    if (nodes.count() > 0)
+    if (nodeSnaps.count() > 0)
     {
-	Node * node = nodes.at(0);
-	minx = maxx = node->scenePos().rx();
-	miny = maxy = node->scenePos().ry();
+	minx = maxx = nodeSnaps.at(0).x;
+	miny = maxy = nodeSnaps.at(0).y;
     }
-    for (int i = 1; i < nodes.count(); i++)
+    for (int i = 1; i < nodeSnaps.count(); i++)
     {
-	Node * node = nodes.at(i);
-	qreal x = node->scenePos().rx();
-	qreal y = node->scenePos().ry();
+	qreal x = nodeSnaps.at(i).x;
+	qreal y = nodeSnaps.at(i).y;
 	if (x > maxx)
 	    maxx = x;
 	else if (x < minx)
@@ -554,81 +745,117 @@ File_IO::saveGraphIc(QTextStream &outfile, QVector<Node *> nodes,
 	    miny = y;
     }
 
-    qreal midxInch = (maxx + minx) / (currentPhysicalDPI_X * 2.);
-    qreal midyInch = (maxy + miny) / (currentPhysicalDPI_Y * 2.);
-    for (int i = 0; i < nodes.count(); i++)
+    qreal midxInch = (maxx + minx) / (SCENE_DPI * 2.);
+    qreal midyInch = (maxy + miny) / (SCENE_DPI * 2.);
+    auto formatNode = [&](QTextStream & out, int i)
     {
 	// TODO: s/,/\\/ before writing out label.  Undo this when reading.
-	Node * node = nodes.at(i);
-	outfile << "# Node " + QString::number(i) + ":\n";
-	outfile << QString::number(node->scenePos().rx() / currentPhysicalDPI_X
-				   - midxInch,
-				   'f', VP_PREC_GRPHC) << ","
-		<< QString::number(node->scenePos().ry() / currentPhysicalDPI_Y
-				   - midyInch,
-				   'f', VP_PREC_GRPHC) << ", "
-		<< QString::number(node->getDiameter()) << ", "
-		<< QString::number(node->getPenWidth()) << ", "
-		<< QString::number(node->getFillColour().redF()) << ","
-		<< QString::number(node->getFillColour().greenF()) << ","
-		<< QString::number(node->getFillColour().blueF()) << ", "
-		<< QString::number(node->getLineColour().redF()) << ","
-		<< QString::number(node->getLineColour().greenF()) << ","
-		<< QString::number(node->getLineColour().blueF()) << ", "
-		<< QString::number(node->getLabelSize()) << ", <"
-		<< node->getLabel() << ">\n";
-    }
-
-    outfile << "\n# The edge descriptions; the format is:\n"
-	    << "# u, v, dest_radius, source_radius, pen_width,\n"
-	    << "#	line r,g,b, label_font_size, <label>\n";
-
-    for (int n = 0; n < nodes.count(); n++)
+	const nodeSnapshot & node = nodeSnaps.at(i);
+	out << "# Node " + QString::number(i) + ":\n";
+	out << QString::number(node.x / SCENE_DPI - midxInch,
+			       'f', VP_PREC_GRPHC) << ","
+	    << QString::number(node.y / SCENE_DPI - midyInch,
+			       'f', VP_PREC_GRPHC) << ", "
+	    << QString::number(node.diameter) << ", "
+	    << QString::number(node.penWidth) << ", "
+	    << QString::number(node.fillColour.redF()) << ","
+	    << QString::number(node.fillColour.greenF()) << ","
+	    << QString::number(node.fillColour.blueF()) << ", "
+	    << QString::number(node.lineColour.redF()) << ","
+	    << QString::number(node.lineColour.greenF()) << ","
+	    << QString::number(node.lineColour.blueF()) << ", "
+	    << QString::number(node.labelSize) << ", ";
+	if (!node.styleClass.isEmpty())
+	    out << "style=" << node.styleClass << ", ";
+	out << "<" << node.label << ">\n";
+    };
+
+    auto formatEdges = [&](QTextStream & out, int n)
     {
-	for (int e = 0; e < nodes.at(n)->edgeList.count(); e++)
+	const nodeSnapshot & node = nodeSnaps.at(n);
+	for (int e = 0; e < node.numEdges; e++)
 	{
-	    Edge * edge = nodes.at(n)->edgeList.at(e);
+	    const edgeSnapshot & edge = edgeSnaps.at(node.firstEdge + e);
 	    if (outputExtra)
 	    {
-		outfile << "# Looking at n, e = "
-			<< QString::number(n) << ", " << QString::number(e)
-			<< "  ->  src, dst = "
-			<< QString::number(edge->sourceNode()->getID())
-			<< ", "
-			<< QString::number(edge->destNode()->getID())
-			<< "\n";
+		out << "# Looking at n, e = "
+		    << QString::number(n) << ", " << QString::number(e)
+		    << "  ->  src, dst = "
+		    << QString::number(edge.sourceID)
+		    << ", "
+		    << QString::number(edge.destID)
+		    << "\n";
 	    }
 
 	    int printThisOne = 0;
-	    int sourceID = edge->sourceNode()->getID();
-	    int destID = edge->destNode()->getID();
+	    int sourceID = edge.sourceID;
+	    int destID = edge.destID;
 	    if (sourceID == n && destID > n)
 	    {
 		printThisOne++;
-		outfile << QString("%1").arg(sourceID, 2, 10, QChar(' '))
-			<<  ","
-			<< QString("%1").arg(destID, 2, 10, QChar(' '));
+		out << QString("%1").arg(sourceID, 2, 10, QChar(' '))
+		    <<  ","
+		    << QString("%1").arg(destID, 2, 10, QChar(' '));
 	    }
 	    else if (destID == n && sourceID > n)
 	    {
 		printThisOne++;
-		outfile << QString("%1").arg(destID, 2, 10, QChar(' '))
-			<<  ","
-			<< QString("%1").arg(sourceID, 2, 10, QChar(' '));
+		out << QString("%1").arg(destID, 2, 10, QChar(' '))
+		    <<  ","
+		    << QString("%1").arg(sourceID, 2, 10, QChar(' '));
 	    }
 	    if (printThisOne)
 	    {
-		outfile << ", " << QString::number(edge->getDestRadius())
-			<< ", " << QString::number(edge->getSourceRadius())
-			<< ", " << QString::number(edge->getPenWidth()) << ", "
-			<< QString::number(edge->getColour().redF()) << ","
-			<< QString::number(edge->getColour().greenF()) << ","
-			<< QString::number(edge->getColour().blueF()) << ", "
-			<< edge->getLabelSize() << ", <"
-			<< edge->getLabel() << ">\n";
+		out << ", " << QString::number(edge.destRadius)
+		    << ", " << QString::number(edge.sourceRadius)
+		    << ", " << QString::number(edge.penWidth) << ", "
+		    << QString::number(edge.colour.redF()) << ","
+		    << QString::number(edge.colour.greenF()) << ","
+		    << QString::number(edge.colour.blueF()) << ", "
+		    << edge.labelSize << ", ";
+		if (edge.labelPos != 0.5 || edge.labelSide != 0)
+		    out << "pos=" << QString::number(edge.labelPos)
+			<< ", side=" << QString::number(edge.labelSide)
+			<< ", ";
+		if (!edge.styleClass.isEmpty())
+		    out << "style=" << edge.styleClass << ", ";
+		out << "<" << edge.label << ">\n";
 	    }
 	}
-    }
+    };
+
+    // As in saveTikZ(), format ranges of nodes and edges into their
+    // own buffers in parallel, and then write them out in order.
+    int chunks = (nodeSnaps.count() + FORMAT_GRAIN_SIZE - 1)
+	/ FORMAT_GRAIN_SIZE;
+    QVector<QString> nodeText(chunks), edgeText(chunks);
+    JobScheduler::instance()->parallelFor(
+	chunks, 1,
+	[&](int begin, int end)
+	{
+	    for (int c = begin; c < end; c++)
+	    {
+		int last = qMin((c + 1) * FORMAT_GRAIN_SIZE, nodeSnaps.count());
+		QTextStream nodeOut(&nodeText[c]);
+		QTextStream edgeOut(&edgeText[c]);
+		for (int i = c * FORMAT_GRAIN_SIZE; i < last; i++)
+		{
+		    formatNode(nodeOut, i);
+		    formatEdges(edgeOut, i);
+		}
+	    }
+	});
+
+    for (int c = 0; c < chunks; c++)
+	outfile << nodeText.at(c);
+
+    outfile << "\n# The edge descriptions; the format is:\n"
+	    << "# u, v, dest_radius, source_radius, pen_width,\n"
+	    << "#	line r,g,b, label_font_size, [pos=p, side=s,]\n"
+	    << "#	[style=name,] <label>\n";
+
+    for (int c = 0; c < chunks; c++)
+	outfile << edgeText.at(c);
 
     return true;
 }
@@ -644,7 +871,9 @@ File_IO::saveGraphIc(QTextStream &outfile, QVector<Node *> nodes,
  * Returns:	True on file successfully saved, false otherwise.
  * Assumptions: ?
  * Bugs:	This function is too long.
- * Notes:	None.
+ * Notes:	The nodes which any meta-nodes stand for are put in
+ *		the scene while the file is written, and taken out
+ *		again afterwards (see metanode.h).
  */
 
 bool
@@ -726,6 +955,11 @@ File_IO::saveGraph(bool * promptSave, QWidget * parent, Ui::MainWindow * ui)
 	qDeb() << "saveGraph(): computed filename is" << fileName;
     }
 #endif
+    SessionRecorder::saved(QFileInfo(fileName).suffix().toLower());
+
+    // Collapsed nodes are not in the scene; put them there while
+    // the file is written so that they are saved.
+    MetaNode::revealAll();
 
     // Handle all image (i.e., non-text) outputs here;
     // check for all known text-file types.
@@ -742,85 +976,39 @@ File_IO::saveGraph(bool * promptSave, QWidget * parent, Ui::MainWindow * ui)
 	&& selectedFilter != SVG_SAVE_FILE)
     {
 	ui->canvas->scene()->clearSelection();
-	ui->canvas->scene()->invalidate(ui->canvas->scene()->itemsBoundingRect(),
+	ui->canvas->scene()->invalidate(CanvasScene::contentBoundsOf(
+					    ui->canvas->scene()),
 					ui->canvas->scene()->BackgroundLayer);
 
-	QPixmap * image = new QPixmap(ui->canvas->scene()
-				      ->itemsBoundingRect().size().toSize());
-	if (selectedFilter == "JPG (*.jpg)")
-	{
-	    if (settings.contains("jpgBgColour"))
-	    {
-		QColor colour = settings.value("jpgBgColour").toString();
-		image->fill(colour);
-	    }
-	    else
-		image->fill(Qt::white);
-	}
-	else
-	{
-	    if (settings.contains("otherImageBgColour"))
-	    {
-		QColor colour = settings.value("otherImageBgColour").toString();
-		image->fill(colour);
-	    }
-	    else
-		image->fill(Qt::transparent);
-	}
-	QPainter painter(image);
-	painter.setRenderHints(QPainter::Antialiasing
-			       | QPainter::TextAntialiasing
-			       | QPainter::HighQualityAntialiasing
-			       | QPainter::NonCosmeticDefaultPen, true);
-	ui->canvas->scene()->setBackgroundBrush(Qt::transparent);
-	ui->canvas->
-	    scene()->render(&painter,
-			    QRectF(0, 0,
-				   ui->canvas->scene()
-				   ->itemsBoundingRect().width(),
-				   ui->canvas->scene()
-				   ->itemsBoundingRect().height()),
-			    ui->canvas->scene()->itemsBoundingRect(),
-			    Qt::IgnoreAspectRatio);
-	image->save(fileName); // Requires file extension or it won't save :-/
+	renderImage(ui->canvas->scene(), selectedFilter == "JPG (*.jpg)",
+		    currentPhysicalDPI_X)
+	    .save(fileName); // Requires file extension or it won't save :-/
 
+	MetaNode::concealAll();
 	ui->canvas->snapToGrid(saveS2GStatus);
 	ui->canvas->update();
 	return true;
     }
 
     // Common code for text files:
-    int numOfNodes = 0;
-    QVector<Node *> nodes;
-    QString edges = "";
-
     QFile outputFile(fileName);
     outputFile.open(QIODevice::WriteOnly);
     if (!outputFile.isOpen())
     {
+	MetaNode::concealAll();
 	QMessageBox::information(0, "Error",
 				 "Unable to open " + fileName + " for output!");
 	return false;
     }
 
-    // The output routines just take a list of nodes.  Create the list
-    // and give each node a meaningful ID.
-    foreach (QGraphicsItem * item, ui->canvas->scene()->items())
-    {
-	if (item->type() == Node::Type)
-	{
-	    Node * node = qgraphicsitem_cast<Node *>(item);
-	    node->setID(numOfNodes++);
-	    nodes.append(node);
-	}
-    }
-
+    QVector<Node *> nodes = numberNodes(ui->canvas->scene());
     QTextStream outStream(&outputFile);
 
     if (selectedFilter == GRAPHiCS_SAVE_FILE)
     {
 	bool success = saveGraphIc(outStream, nodes, false);
 	outputFile.close();
+	MetaNode::concealAll();
 	ui->canvas->snapToGrid(saveS2GStatus);
 	ui->canvas->update();
 	QFileInfo fi(fileName);
@@ -834,6 +1022,7 @@ File_IO::saveGraph(bool * promptSave, QWidget * parent, Ui::MainWindow * ui)
     {
 	bool success = saveEdgelist(outStream, nodes);
 	outputFile.close();
+	MetaNode::concealAll();
 	ui->canvas->snapToGrid(saveS2GStatus);
 	ui->canvas->update();
 	return success;
@@ -843,6 +1032,7 @@ File_IO::saveGraph(bool * promptSave, QWidget * parent, Ui::MainWindow * ui)
     {
 	bool success = saveTikZ(outStream, nodes);
 	outputFile.close();
+	MetaNode::concealAll();
 	ui->canvas->snapToGrid(saveS2GStatus);
 	ui->canvas->update();
 	return success;
@@ -850,25 +1040,16 @@ File_IO::saveGraph(bool * promptSave, QWidget * parent, Ui::MainWindow * ui)
 
     if (selectedFilter == SVG_SAVE_FILE)
     {
-	QSvgGenerator svgGen;
-
-	svgGen.setFileName(fileName);
-	svgGen.setSize(ui->canvas->scene()
-		       ->itemsBoundingRect().size().toSize());
-	QPainter painter(&svgGen);
-	ui->canvas->scene()->render(&painter,
-				    QRectF(0, 0, ui->canvas->scene()
-					   ->itemsBoundingRect().width(),
-					   ui->canvas->scene()
-					   ->itemsBoundingRect().height()),
-				    ui->canvas->scene()->itemsBoundingRect(),
-				    Qt::IgnoreAspectRatio);
+	renderSvg(ui->canvas->scene(), &outputFile);
+	outputFile.close();
+	MetaNode::concealAll();
 	ui->canvas->snapToGrid(saveS2GStatus);
 	ui->canvas->update();
 	return true;
     }
 
     // ? Should not get here!
+    MetaNode::concealAll();
     qDebug() << "saveGraph(): Unexpected output filter in "
 	     << "fileio::saveGraph()!";
     return false;
@@ -876,6 +1057,225 @@ File_IO::saveGraph(bool * promptSave, QWidget * parent, Ui::MainWindow * ui)
 
 
 
+/*
+ * Name:	exportGraph()
+ * Purpose:	Save everything in a scene to a file, without asking
+ *		the user anything.
+ * Arguments:	The scene, the file name and where to put an error
+ *		message.
+ * Outputs:	The file.
+ * Modifies:	*errorMessage, on failure.
+ * Returns:	True on success.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	The type of file is chosen by the file name extension,
+ *		which must be one of those offered by saveGraph().
+ *		Used by the script engine (see scriptengine.h), so it
+ *		must not pop up any dialogs.
+ *		Collapsed nodes are written out but stay collapsed
+ *		(see metanode.h).
+ */
+
+bool
+File_IO::exportGraph(QGraphicsScene * scene, QString fileName,
+		     QString * errorMessage)
+{
+    QFile outputFile(fileName);
+    outputFile.open(QIODevice::WriteOnly);
+    if (!outputFile.isOpen())
+    {
+	*errorMessage = "Unable to open " + fileName + " for output!";
+	return false;
+    }
+
+    // As in saveGraph(), the collapsed nodes are only put in the
+    // scene while it is written.
+    MetaNode::revealAll();
+    bool success = writeGraph(scene, QFileInfo(fileName).suffix(),
+			      &outputFile, errorMessage);
+    MetaNode::concealAll();
+    outputFile.close();
+    if (!success)
+	*errorMessage = fileName + ": " + *errorMessage;
+    return success;
+}
+
+
+
+/*
+ * Name:	writeGraph()
+ * Purpose:	Write everything in a scene to a device in a given
+ *		format.
+ * Arguments:	The scene, the format (a file name extension: "grphc",
+ *		"tikz", "edges", "svg", or an image format which
+ *		QImageWriter knows), the device and where to put an
+ *		error message.
+ * Outputs:	The graph(s), to the device.
+ * Modifies:	*errorMessage, on failure.
+ * Returns:	True on success.
+ * Assumptions:	The device is open for writing.
+ * Bugs:	None known.
+ * Notes:	Used by exportGraph() and the render service (see
+ *		renderservice.h), which writes into a QBuffer.
+ */
+
+bool
+File_IO::writeGraph(QGraphicsScene * scene, QString format,
+		    QIODevice * device, QString * errorMessage)
+{
+    format = format.toLower();
+    if (format == "svg")
+    {
+	renderSvg(scene, device);
+	return true;
+    }
+
+    if (format != GRAPHiCS_FILE_EXTENSION && format != "tikz"
+	&& format != "edges")
+    {
+	if (!QImageWriter::supportedImageFormats().contains(format.toLatin1()))
+	{
+	    *errorMessage = "unknown file type \"" + format + "\"";
+	    return false;
+	}
+	if (!renderImage(scene, format == "jpg" || format == "jpeg",
+			 currentPhysicalDPI_X)
+	    .save(device, format.toLatin1().constData()))
+	{
+	    *errorMessage = "unable to write a " + format + " image";
+	    return false;
+	}
+	return true;
+    }
+
+    QVector<Node *> nodes = numberNodes(scene);
+    QTextStream outStream(device);
+    bool success;
+    if (format == GRAPHiCS_FILE_EXTENSION)
+	success = saveGraphIc(outStream, nodes, false);
+    else if (format == "tikz")
+	success = saveTikZ(outStream, nodes);
+    else
+	success = saveEdgelist(outStream, nodes);
+    outStream.flush();
+
+    if (!success)
+	*errorMessage = "unable to write the graph";
+    return success;
+}
+
+
+
+/*
+ * Name:	numberNodes()
+ * Purpose:	Make the list of nodes which the text output routines
+ *		take, and give each node a meaningful ID.
+ * Arguments:	The scene.
+ * Outputs:	Nothing.
+ * Modifies:	The IDs of the nodes.
+ * Returns:	The nodes.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+QVector<Node *>
+File_IO::numberNodes(QGraphicsScene * scene)
+{
+    int numOfNodes = 0;
+    QVector<Node *> nodes;
+
+    foreach (QGraphicsItem * item, scene->items())
+    {
+	if (item->type() == Node::Type)
+	{
+	    Node * node = qgraphicsitem_cast<Node *>(item);
+	    node->setID(numOfNodes++);
+	    nodes.append(node);
+	}
+    }
+
+    return nodes;
+}
+
+
+
+/*
+ * Name:	renderImage()
+ * Purpose:	Draw everything in a scene into an image.
+ * Arguments:	The scene, whether the image is to be a JPEG, and the
+ *		resolution (in dots per inch) of the image.
+ * Outputs:	Nothing.
+ * Modifies:	The scene's background brush.
+ * Returns:	The image.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	JPEGs have no transparency, so they get their own
+ *		background colour setting.
+ *		This makes a QImage rather than a QPixmap so that it
+ *		can be encoded off the GUI thread (see
+ *		renderservice.cpp) and works with no display.
+ *		Scene coordinates are in 1/SCENE_DPI inch, so any
+ *		resolution is just a scale on the painter.
+ */
+
+QImage
+File_IO::renderImage(QGraphicsScene * scene, bool jpg, qreal dpi)
+{
+    QRectF bounds = CanvasScene::contentBoundsOf(scene);
+    QSizeF size = bounds.size() * dpi / SCENE_DPI;
+    QImage image(size.toSize(), QImage::Format_ARGB32_Premultiplied);
+    image.setDotsPerMeterX(qRound(dpi / 0.0254));
+    image.setDotsPerMeterY(qRound(dpi / 0.0254));
+
+    if (jpg)
+	image.fill(AppSettings::instance()->jpgBgColour());
+    else
+	image.fill(AppSettings::instance()->otherImageBgColour());
+    QPainter painter(&image);
+    painter.setRenderHints(QPainter::Antialiasing
+			   | QPainter::TextAntialiasing
+			   | QPainter::HighQualityAntialiasing
+			   | QPainter::NonCosmeticDefaultPen, true);
+    scene->setBackgroundBrush(Qt::transparent);
+    scene->render(&painter, QRectF(QPointF(0, 0), size),
+		  bounds, Qt::IgnoreAspectRatio);
+    painter.end();
+
+    return image;
+}
+
+
+
+/*
+ * Name:	renderSvg()
+ * Purpose:	Draw everything in a scene as SVG.
+ * Arguments:	The scene and the device to write to.
+ * Outputs:	The SVG, to the device.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	The device is open for writing.
+ * Bugs:	QSvgGenerator doesn't say whether it could write.
+ * Notes:	The SVG's user units are scene units, so its physical
+ *		size is right at any screen resolution.
+ */
+
+void
+File_IO::renderSvg(QGraphicsScene * scene, QIODevice * device)
+{
+    QRectF bounds = CanvasScene::contentBoundsOf(scene);
+    QSvgGenerator svgGen;
+
+    svgGen.setOutputDevice(device);
+    svgGen.setSize(bounds.size().toSize());
+    svgGen.setResolution(qRound(SCENE_DPI));
+    QPainter painter(&svgGen);
+    scene->render(&painter, QRectF(0, 0, bounds.width(), bounds.height()),
+		  bounds, Qt::IgnoreAspectRatio);
+}
+
+
+
 /*
  * Name:	loadGraphicFile()
  * Purpose:	Ask the user for a file to load.  If we get a name,
@@ -1025,8 +1425,80 @@ File_IO::inputCustomGraph(bool prependDirPath, QString graphName,
 	return;
     }
 
-    // TODO: split this off into another function.
+    qreal width, height;
+    QString errorMessage;
+    Graph * graph = readGraphIc(in, graphName, lineNum, &width, &height,
+				&errorMessage);
+    file.close();
+    if (graph == nullptr)
+    {
+	QMessageBox::information(0, "Error", errorMessage);
+	return;
+    }
+
+    // Set the w & h widgets to the actual values for this graph, to make
+    // the UI behave predictably.
+    // Note that if these signals are not (temporarily) turned off,
+    // generateGraph() will be called multiple times.  Duh.
+    ui->graphWidth->blockSignals(true);
+    ui->graphWidth->setValue(width);
+    ui->graphWidth->blockSignals(false);
+    ui->graphHeight->blockSignals(true);
+    ui->graphHeight->setValue(height);
+    ui->graphHeight->blockSignals(false);
+
+    qDeb() << "FI::inputCustomGraph: graph->childItems().length() ="
+	   << graph->childItems().length();
+
+    // Apparently we have to center the graph in the viewport.
+    // (Presumably this is because the node positions are relative to
+    // their parent, the graph?)
+    qDeb() << "    graph current position is " << graph->x() << ", "
+	   << graph->y();
+    // I'd like to use something like
+    // graph->setPos(mapToScene(viewport()->rect().center()));
+    // but I get
+    // "viewport() is unknown in this context".  For now, kludge the
+    // centering of the graph as follows.  Those are the numbers from
+    // PV::Create_Graph (every time), presumably they come from the
+    // fact that PV::PV sets the scene rectangle to (0, 0, 100, 30).
+    // But 100 and 30 are this->width and this->height, and it is not
+    // clear to me how those numbers get set.
+    graph->setPos(49, 15);
+    qDeb() << "    graph CENTERED position is " << graph->x() << ", "
+	   << graph->y();
+    graph->setRotation(-1 * ui->graphRotation->value(), false);
+
+    ui->preview->scene()->clear();
+    ui->preview->scene()->addItem(graph);
+}
+
 
+
+/*
+ * Name:	readGraphIc()
+ * Purpose:	Read the body of a (versioned) graph-ic file.
+ * Arguments:	The stream, positioned just after the version line,
+ *		the file name and line number (for error messages),
+ *		where to put the size of the drawing (in inches), and
+ *		where to put an error message.
+ * Outputs:	Nothing.
+ * Modifies:	*graphWidth and *graphHeight, or *errorMessage.
+ * Returns:	The graph, with its nodes at the positions given in the
+ *		file and their preview coordinates set, or nullptr if
+ *		the file is invalid.
+ * Assumptions:	The input is not deviously invalid.
+ * Bugs:	An edge with an invalid label is not deleted.
+ * Notes:	Split out of inputCustomGraph() so that the render
+ *		service (see renderservice.h) can read graphs which
+ *		aren't in files, without any dialogs.
+ */
+
+Graph *
+File_IO::readGraphIc(QTextStream & in, QString graphName, int lineNum,
+		     qreal * graphWidth, qreal * graphHeight,
+		     QString * errorMessage)
+{
     int i = 0;
     QVector<Node *> nodes;
     int numOfNodes = -1;		// < 0 ==> haven't read numOfNodes yet
@@ -1039,6 +1511,10 @@ File_IO::inputCustomGraph(bool prependDirPath, QString graphName,
     // extremal positions stored above.
     qreal minXr = 0, maxXr = 0, minYr = 0, maxYr = 0;
     qreal radius_total = 0;
+    // Labels are converted to HTML all at once when the file is read.
+    LabelBatch labels;
+    // The style classes defined in the file, by their names in the file.
+    QHash<QString, StyleClass *> styleClasses;
 
     while (!in.atEnd())
     {
@@ -1052,6 +1528,12 @@ File_IO::inputCustomGraph(bool prependDirPath, QString graphName,
 	    continue;
 	}
 
+	if (simpLine.startsWith("#%style "))
+	{
+	    readStyleClass(simpLine, &styleClasses);
+	    continue;
+	}
+
 	if (simpLine.at(0).toLatin1() == '#')
 	{
 	    // Allow comments where first non-white is '#'.
@@ -1067,14 +1549,13 @@ File_IO::inputCustomGraph(bool prependDirPath, QString graphName,
 	    // Theoretically yes, but practically, no.
 	    if (! ok || numOfNodes < 0)
 	    {
-		QMessageBox::information(0, "Error",
-					 "The file " + graphName
-					 + " has an invalid number of "
-					 "nodes.  Thus I can not read "
-					 "this file.");
+		*errorMessage = "The file " + graphName
+				+ " has an invalid number of "
+				"nodes.  Thus I can not read "
+				"this file.";
 		qDeb() << "  numOfNodes = " << numOfNodes;
-		file.close();
-		return;
+		delete graph;
+		return nullptr;
 	    }
 	    continue;
 	}
@@ -1093,17 +1574,15 @@ File_IO::inputCustomGraph(bool prependDirPath, QString graphName,
 	    // label.
 	    if (fields.count() < 12)
 	    {
-		QMessageBox::information(0, "Error",
-					 "Node " + QString::number(i - 1)
-					 + " on line "
-					 + QString::number(lineNum)
-					 + " of file "
-					 + graphName
-					 + " has too few fields.  Thus I "
-					 "can not read this file.");
-		// TODO: do I need to free any storage?
-		file.close();
-		return;
+		*errorMessage = "Node " + QString::number(i - 1)
+				+ " on line "
+				+ QString::number(lineNum)
+				+ " of file "
+				+ graphName
+				+ " has too few fields.  Thus I "
+				"can not read this file.";
+		delete graph;
+		return nullptr;
 	    }
 
 	    Node * node = new Node();
@@ -1113,7 +1592,7 @@ File_IO::inputCustomGraph(bool prependDirPath, QString graphName,
 	    qreal d = fields.at(2).toDouble();
 	    qreal r = d / 2.;
 	    radius_total += r;
-	    node->setPos(x * currentPhysicalDPI_X, y * currentPhysicalDPI_Y);
+	    node->setPos(x * SCENE_DPI, y * SCENE_DPI);
 	    node->setDiameter(d);
 	    node->setPenWidth(fields.at(3).toDouble());
 	    // Record information about the extremal nodes for use below.
@@ -1159,17 +1638,16 @@ File_IO::inputCustomGraph(bool prependDirPath, QString graphName,
 	    // stand in their way?
 	    if (labelPrefixLoc < 0 || ! line.endsWith(">"))
 	    {
-		QMessageBox::information(0, "Error",
-					 "Node " + QString::number(i - 1)
-					 + " on line "
-					 + QString::number(lineNum)
-					 + " of file "
-					 + graphName
-					 + " has an invalid label.  Thus I "
-					 "can not read this file.");
-		// TODO: do I need to free any storage?
-		file.close();
-		return;
+		*errorMessage = "Node " + QString::number(i - 1)
+				+ " on line "
+				+ QString::number(lineNum)
+				+ " of file "
+				+ graphName
+				+ " has an invalid label.  Thus I "
+				"can not read this file.";
+		delete node;
+		delete graph;
+		return nullptr;
 	    }
 	    
 	    QString l = line.mid(labelPrefixLoc + 3,
@@ -1178,7 +1656,9 @@ File_IO::inputCustomGraph(bool prependDirPath, QString graphName,
 	    qDeb() << "    subs line, " << labelPrefixLoc + 3
 		   << ", " << line.length() - (labelPrefixLoc + 3) - 1
 		   << ") = |" << l << "|";
-	    node->setNodeLabel(l);
+	    labels.add(node, l);
+	    node->setStyleClass(
+		styleClasses.value(styleField(line.left(labelPrefixLoc))));
 
 	    nodes.append(node);
 	    node->setParentItem(graph);
@@ -1191,22 +1671,33 @@ File_IO::inputCustomGraph(bool prependDirPath, QString graphName,
 	    // Edges may or may not have label info.  Accept both.
 	    if (fields.count() < 8 || fields.count() == 9)
 	    {
-		QMessageBox::information(0, "Error",
-					 "Edge "
-					 + QString::number(i - numOfNodes)
-					 + " on line "
-					 + QString::number(lineNum)
-					 + " of file "
-					 + graphName
-					 + " has an invalid number of "
-					 "fields.  Thus I can not read "
-					 "this file.");
-		// TODO: do I need to free any storage?
-		file.close();
-		return;
+		*errorMessage = "Edge "
+				+ QString::number(i - numOfNodes)
+				+ " on line "
+				+ QString::number(lineNum)
+				+ " of file "
+				+ graphName
+				+ " has an invalid number of "
+				"fields.  Thus I can not read "
+				"this file.";
+		delete graph;
+		return nullptr;
 	    }
 	    int from = fields.at(0).toInt();
 	    int to = fields.at(1).toInt();
+	    if (from < 0 || from >= nodes.count()
+		|| to < 0 || to >= nodes.count())
+	    {
+		*errorMessage = "Edge (" + QString::number(from)
+				+ ", "  + QString::number(to)
+				+ ") on line "
+				+ QString::number(lineNum)
+				+ " of file "
+				+ graphName
+				+ " refers to a node which doesn't exist.";
+		delete graph;
+		return nullptr;
+	    }
 	    Edge * edge = new Edge(nodes.at(from), nodes.at(to));
 	    edge->setDestRadius(fields.at(2).toDouble());
 	    edge->setSourceRadius(fields.at(3).toDouble());
@@ -1221,18 +1712,16 @@ File_IO::inputCustomGraph(bool prependDirPath, QString graphName,
 	    int labelPrefixLoc = line.indexOf(", <");
 	    if (labelPrefixLoc < 0 || ! line.endsWith(">"))
 	    {
-		QMessageBox::information(0, "Error",
-					 "Edge (" + QString::number(from)
-					 + ", "  + QString::number(to)
-					 + ") on line "
-					 + QString::number(lineNum)
-					 + " of file "
-					 + graphName
-					 + " has an invalid label.  Thus I "
-					 "can not read this file.");
-		// TODO: do I need to free any storage?
-		file.close();
-		return;
+		*errorMessage = "Edge (" + QString::number(from)
+				+ ", "  + QString::number(to)
+				+ ") on line "
+				+ QString::number(lineNum)
+				+ " of file "
+				+ graphName
+				+ " has an invalid label.  Thus I "
+				"can not read this file.";
+		delete graph;
+		return nullptr;
 	    }
 
 	    QString l = line.mid(labelPrefixLoc + 3,
@@ -1240,12 +1729,18 @@ File_IO::inputCustomGraph(bool prependDirPath, QString graphName,
 	    qDeb() << "    subs line, " << labelPrefixLoc + 3
 		   << ", " << line.length() - (labelPrefixLoc + 3) - 1
 		   << ") = |" << l << "|";
-	    edge->setEdgeLabel(l);
+	    labels.add(edge, l);
+	    edge->setStyleClass(
+		styleClasses.value(styleField(line.left(labelPrefixLoc))));
+	    qreal labelPos;
+	    int labelSide;
+	    placementField(line.left(labelPrefixLoc), &labelPos, &labelSide);
+	    edge->setLabelPlacement(labelPos, labelSide);
 
 	    edge->setParentItem(graph);
 	}
     }
-    file.close();
+    labels.apply();
 
     // Scale all the node CENTER positions to a 1"x1" square
     // so that it can be appropriately styled.
@@ -1265,49 +1760,111 @@ File_IO::inputCustomGraph(bool prependDirPath, QString graphName,
     {
 	Node * n = nodes.at(i);
 	n->setPreviewCoords(width == 0. ? 0.
-			    : n->x() / width / currentPhysicalDPI_X,
+			    : n->x() / width / SCENE_DPI,
 			    height == 0. ? 0.
-			    : n->y() / height / currentPhysicalDPI_Y);
+			    : n->y() / height / SCENE_DPI);
 	qDebu("    nodes[%s] coords: screen (%.4f, %.4f); "
 	      "preview set to (%.4f, %.4f)", n->getLabel().toLatin1().data(),
 	      n->x(), n->y(), n->getPreviewX(), n->getPreviewY());
     }
 
-    // Set the w & h widgets to the actual values for this graph, to make
-    // the UI behave predictably.
-    // Note that if these signals are not (temporarily) turned off,
-    // generateGraph() will be called multiple times.  Duh.
-    ui->graphWidth->blockSignals(true);
-    ui->graphWidth->setValue(width + 2 * radius_total / numOfNodes);
-    ui->graphWidth->blockSignals(false);
-    ui->graphHeight->blockSignals(true);
-    ui->graphHeight->setValue(height + 2 * radius_total / numOfNodes);
-    ui->graphHeight->blockSignals(false);
 
-    qDeb() << "FI::inputCustomGraph: graph->childItems().length() ="
-	   << graph->childItems().length();
+    qreal averageDiameter = numOfNodes > 0 ? 2 * radius_total / numOfNodes : 0;
+    *graphWidth = width + averageDiameter;
+    *graphHeight = height + averageDiameter;
+    return graph;
+}
 
-    // Apparently we have to center the graph in the viewport.
-    // (Presumably this is because the node positions are relative to
-    // their parent, the graph?)
-    qDeb() << "    graph current position is " << graph->x() << ", "
-	   << graph->y();
-    // I'd like to use something like
-    // graph->setPos(mapToScene(viewport()->rect().center()));
-    // but I get
-    // "viewport() is unknown in this context".  For now, kludge the
-    // centering of the graph as follows.  Those are the numbers from
-    // PV::Create_Graph (every time), presumably they come from the
-    // fact that PV::PV sets the scene rectangle to (0, 0, 100, 30).
-    // But 100 and 30 are this->width and this->height, and it is not
-    // clear to me how those numbers get set.
-    graph->setPos(49, 15);
-    qDeb() << "    graph CENTERED position is " << graph->x() << ", "
-	   << graph->y();
-    graph->setRotation(-1 * ui->graphRotation->value(), false);
 
-    ui->preview->scene()->clear();
-    ui->preview->scene()->addItem(graph);
+
+/*
+ * Name:	readEdgelist()
+ * Purpose:	Read an edge list (as written by saveEdgelist()).
+ * Arguments:	The stream, the name of the input (for error messages),
+ *		the largest number of nodes to accept, and where to
+ *		put an error message.
+ * Outputs:	Nothing.
+ * Modifies:	*errorMessage, on failure.
+ * Returns:	The graph, or nullptr if the input is invalid.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	The first (non-blank, non-comment) line is the number
+ *		of nodes, n, and each following line has the numbers
+ *		(0 to n - 1) of the two ends of an edge, separated by
+ *		a comma or white space.  Repeated edges are ignored.
+ *		An edge list says nothing about where the nodes go,
+ *		so they are put on a circle, with preview coordinates
+ *		like a basic graph's, and given no style; the caller
+ *		must position and style them.
+ *		The nodes are all made as soon as the count is read,
+ *		so a count from an untrusted source (e.g., a render
+ *		service client) must be limited by maxNodes.
+ */
+
+Graph *
+File_IO::readEdgelist(QTextStream & in, QString graphName, int maxNodes,
+		      QString * errorMessage)
+{
+    Graph * graph = nullptr;
+    QList<Node *> nodes;
+    QSet<QPair<int, int>> seen;
+    int lineNum = 0;
+
+    while (!in.atEnd())
+    {
+	QString line = in.readLine().simplified();
+	lineNum++;
+	if (line.isEmpty() || line.at(0) == '#')
+	    continue;
+
+	QStringList fields = line.replace(',', ' ').simplified().split(' ');
+	bool ok1, ok2 = true;
+	int from = fields.at(0).toInt(&ok1);
+	int to = fields.count() > 1 ? fields.at(1).toInt(&ok2) : 0;
+
+	if (graph == nullptr)
+	{
+	    if (! ok1 || fields.count() != 1 || from < 1)
+	    {
+		*errorMessage = graphName + ", line " + QString::number(lineNum)
+				+ ": expected the number of nodes.";
+		return nullptr;
+	    }
+	    if (from > maxNodes)
+	    {
+		*errorMessage = graphName + ", line " + QString::number(lineNum)
+				+ ": too many nodes (" + QString::number(from)
+				+ "; the limit is "
+				+ QString::number(maxNodes) + ").";
+		return nullptr;
+	    }
+	    graph = new Graph();
+	    BasicGraphs basicG;
+	    nodes = basicG.create_cycle(graph, 0.5, 0.5, from);
+	    continue;
+	}
+
+	if (! ok1 || ! ok2 || fields.count() != 2
+	    || from < 0 || from >= nodes.count()
+	    || to < 0 || to >= nodes.count() || from == to)
+	{
+	    *errorMessage = graphName + ", line " + QString::number(lineNum)
+			    + ": invalid edge \"" + line + "\".";
+	    delete graph;
+	    return nullptr;
+	}
+
+	QPair<int, int> key(qMin(from, to), qMax(from, to));
+	if (seen.contains(key))
+	    continue;
+	seen.insert(key);
+	Edge * edge = new Edge(nodes.at(from), nodes.at(to));
+	edge->setParentItem(graph);
+    }
+
+    if (graph == nullptr)
+	*errorMessage = graphName + ": no data.";
+    return graph;
 }
 
 
@@ -1666,6 +2223,315 @@ File_IO::findDefaults(QVector<Node *> nodes,
 
 
 
+/*
+ * Name:	takeSnapshot()
+ * Purpose:	Copy what the writers need to know about the nodes and
+ *		edges into plain structs.
+ * Arguments:	The list of nodes, and the vectors to fill in.
+ * Outputs:	Nothing.
+ * Modifies:	*nodeSnaps and *edgeSnaps.
+ * Returns:	Nothing.
+ * Assumptions:	Called on the GUI thread; node IDs are meaningful.
+ * Bugs:	None known.
+ * Notes:	The edges of node i are edgeSnaps[firstEdge] ..
+ *		edgeSnaps[firstEdge + numEdges - 1], in edgeList order,
+ *		so an edge appears once for each of its end nodes.
+ *		Once this is done the writers can format the output on
+ *		any thread, since they no longer touch the items.
+ */
+
+void
+File_IO::takeSnapshot(QVector<Node *> nodes, QVector<nodeSnapshot> * nodeSnaps,
+		      QVector<edgeSnapshot> * edgeSnaps)
+{
+    nodeSnaps->resize(nodes.count());
+    edgeSnaps->clear();
+
+    for (int i = 0; i < nodes.count(); i++)
+    {
+	Node * node = nodes.at(i);
+	nodeSnapshot & snap = (*nodeSnaps)[i];
+	QPointF pos = node->scenePos();
+
+	snap.x = pos.x();
+	snap.y = pos.y();
+	snap.diameter = node->getDiameter();
+	snap.penWidth = node->getPenWidth();
+	snap.fillColour = node->getFillColour();
+	snap.lineColour = node->getLineColour();
+	snap.labelSize = node->getLabelSize();
+	snap.label = node->getLabel();
+	snap.styleClass = node->getStyleClass() == nullptr
+	    ? QString() : node->getStyleClass()->name();
+	snap.firstEdge = edgeSnaps->count();
+	snap.numEdges = node->edgeList.count();
+
+	foreach (Edge * edge, node->edgeList)
+	{
+	    edgeSnapshot e;
+	    e.sourceID = edge->sourceNode()->getID();
+	    e.destID = edge->destNode()->getID();
+	    e.destRadius = edge->getDestRadius();
+	    e.sourceRadius = edge->getSourceRadius();
+	    e.penWidth = edge->getPenWidth();
+	    e.colour = edge->getColour();
+	    e.labelSize = edge->getLabelSize();
+	    e.label = edge->getLabel();
+	    e.labelPos = edge->getLabelPos();
+	    e.labelSide = edge->getLabelSide();
+	    e.styleClass = edge->getStyleClass() == nullptr
+		? QString() : edge->getStyleClass()->name();
+	    edgeSnaps->append(e);
+	}
+    }
+}
+
+
+
+/*
+ * Name:	usedStyleClasses()
+ * Purpose:	Find the style classes used by some nodes and edges.
+ * Arguments:	The node and edge snapshots.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The names of the classes, in order of first use (nodes
+ *		first, then edges).
+ * Assumptions:	Called on the GUI thread, since it looks the classes
+ *		up.
+ * Bugs:	None known.
+ * Notes:	Only the classes which are used are written out.
+ */
+
+QStringList
+File_IO::usedStyleClasses(const QVector<nodeSnapshot> & nodeSnaps,
+			  const QVector<edgeSnapshot> & edgeSnaps)
+{
+    QStringList names;
+    QSet<QString> seen;
+
+    foreach (const nodeSnapshot & node, nodeSnaps)
+    {
+	if (!node.styleClass.isEmpty() && !seen.contains(node.styleClass))
+	{
+	    seen.insert(node.styleClass);
+	    names.append(node.styleClass);
+	}
+    }
+    foreach (const edgeSnapshot & edge, edgeSnaps)
+    {
+	if (!edge.styleClass.isEmpty() && !seen.contains(edge.styleClass))
+	{
+	    seen.insert(edge.styleClass);
+	    names.append(edge.styleClass);
+	}
+    }
+
+    return names;
+}
+
+
+
+/*
+ * Name:	readStyleClass()
+ * Purpose:	Read a style class definition from a .grphc file.
+ * Arguments:	The (simplified) "#%style ..." line, and the hash of
+ *		the classes read so far.
+ * Outputs:	Nothing.
+ * Modifies:	*styleClasses, and the set of style classes.
+ * Returns:	True iff the line was understood.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	If there is already a class with this name and the same
+ *		values, the file's nodes and edges join it.  If there
+ *		is one with different values, a new class with a
+ *		similar name is made, so that reading a file never
+ *		restyles the graphs already on the canvas.
+ *		A line which can't be understood is ignored, just as
+ *		older versions do; the nodes and edges which use that
+ *		class still have all of their own values.
+ */
+
+bool
+File_IO::readStyleClass(QString line,
+			QHash<QString, StyleClass *> * styleClasses)
+{
+    QStringList toks = line.split(" ");
+    if (toks.count() < 2)
+	return false;
+
+    QString name = toks.at(1);
+    StyleClass::Values v = StyleClass::Values();
+    int found = 0;
+    auto readColour = [](QString value, QColor * colour)
+    {
+	QStringList rgb = value.split(",");
+	if (rgb.count() != 3)
+	    return false;
+	colour->setRedF(rgb.at(0).toDouble());
+	colour->setGreenF(rgb.at(1).toDouble());
+	colour->setBlueF(rgb.at(2).toDouble());
+	return true;
+    };
+
+    for (int t = 2; t < toks.count(); t++)
+    {
+	QString key = toks.at(t).section('=', 0, 0);
+	QString value = toks.at(t).section('=', 1);
+	bool ok = true;
+	if (key == "fill")
+	    ok = readColour(value, &v.fillColour);
+	else if (key == "outline")
+	    ok = readColour(value, &v.lineColour);
+	else if (key == "diameter")
+	    v.diameter = value.toDouble(&ok);
+	else if (key == "pen")
+	    v.penWidth = value.toDouble(&ok);
+	else if (key == "label")
+	    v.labelSize = value.toDouble(&ok);
+	else if (key == "edge")
+	    ok = readColour(value, &v.edgeColour);
+	else
+	    continue;
+	if (!ok)
+	    break;
+	found++;
+    }
+    if (found != 6)
+    {
+	qDeb() << "FI::readStyleClass(): ignoring bad style line /"
+	       << line << "/";
+	return false;
+    }
+
+    StyleClass * styleClass = StyleClass::find(name);
+    if (styleClass == nullptr || !(styleClass->values() == v))
+    {
+	if (styleClass != nullptr)
+	    name = StyleClass::uniqueName(name);
+	styleClass = StyleClass::define(name, v);
+    }
+    styleClasses->insert(toks.at(1), styleClass);
+    return true;
+}
+
+
+
+/*
+ * Name:	styleField()
+ * Purpose:	Find the style class name on a node or edge line.
+ * Arguments:	The part of the line before the label.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The name, or an empty string if there is none.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	The "style=<name>" field, if any, is the last one before
+ *		the label, so older versions (which read the fields by
+ *		position and find the label by its '<') ignore it.
+ */
+
+QString
+File_IO::styleField(QString line)
+{
+    int styleLoc = line.lastIndexOf(", style=");
+    if (styleLoc < 0)
+	return QString();
+    return line.mid(styleLoc + 8).trimmed();
+}
+
+
+
+/*
+ * Name:	placementField()
+ * Purpose:	Find the label placement on an edge line.
+ * Arguments:	The part of the line before the label, and where to
+ *		put the placement.
+ * Outputs:	Nothing.
+ * Modifies:	*pos and *side.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	The "pos=" and "side=" fields (see
+ *		Edge::setLabelPlacement()) are only written if the
+ *		label isn't in the middle of the line, so the middle
+ *		is the default.  They come before the style field, if
+ *		any, which is ignored here since a style name may be
+ *		anything.
+ */
+
+void
+File_IO::placementField(QString line, qreal * pos, int * side)
+{
+    *pos = 0.5;
+    *side = 0;
+
+    int styleLoc = line.lastIndexOf(", style=");
+    if (styleLoc >= 0)
+	line = line.left(styleLoc);
+
+    foreach (QString field, line.split(","))
+    {
+	field = field.trimmed();
+	if (field.startsWith("pos="))
+	    *pos = field.mid(4).toDouble();
+	else if (field.startsWith("side="))
+	    *side = field.mid(5).toInt();
+    }
+}
+
+
+
+/*
+ * Name:	nameColour()
+ * Purpose:	Find the TikZ name for a (non-default) colour.
+ * Arguments:	The colour, the name to \definecolor it as if it is
+ *		neither known to TikZ nor seen before, the hash of
+ *		colours defined so far, and where to put the results.
+ * Outputs:	Nothing.
+ * Modifies:	*unnamedColours, *name, *define.
+ * Returns:	Nothing.
+ * Assumptions:	Called in output order (see saveTikZ()).
+ * Bugs:	None known.
+ * Notes:	*define is set T iff the caller must output a
+ *		\definecolor for this colour.
+ *		It seems (Qt5.15.1, anyway) that a QHash can't use a
+ *		QColor as a key, so the hash is keyed on .name().
+ */
+
+void
+File_IO::nameColour(QColor colour, QString newName,
+		    QHash<QString, QString> * unnamedColours,
+		    QString * name, bool * define)
+{
+    QString qtname = colour.name();
+
+    *define = false;
+    // Is this colour known to TikZ?
+    *name = lookupColour(colour);
+    if (*name == nullptr)
+    {
+	// Not known to TikZ... have we seen it yet?
+	if (unnamedColours->contains(qtname))
+	{
+	    qDeb() << "\thot diggity... found " << colour << " == " << qtname;
+	    *name = unnamedColours->value(qtname);
+	}
+    }
+    if (*name == nullptr)
+    {
+	// We have not seen this colour before.
+	// \definecolor it for TikZ *and* add it to the hash
+	// of known colour names.
+	qDeb() << "\tdid not find " << colour
+	       << ";\n\t\tadding it to hash as " << qtname;
+	*name = newName;
+	(*unnamedColours)[qtname] = newName;
+	*define = true;
+    }
+}
+
+
+
 /*
  * Name:	setFileDirectory()
  * Purpose:	Set the fileDirectory variable.
@@ -1817,7 +2683,7 @@ File_IO::inputCustomGraphOriginal(QString graphFileName, Ui::MainWindow * ui)
 	    qreal d = fields.at(2).toDouble();
 	    qreal r = d / 2.;
 	    radius_total += r;
-	    node->setPos(x * currentPhysicalDPI_X, y * currentPhysicalDPI_Y);
+	    node->setPos(x * SCENE_DPI, y * SCENE_DPI);
 	    node->setDiameter(d);
 	    node->setRotation(fields.at(3).toDouble());
 	    node->setID(i++);
@@ -1944,9 +2810,9 @@ File_IO::inputCustomGraphOriginal(QString graphFileName, Ui::MainWindow * ui)
     {
 	Node * n = nodes.at(i);
 	n->setPreviewCoords(width == 0. ? 0.
-			    : n->x() / width / currentPhysicalDPI_X,
+			    : n->x() / width / SCENE_DPI,
 			    height == 0. ? 0.
-			    : n->y() / height / currentPhysicalDPI_Y);
+			    : n->y() / height / SCENE_DPI);
 	qDebu("    nodes[%s] coords: screen (%.4f, %.4f); "
 	      "preview set to (%.4f, %.4f)", n->getLabel().toLatin1().data(),
 	      n->x(), n->y(), n->getPreviewX(), n->getPreviewY());
@@ -2,7 +2,7 @@
  * File:	file-io.h
  * Author:	Jim Diamond
  * Date:	2020-10-22
- * Version:	1.0
+ * Version:	1.8
  *
  * Purpose:	This class holds all the functions which read or write
  *		files (except for the settings, which is taken care of
@@ -18,17 +18,42 @@
  * Oct 22, 2020 (JD V1.0)
  *  (a) Initial revision.  Functions and structs extracted from
  *	mainwindow.cpp and mainwindow.h.
+ * Oct 19, 2026 (JD V1.1)
+ *  (a) Add the snapshot structs, takeSnapshot() and nameColour(),
+ *	used by the (now parallel) saveTikZ() and saveGraphIc().
+ * Oct 19, 2026 (JD V1.2)
+ *  (a) Add labelPos and labelSide to edgeSnapshot.
+ * Oct 19, 2026 (JD V1.3)
+ *  (a) Add styleClass to the snapshots, and usedStyleClasses(),
+ *	readStyleClass() and styleField().
+ * Oct 19, 2026 (JD V1.4)
+ *  (a) Add exportGraph(), renderImage(), renderSvg() and numberNodes().
+ * Oct 19, 2026 (JD V1.5)
+ *  (a) Add readGraphIc(), readEdgelist() and writeGraph(); change
+ *	renderImage() and renderSvg().
+ * Oct 19, 2026 (JD V1.6)
+ *  (a) renderImage() takes a resolution.
+ * Oct 19, 2026 (JD V1.7)
+ *  (a) Add placementField().
+ * Oct 19, 2026 (JD V1.8)
+ *  (a) readEdgelist() takes the largest number of nodes to accept.
  */
 
 #ifndef FILE_IO_H
 #define FILE_IO_H
 
+#include <QHash>
+#include <QImage>
+#include <QStringList>
 #include <QTextStream>
 
 #include "node.h"
 #include "mainwindow.h"
 #include "ui_mainwindow.h"
 
+class Graph;
+class StyleClass;
+
 #define GRAPHiCS_FILE_EXTENSION "grphc"
 #define GRAPHiCS_SAVE_FILE	"Graph-ic (*." GRAPHiCS_FILE_EXTENSION ")"
 #define GRAPHiCS_SAVE_SUBDIR	"graph-ic"
@@ -42,7 +67,18 @@ public:
 			    bool outputExtra);
     static bool saveGraph(bool * promptSave, QWidget * parent,
 			   Ui::MainWindow * ui);
+    static bool exportGraph(QGraphicsScene * scene, QString fileName,
+			    QString * errorMessage);
+    static bool writeGraph(QGraphicsScene * scene, QString format,
+			   QIODevice * device, QString * errorMessage);
+    static QImage renderImage(QGraphicsScene * scene, bool jpg, qreal dpi);
+    static void renderSvg(QGraphicsScene * scene, QIODevice * device);
     static bool loadGraphicFile(QWidget * parent, Ui::MainWindow * ui);
+    static Graph * readGraphIc(QTextStream & in, QString graphName,
+			       int lineNum, qreal * graphWidth,
+			       qreal * graphHeight, QString * errorMessage);
+    static Graph * readEdgelist(QTextStream & in, QString graphName,
+				int maxNodes, QString * errorMessage);
     static void loadGraphicLibrary(Ui::MainWindow * ui);
     static void inputCustomGraph(bool prependDirPath, QString graphName,
 				 Ui::MainWindow * ui);
@@ -67,8 +103,57 @@ private:
 	qreal labelSize;	// points
     } edgeInfo;
 
+    // Plain copies of the item data needed by the writers, so that
+    // the text can be formatted off the GUI thread.
+    typedef struct
+    {
+	qreal x, y;		// Scene coords (pixels).
+	qreal diameter;		// inches
+	qreal penWidth;		// pixels
+	QColor fillColour, lineColour;
+	qreal labelSize;	// points
+	QString label;
+	QString styleClass;	// Empty if none; see styleclass.h.
+	int firstEdge;		// Index of this node's first edgeSnapshot.
+	int numEdges;
+    } nodeSnapshot;
+
+    typedef struct
+    {
+	int sourceID, destID;
+	qreal destRadius, sourceRadius;
+	qreal penWidth;		// pixels
+	QColor colour;
+	qreal labelSize;	// points
+	QString label;
+	qreal labelPos;		// See Edge::setLabelPlacement().
+	int labelSide;
+	QString styleClass;
+    } edgeSnapshot;
+
+    // The TikZ colour names chosen for a node or an edge.
+    typedef struct
+    {
+	QString fill, line;
+	bool defineFill = false, defineLine = false;
+    } tikzColours;
+
     static void findDefaults(QVector<Node *> nodes, nodeInfo * nodeDefaults_p,
 			     edgeInfo * edgeDefaults_p);
+    static QVector<Node *> numberNodes(QGraphicsScene * scene);
+    static void takeSnapshot(QVector<Node *> nodes,
+			     QVector<nodeSnapshot> * nodeSnaps,
+			     QVector<edgeSnapshot> * edgeSnaps);
+    static QStringList usedStyleClasses(
+	const QVector<nodeSnapshot> & nodeSnaps,
+	const QVector<edgeSnapshot> & edgeSnaps);
+    static bool readStyleClass(QString line,
+			       QHash<QString, StyleClass *> * styleClasses);
+    static QString styleField(QString line);
+    static void placementField(QString line, qreal * pos, int * side);
+    static void nameColour(QColor colour, QString newName,
+			   QHash<QString, QString> * unnamedColours,
+			   QString * name, bool * define);
     static QString lookupColour(QColor colour);
     static void inputCustomGraphOriginal(QString graphFileName,
 					 Ui::MainWindow * ui);
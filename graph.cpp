@@ -2,7 +2,7 @@
  * File:    graph.cpp
  * Author:  Rachel Bood
  * Date:    2014/11/07 (?)
- * Version: 1.11
+ * Version: 1.17
  *
  * Purpose:
  *
@@ -63,13 +63,44 @@
  *	is rotated via the Edit Canvas Graph tab it appears to rotate
  *	around its center, rather than orbiting around some apparently
  *	arbitrary point on the canvas.
+ * Oct 19, 2026 (JD V1.12)
+ *  (a) Add an optional "batch painting" mode in which paint() draws
+ *	all of the graph's edges and nodes, setting up the painter once
+ *	per style rather than once per item.  The individual items stay
+ *	in the scene for selection and interaction.  The mode follows
+ *	the "batchPainting" setting (via AppSettings).
+ * Oct 19, 2026 (JD V1.13)
+ *  (a) Add an optional edge bundling mode (see edgebundler.h).  The
+ *	bundles are computed by a background job once the nodes have
+ *	been still for a moment, cached, and thrown away when an edge
+ *	is adjusted or a child comes or goes.
+ *  (b) paintBatched() can leave the edges to paintBundles().
+ * Oct 19, 2026 (JD V1.14)
+ *  (a) Node diameters are converted with SCENE_DPI in boundingBox().
+ * Oct 19, 2026 (JD V1.15)
+ *  (a) Keep the scene bounds of each top-level graph (its "extent")
+ *	up to date as nodes move, and tell the canvas scene when they
+ *	change, so that it knows the bounds of its contents without
+ *	looking at every item.  Add sceneExtent(), childMoved(),
+ *	invalidateExtent(), invalidateExtentOf(), helpers and a
+ *	destructor.
+ * Oct 19, 2026 (JD V1.16)
+ *  (a) boundingRect() includes the bundled edges, which can bulge
+ *	out past the nodes: keep their bounds in bundleBounds when a
+ *	bundling job finishes, and drop them when the bundles go.
+ * Oct 19, 2026 (JD V1.17)
+ *  (a) paintBatched() converts the node diameter from inches to
+ *	scene units; nodes were being drawn as dots.
  */
 
 #include "graph.h"
+#include "appsettings.h"
 #include "defuns.h"
+#include "canvasscene.h"
 #include "canvasview.h"
 #include "node.h"
 #include "edge.h"
+#include "edgebundler.h"
 #include "graphmimedata.h"
 
 #include <QMimeData>
@@ -77,12 +108,22 @@
 #include <QDebug>
 #include <QByteArray>
 #include <QGraphicsSceneMouseEvent>
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include <QTimer>
 #include <QtAlgorithms>
 #include <QApplication>
 #include <QtCore>
 #include <QtGui>
 #include <QtMath>
 
+// How long (in ms) the nodes must be still before edges are bundled.
+#define BUNDLE_DELAY		200
+
+// Bundling takes time proportional to the square of the number of
+// edges, so graphs with more than this many are drawn unbundled.
+#define BUNDLE_MAX_EDGES	5000
+
 
 
 /*
@@ -102,10 +143,50 @@ Graph::Graph()
     setFlag(ItemIsMovable);
     setFlag(ItemIsSelectable);
     setFlag(ItemIsFocusable);
+    setFlag(ItemSendsGeometryChanges);
     setCacheMode(DeviceCoordinateCache);
     moved = 0;
+    extentValid = false;
     setAcceptHoverEvents(true);
     setZValue(0);
+
+    bundling = false;
+    bundleGeneration = 0;
+    bundleTimer = new QTimer(this);
+    bundleTimer->setSingleShot(true);
+    bundleTimer->setInterval(BUNDLE_DELAY);
+    connect(bundleTimer, &QTimer::timeout, this, [this]() { startBundling(); });
+
+    AppSettings * appSettings = AppSettings::instance();
+    batchPainting = false;
+    setBatchPainting(appSettings->batchPainting());
+    setBundling(appSettings->edgeBundling());
+    connect(appSettings, &AppSettings::renderingChanged, this, [this]() {
+	setBatchPainting(AppSettings::instance()->batchPainting());
+	setBundling(AppSettings::instance()->edgeBundling());
+    });
+}
+
+
+
+/*
+ * Name:	~Graph()
+ * Purpose:	Destructor.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	The canvas scene's list of graphs.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	By the time QGraphicsItem's destructor takes the graph
+ *		out of the scene, itemChange() can no longer be called.
+ */
+
+Graph::~Graph()
+{
+    CanvasScene * canvasScene = qobject_cast<CanvasScene *>(scene());
+    if (canvasScene != nullptr)
+	canvasScene->removeGraph(this);
 }
 
 
@@ -161,9 +242,9 @@ Graph::boundingBox(QPointF * center, bool useNodeSizes, QPointF * RGcenter)
 	    if (useNodeSizes)
 	    {
 		// If we wish to take the node diameter into account we
-		// must convert from inches to screen coords.
+		// must convert from inches to scene coords.
 		r = (qgraphicsitem_cast<Node *>(item))->getDiameter() / 2
-		    * currentPhysicalDPI;
+		    * SCENE_DPI;
 	    }
 	    else
 		r = 0;
@@ -288,7 +369,8 @@ Graph::mouseReleaseEvent(QGraphicsSceneMouseEvent * event)
 
 /*
  * Name:	paint()
- * Purpose:	None, really (required for custom QGraphicsItems).
+ * Purpose:	None, really (required for custom QGraphicsItems),
+ *		unless batch painting is on.
  * Arguments:	QPainter *, QStyleOptionGraphicsItem *, QWidget *
  * Outputs:	Nothing.
  * Modifies:	Nothing.
@@ -297,16 +379,23 @@ Graph::mouseReleaseEvent(QGraphicsSceneMouseEvent * event)
  * Bugs:	None known.
  * Notes:	A Graph object is just a container to house the nodes
  *		and edges, therefore nothing is required to be drawn
- *		in a graph object.
+ *		in a graph object.  However, if batch painting is on,
+ *		the nodes and edges only position their labels, and
+ *		their shapes are drawn here (see paintBatched()).
+ *		Likewise, bundled edges are drawn here.
  */
 
 void
 Graph::paint(QPainter * painter, const QStyleOptionGraphicsItem * option,
 	     QWidget * widget)
 {
-    Q_UNUSED(option);
     Q_UNUSED(widget);
 
+    if (!bundles.isEmpty())
+	paintBundles(painter, option);
+    if (batchPainting)
+	paintBatched(painter, option, bundles.isEmpty());
+
 #ifdef DEBUG
     // Paints a border around graphs for debug purposes.
     QRectF border = boundingRect();
@@ -334,13 +423,657 @@ Graph::paint(QPainter * painter, const QStyleOptionGraphicsItem * option,
  * Assumptions: None.
  * Bugs:	None known.
  * Notes:	Returns the bounding rectangle that surrounds the
- *		nodes and edges of the graph.
+ *		nodes and edges of the graph, and any bundled edges
+ *		(see paintBundles()), which may be drawn outside them.
  */
 
 QRectF
 Graph::boundingRect() const
 {
-    return childrenBoundingRect();
+    return childrenBoundingRect() | bundleBounds;
+}
+
+
+
+/*
+ * Name:	setBatchPainting()
+ * Purpose:	Turn batch painting of this graph on or off.
+ * Arguments:	True to draw the edges and nodes from Graph::paint(),
+ *		false to let each one draw itself.
+ * Outputs:	Nothing.
+ * Modifies:	batchPainting and the cache mode of the graph.
+ * Returns:	Nothing.
+ * Assumptions: None.
+ * Bugs:	None known.
+ * Notes:	When batch painting the graph's own drawing depends on
+ *		its children, so it can't be cached: a node or edge
+ *		which changes only asks for its own area to be
+ *		redrawn, not for the graph's cache to be refreshed.
+ *		Instead, we ask for the exposed rectangle so that only
+ *		the items in it are drawn.
+ */
+
+void
+Graph::setBatchPainting(bool batch)
+{
+    if (batch == batchPainting)
+	return;
+
+    batchPainting = batch;
+    setCacheMode(batchPainting || bundling ? NoCache : DeviceCoordinateCache);
+    setFlag(ItemUsesExtendedStyleOption, batchPainting || bundling);
+    update();
+    foreach (QGraphicsItem * item, childItems())
+	item->update();
+}
+
+
+
+/*
+ * Name:	setBundling()
+ * Purpose:	Turn edge bundling of this graph on or off.
+ * Arguments:	True to draw the edges bundled.
+ * Outputs:	Nothing.
+ * Modifies:	bundling, the bundles and the cache mode of the graph.
+ * Returns:	Nothing.
+ * Assumptions: None.
+ * Bugs:	None known.
+ * Notes:	As with batch painting, the graph's drawing depends on
+ *		its edges, so it isn't cached.  The edges draw
+ *		themselves as straight lines until the bundles have
+ *		been computed.
+ */
+
+void
+Graph::setBundling(bool bundle)
+{
+    if (bundle == bundling)
+	return;
+
+    if (bundle)
+    {
+	bundling = true;
+	invalidateBundles();
+    }
+    else
+    {
+	invalidateBundles();
+	bundling = false;
+	bundleTimer->stop();
+    }
+    setCacheMode(batchPainting || bundling ? NoCache : DeviceCoordinateCache);
+    setFlag(ItemUsesExtendedStyleOption, batchPainting || bundling);
+    update();
+}
+
+
+
+/*
+ * Name:	invalidateBundles()
+ * Purpose:	Throw away the bundles, since the edges have changed.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	The bundles, bundleBounds, any bundling job and the
+ *		bundle timer.
+ * Returns:	Nothing.
+ * Assumptions: None.
+ * Bugs:	None known.
+ * Notes:	Called whenever an edge is adjusted (i.e., one of its
+ *		nodes has moved) and whenever a child is added or
+ *		removed, so it has to be cheap.  The new bundles are
+ *		only computed once things have been still for
+ *		BUNDLE_DELAY ms.  Moving the whole graph doesn't
+ *		change its children's positions within it, so the
+ *		bundles survive that.
+ */
+
+void
+Graph::invalidateBundles()
+{
+    if (!bundling)
+	return;
+
+    bundleGeneration++;
+    if (!bundleJob.isNull())
+    {
+	bundleJob->cancel();
+	bundleJob.clear();
+    }
+    if (!bundles.isEmpty())
+    {
+	prepareGeometryChange();
+	bundles.clear();
+	bundledEdges.clear();
+	bundleBounds = QRectF();
+	invalidateExtent();
+	update();
+    }
+    bundleTimer->start();
+}
+
+
+
+/*
+ * Name:	startBundling()
+ * Purpose:	Compute the edge bundles on a worker thread.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	bundleJob, and (later, on the GUI thread) the bundles
+ *		and bundleBounds.
+ * Returns:	Nothing.
+ * Assumptions: None.
+ * Bugs:	None known.
+ * Notes:	The job is given plain lines in the graph's
+ *		coordinates (see edgebundler.h).  A result which comes
+ *		back after the bundles have been invalidated again is
+ *		dropped.
+ */
+
+void
+Graph::startBundling()
+{
+    QVector<QLineF> lines;
+    QVector<QPointer<Edge>> edges;
+
+    foreach (QGraphicsItem * item, childItems())
+    {
+	if (item->type() != Edge::Type)
+	    continue;
+	Edge * edge = qgraphicsitem_cast<Edge *>(item);
+	if (!edge->sourceNode() || !edge->destNode())
+	    continue;
+	QLineF line = edge->getLine();
+	lines.append(QLineF(edge->mapToParent(line.p1()),
+			    edge->mapToParent(line.p2())));
+	edges.append(edge);
+    }
+    if (lines.count() < 2 || lines.count() > BUNDLE_MAX_EDGES)
+	return;
+
+    int generation = bundleGeneration;
+    QSharedPointer<QVector<QPolygonF>> result(new QVector<QPolygonF>);
+    bundleJob = JobScheduler::instance()->submit(
+	"Bundling edges", JobScheduler::BackgroundPriority,
+	[lines, result](JobToken & token) {
+	    *result = EdgeBundler::bundle(lines, token);
+	    return QVariant();
+	},
+	this,
+	[this, generation, edges, result](const QVariant &) {
+	    if (generation != bundleGeneration
+		|| result->count() != edges.count())
+		return;
+	    bundleJob.clear();
+
+	    // The bundles may be drawn outside the children, so the
+	    // graph's bounds (and extent) may grow.
+	    QRectF bounds;
+	    qreal penWidth = 0;
+	    for (int i = 0; i < result->count(); i++)
+	    {
+		bounds |= result->at(i).boundingRect();
+		if (!edges.at(i).isNull())
+		    penWidth = qMax(penWidth, edges.at(i)->getPen().widthF());
+	    }
+	    prepareGeometryChange();
+	    bundles = *result;
+	    bundledEdges = edges;
+	    bundleBounds = bounds.adjusted(-penWidth / 2, -penWidth / 2,
+					   penWidth / 2, penWidth / 2);
+	    childMoved(QRectF(), mapRectToScene(bundleBounds));
+	    update();
+	});
+}
+
+
+
+/*
+ * Name:	paintBundles()
+ * Purpose:	Draw the bundled edges of the graph.
+ * Arguments:	The painter and the style option given to paint().
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions: The bundles are up to date.
+ * Bugs:	Edges are still selected and hit-tested as straight
+ *		lines.
+ * Notes:	As in paintBatched(), the polylines are gathered into
+ *		one path per pen.  Edges which are hidden or have been
+ *		taken off the canvas (see viewfilter.h) are skipped.
+ */
+
+void
+Graph::paintBundles(QPainter * painter,
+		    const QStyleOptionGraphicsItem * option)
+{
+    QRectF exposed = option->exposedRect;
+    QVector<QPen> pens;
+    QVector<QPainterPath> paths;
+
+    for (int i = 0; i < bundles.count(); i++)
+    {
+	Edge * edge = bundledEdges.at(i).data();
+	if (edge == nullptr || !edge->isVisible() || edge->scene() != scene())
+	    continue;
+
+	const QPolygonF & polyline = bundles.at(i);
+	if (!exposed.intersects(polyline.boundingRect()))
+	    continue;
+
+	QPen pen = edge->getPen();
+	int style = pens.indexOf(pen);
+	if (style < 0)
+	{
+	    style = pens.count();
+	    pens.append(pen);
+	    paths.append(QPainterPath());
+	}
+	paths[style].addPolygon(polyline);
+    }
+
+    painter->setBrush(Qt::NoBrush);
+    for (int style = 0; style < pens.count(); style++)
+    {
+	painter->setPen(pens.at(style));
+	painter->drawPath(paths.at(style));
+    }
+}
+
+
+
+/*
+ * Name:	itemChange()
+ * Purpose:	Notice children coming and going, the graph moving, and
+ *		the graph being added to or removed from a scene.
+ * Arguments:	The change and its value.
+ * Outputs:	Nothing.
+ * Modifies:	The bundles, the extent and the canvas scene's list of
+ *		graphs.
+ * Returns:	What QGraphicsItem::itemChange() returns.
+ * Assumptions: None.
+ * Bugs:	None known.
+ * Notes:	A node being dragged is taken out of its graph and put
+ *		back on every move (see Node::itemChange()); that is
+ *		not a change in the extent, and the move itself is
+ *		reported by the node.
+ */
+
+QVariant
+Graph::itemChange(GraphicsItemChange change, const QVariant & value)
+{
+    QGraphicsItem * child;
+    Node * node;
+    CanvasScene * canvasScene;
+
+    switch (change)
+    {
+      case ItemChildAddedChange:
+      case ItemChildRemovedChange:
+	invalidateBundles();
+	child = value.value<QGraphicsItem *>();
+	node = qgraphicsitem_cast<Node *>(child);
+	if (node == nullptr)
+	    invalidateExtent();
+	else if (!node->isReparenting())
+	{
+	    if (change == ItemChildAddedChange)
+		childMoved(QRectF(), childExtent(child));
+	    else
+		childMoved(childExtent(child), QRectF());
+	}
+	break;
+
+      case ItemPositionChange:
+	if (parentItem() != nullptr)
+	    invalidateExtent();
+	else if (extentValid)
+	{
+	    QRectF oldExtent = extent;
+	    extent.translate(value.toPointF() - pos());
+	    extentChanged(oldExtent, extent);
+	}
+	break;
+
+      case ItemRotationHasChanged:
+      case ItemScaleHasChanged:
+      case ItemTransformHasChanged:
+      case ItemParentHasChanged:
+	invalidateExtent();
+	break;
+
+      case ItemSceneChange:
+	canvasScene = qobject_cast<CanvasScene *>(scene());
+	if (canvasScene != nullptr)
+	    canvasScene->removeGraph(this);
+	break;
+
+      case ItemSceneHasChanged:
+	extentValid = false;
+	canvasScene = qobject_cast<CanvasScene *>(scene());
+	if (canvasScene != nullptr)
+	    canvasScene->addGraph(this);
+	break;
+
+      default:
+	break;
+    }
+
+    return QGraphicsObject::itemChange(change, value);
+}
+
+
+
+/*
+ * Name:	sceneExtent()
+ * Purpose:	Return the scene bounds of everything in this graph.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	extent and extentValid.
+ * Returns:	The bounds.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	The bounds are kept up to date as nodes move (see
+ *		childMoved()) and are only found from scratch after
+ *		a change which might have shrunk them.  Only the
+ *		extent of a top-level graph is kept; nested graphs
+ *		pass their changes on to it.
+ */
+
+QRectF
+Graph::sceneExtent()
+{
+    if (!extentValid)
+    {
+	extent = sceneBoundingRect();
+	extentValid = true;
+    }
+    return extent;
+}
+
+
+
+/*
+ * Name:	childMoved()
+ * Purpose:	Update the extent when something in the graph moves.
+ * Arguments:	The old and new scene bounds of the thing; a null
+ *		rectangle means "none" (the thing was added or
+ *		removed).
+ * Outputs:	Nothing.
+ * Modifies:	The root graph's extent; the canvas scene's content
+ *		bounds.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Growing is O(1).  Something which moves away from the
+ *		edge of the extent may have shrunk it, in which case
+ *		the extent is found again when next asked for.
+ */
+
+void
+Graph::childMoved(QRectF oldExtent, QRectF newExtent)
+{
+    Graph * root = rootGraph();
+    if (root != this)
+    {
+	root->childMoved(oldExtent, newExtent);
+	return;
+    }
+
+    // If the extent isn't known, neither is the scene's.
+    if (!extentValid)
+	return;
+
+    if (!oldExtent.isNull() && !newExtent.contains(oldExtent)
+	&& !CanvasScene::strictlyInside(oldExtent, extent))
+    {
+	invalidateExtent();
+	return;
+    }
+
+    if (!newExtent.isNull() && !extent.contains(newExtent))
+    {
+	QRectF before = extent;
+	extent |= newExtent;
+	extentChanged(before, extent);
+    }
+}
+
+
+
+/*
+ * Name:	invalidateExtent()
+ * Purpose:	Note that the extent must be found from scratch.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	The root graph's extentValid; the canvas scene's
+ *		content bounds.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Cheap when the extent is already invalid, so it may be
+ *		called for each of many changes.
+ */
+
+void
+Graph::invalidateExtent()
+{
+    Graph * root = rootGraph();
+    if (!root->extentValid)
+	return;
+
+    root->extentValid = false;
+    CanvasScene * canvasScene = qobject_cast<CanvasScene *>(root->scene());
+    if (canvasScene != nullptr)
+	canvasScene->invalidateContentBounds();
+}
+
+
+
+/*
+ * Name:	invalidateExtentOf()
+ * Purpose:	Note that an item (a node, an edge, a label, ...) may
+ *		have changed size in a way that wasn't reported.
+ * Arguments:	The item.
+ * Outputs:	Nothing.
+ * Modifies:	See invalidateExtent().
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Does nothing for an item which isn't in a graph.
+ */
+
+void
+Graph::invalidateExtentOf(QGraphicsItem * item)
+{
+    for (QGraphicsItem * parent = item->parentItem(); parent != nullptr;
+	 parent = parent->parentItem())
+    {
+	if (parent->type() == Graph::Type)
+	{
+	    static_cast<Graph *>(parent)->invalidateExtent();
+	    return;
+	}
+    }
+}
+
+
+
+/*
+ * Name:	rootGraph()
+ * Purpose:	Find the top-level graph this graph is part of.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The top-level graph (perhaps this one).
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Like getRootParent(), but stops at non-graph parents.
+ */
+
+Graph *
+Graph::rootGraph()
+{
+    Graph * root = this;
+    while (root->parentItem() != nullptr
+	   && root->parentItem()->type() == Graph::Type)
+	root = static_cast<Graph *>(root->parentItem());
+    return root;
+}
+
+
+
+/*
+ * Name:	childExtent()
+ * Purpose:	Find the scene bounds of a child and its own children.
+ * Arguments:	The child.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The bounds.
+ * Assumptions:	child is (or is about to be, or just was) a child of
+ *		this graph.
+ * Bugs:	None known.
+ * Notes:	Goes through this graph's transform rather than the
+ *		child's scene transform, since the child's parent
+ *		may not be set yet (or any more).
+ */
+
+QRectF
+Graph::childExtent(QGraphicsItem * child)
+{
+    return mapRectToScene(child->mapRectToParent(child->boundingRect()
+						 | child->childrenBoundingRect()));
+}
+
+
+
+/*
+ * Name:	extentChanged()
+ * Purpose:	Tell the canvas scene that this graph's extent changed.
+ * Arguments:	The old and new extents.
+ * Outputs:	Nothing.
+ * Modifies:	The canvas scene's content bounds.
+ * Returns:	Nothing.
+ * Assumptions:	This is a top-level graph.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+void
+Graph::extentChanged(QRectF oldExtent, QRectF newExtent)
+{
+    CanvasScene * canvasScene = qobject_cast<CanvasScene *>(scene());
+    if (canvasScene != nullptr)
+	canvasScene->extentChanged(oldExtent, newExtent);
+}
+
+
+
+/*
+ * Name:	paintBatched()
+ * Purpose:	Draw all of the edges and then all of the nodes of the
+ *		graph, setting up the painter once per distinct style
+ *		rather than once per item.
+ * Arguments:	The painter and the style option given to paint(),
+ *		and whether to draw the edges too.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions: The children of a graph are nodes and edges (and
+ *		nothing else is drawn).
+ * Bugs:	None known.
+ * Notes:	Edges go into one drawLines() call per pen, nodes into
+ *		a run of drawEllipse() calls per (pen, fill) pair.
+ *		Nodes are drawn in stacking order within each style,
+ *		so two overlapping nodes of different styles may be
+ *		stacked differently than when they draw themselves.
+ *		Items outside the exposed rectangle are skipped.
+ *		A graph typically has only a handful of styles, so a
+ *		linear search for the style is fine.
+ */
+
+void
+Graph::paintBatched(QPainter * painter,
+		    const QStyleOptionGraphicsItem * option, bool withEdges)
+{
+    QRectF exposed = option->exposedRect;
+    QVector<QPen> edgePens;
+    QVector<QVector<QLineF>> edgeLines;
+    QVector<QPen> nodePens;
+    QVector<QColor> nodeFills;
+    QVector<QVector<QRectF>> nodeRects;
+
+    foreach (QGraphicsItem * item, childItems())
+    {
+	if (!item->isVisible())
+	    continue;
+
+	if (item->type() == Edge::Type)
+	{
+	    Edge * edge = qgraphicsitem_cast<Edge *>(item);
+	    if (!withEdges || !edge->sourceNode() || !edge->destNode())
+		continue;
+
+	    QLineF line = edge->getLine();
+	    if (qFuzzyCompare(line.length(), qreal(0.)))
+		continue;
+	    if (!exposed.intersects(edge->mapRectToParent(
+					edge->boundingRect())))
+		continue;
+
+	    QPen pen = edge->getPen();
+	    int style = edgePens.indexOf(pen);
+	    if (style < 0)
+	    {
+		style = edgePens.count();
+		edgePens.append(pen);
+		edgeLines.append(QVector<QLineF>());
+	    }
+	    edgeLines[style].append(QLineF(edge->mapToParent(line.p1()),
+					   edge->mapToParent(line.p2())));
+	}
+	else if (item->type() == Node::Type)
+	{
+	    Node * node = qgraphicsitem_cast<Node *>(item);
+	    // getDiameter() is in inches; the ellipse is in scene units.
+	    qreal diameter = node->getDiameter() * SCENE_DPI;
+	    QPointF center = node->mapToParent(0, 0);
+	    QRectF rect(center.x() - diameter / 2, center.y() - diameter / 2,
+			diameter, diameter);
+	    qreal margin = node->getPenWidth() / 2;
+	    if (!exposed.intersects(rect.adjusted(-margin, -margin,
+						  margin, margin)))
+		continue;
+
+	    QPen pen = node->getPen();
+	    QColor fill = node->getFillColour();
+	    int style;
+	    for (style = 0; style < nodePens.count(); style++)
+		if (nodePens.at(style) == pen && nodeFills.at(style) == fill)
+		    break;
+	    if (style == nodePens.count())
+	    {
+		nodePens.append(pen);
+		nodeFills.append(fill);
+		nodeRects.append(QVector<QRectF>());
+	    }
+	    nodeRects[style].append(rect);
+	}
+    }
+
+    painter->setBrush(Qt::NoBrush);
+    for (int style = 0; style < edgePens.count(); style++)
+    {
+	painter->setPen(edgePens.at(style));
+	painter->drawLines(edgeLines.at(style));
+    }
+
+    for (int style = 0; style < nodePens.count(); style++)
+    {
+	painter->setPen(nodePens.at(style));
+	painter->setBrush(nodeFills.at(style));
+	foreach (QRectF rect, nodeRects.at(style))
+	    painter->drawEllipse(rect);
+    }
 }
 
 
@@ -2,7 +2,7 @@
  * File:	graph.h
  * Author:	Rachel Bood
  * Date:	2014 or 2015?
- * Version:	1.8
+ * Version:	1.12
  *
  * Purpose:	Define the graph class.
  *
@@ -31,12 +31,28 @@
  *  (a) Added the third arg to boundingBox().
  * Nov 16, 2020 (JD V1.8)
  *  (a) Added centerGraph() function.
+ * Oct 19, 2026 (JD V1.9)
+ *  (a) Add setBatchPainting(), isBatchPainting() and paintBatched().
+ * Oct 19, 2026 (JD V1.10)
+ *  (a) Add edge bundling: setBundling(), isBundling(), drawsEdges(),
+ *	invalidateBundles(), itemChange() and the bundle cache.
+ * Oct 19, 2026 (JD V1.11)
+ *  (a) Add the extent members and functions, and a destructor.
+ * Oct 19, 2026 (JD V1.12)
+ *  (a) Add bundleBounds.
  */
 
 #ifndef GRAPH_H
 #define GRAPH_H
 
+#include "jobscheduler.h"
+
 #include <QGraphicsItemGroup>
+#include <QPointer>
+#include <QPolygonF>
+#include <QVector>
+
+class QTimer;
 
 class CanvasView;
 class Node;
@@ -59,6 +75,7 @@ class Graph : public QGraphicsObject
     } Nodes;
 
     Graph();
+    ~Graph();
     void isMoved();
     enum {Type = UserType + 3};
     int type() const {return Type;}
@@ -70,8 +87,20 @@ class Graph : public QGraphicsObject
     QGraphicsItem * getRootParent();
     QRectF boundingBox(QPointF * center, bool useNodeSizes, QPointF * RGcenter);
     void centerGraph();
+    void setBatchPainting(bool batch);
+    bool isBatchPainting() const { return batchPainting; }
+    void setBundling(bool bundle);
+    bool isBundling() const { return bundling; }
+    bool drawsEdges() const
+	{ return batchPainting || !bundles.isEmpty(); }
+    void invalidateBundles();
+    QRectF sceneExtent();
+    void childMoved(QRectF oldExtent, QRectF newExtent);
+    void invalidateExtent();
+    static void invalidateExtentOf(QGraphicsItem * item);
 
   protected:
+    QVariant itemChange(GraphicsItemChange change, const QVariant & value);
     void mouseReleaseEvent(QGraphicsSceneMouseEvent * event);
     void paint(QPainter * painter,
 	       const QStyleOptionGraphicsItem * option,
@@ -79,6 +108,26 @@ class Graph : public QGraphicsObject
 
   private:
     int moved;		// 1 means the graph was dropped onto the canvas.
+    bool batchPainting;	// Draw the children's shapes here, per style.
+    void paintBatched(QPainter * painter,
+		      const QStyleOptionGraphicsItem * option, bool withEdges);
+
+    bool bundling;	// Draw the edges as bundled polylines.
+    QVector<QPolygonF> bundles;		// Empty until computed.
+    QVector<QPointer<Edge>> bundledEdges;	// The edge of each bundle.
+    QRectF bundleBounds;	// Bounds of the bundles, with their pens.
+    QTimer * bundleTimer;	// Waits for the nodes to stop moving.
+    JobTokenPtr bundleJob;
+    int bundleGeneration;	// Bumped whenever the bundles go stale.
+    void startBundling();
+    void paintBundles(QPainter * painter,
+		      const QStyleOptionGraphicsItem * option);
+
+    QRectF extent;	// Scene bounds of everything in the graph...
+    bool extentValid;	// ... if this is set.
+    Graph * rootGraph();
+    QRectF childExtent(QGraphicsItem * child);
+    void extentChanged(QRectF oldExtent, QRectF newExtent);
 };
 
 #endif // GRAPH_H
@@ -0,0 +1,535 @@
+/*
+ * File:	graphops.cpp
+ * Author:	Jim Diamond
+ * Date:	2026-10-19
+ * Version:	1.3
+ *
+ * Purpose:	Implement the GraphOps class (see graphops.h).
+ *
+ * Modification history:
+ * Oct 19, 2026 (JD V1.0)
+ *  (a) Initial version.
+ * Oct 19, 2026 (JD V1.1)
+ *  (a) copyNode() and copyEdge() copy the style class.
+ * Oct 19, 2026 (JD V1.2)
+ *  (a) deleteNode() makes the canvas scene forget the node's moves,
+ *	so that Escape doesn't move a deleted node.
+ *  (b) identifyNodes() (and so contractEdge()) and splitNode()
+ *	refuse meta-nodes: add notMetaNode().
+ * Oct 19, 2026 (JD V1.3)
+ *  (a) subdivideEdge() and inducedSubgraph() refuse meta-nodes too.
+ */
+
+#include "graphops.h"
+#include "canvasscene.h"
+#include "defuns.h"
+#include "edge.h"
+#include "graph.h"
+#include "metanode.h"
+#include "node.h"
+
+#include <QGraphicsScene>
+#include <QSet>
+#include <QVector>
+#include <qmath.h>
+
+#include <algorithm>
+
+// A copied induced subgraph is put this many node widths to the right
+// of the original.
+#define INDUCED_SUBGRAPH_GAP	2
+
+
+
+/*
+ * Name:	contractEdge()
+ * Purpose:	Contract an edge: its two nodes become one node, half way
+ *		between them.
+ * Arguments:	The edge, and a place to put an error message.
+ * Outputs:	Nothing.
+ * Modifies:	The edge's graph.
+ * Returns:	The remaining node, or nullptr (with *errorMessage set).
+ * Assumptions:	The edge is on the canvas.
+ * Bugs:	None known.
+ * Notes:	The source node is kept (with its label and style); the
+ *		destination node is deleted.  Cost: O(deg(source) +
+ *		deg(dest)).
+ */
+
+Node *
+GraphOps::contractEdge(Edge * edge, QString * errorMessage)
+{
+    Node * keep = edge->sourceNode();
+    Node * gone = edge->destNode();
+    QPointF middle = (keep->pos() + gone->pos()) / 2;
+
+    if (identifyNodes(keep, gone, errorMessage) == nullptr)
+	return nullptr;
+
+    // Moving the node adjusts its edges.
+    keep->setPos(middle);
+    return keep;
+}
+
+
+
+/*
+ * Name:	subdivideEdge()
+ * Purpose:	Replace an edge by a path of k + 1 edges through k new
+ *		nodes.
+ * Arguments:	The edge, k, and a place to put an error message.
+ * Outputs:	Nothing.
+ * Modifies:	The edge's graph.
+ * Returns:	The new nodes, in order from the source end, or an
+ *		empty list (with *errorMessage set).
+ * Assumptions:	The edge is on the canvas.
+ * Bugs:	None known.
+ * Notes:	The new nodes are evenly spaced along the edge and look
+ *		like its source node, but are unlabelled.  The new edges
+ *		look like the old one; the old edge's label goes on the
+ *		first new edge.  Cost: O(k + deg(source) + deg(dest)).
+ */
+
+QList<Node *>
+GraphOps::subdivideEdge(Edge * edge, int k, QString * errorMessage)
+{
+    QList<Node *> newNodes;
+    Node * source = edge->sourceNode();
+    Node * dest = edge->destNode();
+
+    if (k < 1)
+    {
+	*errorMessage = "An edge must be subdivided at least once.";
+	return newNodes;
+    }
+    if (!sameGraph(source, dest, errorMessage)
+	|| !notMetaNode(source, errorMessage)
+	|| !notMetaNode(dest, errorMessage))
+	return newNodes;
+    Graph * graph = qgraphicsitem_cast<Graph *>(source->parentItem());
+
+    Node * previous = source;
+    for (int i = 1; i <= k; i++)
+    {
+	QPointF pos = source->pos()
+	    + (dest->pos() - source->pos()) * i / (k + 1);
+	Node * node = copyNode(source, graph, pos);
+	node->setNodeLabel(QString());
+	Edge * segment = copyEdge(edge, previous, node, graph);
+	segment->setEdgeLabel(i == 1 ? edge->getLabel() : QString());
+	newNodes.append(node);
+	previous = node;
+    }
+    Edge * last = copyEdge(edge, previous, dest, graph);
+    last->setEdgeLabel(QString());
+
+    deleteEdge(edge);
+    return newNodes;
+}
+
+
+
+/*
+ * Name:	identifyNodes()
+ * Purpose:	Make two nodes of a graph into one.
+ * Arguments:	The node to keep, the node to get rid of, and a place to
+ *		put an error message.
+ * Outputs:	Nothing.
+ * Modifies:	The nodes' graph.
+ * Returns:	The kept node, or nullptr (with *errorMessage set).
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Each edge of "gone" is moved over to "keep", unless it
+ *		joins the two nodes, or "keep" already has an edge to
+ *		the same neighbour, in which case it is deleted.  The
+ *		hash of keep's neighbours makes each check O(1), so the
+ *		cost is O(deg(keep) + deg(gone)).
+ */
+
+Node *
+GraphOps::identifyNodes(Node * keep, Node * gone, QString * errorMessage)
+{
+    if (keep == gone)
+    {
+	*errorMessage = "A node can't be identified with itself.";
+	return nullptr;
+    }
+    if (!sameGraph(keep, gone, errorMessage)
+	|| !notMetaNode(keep, errorMessage) || !notMetaNode(gone, errorMessage))
+	return nullptr;
+
+    QHash<Node *, Edge *> adjacent = neighbours(keep);
+    QList<Edge *> moved;
+    foreach (Edge * edge, gone->edgeList)
+    {
+	Node * other = otherEnd(edge, gone);
+	if (other == keep || adjacent.contains(other))
+	{
+	    deleteEdge(edge);
+	    continue;
+	}
+
+	gone->removeEdge(edge);
+	if (edge->sourceNode() == gone)
+	    edge->setSourceNode(keep);
+	else
+	    edge->setDestNode(keep);
+	keep->addEdge(edge);
+	adjacent.insert(other, edge);
+	moved.append(edge);
+    }
+
+    deleteNode(gone);
+    foreach (Edge * edge, moved)
+	edge->adjust();
+
+    return keep;
+}
+
+
+
+/*
+ * Name:	splitNode()
+ * Purpose:	Split a node in two, joined by a new edge, sharing out
+ *		its edges between them.
+ * Arguments:	The node, and a place to put an error message.
+ * Outputs:	Nothing.
+ * Modifies:	The node's graph.
+ * Returns:	The new node, or nullptr (with *errorMessage set).
+ * Assumptions:	The node is on the canvas.
+ * Bugs:	None known.
+ * Notes:	This is the opposite of contracting an edge.  The edges
+ *		are sorted by the direction of their other ends, and
+ *		the new node gets a contiguous half of them, so that
+ *		edges don't cross each other.  It is put two node
+ *		widths away, towards the neighbours it takes.
+ *		Cost: O(deg log deg).
+ */
+
+Node *
+GraphOps::splitNode(Node * node, QString * errorMessage)
+{
+    int degree = node->edgeList.count();
+    Graph * graph = qgraphicsitem_cast<Graph *>(node->parentItem());
+
+    if (degree < 2)
+    {
+	*errorMessage = "A node needs at least two edges to be split.";
+	return nullptr;
+    }
+    if (graph == nullptr)
+    {
+	*errorMessage = "Only nodes on the canvas can be split.";
+	return nullptr;
+    }
+    if (!notMetaNode(node, errorMessage))
+	return nullptr;
+
+    QVector<Edge *> edges = node->edgeList.toVector();
+    QHash<Edge *, qreal> angleOf;
+    foreach (Edge * edge, edges)
+    {
+	QPointF d = otherEnd(edge, node)->pos() - node->pos();
+	angleOf.insert(edge, qAtan2(d.y(), d.x()));
+    }
+    std::sort(edges.begin(), edges.end(), [&](Edge * a, Edge * b) {
+	return angleOf.value(a) < angleOf.value(b);
+    });
+
+    // Work out where the new node goes.
+    QPointF direction(0, 0);
+    for (int i = degree / 2; i < degree; i++)
+    {
+	qreal theta = angleOf.value(edges.at(i));
+	direction += QPointF(qCos(theta), qSin(theta));
+    }
+    qreal length = qSqrt(direction.x() * direction.x()
+			 + direction.y() * direction.y());
+    if (length < 1e-6)
+	direction = QPointF(1, 0);
+    else
+	direction /= length;
+    qreal distance = node->boundingRect().width() * 2;
+
+    Node * newNode = copyNode(node, graph, node->pos() + direction * distance);
+    newNode->setNodeLabel(QString());
+
+    for (int i = degree / 2; i < degree; i++)
+    {
+	Edge * edge = edges.at(i);
+	node->removeEdge(edge);
+	if (edge->sourceNode() == node)
+	    edge->setSourceNode(newNode);
+	else
+	    edge->setDestNode(newNode);
+	newNode->addEdge(edge);
+	edge->adjust();
+    }
+
+    Edge * join = copyEdge(edges.at(0), node, newNode, graph);
+    join->setEdgeLabel(QString());
+
+    return newNode;
+}
+
+
+
+/*
+ * Name:	inducedSubgraph()
+ * Purpose:	Copy the given nodes, and every edge between two of
+ *		them, into a new graph beside the original(s).
+ * Arguments:	The nodes, and a place to put an error message.
+ * Outputs:	Nothing.
+ * Modifies:	The scene and canvasGraphList.
+ * Returns:	The new graph, or nullptr (with *errorMessage set).
+ * Assumptions:	The nodes are on the canvas.
+ * Bugs:	None known.
+ * Notes:	The nodes may come from several graphs.  The copy is
+ *		built off the canvas and added to the scene in one go.
+ *		Cost: O(sum of the nodes' degrees).
+ *		A meta-node would be copied as a plain node standing
+ *		for nothing, so the nodes must not include any.
+ */
+
+Graph *
+GraphOps::inducedSubgraph(QList<Node *> nodes, QString * errorMessage)
+{
+    if (nodes.isEmpty() || nodes.at(0)->scene() == nullptr)
+    {
+	*errorMessage = "Select the nodes of the subgraph first.";
+	return nullptr;
+    }
+    QGraphicsScene * scene = nodes.at(0)->scene();
+    foreach (Node * node, nodes)
+	if (!notMetaNode(node, errorMessage))
+	    return nullptr;
+
+    QRectF bounds;
+    foreach (Node * node, nodes)
+	bounds |= node->sceneBoundingRect();
+    QPointF offset(bounds.width()
+		   + INDUCED_SUBGRAPH_GAP
+		   * nodes.at(0)->boundingRect().width(), 0);
+
+    Graph * graph = new Graph();
+    QHash<Node *, Node *> copies;
+    foreach (Node * node, nodes)
+	copies.insert(node, copyNode(node, graph, node->scenePos() + offset));
+
+    QSet<Edge *> done;
+    foreach (Node * node, nodes)
+    {
+	foreach (Edge * edge, node->edgeList)
+	{
+	    Node * other = otherEnd(edge, node);
+	    if (done.contains(edge) || !copies.contains(other))
+		continue;
+	    done.insert(edge);
+	    Edge * copy = copyEdge(edge, copies.value(edge->sourceNode()),
+				   copies.value(edge->destNode()), graph);
+	    copy->setEdgeLabel(edge->getLabel());
+	}
+    }
+
+    scene->addItem(graph);
+    canvasGraphList.append(graph);
+
+    qDeb() << "GraphOps::inducedSubgraph(): " << copies.count()
+	   << " nodes and " << done.count() << " edges copied";
+    return graph;
+}
+
+
+
+/*
+ * Name:	neighbours()
+ * Purpose:	Make a hash of a node's neighbours.
+ * Arguments:	The node.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	A hash from each neighbour to the edge joining them.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	O(deg).
+ */
+
+QHash<Node *, Edge *>
+GraphOps::neighbours(Node * node)
+{
+    QHash<Node *, Edge *> adjacent;
+
+    adjacent.reserve(node->edgeList.count());
+    foreach (Edge * edge, node->edgeList)
+	adjacent.insert(otherEnd(edge, node), edge);
+    return adjacent;
+}
+
+
+
+Node *
+GraphOps::otherEnd(Edge * edge, Node * node)
+{
+    return edge->sourceNode() == node ? edge->destNode() : edge->sourceNode();
+}
+
+
+
+/*
+ * Name:	copyNode()
+ * Purpose:	Make a new node which looks like an existing one.
+ * Arguments:	The node to copy, the graph for the new node, and its
+ *		position in the graph.
+ * Outputs:	Nothing.
+ * Modifies:	The graph.
+ * Returns:	The new node.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	The label and style class are copied too.
+ */
+
+Node *
+GraphOps::copyNode(Node * style, Graph * graph, QPointF pos)
+{
+    Node * node = new Node();
+
+    node->setDiameter(style->getDiameter());
+    node->setPenWidth(style->getPenWidth());
+    node->setFillColour(style->getFillColour());
+    node->setLineColour(style->getLineColour());
+    node->setNodeLabelSize(style->getLabelSize());
+    node->setNodeLabel(style->getLabel());
+    node->setRotation(style->getRotation());
+    node->setStyleClass(style->getStyleClass());
+    node->setParentItem(graph);
+    node->setPos(pos);
+    return node;
+}
+
+
+
+/*
+ * Name:	copyEdge()
+ * Purpose:	Make a new edge which looks like an existing one.
+ * Arguments:	The edge to copy, the new edge's nodes, and its graph.
+ * Outputs:	Nothing.
+ * Modifies:	The graph and the nodes' edgeLists.
+ * Returns:	The new edge.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	The style class is copied, the label is not.
+ */
+
+Edge *
+GraphOps::copyEdge(Edge * style, Node * source, Node * dest, Graph * graph)
+{
+    Edge * edge = new Edge(source, dest);
+
+    edge->setPenWidth(style->getPenWidth());
+    edge->setColour(style->getColour());
+    edge->setEdgeLabelSize(style->getLabelSize());
+    edge->setSourceRadius(source->getDiameter() / 2.);
+    edge->setDestRadius(dest->getDiameter() / 2.);
+    edge->setRotation(style->getRotation());
+    edge->setStyleClass(style->getStyleClass());
+    edge->setParentItem(graph);
+    edge->adjust();
+    return edge;
+}
+
+
+
+/*
+ * Name:	deleteEdge(), deleteNode()
+ * Purpose:	Take an edge or node off the canvas and delete it.
+ * Arguments:	The edge or node.
+ * Outputs:	Nothing.
+ * Modifies:	The scene and (for an edge) its nodes' edgeLists.
+ * Returns:	Nothing.
+ * Assumptions:	A node has no edges left.
+ * Bugs:	None known.
+ * Notes:	As in CanvasScene::mousePressEvent()'s delete code,
+ *		which also has the scene forget the node's moves.
+ */
+
+void
+GraphOps::deleteEdge(Edge * edge)
+{
+    edge->sourceNode()->removeEdge(edge);
+    edge->destNode()->removeEdge(edge);
+    edge->setParentItem(nullptr);
+    if (edge->scene() != nullptr)
+	edge->scene()->removeItem(edge);
+    delete edge;
+}
+
+
+
+void
+GraphOps::deleteNode(Node * node)
+{
+    CanvasScene::forgetNodes(node->scene(), QList<Node *>() << node);
+    node->setParentItem(nullptr);
+    if (node->scene() != nullptr)
+	node->scene()->removeItem(node);
+    delete node;
+}
+
+
+
+/*
+ * Name:	sameGraph()
+ * Purpose:	Check that two nodes are in the same canvas graph.
+ * Arguments:	The nodes, and a place to put an error message.
+ * Outputs:	Nothing.
+ * Modifies:	*errorMessage, if they aren't.
+ * Returns:	True iff they are.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+bool
+GraphOps::sameGraph(Node * a, Node * b, QString * errorMessage)
+{
+    if (a->parentItem() == nullptr || a->parentItem()->type() != Graph::Type
+	|| a->scene() == nullptr)
+    {
+	*errorMessage = "Only nodes on the canvas can be changed.";
+	return false;
+    }
+    if (a->parentItem() != b->parentItem())
+    {
+	*errorMessage = "Both nodes must be in the same graph "
+	    "(use \"join\" to combine graphs).";
+	return false;
+    }
+    return true;
+}
+
+
+
+/*
+ * Name:	notMetaNode()
+ * Purpose:	Check that a node isn't a meta-node.
+ * Arguments:	The node, and a place to put an error message.
+ * Outputs:	Nothing.
+ * Modifies:	*errorMessage, if it is.
+ * Returns:	True iff it isn't.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Deleting a meta-node deletes the nodes it stands for,
+ *		and its edges are only stand-ins, so none of the
+ *		operations take them.
+ */
+
+bool
+GraphOps::notMetaNode(Node * node, QString * errorMessage)
+{
+    if (MetaNode::isMetaNode(node))
+    {
+	*errorMessage = "Collapsed nodes can't be changed; "
+	    "expand them first.";
+	return false;
+    }
+    return true;
+}
@@ -0,0 +1,76 @@
+/*
+ * File:	graphops.h
+ * Author:	Jim Diamond
+ * Date:	2026-10-19
+ * Version:	1.2
+ *
+ * Purpose:	Define the GraphOps class, which does local structural
+ *		edits on a canvas graph: contracting and subdividing
+ *		edges, identifying two nodes, splitting a node, and
+ *		copying out the subgraph induced by some nodes.
+ *
+ * Notes:	Each operation only looks at the edges of the nodes
+ *		involved, using a hash of a node's neighbours to find
+ *		parallel edges, so the cost depends on the degrees of
+ *		those nodes and not on the size of the graph.  Unlike
+ *		joining, nothing is re-parented.
+ *		Contracting, identifying and splitting only work on
+ *		nodes in the same graph; use "join" to combine graphs.
+ *		All of the operations refuse meta-nodes (see
+ *		metanode.h), which must be expanded first, since the
+ *		nodes a meta-node stands for would otherwise be lost
+ *		or left with dangling edges.
+ *		Parallel edges which would be created by contracting or
+ *		identifying are deleted, so the graph stays simple.
+ *		New nodes and edges take their style from the existing
+ *		ones they are made from.
+ *
+ * Modification history:
+ * Oct 19, 2026 (JD V1.0)
+ *  (a) Initial version.
+ * Oct 19, 2026 (JD V1.1)
+ *  (a) Add notMetaNode().
+ * Oct 19, 2026 (JD V1.2)
+ *  (a) Note that every operation refuses meta-nodes.
+ */
+
+#ifndef GRAPHOPS_H
+#define GRAPHOPS_H
+
+#include <QHash>
+#include <QList>
+#include <QPointF>
+#include <QString>
+
+class Edge;
+class Graph;
+class Node;
+
+class GraphOps
+{
+  public:
+    enum Operation { ContractEdge, SubdivideEdge, IdentifyNodes,
+		     SplitNode, InducedSubgraph };
+
+    static Node * contractEdge(Edge * edge, QString * errorMessage);
+    static QList<Node *> subdivideEdge(Edge * edge, int k,
+				       QString * errorMessage);
+    static Node * identifyNodes(Node * keep, Node * gone,
+				QString * errorMessage);
+    static Node * splitNode(Node * node, QString * errorMessage);
+    static Graph * inducedSubgraph(QList<Node *> nodes,
+				   QString * errorMessage);
+
+  private:
+    static QHash<Node *, Edge *> neighbours(Node * node);
+    static Node * otherEnd(Edge * edge, Node * node);
+    static Node * copyNode(Node * style, Graph * graph, QPointF pos);
+    static Edge * copyEdge(Edge * style, Node * source, Node * dest,
+			   Graph * graph);
+    static void deleteEdge(Edge * edge);
+    static void deleteNode(Node * node);
+    static bool sameGraph(Node * a, Node * b, QString * errorMessage);
+    static bool notMetaNode(Node * node, QString * errorMessage);
+};
+
+#endif // GRAPHOPS_H
@@ -2,7 +2,7 @@
  * File:	html-label.cpp	    Formerly label.cpp
  * Author:	Rachel Bood
  * Date:	2014-??-??
- * Version:	1.10
+ * Version:	1.13
  * 
  * Purpose:	Implement the functions relating to node and edge labels.
  *		(Some places in the code use "weight" for "edge label".)
@@ -69,10 +69,20 @@
  *	such as "a^\{", "a\_", and many more such pathological expressions.
  *  (b) Remove setHtmlLabel(), which was made redundant by the changes
  *	to edge.cpp on Aug 21, 2020.
+ * Oct 19, 2026 (JD V1.11)
+ *  (a) Note in strToHtml() that it must stay thread-safe.
+ * Oct 19, 2026 (JD V1.12)
+ *  (a) Allocate labels from an ItemPool (see itempool.h).
+ * Oct 19, 2026 (JD V1.13)
+ *  (a) Don't draw labels on the canvas while it is at draft quality,
+ *	if the user so wishes.
  */
 
+#include "appsettings.h"
+#include "canvasview.h"
 #include "defuns.h"
 #include "html-label.h"
+#include "itempool.h"
 
 #include <QTextCursor>
 #include <QEvent>
@@ -114,6 +124,34 @@ HTML_Label::HTML_Label(QGraphicsItem * parent)
 
 
 
+/*
+ * Name:	operator new / operator delete
+ * Purpose:	Allocate and free HTML_Label objects from a pool.
+ * Arguments:	The size (and, for delete, the pointer).
+ * Outputs:	Nothing.
+ * Modifies:	The HTML_Label pool.
+ * Returns:	new: the storage.
+ * Assumptions: Only called on the GUI thread.
+ * Bugs:	None known.
+ * Notes:	See itempool.h.  Every node and edge has one of these.
+ */
+
+void *
+HTML_Label::operator new(size_t size)
+{
+    return ItemPool<HTML_Label>::allocate(size);
+}
+
+
+
+void
+HTML_Label::operator delete(void * p, size_t size)
+{
+    ItemPool<HTML_Label>::release(p, size);
+}
+
+
+
 /*
  * Name:        eventFilter()
  * Purpose:     Intercepts events related to canvas labels so we can
@@ -197,6 +235,10 @@ HTML_Label::eventFilter(QObject * obj, QEvent * event)
  *		gets or loses focus, and about once per second when
  *		the label on the canvas is being edited.
  *		And maybe some other times.
+ *		Labels are not drawn while the canvas is at draft
+ *		quality (see CanvasView::startDraftQuality()), if the
+ *		user so wishes.  The widget is the view's viewport,
+ *		or nullptr when rendering to an image or file.
  */
 
 void
@@ -204,6 +246,14 @@ HTML_Label::paint(QPainter * painter,
 		  const QStyleOptionGraphicsItem * option,
 		  QWidget * widget)
 {
+    if (widget != nullptr)
+    {
+	CanvasView * view = qobject_cast<CanvasView *>(widget->parentWidget());
+	if (view != nullptr && view->isDraftQuality()
+	    && AppSettings::instance()->draftHideLabels())
+	    return;
+    }
+
     QGraphicsTextItem::paint(painter, option, widget);
 }
 
@@ -506,6 +556,9 @@ strToHtml2(QByteArray chars)
  *		This function boldly uses the dreaded and feared goto!
  *		The "prev" variable below holds the syntactic value of
  *		the previous char, not necessarily the actual char.
+ *		This (and everything it calls) only works on its
+ *		arguments, so it may be called from worker threads
+ *		(see labelbatch.cpp).  Keep it that way.
  */
 
 QString
@@ -2,7 +2,7 @@
  * File:	html-label.h	    formerly label.h
  * Author:	Rachel Bood
  * Date:	2014-??-??
- * Version:	1.3
+ * Version:	1.4
  * 
  * Purpose:	Declare the functions relating to the HTML version of
  *		node and edge labels (i.e., the version of the strings
@@ -25,6 +25,8 @@
  *      the node being edited/looked at in the edit tab list.
  * Aug 20, 2020 (IC V1.3)
  *  (a) Remove htmlLabelText and add texLabelText.
+ * Oct 19, 2026 (JD V1.4)
+ *  (a) Add class-specific operator new and delete (see itempool.h).
  */
 
 #ifndef HTML_LABEL_H
@@ -39,6 +41,9 @@ class HTML_Label : public QGraphicsTextItem
 
 public:
     HTML_Label(QGraphicsItem * parent = 0);
+
+    static void * operator new(size_t size);
+    static void operator delete(void * p, size_t size);
     void setTextInteraction(bool on, bool selectAll = false);
 
     enum { Type = UserType + 4 };
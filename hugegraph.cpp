@@ -0,0 +1,887 @@
+/*
+ * File:	hugegraph.cpp
+ * Author:	Jim Diamond
+ * Date:	2026-10-19
+ * Version:	1.0
+ *
+ * Purpose:	Implement the HugeGraph class: loading and laying out
+ *		big edge lists, the spatial indexes, tile drawing, and
+ *		copying part of a huge graph into ordinary graph items.
+ *
+ * Modification history:
+ * Oct 19, 2026 (JD V1.0)
+ *  (a) Initial version.
+ */
+
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QPainter>
+#include <QPolygonF>
+#include <QtMath>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "hugegraph.h"
+#include "canvasscene.h"
+#include "defuns.h"
+#include "edge.h"
+#include "graph.h"
+#include "jobscheduler.h"
+#include "labelbatch.h"
+#include "node.h"
+
+// The input is cut into pieces of about this many bytes, which are
+// parsed in parallel.
+#define PARSE_CHUNK_SIZE	(1 << 20)
+
+// The grain sizes for the per-node and per-item parallel loops.
+#define NODE_GRAIN_SIZE		4096
+
+// The number of times each node is pulled towards its neighbours.
+#define SMOOTHING_PASSES	8
+
+// The finest index level has at most 4^(INDEX_LEVELS - 1) cells.
+#define INDEX_LEVELS		11
+
+// Tiles with fewer things than this to draw are antialiased; denser
+// ones would only turn grey (and slow) if they were.
+#define ANTIALIAS_LIMIT		20000
+
+// Nodes smaller than this (in pixels) are drawn as dots.
+#define MIN_CIRCLE_SIZE		3.
+
+
+
+/*
+ * Name:	hilbertPoint()
+ * Purpose:	Find the d'th point along a Hilbert curve.
+ * Arguments:	The side of the (square, power of 2) grid, d, and
+ *		where to put the point.
+ * Outputs:	Nothing.
+ * Modifies:	*x and *y.
+ * Returns:	Nothing.
+ * Assumptions:	0 <= d < side * side.
+ * Bugs:	None known.
+ * Notes:	Consecutive points are always next to each other, and
+ *		points close together along the curve are generally
+ *		close together in the plane.
+ */
+
+static void
+hilbertPoint(int side, qint64 d, int * x, int * y)
+{
+    *x = *y = 0;
+    for (int s = 1; s < side; s *= 2)
+    {
+	int rx = 1 & (int)(d / 2);
+	int ry = 1 & (int)(d ^ rx);
+	if (ry == 0)
+	{
+	    if (rx == 1)
+	    {
+		*x = s - 1 - *x;
+		*y = s - 1 - *y;
+	    }
+	    std::swap(*x, *y);
+	}
+	*x += s * rx;
+	*y += s * ry;
+	d /= 4;
+    }
+}
+
+
+
+/*
+ * Name:	parseNumber()
+ * Purpose:	Read a non-negative integer less than a limit.
+ * Arguments:	The text (p up to, but not including, end), and the
+ *		limit.
+ * Outputs:	Nothing.
+ * Modifies:	*p, which is left after the digits.
+ * Returns:	The number, or -1 if there is none or it is too big.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	This is much faster than going through QString.
+ */
+
+static qint64
+parseNumber(const char ** p, const char * end, qint64 limit)
+{
+    const char * q = *p;
+    qint64 value = 0;
+
+    while (q < end && *q >= '0' && *q <= '9')
+    {
+	value = value * 10 + (*q - '0');
+	if (value >= limit)
+	    return -1;
+	q++;
+    }
+    if (q == *p)
+	return -1;
+    *p = q;
+    return value;
+}
+
+
+
+/*
+ * Name:	parseEdges()
+ * Purpose:	Parse the edge lines in one piece of an edge list.
+ * Arguments:	The text (begin up to, but not including, end), the
+ *		number of nodes, where to put the edges, and where to
+ *		put the position of the first bad line.
+ * Outputs:	Nothing.
+ * Modifies:	*edges and *errorAt.
+ * Returns:	Nothing.
+ * Assumptions:	The piece starts at the start of a line.
+ * Bugs:	None known.
+ * Notes:	Each edge is packed as (smaller end << 32) | larger end,
+ *		so that sorting them puts repeats next to each other.
+ *		A line is two node numbers separated by commas and/or
+ *		white space; blank lines and "#" comments are skipped.
+ *		*errorAt is left alone if every line is valid.
+ */
+
+static void
+parseEdges(const char * begin, const char * end, qint64 nodeCount,
+	   QVector<quint64> * edges, qint64 * errorAt)
+{
+    const char * p = begin;
+
+    while (p < end)
+    {
+	const char * eol = (const char *)memchr(p, '\n', end - p);
+	if (eol == nullptr)
+	    eol = end;
+	const char * start = p;
+	const char * line = p;
+	p = eol + 1;
+
+	while (line < eol && (*line == ' ' || *line == '\t' || *line == '\r'))
+	    line++;
+	if (line == eol || *line == '#')
+	    continue;
+
+	qint64 from = parseNumber(&line, eol, nodeCount);
+	const char * sep = line;
+	while (line < eol && (*line == ' ' || *line == '\t' || *line == ','))
+	    line++;
+	qint64 to = line > sep ? parseNumber(&line, eol, nodeCount) : -1;
+	while (line < eol && (*line == ' ' || *line == '\t' || *line == '\r'))
+	    line++;
+
+	if (from < 0 || to < 0 || from == to || line != eol)
+	{
+	    *errorAt = start - begin;
+	    return;
+	}
+	edges->append(((quint64)qMin(from, to) << 32) | (quint64)qMax(from, to));
+    }
+}
+
+
+
+/*
+ * Name:	loadEdgelist()
+ * Purpose:	Read an edge list file into a new HugeGraph, and lay
+ *		it out.
+ * Arguments:	The file name, the job's token (or nullptr) and where
+ *		to put an error message.
+ * Outputs:	Nothing.
+ * Modifies:	*errorMessage, on failure.
+ * Returns:	The new graph, or nullptr if the file can't be read, is
+ *		invalid, or the job is cancelled.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	The format is that of File_IO::readEdgelist().
+ *		This is meant to run as a job: it may take a while,
+ *		polls the token, and reports its progress.
+ */
+
+HugeGraph *
+HugeGraph::loadEdgelist(QString fileName, JobToken * token,
+			QString * errorMessage)
+{
+    QFile file(fileName);
+    if (! file.open(QIODevice::ReadOnly))
+    {
+	*errorMessage = "Can't open " + fileName + ": " + file.errorString();
+	return nullptr;
+    }
+    QByteArray data = file.readAll();
+    file.close();
+
+    HugeGraph * graph = new HugeGraph();
+    graph->fileName = QFileInfo(fileName).fileName();
+    if (! graph->parse(data, token, errorMessage))
+    {
+	delete graph;
+	return nullptr;
+    }
+    data.clear();
+    if (token)
+	token->setProgress(40);
+
+    graph->buildAdjacency();
+    if (token)
+	token->setProgress(50);
+
+    if (! graph->layOut(token))
+    {
+	*errorMessage = "Cancelled.";
+	delete graph;
+	return nullptr;
+    }
+    if (token)
+	token->setProgress(90);
+
+    graph->buildIndexes();
+    return graph;
+}
+
+
+
+/*
+ * Name:	parse()
+ * Purpose:	Fill in the nodes and edges from an edge list.
+ * Arguments:	The file contents, the job's token (or nullptr) and
+ *		where to put an error message.
+ * Outputs:	Nothing.
+ * Modifies:	This graph's arrays and *errorMessage.
+ * Returns:	True on success.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	The first line is read here; the rest is cut into
+ *		pieces at line boundaries and parsed on the job
+ *		scheduler's workers.  Repeated edges are dropped.
+ */
+
+bool
+HugeGraph::parse(QByteArray data, JobToken * token, QString * errorMessage)
+{
+    const char * text = data.constData();
+    qint64 size = data.size();
+    qint64 pos = 0;
+    qint64 nodeCount = -1;
+
+    // Find the number of nodes.
+    while (pos < size && nodeCount < 0)
+    {
+	qint64 eol = data.indexOf('\n', pos);
+	if (eol < 0)
+	    eol = size;
+	QByteArray line = data.mid(pos, eol - pos).simplified();
+	pos = eol + 1;
+	if (line.isEmpty() || line.at(0) == '#')
+	    continue;
+	bool ok;
+	nodeCount = line.toInt(&ok);
+	if (! ok || nodeCount < 1)
+	{
+	    *errorMessage = fileName + ": expected the number of nodes, not \""
+		+ QString::fromUtf8(line.left(40)) + "\".";
+	    return false;
+	}
+    }
+    if (nodeCount < 0)
+    {
+	*errorMessage = fileName + ": no data.";
+	return false;
+    }
+
+    // Cut the rest into pieces which start at the start of a line.
+    QVector<qint64> starts;
+    while (pos < size)
+    {
+	starts.append(pos);
+	qint64 next = pos + PARSE_CHUNK_SIZE;
+	if (next >= size)
+	    break;
+	next = data.indexOf('\n', next);
+	pos = next < 0 ? size : next + 1;
+    }
+    starts.append(size);
+
+    int pieces = starts.count() - 1;
+    QVector<QVector<quint64>> parts(pieces);
+    QVector<qint64> errorAt(pieces, -1);
+    JobScheduler::instance()->parallelFor(
+	pieces, 1,
+	[&](int begin, int end)
+	{
+	    for (int i = begin; i < end; i++)
+	    {
+		if (token && token->isCancelled())
+		    return;
+		parseEdges(text + starts.at(i), text + starts.at(i + 1),
+			   nodeCount, &parts[i], &errorAt[i]);
+	    }
+	});
+    if (token && token->isCancelled())
+    {
+	*errorMessage = "Cancelled.";
+	return false;
+    }
+
+    for (int i = 0; i < pieces; i++)
+    {
+	if (errorAt.at(i) < 0)
+	    continue;
+	qint64 at = starts.at(i) + errorAt.at(i);
+	int lineNum = data.left(at).count('\n') + 1;
+	qint64 lineStart = data.lastIndexOf('\n', at) + 1;
+	qint64 lineEnd = data.indexOf('\n', at);
+	if (lineEnd < 0)
+	    lineEnd = size;
+	*errorMessage = fileName + ", line " + QString::number(lineNum)
+	    + ": invalid edge \""
+	    + QString::fromUtf8(data.mid(lineStart, lineEnd - lineStart)
+				.simplified()) + "\".";
+	return false;
+    }
+    if (token)
+	token->setProgress(25);
+
+    QVector<quint64> edges;
+    int total = 0;
+    foreach (const QVector<quint64> & part, parts)
+	total += part.count();
+    edges.reserve(total);
+    for (int i = 0; i < pieces; i++)
+    {
+	edges += parts.at(i);
+	parts[i].clear();
+    }
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+    xs.resize(nodeCount);
+    ys.resize(nodeCount);
+    edgeFrom.resize(edges.count());
+    edgeTo.resize(edges.count());
+    for (int e = 0; e < edges.count(); e++)
+    {
+	edgeFrom[e] = (qint32)(edges.at(e) >> 32);
+	edgeTo[e] = (qint32)(edges.at(e) & 0xffffffff);
+    }
+    return true;
+}
+
+
+
+/*
+ * Name:	buildAdjacency()
+ * Purpose:	Make the neighbour lists from the edges.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	adjStart and adj.
+ * Returns:	Nothing.
+ * Assumptions:	The edges are loaded.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+void
+HugeGraph::buildAdjacency()
+{
+    int n = nodeCount();
+    int m = edgeCount();
+
+    adjStart.fill(0, n + 1);
+    for (int e = 0; e < m; e++)
+    {
+	adjStart[edgeFrom.at(e) + 1]++;
+	adjStart[edgeTo.at(e) + 1]++;
+    }
+    for (int i = 0; i < n; i++)
+	adjStart[i + 1] += adjStart.at(i);
+
+    QVector<qint32> next = adjStart;
+    adj.resize(2 * m);
+    for (int e = 0; e < m; e++)
+    {
+	adj[next[edgeFrom.at(e)]++] = edgeTo.at(e);
+	adj[next[edgeTo.at(e)]++] = edgeFrom.at(e);
+    }
+}
+
+
+
+/*
+ * Name:	layOut()
+ * Purpose:	Give every node a position.
+ * Arguments:	The job's token (or nullptr).
+ * Outputs:	Nothing.
+ * Modifies:	xs, ys and area.
+ * Returns:	False if the job was cancelled.
+ * Assumptions:	The neighbour lists are built.
+ * Bugs:	This is no substitute for a real layout algorithm, but
+ *		it is linear, and usually shows the structure.
+ * Notes:	The nodes are visited breadth-first (one component
+ *		after another) and put on a Hilbert curve in that
+ *		order, HUGE_NODE_SPACING apart, so neighbours start
+ *		near each other.  Then each node is moved half way to
+ *		the average of its neighbours, SMOOTHING_PASSES times.
+ */
+
+bool
+HugeGraph::layOut(JobToken * token)
+{
+    int n = nodeCount();
+
+    QVector<qint32> order;
+    order.reserve(n);
+    QVector<bool> seen(n, false);
+    for (int root = 0; root < n; root++)
+    {
+	if (seen.at(root))
+	    continue;
+	seen[root] = true;
+	int head = order.count();
+	order.append(root);
+	while (head < order.count())
+	{
+	    int u = order.at(head++);
+	    for (int k = adjStart.at(u); k < adjStart.at(u + 1); k++)
+	    {
+		int v = adj.at(k);
+		if (! seen.at(v))
+		{
+		    seen[v] = true;
+		    order.append(v);
+		}
+	    }
+	}
+    }
+    seen.clear();
+
+    int side = 1;
+    while ((qint64)side * side < n)
+	side *= 2;
+    qreal spacing = HUGE_NODE_SPACING * SCENE_DPI;
+    JobScheduler * scheduler = JobScheduler::instance();
+    scheduler->parallelFor(
+	n, NODE_GRAIN_SIZE,
+	[&](int begin, int end)
+	{
+	    for (int i = begin; i < end; i++)
+	    {
+		int x, y;
+		hilbertPoint(side, i, &x, &y);
+		xs[order.at(i)] = x * spacing;
+		ys[order.at(i)] = y * spacing;
+	    }
+	});
+    order.clear();
+
+    QVector<float> newXs(n), newYs(n);
+    for (int pass = 0; pass < SMOOTHING_PASSES; pass++)
+    {
+	if (token && token->isCancelled())
+	    return false;
+	scheduler->parallelFor(
+	    n, NODE_GRAIN_SIZE,
+	    [&](int begin, int end)
+	    {
+		for (int i = begin; i < end; i++)
+		{
+		    int first = adjStart.at(i);
+		    int count = adjStart.at(i + 1) - first;
+		    if (count == 0)
+		    {
+			newXs[i] = xs.at(i);
+			newYs[i] = ys.at(i);
+			continue;
+		    }
+		    qreal sumX = 0, sumY = 0;
+		    for (int k = first; k < first + count; k++)
+		    {
+			sumX += xs.at(adj.at(k));
+			sumY += ys.at(adj.at(k));
+		    }
+		    newXs[i] = (xs.at(i) + sumX / count) / 2;
+		    newYs[i] = (ys.at(i) + sumY / count) / 2;
+		}
+	    });
+	xs.swap(newXs);
+	ys.swap(newYs);
+	if (token)
+	    token->setProgress(50 + 40 * (pass + 1) / SMOOTHING_PASSES);
+    }
+
+    qreal left = xs.at(0), right = left, top = ys.at(0), bottom = top;
+    for (int i = 1; i < n; i++)
+    {
+	left = qMin(left, (qreal)xs.at(i));
+	right = qMax(right, (qreal)xs.at(i));
+	top = qMin(top, (qreal)ys.at(i));
+	bottom = qMax(bottom, (qreal)ys.at(i));
+    }
+    area = QRectF(left, top, right - left, bottom - top);
+    return true;
+}
+
+
+
+/*
+ * Name:	buildIndexes()
+ * Purpose:	Make the node and edge indexes.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	nodeIndex and edgeIndex.
+ * Returns:	Nothing.
+ * Assumptions:	The nodes have their final positions.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+void
+HugeGraph::buildIndexes()
+{
+    buildIndex(&nodeIndex, area, nodeCount(),
+	       [this](int i)
+	       { return QRectF(position(i), QSizeF(0, 0)); });
+    buildIndex(&edgeIndex, area, edgeCount(),
+	       [this](int e)
+	       {
+		   return QRectF(position(edgeFrom.at(e)),
+				 position(edgeTo.at(e))).normalized();
+	       });
+}
+
+
+
+/*
+ * Name:	buildIndex()
+ * Purpose:	Make a loose grid index of some items.
+ * Arguments:	The index to fill in, the area the items are in, the
+ *		number of items and a function giving item i's bounds.
+ * Outputs:	Nothing.
+ * Modifies:	*index.
+ * Returns:	Nothing.
+ * Assumptions:	Every item's centre is in area.
+ * Bugs:	None known.
+ * Notes:	Level L has 2^L by 2^L cells.  There are just enough
+ *		levels that the finest one has about one cell per
+ *		four items, up to INDEX_LEVELS.
+ */
+
+void
+HugeGraph::buildIndex(Index * index, QRectF area, int count,
+		      std::function<QRectF(int)> bounds)
+{
+    qreal rootSize = qMax(qMax(area.width(), area.height()), 1.);
+    int levels = 1;
+    while (levels < INDEX_LEVELS && ((qint64)1 << (2 * levels)) <= count)
+	levels++;
+
+    index->area = QRectF(area.topLeft(), QSizeF(rootSize, rootSize));
+    index->levels = levels;
+    index->start.resize(levels);
+    index->items.resize(levels);
+
+    QVector<qint8> itemLevel(count);
+    QVector<qint32> itemCell(count);
+    JobScheduler::instance()->parallelFor(
+	count, NODE_GRAIN_SIZE,
+	[&](int begin, int end)
+	{
+	    for (int i = begin; i < end; i++)
+	    {
+		QRectF b = bounds(i);
+		qreal size = qMax(b.width(), b.height());
+		int level = size > 0
+		    ? qFloor(std::log2(rootSize / size)) : levels - 1;
+		level = qBound(0, level, levels - 1);
+		int dim = 1 << level;
+		qreal cellSize = rootSize / dim;
+		QPointF c = b.center() - index->area.topLeft();
+		int x = qBound(0, (int)(c.x() / cellSize), dim - 1);
+		int y = qBound(0, (int)(c.y() / cellSize), dim - 1);
+		itemLevel[i] = level;
+		itemCell[i] = y * dim + x;
+	    }
+	});
+
+    for (int level = 0; level < levels; level++)
+    {
+	int cells = 1 << (2 * level);
+	index->start[level].fill(0, cells + 1);
+    }
+    for (int i = 0; i < count; i++)
+	index->start[itemLevel.at(i)][itemCell.at(i) + 1]++;
+    QVector<QVector<int>> next(levels);
+    for (int level = 0; level < levels; level++)
+    {
+	QVector<int> & start = index->start[level];
+	for (int c = 1; c < start.count(); c++)
+	    start[c] += start.at(c - 1);
+	index->items[level].resize(start.last());
+	next[level] = start;
+    }
+    for (int i = 0; i < count; i++)
+	index->items[itemLevel.at(i)][next[itemLevel.at(i)][itemCell.at(i)]++]
+	    = i;
+}
+
+
+
+/*
+ * Name:	query()
+ * Purpose:	Visit every item of an index which might overlap a
+ *		rectangle.
+ * Arguments:	The index, the rectangle, and what to do with each
+ *		item.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Each item is visited at most once, but some items near
+ *		the rectangle may be visited too; the caller must
+ *		check them if that matters.
+ */
+
+void
+HugeGraph::query(const Index & index, QRectF rect,
+		 std::function<void(int)> visit)
+{
+    for (int level = 0; level < index.levels; level++)
+    {
+	const QVector<int> & start = index.start.at(level);
+	const QVector<qint32> & items = index.items.at(level);
+	if (items.isEmpty())
+	    continue;
+
+	int dim = 1 << level;
+	qreal cellSize = index.area.width() / dim;
+	QRectF r = rect.translated(-index.area.topLeft())
+	    .adjusted(-cellSize / 2, -cellSize / 2, cellSize / 2, cellSize / 2);
+	int x0 = qMax(0, qFloor(r.left() / cellSize));
+	int x1 = qMin(dim - 1, qFloor(r.right() / cellSize));
+	int y0 = qMax(0, qFloor(r.top() / cellSize));
+	int y1 = qMin(dim - 1, qFloor(r.bottom() / cellSize));
+	for (int y = y0; y <= y1; y++)
+	{
+	    // The cells of a row are next to each other.
+	    int last = start.at(y * dim + x1 + 1);
+	    for (int k = start.at(y * dim + x0); k < last; k++)
+		visit(items.at(k));
+	}
+    }
+}
+
+
+
+/*
+ * Name:	nodeAt()
+ * Purpose:	Find the node nearest a point.
+ * Arguments:	The point and how far from it to look.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The node's number, or -1 if none is that close.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+int
+HugeGraph::nodeAt(QPointF pos, qreal radius) const
+{
+    int best = -1;
+    qreal bestDistance = radius * radius;
+
+    query(nodeIndex, QRectF(pos.x() - radius, pos.y() - radius,
+			    2 * radius, 2 * radius),
+	  [&](int i)
+	  {
+	      QPointF d = position(i) - pos;
+	      qreal distance = d.x() * d.x() + d.y() * d.y();
+	      if (distance <= bestDistance)
+	      {
+		  best = i;
+		  bestDistance = distance;
+	      }
+	  });
+    return best;
+}
+
+
+
+/*
+ * Name:	nodesIn()
+ * Purpose:	Find the nodes in a rectangle.
+ * Arguments:	The rectangle.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The nodes' numbers, in increasing order.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+QVector<int>
+HugeGraph::nodesIn(QRectF rect) const
+{
+    QVector<int> nodes;
+
+    query(nodeIndex, rect,
+	  [&](int i)
+	  {
+	      if (rect.contains(position(i)))
+		  nodes.append(i);
+	  });
+    std::sort(nodes.begin(), nodes.end());
+    return nodes;
+}
+
+
+
+/*
+ * Name:	renderTile()
+ * Purpose:	Draw part of the graph.
+ * Arguments:	The part of the scene to draw, and the image size.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The image.
+ * Assumptions:	sceneRect has the same shape as the image.
+ * Bugs:	None known.
+ * Notes:	This is safe to call from any thread (it uses no
+ *		fonts), and does work proportional to what is in the
+ *		tile, plus the few long edges which pass near it.
+ *		Lines and dots are drawn with cosmetic pens, so they
+ *		stay visible at any zoom.  When there are many edges
+ *		they are drawn translucent, so that dense areas come
+ *		out darker instead of uniformly black.
+ */
+
+QImage
+HugeGraph::renderTile(QRectF sceneRect, QSize size) const
+{
+    QImage image(size, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::white);
+
+    qreal scale = size.width() / sceneRect.width();
+    qreal radius = HUGE_NODE_DIAMETER * SCENE_DPI / 2;
+    qreal pixels = 2 * radius * scale;
+
+    QVector<QLineF> lines;
+    query(edgeIndex, sceneRect,
+	  [&](int e)
+	  {
+	      lines.append(QLineF(position(edgeFrom.at(e)),
+				  position(edgeTo.at(e))));
+	  });
+    QVector<QPointF> points;
+    query(nodeIndex, sceneRect.adjusted(-radius, -radius, radius, radius),
+	  [&](int i) { points.append(position(i)); });
+
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing,
+			  lines.count() + points.count() < ANTIALIAS_LIMIT);
+    painter.scale(scale, scale);
+    painter.translate(-sceneRect.topLeft());
+
+    QColor edgeColour(Qt::black);
+    if (lines.count() > size.width() * size.height() / 64)
+	edgeColour.setAlpha(64);
+    QPen pen(edgeColour, 1);
+    pen.setCosmetic(true);
+    painter.setPen(pen);
+    painter.drawLines(lines);
+
+    if (pixels < MIN_CIRCLE_SIZE)
+    {
+	pen = QPen(Qt::black, qMax(pixels, 1.), Qt::SolidLine, Qt::RoundCap);
+	pen.setCosmetic(true);
+	painter.setPen(pen);
+	painter.drawPoints(points);
+    }
+    else
+    {
+	pen = QPen(Qt::black, 1);
+	pen.setCosmetic(true);
+	painter.setPen(pen);
+	painter.setBrush(Qt::white);
+	foreach (QPointF p, points)
+	    painter.drawEllipse(p, radius, radius);
+    }
+
+    return image;
+}
+
+
+
+/*
+ * Name:	toGraph()
+ * Purpose:	Copy some of the nodes, and the edges between them,
+ *		into a new (editable) graph.
+ * Arguments:	The numbers of the nodes to copy.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The new graph.
+ * Assumptions:	The numbers are valid and not repeated.
+ * Bugs:	None known.
+ * Notes:	The nodes keep their relative positions, with the
+ *		graph's origin at the centre of their bounding box, and
+ *		are labelled with their numbers in the edge list.
+ *		They get the same default style as a generated graph
+ *		(see ScriptEngine::layOut()).  The new graph isn't in
+ *		any scene; that is up to the caller.
+ */
+
+Graph *
+HugeGraph::toGraph(QVector<int> nodes) const
+{
+    qreal diameter = HUGE_NODE_DIAMETER;
+    Graph * graph = new Graph();
+    QHash<int, Node *> copies;
+    QList<Node *> nodeList;
+    QList<QPointF> positions;
+    LabelBatch labels;
+
+    copies.reserve(nodes.count());
+    foreach (int i, nodes)
+    {
+	Node * node = new Node();
+	node->setDiameter(diameter);
+	node->setPenWidth(1);
+	node->setFillColour(Qt::white);
+	node->setLineColour(Qt::black);
+	node->setNodeLabelSize(12);
+	node->setParentItem(graph);
+	labels.add(node, QString::number(i));
+	copies.insert(i, node);
+	nodeList.append(node);
+	positions.append(position(i));
+    }
+
+    foreach (int i, nodes)
+    {
+	for (int k = adjStart.at(i); k < adjStart.at(i + 1); k++)
+	{
+	    int j = adj.at(k);
+	    if (j < i || ! copies.contains(j))
+		continue;
+	    Edge * edge = new Edge(copies.value(i), copies.value(j));
+	    edge->setPenWidth(1);
+	    edge->setColour(Qt::black);
+	    edge->setEdgeLabelSize(12);
+	    edge->setSourceRadius(diameter / 2.);
+	    edge->setDestRadius(diameter / 2.);
+	    edge->setParentItem(graph);
+	}
+    }
+
+    labels.apply();
+    QPointF centre = QPolygonF(positions.toVector()).boundingRect().center();
+    for (int k = 0; k < positions.count(); k++)
+	positions[k] -= centre;
+    CanvasScene::setNodePositions(nodeList, positions);
+    return graph;
+}
@@ -0,0 +1,109 @@
+/*
+ * File:	hugegraph.h
+ * Author:	Jim Diamond
+ * Date:	2026-10-19
+ * Version:	1.0
+ *
+ * Purpose:	Define the HugeGraph class, a compact, read-only graph
+ *		for viewing imports far too big to be made of Node and
+ *		Edge items (hundreds of thousands to millions of edges).
+ *
+ * Notes:	The graph is stored as a "struct of arrays": one array
+ *		of x coordinates, one of y coordinates, one of edge
+ *		sources, and so on, about 30 bytes per edge in all,
+ *		versus kilobytes for an Edge item and its label.
+ *		Coordinates are scene units (see SCENE_DPI), so a part
+ *		of the graph can be copied onto the canvas as it is
+ *		(see toGraph()).
+ *		Nodes and edges are found by position with a "loose"
+ *		grid (see Index below), which renderTile() uses to
+ *		draw only what is in a tile, and nodeAt() and nodesIn()
+ *		use for picking.  Once loaded, a HugeGraph is never
+ *		changed, so any number of threads may draw from it at
+ *		once.
+ *		Only edge lists (see File_IO::readEdgelist()) are read.
+ *		They have no coordinates, so the nodes are laid out by
+ *		putting them along a Hilbert curve in breadth-first
+ *		order (so neighbours start out close together) and
+ *		then pulling each node towards its neighbours a few
+ *		times.  This takes O(n + m) per pass and is done on
+ *		the job scheduler's workers.
+ *
+ * Modification history:
+ * Oct 19, 2026 (JD V1.0)
+ *  (a) Initial version.
+ */
+
+#ifndef HUGEGRAPH_H
+#define HUGEGRAPH_H
+
+#include <QImage>
+#include <QRectF>
+#include <QString>
+#include <QVector>
+
+#include <functional>
+
+class Graph;
+class JobToken;
+
+// How the nodes are drawn, and how far apart they start out.
+#define HUGE_NODE_DIAMETER	0.2	// inches
+#define HUGE_NODE_SPACING	0.5	// inches
+
+class HugeGraph
+{
+  public:
+    static HugeGraph * loadEdgelist(QString fileName, JobToken * token,
+				    QString * errorMessage);
+
+    int nodeCount() const { return xs.count(); }
+    int edgeCount() const { return edgeFrom.count(); }
+    int degree(int node) const
+	{ return adjStart.at(node + 1) - adjStart.at(node); }
+    QPointF position(int node) const
+	{ return QPointF(xs.at(node), ys.at(node)); }
+    QRectF bounds() const { return area; }
+    QString name() const { return fileName; }
+
+    int nodeAt(QPointF pos, qreal radius) const;
+    QVector<int> nodesIn(QRectF rect) const;
+    QImage renderTile(QRectF sceneRect, QSize size) const;
+    Graph * toGraph(QVector<int> nodes) const;
+
+  private:
+    // A loose grid: item i (with bounds b) is put in the cell
+    // containing b's centre, at the finest level whose cells are at
+    // least as big as b.  Each item is then within half a cell of
+    // its cell, so a query only looks at the cells (plus that
+    // margin) it overlaps, at every level.  The items of each level
+    // are kept sorted by cell, with each cell's start in "start".
+    typedef struct
+    {
+	QRectF area;
+	int levels;
+	QVector<QVector<int>> start;	// Per level, dim * dim + 1.
+	QVector<QVector<qint32>> items;	// Per level, sorted by cell.
+    } Index;
+
+    HugeGraph() {}
+    bool parse(QByteArray data, JobToken * token, QString * errorMessage);
+    void buildAdjacency();
+    bool layOut(JobToken * token);
+    void buildIndexes();
+    static void buildIndex(Index * index, QRectF area, int count,
+			   std::function<QRectF(int)> bounds);
+    static void query(const Index & index, QRectF rect,
+		      std::function<void(int)> visit);
+
+    QString fileName;
+    QVector<float> xs, ys;		// Node positions.
+    QVector<qint32> edgeFrom, edgeTo;	// Edge ends, from < to.
+    QVector<qint32> adjStart;		// Node i's neighbours are
+    QVector<qint32> adj;		// adj[adjStart[i] .. adjStart[i+1]).
+    QRectF area;			// Bounds of the node centres.
+    Index nodeIndex;
+    Index edgeIndex;
+};
+
+#endif // HUGEGRAPH_H
@@ -0,0 +1,730 @@
+/*
+ * File:	hugegraphview.cpp
+ * Author:	Jim Diamond
+ * Date:	2026-10-19
+ * Version:	1.0
+ *
+ * Purpose:	Implement the HugeGraphView class.
+ *
+ * Modification history:
+ * Oct 19, 2026 (JD V1.0)
+ *  (a) Initial version.
+ */
+
+#include <QApplication>
+#include <QContextMenuEvent>
+#include <QKeyEvent>
+#include <QMenu>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QWheelEvent>
+#include <QtMath>
+
+#include "hugegraphview.h"
+#include "defuns.h"
+#include "hugegraph.h"
+
+// Each zoom step scales by this much.
+#define ZOOM_FACTOR		1.41421356237
+
+// The zoom steps allowed, relative to actual size.
+#define MIN_ZOOM		-40
+#define MAX_ZOOM		8
+
+// Tiles are only stretched this many zoom steps to stand in for
+// missing ones; beyond that there would be too many (or too blurry).
+#define MAX_STAND_IN		4
+
+// Labels are drawn when the nodes are at least this big (in pixels)
+// and there are no more than this many of them in view.
+#define MIN_LABEL_SIZE		24.
+#define MAX_LABELS		2000
+
+// The selected nodes are marked if there are no more than this many.
+#define MAX_MARKED		50000
+
+// How close (in pixels) a click must be to a node to pick it.
+#define PICK_DISTANCE		6.
+
+
+
+/*
+ * Name:	HugeGraphView()
+ * Purpose:	Make a view of a huge graph, zoomed to fit.
+ * Arguments:	The graph and the parent widget.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	hugeGraph is not null.
+ * Bugs:	None known.
+ * Notes:	The fit is done on the first resize, when the window
+ *		has a size.
+ */
+
+HugeGraphView::HugeGraphView(QSharedPointer<HugeGraph> hugeGraph,
+			     QWidget * parent)
+    : QWidget(parent),
+      graph(hugeGraph),
+      resolution(currentPhysicalDPI_X / SCENE_DPI),
+      zoom(0),
+      previousZoom(0),
+      tiles(TILE_CACHE_SIZE),
+      dragging(false),
+      selecting(false),
+      picked(-1)
+{
+    setWindowTitle(graph->name() + " ("
+		   + QString::number(graph->nodeCount()) + " nodes, "
+		   + QString::number(graph->edgeCount()) + " edges)");
+    setFocusPolicy(Qt::StrongFocus);
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    centre = graph->bounds().center();
+}
+
+
+
+HugeGraphView::~HugeGraphView()
+{
+    cancelTiles(true);
+}
+
+
+
+QSize
+HugeGraphView::sizeHint() const
+{
+    return QSize(1000, 750);
+}
+
+
+
+/*
+ * Name:	scaleAt()
+ * Purpose:	Find the pixels per scene unit at a zoom level.
+ * Arguments:	The zoom level.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The scale.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Zoom level 0 is actual size on this screen.
+ */
+
+qreal
+HugeGraphView::scaleAt(int zoomLevel) const
+{
+    return resolution * qPow(ZOOM_FACTOR, zoomLevel);
+}
+
+
+
+QPointF
+HugeGraphView::toScene(QPointF widgetPos) const
+{
+    return centre + (widgetPos - QPointF(width() / 2., height() / 2.))
+	/ scaleAt(zoom);
+}
+
+
+
+QPointF
+HugeGraphView::toWidget(QPointF scenePos) const
+{
+    return (scenePos - centre) * scaleAt(zoom)
+	+ QPointF(width() / 2., height() / 2.);
+}
+
+
+
+/*
+ * Name:	tileKey()
+ * Purpose:	Find the cache key of a tile.
+ * Arguments:	The tile's zoom level and position (in tiles).
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The key.
+ * Assumptions:	The position fits in 28 bits, which at MAX_ZOOM is
+ *		still a graph several miles wide.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+quint64
+HugeGraphView::tileKey(int zoomLevel, int x, int y)
+{
+    return ((quint64)(zoomLevel & 0xff) << 56)
+	| ((quint64)(x & 0xfffffff) << 28)
+	| (quint64)(y & 0xfffffff);
+}
+
+
+
+/*
+ * Name:	paintEvent()
+ * Purpose:	Draw the visible part of the graph.
+ * Arguments:	The event (unused).
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Tiles which aren't ready yet are requested, and the
+ *		previous zoom level's tiles are shown in their place.
+ *		Once every tile of this level has been drawn, the
+ *		previous level is no longer needed.
+ */
+
+void
+HugeGraphView::paintEvent(QPaintEvent * event)
+{
+    Q_UNUSED(event);
+    QPainter painter(this);
+    painter.fillRect(rect(), Qt::white);
+
+    if (previousZoom != zoom && qAbs(previousZoom - zoom) <= MAX_STAND_IN)
+	drawTiles(&painter, previousZoom, false);
+    if (drawTiles(&painter, zoom, true))
+	previousZoom = zoom;
+
+    drawLabels(&painter);
+    drawSelection(&painter);
+    drawStatus(&painter);
+}
+
+
+
+/*
+ * Name:	drawTiles()
+ * Purpose:	Draw the cached tiles of one zoom level which are in
+ *		view.
+ * Arguments:	The painter, the zoom level, and whether to request
+ *		the missing tiles.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	True if every tile in view was drawn.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Tiles of another zoom level are stretched to fit.
+ */
+
+bool
+HugeGraphView::drawTiles(QPainter * painter, int zoomLevel, bool request)
+{
+    qreal tileSize = TILE_SIZE / scaleAt(zoomLevel);	// Scene units.
+    QRectF visible(toScene(QPointF(0, 0)),
+		   toScene(QPointF(width(), height())));
+    int x0 = qFloor(visible.left() / tileSize);
+    int x1 = qFloor(visible.right() / tileSize);
+    int y0 = qFloor(visible.top() / tileSize);
+    int y1 = qFloor(visible.bottom() / tileSize);
+    bool complete = true;
+
+    for (int y = y0; y <= y1; y++)
+    {
+	for (int x = x0; x <= x1; x++)
+	{
+	    QImage * image = tiles.object(tileKey(zoomLevel, x, y));
+	    if (image == nullptr)
+	    {
+		complete = false;
+		if (request)
+		    requestTile(zoomLevel, x, y);
+		continue;
+	    }
+	    QRectF target(toWidget(QPointF(x * tileSize, y * tileSize)),
+			  toWidget(QPointF((x + 1) * tileSize,
+					   (y + 1) * tileSize)));
+	    if (zoomLevel == zoom)
+		target = QRectF(target.topLeft().toPoint(),
+				QSizeF(TILE_SIZE, TILE_SIZE));
+	    painter->drawImage(target, *image);
+	}
+    }
+
+    return complete;
+}
+
+
+
+/*
+ * Name:	requestTile()
+ * Purpose:	Have a tile drawn, unless it already is being drawn.
+ * Arguments:	The tile's zoom level and position (in tiles).
+ * Outputs:	Nothing.
+ * Modifies:	pending.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	The job holds a reference to the graph, so closing the
+ *		window while tiles are being drawn is safe.
+ */
+
+void
+HugeGraphView::requestTile(int zoomLevel, int x, int y)
+{
+    quint64 key = tileKey(zoomLevel, x, y);
+    if (pending.contains(key))
+	return;
+
+    qreal tileSize = TILE_SIZE / scaleAt(zoomLevel);
+    QRectF area(x * tileSize, y * tileSize, tileSize, tileSize);
+    QSharedPointer<HugeGraph> g = graph;
+    JobFunction work = [g, area](JobToken & token) -> QVariant
+    {
+	if (token.isCancelled())
+	    return QVariant();
+	return QVariant::fromValue(g->renderTile(area,
+						 QSize(TILE_SIZE, TILE_SIZE)));
+    };
+    JobResultFunction done = [this, key](const QVariant & result)
+    {
+	tileDone(key, result.value<QImage>());
+    };
+
+    pending.insert(key, JobScheduler::instance()->submit(
+		       QString(), JobScheduler::InteractivePriority,
+		       work, this, done));
+}
+
+
+
+void
+HugeGraphView::tileDone(quint64 key, QImage image)
+{
+    pending.remove(key);
+    if (image.isNull())
+	return;
+    tiles.insert(key, new QImage(image));
+    update();
+}
+
+
+
+/*
+ * Name:	cancelTiles()
+ * Purpose:	Stop drawing the tiles of other zoom levels.
+ * Arguments:	Whether to stop drawing this level's tiles too.
+ * Outputs:	Nothing.
+ * Modifies:	pending.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Called when the zoom changes, and (for all tiles) from
+ *		the destructor.
+ */
+
+void
+HugeGraphView::cancelTiles(bool all)
+{
+    QHash<quint64, JobTokenPtr>::iterator it = pending.begin();
+    while (it != pending.end())
+    {
+	if (all || (int)(qint8)(it.key() >> 56) != zoom)
+	{
+	    it.value()->cancel();
+	    it = pending.erase(it);
+	}
+	else
+	    ++it;
+    }
+}
+
+
+
+/*
+ * Name:	drawLabels()
+ * Purpose:	Number the nodes in view, if they are big enough.
+ * Arguments:	The painter.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+void
+HugeGraphView::drawLabels(QPainter * painter)
+{
+    qreal size = HUGE_NODE_DIAMETER * SCENE_DPI * scaleAt(zoom);
+    if (size < MIN_LABEL_SIZE)
+	return;
+
+    QVector<int> nodes = graph->nodesIn(QRectF(toScene(QPointF(0, 0)),
+					       toScene(QPointF(width(),
+							       height()))));
+    if (nodes.count() > MAX_LABELS)
+	return;
+
+    QFont font = painter->font();
+    font.setPixelSize(qRound(size * 0.4));
+    painter->setFont(font);
+    painter->setPen(Qt::black);
+    foreach (int i, nodes)
+    {
+	QPointF c = toWidget(graph->position(i));
+	painter->drawText(QRectF(c.x() - size / 2, c.y() - size / 2,
+				 size, size),
+			  Qt::AlignCenter, QString::number(i));
+    }
+}
+
+
+
+/*
+ * Name:	drawSelection()
+ * Purpose:	Show the selection rectangle, the selected nodes, and
+ *		the picked node.
+ * Arguments:	The painter.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+void
+HugeGraphView::drawSelection(QPainter * painter)
+{
+    qreal radius = qMax(HUGE_NODE_DIAMETER * SCENE_DPI / 2 * scaleAt(zoom),
+			2.);
+
+    if (! band.isNull())
+    {
+	painter->setPen(QPen(Qt::blue, 1, Qt::DashLine));
+	painter->setBrush(QColor(0, 0, 255, 24));
+	painter->drawRect(QRectF(toWidget(band.topLeft()),
+				 toWidget(band.bottomRight())));
+    }
+
+    if (selection.count() <= MAX_MARKED)
+    {
+	painter->setPen(QPen(Qt::blue, 2));
+	painter->setBrush(Qt::NoBrush);
+	foreach (int i, selection)
+	    painter->drawEllipse(toWidget(graph->position(i)), radius, radius);
+    }
+
+    if (picked >= 0)
+    {
+	painter->setPen(QPen(Qt::red, 2));
+	painter->setBrush(Qt::NoBrush);
+	painter->drawEllipse(toWidget(graph->position(picked)),
+			     radius + 2, radius + 2);
+    }
+}
+
+
+
+/*
+ * Name:	drawStatus()
+ * Purpose:	Describe the zoom, the selection and the picked node
+ *		along the bottom of the window.
+ * Arguments:	The painter.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+void
+HugeGraphView::drawStatus(QPainter * painter)
+{
+    QString status = QString("Zoom %1%")
+	.arg(qPow(ZOOM_FACTOR, zoom) * 100, 0, 'g', 3);
+    if (! selection.isEmpty())
+	status += QString("    %1 nodes selected (Enter to edit)")
+	    .arg(selection.count());
+    if (picked >= 0)
+	status += QString("    Node %1, degree %2")
+	    .arg(picked).arg(graph->degree(picked));
+    if (! pending.isEmpty())
+	status += "    Drawing...";
+
+    QFontMetrics metrics(font());
+    QRect line(0, height() - metrics.height() - 4, width(),
+	       metrics.height() + 4);
+    painter->setFont(font());
+    painter->fillRect(line, QColor(255, 255, 255, 208));
+    painter->setPen(Qt::black);
+    painter->drawText(line.adjusted(6, 0, -6, 0),
+		      Qt::AlignLeft | Qt::AlignVCenter, status);
+}
+
+
+
+void
+HugeGraphView::resizeEvent(QResizeEvent * event)
+{
+    QWidget::resizeEvent(event);
+    if (event->oldSize().isEmpty())
+	zoomToFit();
+}
+
+
+
+/*
+ * Name:	zoomBy()
+ * Purpose:	Zoom in or out, keeping one point still.
+ * Arguments:	The number of steps (negative to zoom out) and the
+ *		point (in widget coordinates).
+ * Outputs:	Nothing.
+ * Modifies:	zoom, centre and pending.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+void
+HugeGraphView::zoomBy(int steps, QPointF about)
+{
+    int newZoom = qBound(MIN_ZOOM, zoom + steps, MAX_ZOOM);
+    if (newZoom == zoom)
+	return;
+
+    // previousZoom is left alone: it is the last level which was
+    // completely drawn.
+    QPointF fixed = toScene(about);
+    zoom = newZoom;
+    centre = fixed - (about - QPointF(width() / 2., height() / 2.))
+	/ scaleAt(zoom);
+    cancelTiles();
+    update();
+}
+
+
+
+void
+HugeGraphView::zoomIn()
+{
+    zoomBy(1, QPointF(width() / 2., height() / 2.));
+}
+
+
+
+void
+HugeGraphView::zoomOut()
+{
+    zoomBy(-1, QPointF(width() / 2., height() / 2.));
+}
+
+
+
+/*
+ * Name:	zoomToFit()
+ * Purpose:	Show the whole graph.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	zoom, centre and pending.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	This uses the biggest zoom step at which the graph
+ *		(and a margin) fits.
+ */
+
+void
+HugeGraphView::zoomToFit()
+{
+    qreal margin = HUGE_NODE_SPACING * SCENE_DPI;
+    QRectF area = graph->bounds().adjusted(-margin, -margin, margin, margin);
+    qreal fit = qMin(width() / area.width(), height() / area.height());
+
+    int newZoom = qFloor(qLn(fit / resolution) / qLn(ZOOM_FACTOR));
+    newZoom = qBound(MIN_ZOOM, newZoom, MAX_ZOOM);
+    zoom = newZoom;
+    centre = area.center();
+    cancelTiles();
+    update();
+}
+
+
+
+void
+HugeGraphView::clearSelection()
+{
+    selection.clear();
+    band = QRectF();
+    update();
+}
+
+
+
+/*
+ * Name:	promoteSelection()
+ * Purpose:	Ask for the selected nodes to be copied to the canvas.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	The receiver of promote() does the copying (see
+ *		HugeGraph::toGraph()) with getSelection().
+ */
+
+void
+HugeGraphView::promoteSelection()
+{
+    if (! selection.isEmpty())
+	emit promote();
+}
+
+
+
+void
+HugeGraphView::mousePressEvent(QMouseEvent * event)
+{
+    if (event->button() != Qt::LeftButton)
+    {
+	QWidget::mousePressEvent(event);
+	return;
+    }
+    pressPos = lastPos = event->pos();
+    selecting = event->modifiers() & Qt::ShiftModifier;
+    dragging = false;
+}
+
+
+
+/*
+ * Name:	mouseMoveEvent()
+ * Purpose:	Pan, or stretch the selection rectangle.
+ * Arguments:	The event.
+ * Outputs:	Nothing.
+ * Modifies:	centre or band.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Small movements are ignored, so that a click can
+ *		still pick a node.
+ */
+
+void
+HugeGraphView::mouseMoveEvent(QMouseEvent * event)
+{
+    if (! (event->buttons() & Qt::LeftButton))
+	return;
+    if (! dragging
+	&& (event->pos() - pressPos).manhattanLength()
+	   < QApplication::startDragDistance())
+	return;
+    dragging = true;
+
+    if (selecting)
+	band = QRectF(toScene(pressPos), toScene(event->pos())).normalized();
+    else
+	centre -= QPointF(event->pos() - lastPos) / scaleAt(zoom);
+    lastPos = event->pos();
+    update();
+}
+
+
+
+/*
+ * Name:	mouseReleaseEvent()
+ * Purpose:	Finish a selection, or pick the node clicked on.
+ * Arguments:	The event.
+ * Outputs:	Nothing.
+ * Modifies:	selection, band and picked.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+void
+HugeGraphView::mouseReleaseEvent(QMouseEvent * event)
+{
+    if (event->button() != Qt::LeftButton)
+	return;
+
+    if (dragging && selecting)
+	selection = graph->nodesIn(band);
+    else if (! dragging)
+    {
+	qreal radius = qMax(HUGE_NODE_DIAMETER * SCENE_DPI / 2,
+			    PICK_DISTANCE / scaleAt(zoom));
+	picked = graph->nodeAt(toScene(event->pos()), radius);
+    }
+    dragging = selecting = false;
+    update();
+}
+
+
+
+void
+HugeGraphView::wheelEvent(QWheelEvent * event)
+{
+    int steps = event->angleDelta().y() / 120;
+    if (steps != 0)
+	zoomBy(steps, event->pos());
+    event->accept();
+}
+
+
+
+void
+HugeGraphView::keyPressEvent(QKeyEvent * event)
+{
+    QPointF step = QPointF(width() / 8., height() / 8.) / scaleAt(zoom);
+
+    switch (event->key())
+    {
+      case Qt::Key_Plus:
+      case Qt::Key_Equal:
+	zoomIn();
+	break;
+      case Qt::Key_Minus:
+	zoomOut();
+	break;
+      case Qt::Key_0:
+	zoomToFit();
+	break;
+      case Qt::Key_Left:
+	centre.rx() -= step.x();
+	update();
+	break;
+      case Qt::Key_Right:
+	centre.rx() += step.x();
+	update();
+	break;
+      case Qt::Key_Up:
+	centre.ry() -= step.y();
+	update();
+	break;
+      case Qt::Key_Down:
+	centre.ry() += step.y();
+	update();
+	break;
+      case Qt::Key_Return:
+      case Qt::Key_Enter:
+	promoteSelection();
+	break;
+      case Qt::Key_Escape:
+	clearSelection();
+	break;
+      default:
+	QWidget::keyPressEvent(event);
+    }
+}
+
+
+
+void
+HugeGraphView::contextMenuEvent(QContextMenuEvent * event)
+{
+    QMenu menu(this);
+    menu.addAction("Zoom to Fit", this, SLOT(zoomToFit()));
+    QAction * edit = menu.addAction("Edit Selection on Canvas",
+				    this, SLOT(promoteSelection()));
+    QAction * clear = menu.addAction("Clear Selection",
+				     this, SLOT(clearSelection()));
+    edit->setEnabled(! selection.isEmpty());
+    clear->setEnabled(! selection.isEmpty());
+    menu.exec(event->globalPos());
+}
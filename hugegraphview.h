@@ -0,0 +1,117 @@
+/*
+ * File:	hugegraphview.h
+ * Author:	Jim Diamond
+ * Date:	2026-10-19
+ * Version:	1.0
+ *
+ * Purpose:	Define the HugeGraphView class, a window which shows a
+ *		HugeGraph (File > Open Huge Graph...), lets the user
+ *		pan, zoom and pick nodes, and copy a selected region
+ *		onto the canvas for editing.
+ *
+ * Notes:	The graph is drawn in square tiles (TILE_SIZE pixels)
+ *		by HugeGraph::renderTile() on the job scheduler's
+ *		workers, so the window stays responsive however big
+ *		the graph is.  Tiles are kept in a cache, keyed by the
+ *		zoom level and their position, so panning back over an
+ *		area costs nothing.  Until a tile arrives, the tiles of
+ *		the previous zoom level are stretched to fill in.
+ *		Tiles of a zoom level the user has left are cancelled.
+ *		Zooming goes in fixed steps, so tiles can be re-used.
+ *		Node labels are drawn over the tiles (on this thread,
+ *		since they need fonts) when the nodes are big enough
+ *		to hold them.
+ *		Mouse:	drag to pan, click to pick a node, shift-drag
+ *			to select a region, wheel to zoom.
+ *		Keys:	+, - and 0 zoom in, out and to fit, the
+ *			arrows pan, Enter copies the selection to
+ *			the canvas and Esc clears it.
+ *
+ * Modification history:
+ * Oct 19, 2026 (JD V1.0)
+ *  (a) Initial version.
+ */
+
+#ifndef HUGEGRAPHVIEW_H
+#define HUGEGRAPHVIEW_H
+
+#include <QCache>
+#include <QHash>
+#include <QImage>
+#include <QSharedPointer>
+#include <QVector>
+#include <QWidget>
+
+#include "jobscheduler.h"
+
+class HugeGraph;
+class QPainter;
+
+#define TILE_SIZE		256	// pixels
+#define TILE_CACHE_SIZE		256	// tiles (256 KB each)
+
+class HugeGraphView : public QWidget
+{
+    Q_OBJECT
+
+  public:
+    HugeGraphView(QSharedPointer<HugeGraph> hugeGraph,
+		  QWidget * parent = nullptr);
+    ~HugeGraphView();
+
+    QSize sizeHint() const;
+    QSharedPointer<HugeGraph> getGraph() const { return graph; }
+    QVector<int> getSelection() const { return selection; }
+
+  public slots:
+    void zoomIn();
+    void zoomOut();
+    void zoomToFit();
+    void clearSelection();
+    void promoteSelection();
+
+  signals:
+    void promote();
+
+  protected:
+    void paintEvent(QPaintEvent * event);
+    void resizeEvent(QResizeEvent * event);
+    void mousePressEvent(QMouseEvent * event);
+    void mouseMoveEvent(QMouseEvent * event);
+    void mouseReleaseEvent(QMouseEvent * event);
+    void wheelEvent(QWheelEvent * event);
+    void keyPressEvent(QKeyEvent * event);
+    void contextMenuEvent(QContextMenuEvent * event);
+
+  private:
+    qreal scaleAt(int zoomLevel) const;
+    QPointF toScene(QPointF widgetPos) const;
+    QPointF toWidget(QPointF scenePos) const;
+    void zoomBy(int steps, QPointF about);
+    bool drawTiles(QPainter * painter, int zoomLevel, bool request);
+    void requestTile(int zoomLevel, int x, int y);
+    void tileDone(quint64 key, QImage image);
+    void cancelTiles(bool all = false);
+    void drawLabels(QPainter * painter);
+    void drawSelection(QPainter * painter);
+    void drawStatus(QPainter * painter);
+    static quint64 tileKey(int zoomLevel, int x, int y);
+
+    QSharedPointer<HugeGraph> graph;
+    qreal resolution;			// Pixels per scene unit at zoom 0.
+    QPointF centre;			// Scene point in the middle.
+    int zoom;
+    int previousZoom;			// Stand-in tiles come from here.
+    QCache<quint64, QImage> tiles;
+    QHash<quint64, JobTokenPtr> pending;
+
+    QPoint pressPos;
+    QPoint lastPos;
+    bool dragging;
+    bool selecting;
+    QRectF band;			// Selection rectangle (scene).
+    QVector<int> selection;
+    int picked;				// Clicked node, or -1.
+};
+
+#endif // HUGEGRAPHVIEW_H
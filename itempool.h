@@ -0,0 +1,144 @@
+/*
+ * File:	itempool.h
+ * Author:	Jim Diamond
+ * Date:	2026-10-19
+ * Version:	1.0
+ *
+ * Purpose:	Define ItemPool, a simple pool allocator for the
+ *		graph items (Node, Edge and HTML_Label) which are
+ *		created and destroyed by the thousand when graphs are
+ *		generated, styled, loaded and cleared.
+ *
+ * Notes:	Each pooled class gets its own free list of
+ *		sizeof(class)-sized blocks, carved out of slabs of
+ *		ITEM_POOL_SLAB_SIZE blocks.  Freed blocks go back on the
+ *		free list and are re-used by the next "new", so
+ *		repeatedly creating and clearing large preview graphs
+ *		neither goes to the general allocator for every item
+ *		nor fragments the heap.  Slabs are never given back.
+ *		A request for any other size (e.g., a subclass, of
+ *		which there are none at time of writing) is simply
+ *		passed on to the global operator new/delete.
+ *		Only the item objects themselves are pooled; the
+ *		private data Qt allocates for each QObject and
+ *		QGraphicsItem is out of our hands.
+ *		Items are only ever created and deleted on the GUI
+ *		thread, so there is no locking.
+ *
+ *		To pool a class, declare
+ *		    static void * operator new(size_t size);
+ *		    static void operator delete(void * p, size_t size);
+ *		in it and define them to call ItemPool<Class>::allocate()
+ *		and ItemPool<Class>::release().
+ *
+ * Modification history:
+ * Oct 19, 2026 (JD V1.0)
+ *  (a) Initial version.
+ */
+
+#ifndef ITEMPOOL_H
+#define ITEMPOOL_H
+
+#include <QVector>
+
+#include <cstddef>
+#include <new>
+
+#define ITEM_POOL_SLAB_SIZE	256
+
+template <class T>
+class ItemPool
+{
+  public:
+    static void * allocate(size_t size);
+    static void release(void * p, size_t size);
+
+  private:
+    union Block
+    {
+	Block * next;
+	alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    static Block * freeList;
+    static QVector<Block *> slabs;
+};
+
+template <class T>
+typename ItemPool<T>::Block * ItemPool<T>::freeList = nullptr;
+
+template <class T>
+QVector<typename ItemPool<T>::Block *> ItemPool<T>::slabs;
+
+
+
+/*
+ * Name:	allocate()
+ * Purpose:	Get storage for one T.
+ * Arguments:	The requested size.
+ * Outputs:	Nothing.
+ * Modifies:	The free list (and perhaps the slab list).
+ * Returns:	A pointer to the storage.
+ * Assumptions:	Called on the GUI thread.
+ * Bugs:	None known.
+ * Notes:	Throws std::bad_alloc, as operator new must, if the
+ *		system is out of memory.
+ */
+
+template <class T>
+void *
+ItemPool<T>::allocate(size_t size)
+{
+    if (size != sizeof(T))
+	return ::operator new(size);
+
+    if (freeList == nullptr)
+    {
+	Block * slab = static_cast<Block *>(
+	    ::operator new(ITEM_POOL_SLAB_SIZE * sizeof(Block)));
+	slabs.append(slab);
+	for (int i = 0; i < ITEM_POOL_SLAB_SIZE; i++)
+	{
+	    slab[i].next = freeList;
+	    freeList = &slab[i];
+	}
+    }
+
+    Block * block = freeList;
+    freeList = block->next;
+    return block;
+}
+
+
+
+/*
+ * Name:	release()
+ * Purpose:	Give back the storage of one T.
+ * Arguments:	The pointer (from allocate()) and the size.
+ * Outputs:	Nothing.
+ * Modifies:	The free list.
+ * Returns:	Nothing.
+ * Assumptions:	Called on the GUI thread.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+template <class T>
+void
+ItemPool<T>::release(void * p, size_t size)
+{
+    if (p == nullptr)
+	return;
+
+    if (size != sizeof(T))
+    {
+	::operator delete(p);
+	return;
+    }
+
+    Block * block = static_cast<Block *>(p);
+    block->next = freeList;
+    freeList = block;
+}
+
+#endif // ITEMPOOL_H
@@ -0,0 +1,581 @@
+/*
+ * File:	jobscheduler.cpp
+ * Author:	Jim Diamond
+ * Date:	2026-10-19
+ * Version:	1.1
+ *
+ * Purpose:	Implement the shared background job scheduler.
+ *		See jobscheduler.h for the overall design.
+ *
+ * Modification history:
+ * Oct 19, 2026 (JD V1.0)
+ *  (a) Initial version.
+ * Oct 19, 2026 (JD V1.1)
+ *  (a) busyChanged(true) was emitted directly and busyChanged(false)
+ *	arrived queued from a worker, so the "busy" indicator could
+ *	be hidden while a job was running.  Both now go through
+ *	reportBusy(), which looks at the current count.
+ */
+
+#include "jobscheduler.h"
+#include "defuns.h"
+
+#include <QCoreApplication>
+#include <QThread>
+
+// Which worker (if any) the current thread is.  -1 means "not one of
+// ours", which is the case for the GUI thread.
+static thread_local int currentWorker = -1;
+
+
+
+class JobScheduler::Worker : public QThread
+{
+  public:
+    Worker(JobScheduler * owner, int index)
+	: scheduler(owner), self(index) {}
+
+  protected:
+    void run() override;
+
+  private:
+    JobScheduler * scheduler;
+    int self;
+};
+
+
+
+/*
+ * Name:	Worker::run()
+ * Purpose:	The main loop of a worker thread.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	The job queues.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	The pendingJobs counter is checked while holding
+ *		idleLock, and enqueue() takes idleLock before waking a
+ *		worker, so a wake-up can not be lost.
+ */
+
+void
+JobScheduler::Worker::run()
+{
+    Job job;
+
+    currentWorker = self;
+    for (;;)
+    {
+	if (scheduler->takeJob(self, &job))
+	{
+	    scheduler->runJob(job);
+	    job = Job();
+	    continue;
+	}
+
+	QMutexLocker locker(&scheduler->idleLock);
+	if (scheduler->stopping)
+	    return;
+	if (scheduler->pendingJobs.loadAcquire() == 0)
+	    scheduler->workAvailable.wait(&scheduler->idleLock);
+	if (scheduler->stopping)
+	    return;
+    }
+}
+
+
+
+/*
+ * Name:	JobToken()
+ * Purpose:	Constructor.
+ * Arguments:	The job's ID and the scheduler it belongs to.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+JobToken::JobToken(int id, JobScheduler * owner)
+    : jobID(id), scheduler(owner), cancelled(0), lastPercent(-1)
+{
+}
+
+
+
+/*
+ * Name:	setProgress()
+ * Purpose:	Report the progress of a job.
+ * Arguments:	The percentage done.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Only changes are signalled, so it is cheap to call this
+ *		once per item in a loop.  The signal is emitted from the
+ *		worker thread; connections to GUI-thread objects are
+ *		therefore queued.
+ */
+
+void
+JobToken::setProgress(int percent)
+{
+    percent = qBound(0, percent, 100);
+    if (lastPercent.fetchAndStoreRelaxed(percent) != percent)
+	emit scheduler->jobProgress(jobID, percent);
+}
+
+
+
+/*
+ * Name:	instance()
+ * Purpose:	Return the (one and only) scheduler, creating it if needed.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	A pointer to the scheduler.
+ * Assumptions:	The QApplication exists; the first call is made from
+ *		the GUI thread.
+ * Bugs:	None known.
+ * Notes:	The scheduler is a child of the application object, so
+ *		that it lives in the GUI thread and is cleaned up on exit.
+ */
+
+JobScheduler *
+JobScheduler::instance()
+{
+    static JobScheduler * theScheduler = nullptr;
+
+    if (theScheduler == nullptr)
+	theScheduler = new JobScheduler(QCoreApplication::instance());
+    return theScheduler;
+}
+
+
+
+/*
+ * Name:	JobScheduler()
+ * Purpose:	Constructor; start the worker threads.
+ * Arguments:	The parent QObject.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	One worker per core.  The GUI thread also helps out in
+ *		parallelFor(), so it never sits idle waiting.
+ */
+
+JobScheduler::JobScheduler(QObject * parent)
+    : QObject(parent), stopping(false), pendingJobs(0), trackedJobs(0),
+      reportedBusy(false), nextQueue(0), nextJobID(1)
+{
+    int n = qMax(1, QThread::idealThreadCount());
+
+    for (int i = 0; i < n; i++)
+	queues.append(new WorkerQueue);
+    for (int i = 0; i < n; i++)
+    {
+	Worker * worker = new Worker(this, i);
+	workers.append(worker);
+	worker->start();
+    }
+    qDebu("JobScheduler: started %d workers", n);
+}
+
+
+
+JobScheduler::~JobScheduler()
+{
+    shutdown();
+}
+
+
+
+/*
+ * Name:	shutdown()
+ * Purpose:	Cancel everything and stop the worker threads.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	The worker threads and queues.
+ * Returns:	Nothing.
+ * Assumptions:	Called from the GUI thread.
+ * Bugs:	None known.
+ * Notes:	Running jobs are asked to cancel, and then waited for;
+ *		queued jobs are dropped without being run.
+ *		Called by MainWindow before the widgets go away, since
+ *		a job may refer to them.  Safe to call more than once.
+ */
+
+void
+JobScheduler::shutdown()
+{
+    if (workers.isEmpty())
+	return;
+
+    cancelAll();
+    {
+	QMutexLocker locker(&idleLock);
+	stopping = true;
+	workAvailable.wakeAll();
+    }
+    foreach (Worker * worker, workers)
+    {
+	worker->wait();
+	delete worker;
+    }
+    workers.clear();
+    qDeleteAll(queues);
+    queues.clear();
+}
+
+
+
+/*
+ * Name:	submit()
+ * Purpose:	Queue a job.
+ * Arguments:	A name to display while it runs, its priority, the
+ *		work to do, and optionally a context object and a
+ *		function to call (on the context object's thread)
+ *		with the job's result.
+ * Outputs:	Nothing.
+ * Modifies:	The job queues.
+ * Returns:	The job's token, which can be used to cancel it.
+ * Assumptions:	"work" does not touch any QGraphicsItems or widgets.
+ * Bugs:	None known.
+ * Notes:	A job with an empty name is not reported via jobStarted(),
+ *		jobProgress() or jobFinished(), and does not make the
+ *		scheduler "busy".
+ *		"done" is not called if the job is cancelled.  If no
+ *		context is given, "done" is run on the GUI thread.
+ *		A job submitted from a worker thread goes onto that
+ *		worker's own queue; other workers may steal it.
+ */
+
+JobTokenPtr
+JobScheduler::submit(QString name, Priority priority, JobFunction work,
+		     QObject * context, JobResultFunction done)
+{
+    Job job;
+
+    job.token = JobTokenPtr(new JobToken(nextJobID.fetchAndAddRelaxed(1),
+					 this));
+    job.name = name;
+    job.work = work;
+    job.context = context != nullptr ? context : this;
+    job.done = done;
+
+    if (!name.isEmpty())
+    {
+	{
+	    QMutexLocker locker(&tokensLock);
+	    liveTokens.insert(job.token->id(), job.token);
+	}
+	if (trackedJobs.fetchAndAddOrdered(1) == 0)
+	    QMetaObject::invokeMethod(this, [this]() { reportBusy(); },
+				      Qt::QueuedConnection);
+    }
+
+    JobTokenPtr token = job.token;
+    enqueue(job, priority);
+    return token;
+}
+
+
+
+/*
+ * Name:	enqueue()
+ * Purpose:	Put a job on a worker queue and wake a worker.
+ * Arguments:	The job and its priority.
+ * Outputs:	Nothing.
+ * Modifies:	The job queues.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	If we are shut down the job is simply dropped.
+ */
+
+void
+JobScheduler::enqueue(Job job, Priority priority)
+{
+    if (queues.isEmpty())
+	return;
+
+    int target = currentWorker;
+    if (target < 0)
+	target = (nextQueue.fetchAndAddRelaxed(1) & 0x7fffffff)
+	    % queues.size();
+
+    {
+	QMutexLocker locker(&queues[target]->lock);
+	queues[target]->lanes[priority].push_back(job);
+    }
+    pendingJobs.ref();
+
+    QMutexLocker locker(&idleLock);
+    workAvailable.wakeOne();
+}
+
+
+
+/*
+ * Name:	takeJob()
+ * Purpose:	Find the next job for a given worker.
+ * Arguments:	The worker's index and a place to put the job.
+ * Outputs:	Nothing.
+ * Modifies:	The job queues and *job.
+ * Returns:	True iff a job was found.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	For each priority (highest first) a worker takes the
+ *		oldest job from its own queue, or failing that steals
+ *		the newest job from the other workers' queues.
+ *		Stealing from the far end keeps the owner and the
+ *		thief from fighting over the same jobs.
+ */
+
+bool
+JobScheduler::takeJob(int self, Job * job)
+{
+    int n = queues.size();
+
+    for (int p = 0; p < NumPriorities; p++)
+    {
+	{
+	    WorkerQueue * q = queues[self];
+	    QMutexLocker locker(&q->lock);
+	    if (!q->lanes[p].empty())
+	    {
+		*job = q->lanes[p].front();
+		q->lanes[p].pop_front();
+		pendingJobs.deref();
+		return true;
+	    }
+	}
+	for (int i = 1; i < n; i++)
+	{
+	    WorkerQueue * q = queues[(self + i) % n];
+	    QMutexLocker locker(&q->lock);
+	    if (!q->lanes[p].empty())
+	    {
+		*job = q->lanes[p].back();
+		q->lanes[p].pop_back();
+		pendingJobs.deref();
+		return true;
+	    }
+	}
+    }
+    return false;
+}
+
+
+
+/*
+ * Name:	runJob()
+ * Purpose:	Run a job and hand its result back.
+ * Arguments:	The job.
+ * Outputs:	Nothing.
+ * Modifies:	Whatever the job modifies.
+ * Returns:	Nothing.
+ * Assumptions:	Called on a worker thread.
+ * Bugs:	None known.
+ * Notes:	The result callback is posted to the context object's
+ *		thread; if the context object has gone away by then,
+ *		Qt discards the call.
+ */
+
+void
+JobScheduler::runJob(Job & job)
+{
+    bool tracked = !job.name.isEmpty();
+    int id = job.token->id();
+    QVariant result;
+
+    if (!job.token->isCancelled())
+    {
+	if (tracked)
+	    emit jobStarted(id, job.name);
+	result = job.work(*job.token);
+    }
+
+    bool wasCancelled = job.token->isCancelled();
+    if (!wasCancelled && job.done && !job.context.isNull())
+    {
+	JobResultFunction done = job.done;
+	QMetaObject::invokeMethod(job.context.data(),
+				  [done, result]() { done(result); },
+				  Qt::QueuedConnection);
+    }
+
+    if (tracked)
+    {
+	{
+	    QMutexLocker locker(&tokensLock);
+	    liveTokens.remove(id);
+	}
+	emit jobFinished(id, wasCancelled);
+	if (trackedJobs.fetchAndAddOrdered(-1) == 1)
+	    QMetaObject::invokeMethod(this, [this]() { reportBusy(); },
+				      Qt::QueuedConnection);
+    }
+}
+
+
+
+/*
+ * Name:	reportBusy()
+ * Purpose:	Emit busyChanged() if the scheduler has become busy or
+ *		idle since it was last emitted.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	reportedBusy.
+ * Returns:	Nothing.
+ * Assumptions:	Called on the GUI thread (by way of a queued call).
+ * Bugs:	None known.
+ * Notes:	The 0 -> 1 and 1 -> 0 transitions of trackedJobs happen
+ *		on different threads, so their queued calls may arrive
+ *		in either order (or after the count has changed again);
+ *		looking at the count here, rather than passing it along,
+ *		means the last call always leaves the right state.
+ */
+
+void
+JobScheduler::reportBusy()
+{
+    bool busy = trackedJobs.loadAcquire() > 0;
+
+    if (busy != reportedBusy)
+    {
+	reportedBusy = busy;
+	emit busyChanged(busy);
+    }
+}
+
+
+
+/*
+ * Name:	parallelFor()
+ * Purpose:	Run body(begin, end) over [0, count) in chunks of
+ *		grainSize, spread over the workers, and wait for all
+ *		of it to be done.
+ * Arguments:	The number of items, the chunk size and the body.
+ * Outputs:	Nothing.
+ * Modifies:	Whatever body modifies.
+ * Returns:	Nothing (after all chunks are done).
+ * Assumptions:	body is safe to call concurrently on disjoint ranges.
+ * Bugs:	None known.
+ * Notes:	The calling thread works on chunks too, so this can be
+ *		called from the GUI thread or from inside a job without
+ *		deadlocking even if every worker is busy.
+ *		Helper jobs which only get to run after all chunks have
+ *		been claimed return at once; the shared state is
+ *		reference counted so they may outlive this call.
+ */
+
+void
+JobScheduler::parallelFor(int count, int grainSize,
+			  std::function<void(int, int)> body)
+{
+    if (count <= 0)
+	return;
+    grainSize = qMax(1, grainSize);
+    int chunks = (count + grainSize - 1) / grainSize;
+    if (chunks == 1 || workers.isEmpty())
+    {
+	body(0, count);
+	return;
+    }
+
+    struct ForState
+    {
+	QAtomicInt next;
+	QAtomicInt finished;
+	QMutex lock;
+	QWaitCondition allDone;
+    };
+    QSharedPointer<ForState> state(new ForState);
+    state->next = 0;
+    state->finished = 0;
+
+    auto drain = [state, body, chunks, count, grainSize]()
+    {
+	int c;
+	while ((c = state->next.fetchAndAddOrdered(1)) < chunks)
+	{
+	    int begin = c * grainSize;
+	    body(begin, qMin(begin + grainSize, count));
+	    if (state->finished.fetchAndAddOrdered(1) == chunks - 1)
+	    {
+		QMutexLocker locker(&state->lock);
+		state->allDone.wakeAll();
+	    }
+	}
+    };
+
+    int helpers = qMin(chunks - 1, workers.size());
+    for (int i = 0; i < helpers; i++)
+    {
+	Job job;
+	job.token = JobTokenPtr(new JobToken(0, this));
+	job.work = [drain](JobToken &) { drain(); return QVariant(); };
+	enqueue(job, InteractivePriority);
+    }
+
+    drain();
+
+    QMutexLocker locker(&state->lock);
+    while (state->finished.loadAcquire() < chunks)
+	state->allDone.wait(&state->lock);
+}
+
+
+
+/*
+ * Name:	cancel()
+ * Purpose:	Ask a (named) job to stop.
+ * Arguments:	The job's ID.
+ * Outputs:	Nothing.
+ * Modifies:	The job's token.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Unknown or finished IDs are ignored.
+ */
+
+void
+JobScheduler::cancel(int jobID)
+{
+    QMutexLocker locker(&tokensLock);
+    JobTokenPtr token = liveTokens.value(jobID).toStrongRef();
+    if (!token.isNull())
+	token->cancel();
+}
+
+
+
+/*
+ * Name:	cancelAll()
+ * Purpose:	Ask all (named) jobs to stop.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	The jobs' tokens.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Connected to the cancel button in the status bar.
+ */
+
+void
+JobScheduler::cancelAll()
+{
+    QMutexLocker locker(&tokensLock);
+    foreach (QWeakPointer<JobToken> weak, liveTokens)
+    {
+	JobTokenPtr token = weak.toStrongRef();
+	if (!token.isNull())
+	    token->cancel();
+    }
+}
@@ -0,0 +1,147 @@
+/*
+ * File:	jobscheduler.h
+ * Author:	Jim Diamond
+ * Date:	2026-10-19
+ * Version:	1.1
+ *
+ * Purpose:	Define the JobScheduler class, a single shared pool of
+ *		worker threads which run long operations (saving,
+ *		scanning the library, generating, laying out, ...)
+ *		off the GUI thread.
+ *
+ * Notes:	Jobs are queued in one of three priority lanes.  Each
+ *		worker has its own set of lanes; an idle worker first
+ *		looks at its own lanes and then steals from the other
+ *		workers' lanes, always taking higher-priority work
+ *		first.
+ *		Cancellation is cooperative: a job is handed a
+ *		JobToken and should poll isCancelled() at convenient
+ *		points.  A job which is cancelled before it starts is
+ *		never run.
+ *		Results are handed back to the GUI thread by way of a
+ *		queued call on a "context" QObject, so the callback
+ *		is silently dropped if that object has been destroyed
+ *		in the meantime.
+ *
+ * Modification history:
+ * Oct 19, 2026 (JD V1.0)
+ *  (a) Initial version.
+ * Oct 19, 2026 (JD V1.1)
+ *  (a) Add reportBusy() and reportedBusy.
+ */
+
+#ifndef JOBSCHEDULER_H
+#define JOBSCHEDULER_H
+
+#include <QAtomicInt>
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QPointer>
+#include <QSharedPointer>
+#include <QVariant>
+#include <QVector>
+#include <QWaitCondition>
+
+#include <deque>
+#include <functional>
+
+class JobScheduler;
+
+
+class JobToken
+{
+  public:
+    JobToken(int jobID, JobScheduler * owner);
+
+    int id() const { return jobID; }
+    bool isCancelled() const { return cancelled.loadAcquire() != 0; }
+    void cancel() { cancelled.storeRelease(1); }
+    void setProgress(int percent);
+
+  private:
+    int jobID;
+    JobScheduler * scheduler;
+    QAtomicInt cancelled;
+    QAtomicInt lastPercent;
+};
+
+typedef QSharedPointer<JobToken> JobTokenPtr;
+typedef std::function<QVariant(JobToken &)> JobFunction;
+typedef std::function<void(const QVariant &)> JobResultFunction;
+
+
+
+class JobScheduler : public QObject
+{
+    Q_OBJECT
+
+  public:
+    enum Priority { InteractivePriority = 0, NormalPriority,
+		    BackgroundPriority, NumPriorities };
+
+    static JobScheduler * instance();
+
+    JobTokenPtr submit(QString name, Priority priority, JobFunction work,
+		       QObject * context = nullptr,
+		       JobResultFunction done = nullptr);
+    void parallelFor(int count, int grainSize,
+		     std::function<void(int, int)> body);
+    int workerCount() const { return workers.size(); }
+    void shutdown();
+
+  public slots:
+    void cancel(int jobID);
+    void cancelAll();
+
+  signals:
+    void jobStarted(int jobID, QString name);
+    void jobProgress(int jobID, int percent);
+    void jobFinished(int jobID, bool wasCancelled);
+    void busyChanged(bool busy);
+
+  private:
+    typedef struct
+    {
+	JobTokenPtr token;
+	QString name;		// Empty for internal (untracked) jobs.
+	JobFunction work;
+	QPointer<QObject> context;
+	JobResultFunction done;
+    } Job;
+
+    typedef struct
+    {
+	QMutex lock;
+	std::deque<Job> lanes[NumPriorities];
+    } WorkerQueue;
+
+    class Worker;
+    friend class Worker;
+    friend class JobToken;
+
+    explicit JobScheduler(QObject * parent);
+    ~JobScheduler();
+
+    void enqueue(Job job, Priority priority);
+    bool takeJob(int self, Job * job);
+    void runJob(Job & job);
+    void reportBusy();
+
+    QVector<Worker *> workers;
+    QVector<WorkerQueue *> queues;
+
+    QMutex idleLock;
+    QWaitCondition workAvailable;
+    bool stopping;
+    QAtomicInt pendingJobs;
+    QAtomicInt trackedJobs;
+    bool reportedBusy;		// GUI thread only; see reportBusy().
+    QAtomicInt nextQueue;
+
+    QMutex tokensLock;
+    QHash<int, QWeakPointer<JobToken>> liveTokens;
+    QAtomicInt nextJobID;
+};
+
+#endif // JOBSCHEDULER_H
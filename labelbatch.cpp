@@ -0,0 +1,170 @@
+/*
+ * File:	labelbatch.cpp
+ * Author:	Jim Diamond
+ * Date:	2026-10-19
+ * Version:	1.1
+ *
+ * Purpose:	Implement the bulk label pipeline used by the loaders
+ *		and the (re)stylers.
+ *
+ * Modification history:
+ * Oct 19, 2026 (JD V1.0)
+ *  (a) Initial version.
+ * Oct 19, 2026 (JD V1.1)
+ *  (a) apply() remembers converted labels in htmlCache and only
+ *	converts the ones it hasn't seen.
+ */
+
+#include "labelbatch.h"
+#include "defuns.h"
+#include "edge.h"
+#include "html-label.h"
+#include "jobscheduler.h"
+#include "node.h"
+
+// Labels are short, so hand them to the workers in lumps big enough
+// to be worth the trip.
+#define LABEL_GRAIN_SIZE    64
+
+// The most converted labels to remember.  When the cache fills up it
+// is simply emptied; a batch of new labels will soon refill it.
+#define HTML_CACHE_SIZE	    8192
+
+QHash<QString, QString> LabelBatch::htmlCache;
+
+
+
+/*
+ * Name:	add()
+ * Purpose:	Remember that a node is to get a new label.
+ * Arguments:	The node and its new (TeX-ish) label.
+ * Outputs:	Nothing.
+ * Modifies:	This batch.
+ * Returns:	Nothing.
+ * Assumptions:	node is valid.
+ * Bugs:	None known.
+ * Notes:	Nothing happens to the node until apply() is called.
+ */
+
+void
+LabelBatch::add(Node * node, QString label)
+{
+    items.append(node);
+    labels.append(label);
+}
+
+
+
+/*
+ * Name:	add()
+ * Purpose:	Remember that an edge is to get a new label.
+ * Arguments:	The edge and its new (TeX-ish) label.
+ * Outputs:	Nothing.
+ * Modifies:	This batch.
+ * Returns:	Nothing.
+ * Assumptions:	edge is valid.
+ * Bugs:	None known.
+ * Notes:	Nothing happens to the edge until apply() is called.
+ */
+
+void
+LabelBatch::add(Edge * edge, QString label)
+{
+    items.append(edge);
+    labels.append(label);
+}
+
+
+
+/*
+ * Name:	apply()
+ * Purpose:	Convert all the collected labels to HTML and then set
+ *		them on their items.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	The labels of all items in the batch; empties the batch.
+ * Returns:	Nothing.
+ * Assumptions:	Called on the GUI thread.
+ * Bugs:	None known.
+ * Notes:	Labels found in htmlCache are not converted again.
+ *		The rest are converted on the job scheduler's workers
+ *		(and this thread); small batches are simply done here.
+ *		The cache is only touched here, before and after the
+ *		parallel part, so it needs no lock.
+ *		The end result is the same as calling setNodeLabel() /
+ *		setEdgeLabel() on each item in turn.
+ */
+
+void
+LabelBatch::apply()
+{
+    int n = items.count();
+    QVector<QString> html(n);
+    QVector<int> misses;
+
+    for (int i = 0; i < n; i++)
+    {
+	QHash<QString, QString>::const_iterator it
+	    = htmlCache.constFind(labels.at(i));
+	if (it != htmlCache.constEnd())
+	    html[i] = it.value();
+	else
+	    misses.append(i);
+    }
+
+    qDebu("LabelBatch::apply(): converting %d of %d labels",
+	  misses.count(), n);
+
+    JobScheduler::instance()->parallelFor(
+	misses.count(), LABEL_GRAIN_SIZE,
+	[this, &html, &misses](int begin, int end)
+	{
+	    for (int k = begin; k < end; k++)
+		html[misses.at(k)]
+		    = HTML_Label::strToHtml(labels.at(misses.at(k)));
+	});
+
+    if (htmlCache.count() + misses.count() > HTML_CACHE_SIZE)
+	htmlCache.clear();
+    foreach (int i, misses)
+    {
+	if (htmlCache.count() >= HTML_CACHE_SIZE)
+	    break;
+	htmlCache.insert(labels.at(i), html.at(i));
+    }
+
+    for (int i = 0; i < n; i++)
+    {
+	QGraphicsItem * item = items.at(i);
+	if (item->type() == Node::Type)
+	    qgraphicsitem_cast<Node *>(item)->setNodeLabelHtml(labels.at(i),
+							       html.at(i));
+	else if (item->type() == Edge::Type)
+	    qgraphicsitem_cast<Edge *>(item)->setEdgeLabelHtml(labels.at(i),
+							       html.at(i));
+    }
+
+    items.clear();
+    labels.clear();
+}
+
+
+
+/*
+ * Name:	subscripted()
+ * Purpose:	Build a label with a numeric subscript.
+ * Arguments:	The label text and the subscript.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The label.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Must give the same result as Node::setNodeLabel(QString, int)
+ *		and Edge::setEdgeLabel(QString, int).
+ */
+
+QString
+LabelBatch::subscripted(QString aLabel, int number)
+{
+    return aLabel + "_{" + QString::number(number) + "}";
+}
@@ -0,0 +1,56 @@
+/*
+ * File:	labelbatch.h
+ * Author:	Jim Diamond
+ * Date:	2026-10-19
+ * Version:	1.1
+ *
+ * Purpose:	Define the LabelBatch class, which collects the new
+ *		labels for many nodes and edges, converts them all to
+ *		HTML on the worker threads, and then attaches the
+ *		results to the items on the GUI thread.
+ *
+ * Notes:	HTML_Label::strToHtml() is a pure string function, so
+ *		it is safe to run concurrently.  Only setHtml() (via
+ *		Node::setNodeLabelHtml() and Edge::setEdgeLabelHtml())
+ *		has to happen on the GUI thread.
+ *		Items must not be deleted between add() and apply().
+ *		Converted labels are remembered (up to a limit) from
+ *		one batch to the next, since the same few labels
+ *		("1", "v_{1}", ...) come up over and over.
+ *
+ * Modification history:
+ * Oct 19, 2026 (JD V1.0)
+ *  (a) Initial version.
+ * Oct 19, 2026 (JD V1.1)
+ *  (a) Add htmlCache.
+ */
+
+#ifndef LABELBATCH_H
+#define LABELBATCH_H
+
+#include <QGraphicsItem>
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+class Node;
+class Edge;
+
+class LabelBatch
+{
+  public:
+    void add(Node * node, QString label);
+    void add(Edge * edge, QString label);
+    int count() const { return items.count(); }
+    void apply();
+
+    static QString subscripted(QString aLabel, int number);
+
+  private:
+    QVector<QGraphicsItem *> items;
+    QVector<QString> labels;
+
+    static QHash<QString, QString> htmlCache;	// Label -> HTML.
+};
+
+#endif // LABELBATCH_H
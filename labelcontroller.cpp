@@ -2,7 +2,7 @@
  * File:    labelcontroller.cpp
  * Author:  Rachel Bood
  * Date:    2014/11/07 (?)
- * Version: 1.8
+ * Version: 1.10
  *
  * Purpose: ?
  *
@@ -30,36 +30,35 @@
  *  (a) If an edge's or node's label already has focus when the
  *	label controller is instantiated, set the corresponding edit
  *	tab label bold.
+ * Oct 19, 2026 (JD V1.9)
+ *  (a) The node/edge label is now the single source of truth, and
+ *	the two directions no longer feed each other.  Keystrokes in
+ *	the line edit (textEdited(), which setText() doesn't emit)
+ *	are collected and applied once, LABEL_EDIT_DELAY ms after the
+ *	last one (or when the edit is finished), via a LabelBatch so
+ *	that labels seen before aren't converted to HTML again.
+ *	Changes to the label document which we didn't make ourselves
+ *	(editing on the canvas, restyling, ...) are copied to the line
+ *	edit the same way, and only if the text actually differs and
+ *	the user isn't typing in it.
+ *  (b) Initialize both the node and edge pointers.
+ *  (c) Delete the controller when its line edit is deleted (e.g.,
+ *	when the edit tab is rebuilt), not only when the item is.
+ * Oct 19, 2026 (JD V1.10)
+ *  (a) Tell the session recorder about label edits.
  */
 
 
+#include "labelbatch.h"
 #include "labelcontroller.h"
+#include "sessionrecorder.h"
 
 LabelController::LabelController(Edge * anEdge, QLineEdit * anEdit)
 {
     edit = anEdit;
     edge = anEdge;
-
-    if (edit != nullptr || edit != 0)
-    {
-        edit->setText(edge->getLabel());
-
-        if (edge->htmlLabel->hasFocus())
-        {
-            QFont font = edit->font();
-            font.setBold(true);
-            edit->setFont(font);
-        }
-
-        connect(edit, SIGNAL(textChanged(QString)),
-                this, SLOT(setEdgeLabel(QString)));
-        connect(edge->htmlLabel->document(), SIGNAL(contentsChanged()),
-                this, SLOT(setEdgeEditLabel()));
-        connect(anEdge, SIGNAL(destroyed(QObject*)),
-                this, SLOT(deletedLineEdit()));
-        connect(anEdge, SIGNAL(destroyed(QObject*)),
-                this, SLOT(deleteLater()));
-    }
+    node = nullptr;
+    setUp();
 }
 
 
@@ -67,68 +66,205 @@ LabelController::LabelController(Edge * anEdge, QLineEdit * anEdit)
 LabelController::LabelController(Node * aNode, QLineEdit * anEdit)
 {
     node = aNode;
+    edge = nullptr;
     edit = anEdit;
+    setUp();
+}
+
+
+
+/*
+ * Name:        setUp()
+ * Purpose:     Initialize the line edit and connect it and the
+ *              node's/edge's label to this controller.
+ * Arguments:   None.
+ * Outputs:     Nothing.
+ * Modifies:    The line edit and this controller.
+ * Returns:     Nothing.
+ * Assumptions: Exactly one of node and edge is non-null.
+ * Bugs:        None known.
+ * Notes:       Common code for the two constructors.
+ */
+
+void
+LabelController::setUp()
+{
+    applying = false;
+    applyTimer.setSingleShot(true);
+    applyTimer.setInterval(LABEL_EDIT_DELAY);
+    refreshTimer.setSingleShot(true);
+    refreshTimer.setInterval(LABEL_EDIT_DELAY);
+    connect(&applyTimer, SIGNAL(timeout()), this, SLOT(applyLineEdit()));
+    connect(&refreshTimer, SIGNAL(timeout()), this, SLOT(refreshLineEdit()));
 
-    if (edit != nullptr || edit != 0)
+    if (edit == nullptr)
+        return;
+
+    edit->setText(getLabel());
+
+    if (htmlLabel()->hasFocus())
     {
-        edit->setText(node->getLabel());
-
-        if (node->htmlLabel->hasFocus())
-        {
-            QFont font = edit->font();
-            font.setBold(true);
-            edit->setFont(font);
-        }
-
-        connect(edit, SIGNAL(textChanged(QString)),
-                this, SLOT(setNodeLabel(QString)));
-        connect(node->htmlLabel->document(), SIGNAL(contentsChanged()),
-                this, SLOT(setNodeEditLabel()));
-        connect(aNode, SIGNAL(destroyed(QObject*)),
-                this, SLOT(deletedLineEdit()));
-        connect(aNode, SIGNAL(destroyed(QObject*)),
-                this, SLOT(deleteLater()));
+        QFont font = edit->font();
+        font.setBold(true);
+        edit->setFont(font);
     }
+
+    QObject * item = node != nullptr ? (QObject *)node : (QObject *)edge;
+    connect(edit, SIGNAL(textEdited(QString)),
+            this, SLOT(lineEditChanged(QString)));
+    connect(edit, SIGNAL(editingFinished()),
+            this, SLOT(applyLineEdit()));
+    connect(htmlLabel()->document(), SIGNAL(contentsChanged()),
+            this, SLOT(labelChanged()));
+    connect(item, SIGNAL(destroyed(QObject*)),
+            this, SLOT(deletedLineEdit()));
+    connect(item, SIGNAL(destroyed(QObject*)),
+            this, SLOT(deleteLater()));
+    connect(edit, SIGNAL(destroyed(QObject*)),
+            this, SLOT(deleteLater()));
 }
 
 
 
+/*
+ * Name:        lineEditChanged()
+ * Purpose:     Note that the user typed in the line edit.
+ * Arguments:   The new text.
+ * Outputs:     Nothing.
+ * Modifies:    pending, applyTimer.
+ * Returns:     Nothing.
+ * Assumptions: Only connected to textEdited(), so this is never
+ *              called because of refreshLineEdit().
+ * Bugs:        None known.
+ * Notes:       The label itself is changed by applyLineEdit() once
+ *              the user pauses (for one frame or so), so a burst of
+ *              keystrokes costs one HTML conversion and relayout.
+ */
+
 void
-LabelController::setEdgeLabel(QString string)
+LabelController::lineEditChanged(QString string)
 {
-    if (edge != nullptr || edge != 0)
-        if (edit->hasFocus())
-            edge->setEdgeLabel(string);
+    pending = string;
+    applyTimer.start();
 }
 
 
+
+/*
+ * Name:        applyLineEdit()
+ * Purpose:     Set the node's/edge's label to the text typed in the
+ *              line edit.
+ * Arguments:   None.
+ * Outputs:     Nothing.
+ * Modifies:    The node's/edge's label.
+ * Returns:     Nothing.
+ * Assumptions: None.
+ * Bugs:        None known.
+ * Notes:       Does nothing if nothing was typed since the last
+ *              call, or if the text is already the label.
+ */
+
 void
-LabelController::setNodeLabel(QString string)
+LabelController::applyLineEdit()
 {
-    if (node != nullptr || node != 0)
-        if (edit->hasFocus())
-            node->setNodeLabel(string);
+    applyTimer.stop();
+    if (edit == nullptr || ! edit->isModified())
+        return;
+    edit->setModified(false);
+
+    if (pending == getLabel())
+        return;
+
+    LabelBatch batch;
+    if (node != nullptr)
+        batch.add(node, pending);
+    else
+        batch.add(edge, pending);
+
+    applying = true;
+    batch.apply();
+    applying = false;
+    SessionRecorder::styleChanged(QList<QGraphicsItem *>()
+                                  << (node != nullptr ? (QGraphicsItem *)node
+                                      : (QGraphicsItem *)edge),
+                                  "label");
 }
 
 
+
+/*
+ * Name:        labelChanged()
+ * Purpose:     Note that the label document changed.
+ * Arguments:   None.
+ * Outputs:     Nothing.
+ * Modifies:    refreshTimer.
+ * Returns:     Nothing.
+ * Assumptions: None.
+ * Bugs:        None known.
+ * Notes:       Changes made by applyLineEdit() are ignored; the line
+ *              edit already shows them.
+ */
+
 void
-LabelController::setEdgeEditLabel()
+LabelController::labelChanged()
 {
-    if (edge->htmlLabel->hasFocus())
-        edit->setText(edge->htmlLabel->toPlainText());
+    if (! applying)
+        refreshTimer.start();
 }
 
 
+
+/*
+ * Name:        refreshLineEdit()
+ * Purpose:     Show the node's/edge's current label in the line edit.
+ * Arguments:   None.
+ * Outputs:     The label text to the line edit.
+ * Modifies:    The line edit.
+ * Returns:     Nothing.
+ * Assumptions: None.
+ * Bugs:        None known.
+ * Notes:       While the label is being edited on the canvas the
+ *              document's plain text is what the user sees, so show
+ *              that.  Leave the line edit alone while the user is
+ *              typing in it (it is the newer text), and don't call
+ *              setText() when nothing changed, since that moves the
+ *              cursor.
+ */
+
 void
-LabelController::setNodeEditLabel()
+LabelController::refreshLineEdit()
 {
-    if (node->htmlLabel->hasFocus())
-        edit->setText(node->htmlLabel->toPlainText());
+    if (edit == nullptr || edit->hasFocus())
+        return;
+
+    QString text = htmlLabel()->hasFocus()
+        ? htmlLabel()->toPlainText() : getLabel();
+    if (edit->text() != text)
+        edit->setText(text);
 }
 
 
+
 void
 LabelController::deletedLineEdit()
 {
-    delete edit;
+    applyTimer.stop();
+    refreshTimer.stop();
+    delete edit.data();
+}
+
+
+
+QString
+LabelController::getLabel()
+{
+    return node != nullptr ? node->getLabel() : edge->getLabel();
+}
+
+
+
+HTML_Label *
+LabelController::htmlLabel()
+{
+    return node != nullptr ? node->htmlLabel : edge->htmlLabel;
 }
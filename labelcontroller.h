@@ -2,7 +2,7 @@
  * File:    labelcontroller.h
  * Author:  Rachel Bood
  * Date:    2014/11/07 (?)
- * Version: 1.5
+ * Version: 1.6
  *
  * Purpose: 
  *
@@ -18,6 +18,13 @@
  *   (a) Rename two functions.
  *  Jul 14, 2020 (IC, V1.5)
  *   (a) Update ...EditLabel slot names to more meaningful values.
+ *  Oct 19, 2026 (JD, V1.6)
+ *   (a) Replace the slots with a debounced pipeline: keystrokes in the
+ *       line edit are applied to the node/edge at most once per
+ *       LABEL_EDIT_DELAY ms, and changes on the canvas are copied
+ *       back to the line edit the same way, without either side
+ *       triggering the other.
+ *   (b) Go away when the line edit does.
  */
 
 
@@ -28,6 +35,12 @@
 
 #include <QLineEdit>
 #include <QObject>
+#include <QPointer>
+#include <QTimer>
+
+// How long (in ms) to wait for more keystrokes before applying a
+// label; about one frame.
+#define LABEL_EDIT_DELAY    16
 
 class LabelController: public QObject
 {
@@ -37,16 +50,24 @@ public:
     LabelController(Node * aNode, QLineEdit * anEdit);
 
 private slots:
-    void setEdgeLabel(QString string);
-    void setEdgeEditLabel();
-    void setNodeLabel(QString string);
-    void setNodeEditLabel();
+    void lineEditChanged(QString string);
+    void applyLineEdit();
+    void labelChanged();
+    void refreshLineEdit();
     void deletedLineEdit();
 
 private:
+    void setUp();
+    QString getLabel();
+    HTML_Label * htmlLabel();
+
     Edge * edge;
     Node * node;
-    QLineEdit * edit;
+    QPointer<QLineEdit> edit;   // Null once the edit tab is cleared.
+    QString pending;            // Text typed but not yet applied.
+    bool applying;              // We are the ones changing the label.
+    QTimer applyTimer;
+    QTimer refreshTimer;
 };
 
 #endif // LABELCONTROLLER_H
@@ -0,0 +1,339 @@
+/*
+ * File:	labelindex.cpp
+ * Author:	Jim Diamond
+ * Date:	2026-10-19
+ * Version:	1.1
+ *
+ * Purpose:	Implement the LabelIndex class (see labelindex.h).
+ *
+ * Modification history:
+ * Oct 19, 2026 (JD V1.0)
+ *  (a) Initial version.
+ * Oct 19, 2026 (JD V1.1)
+ *  (a) byLabel holds a QSet per label, so remove() no longer
+ *	searches a list of every item with the label.
+ *  (b) Only items in the canvas scene are put in the lookups; add
+ *	sceneChanged() and onCanvas().
+ */
+
+#include "labelindex.h"
+#include "canvasscene.h"
+
+#include <QGraphicsObject>
+
+QHash<QObject *, LabelIndex::Entry> LabelIndex::entries;
+QHash<QString, QSet<QObject *>> LabelIndex::byLabel;
+QVector<LabelIndex::TrieNode> LabelIndex::trie;
+
+
+
+/*
+ * Name:	setLabel()
+ * Purpose:	Record the (new) label of a node or edge.
+ * Arguments:	The item and its label.
+ * Outputs:	Nothing.
+ * Modifies:	The index.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Setting an empty label takes the item out of the
+ *		lookups, but it stays in "entries" so that it is only
+ *		ever connected to once.
+ *		An item which isn't on the canvas only has its label
+ *		remembered.
+ */
+
+void
+LabelIndex::setLabel(QGraphicsObject * item, QString label)
+{
+    QObject * key = item;
+    QHash<QObject *, Entry>::iterator it = entries.find(key);
+
+    if (it == entries.end())
+    {
+	if (label.isEmpty())
+	    return;
+	Entry entry;
+	entry.item = item;
+	entry.label = label;
+	entry.indexed = onCanvas(item);
+	entries.insert(key, entry);
+	QObject::connect(item, &QObject::destroyed, &LabelIndex::forget);
+	if (entry.indexed)
+	    insert(key, label);
+	return;
+    }
+
+    if (it->label == label)
+	return;
+    if (it->indexed && !it->label.isEmpty())
+	remove(key, it->label);
+    it->label = label;
+    if (it->indexed && !label.isEmpty())
+	insert(key, label);
+}
+
+
+
+/*
+ * Name:	sceneChanged()
+ * Purpose:	Put an item in the lookups, or take it out, when it
+ *		joins or leaves the canvas.
+ * Arguments:	The item.
+ * Outputs:	Nothing.
+ * Modifies:	The index.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Called for every node and edge which changes scene,
+ *		so it does nothing for items which have never had a
+ *		label.
+ */
+
+void
+LabelIndex::sceneChanged(QGraphicsObject * item)
+{
+    QObject * key = item;
+    QHash<QObject *, Entry>::iterator it = entries.find(key);
+
+    if (it == entries.end())
+	return;
+
+    bool indexed = onCanvas(item);
+    if (indexed == it->indexed)
+	return;
+    it->indexed = indexed;
+    if (it->label.isEmpty())
+	return;
+    if (indexed)
+	insert(key, it->label);
+    else
+	remove(key, it->label);
+}
+
+
+
+/*
+ * Name:	find()
+ * Purpose:	Find the items with a given label.
+ * Arguments:	The label.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The items, in no particular order.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+QList<QGraphicsObject *>
+LabelIndex::find(QString label)
+{
+    QList<QGraphicsObject *> found;
+
+    foreach (QObject * key, byLabel.value(label))
+	found.append(entries.value(key).item);
+    return found;
+}
+
+
+
+/*
+ * Name:	findPrefix()
+ * Purpose:	Find the items whose labels start with a given string.
+ * Arguments:	The start of the label, and the most items to return.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	Up to "limit" items, in order of their labels.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	The time taken depends on the length of the prefix and
+ *		on the number of items returned, not on the size of the
+ *		index, since empty branches of the trie are skipped.
+ */
+
+QList<QGraphicsObject *>
+LabelIndex::findPrefix(QString prefix, int limit)
+{
+    QList<QGraphicsObject *> found;
+
+    if (trie.isEmpty())
+	return found;
+
+    int n = 0;
+    for (int i = 0; i < prefix.length(); i++)
+    {
+	n = trie.at(n).children.value(prefix.at(i), -1);
+	if (n < 0)
+	    return found;
+    }
+
+    collect(n, prefix, limit, &found);
+    return found;
+}
+
+
+
+/*
+ * Name:	collect()
+ * Purpose:	Gather the items in one branch of the trie.
+ * Arguments:	The trie node, the label it stands for, the most
+ *		items wanted and the list to append them to.
+ * Outputs:	Nothing.
+ * Modifies:	*found.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Shorter labels come before longer ones, and children
+ *		are visited in character order.
+ */
+
+void
+LabelIndex::collect(int trieNode, QString label, int limit,
+		    QList<QGraphicsObject *> * found)
+{
+    const TrieNode & node = trie.at(trieNode);
+
+    if (found->count() >= limit || node.below == 0)
+	return;
+
+    if (node.here > 0)
+    {
+	foreach (QObject * key, byLabel.value(label))
+	{
+	    if (found->count() >= limit)
+		return;
+	    found->append(entries.value(key).item);
+	}
+    }
+
+    QMap<QChar, int>::const_iterator it;
+    for (it = node.children.constBegin(); it != node.children.constEnd(); ++it)
+	collect(it.value(), label + it.key(), limit, found);
+}
+
+
+
+/*
+ * Name:	insert()
+ * Purpose:	Add an item to the hash and the trie.
+ * Arguments:	The item's key and its (non-empty) label.
+ * Outputs:	Nothing.
+ * Modifies:	byLabel and trie.
+ * Returns:	Nothing.
+ * Assumptions:	The item isn't already in under this label.
+ * Bugs:	None known.
+ * Notes:	Uses indices rather than references into the trie,
+ *		since appending may move it.
+ */
+
+void
+LabelIndex::insert(QObject * key, QString label)
+{
+    byLabel[label].insert(key);
+
+    if (trie.isEmpty())
+    {
+	TrieNode root;
+	root.here = root.below = 0;
+	trie.append(root);
+    }
+
+    int n = 0;
+    trie[n].below++;
+    for (int i = 0; i < label.length(); i++)
+    {
+	int child = trie.at(n).children.value(label.at(i), -1);
+	if (child < 0)
+	{
+	    TrieNode node;
+	    node.here = node.below = 0;
+	    trie.append(node);
+	    child = trie.count() - 1;
+	    trie[n].children.insert(label.at(i), child);
+	}
+	n = child;
+	trie[n].below++;
+    }
+    trie[n].here++;
+}
+
+
+
+/*
+ * Name:	remove()
+ * Purpose:	Take an item out of the hash and the trie.
+ * Arguments:	The item's key and its (non-empty) label.
+ * Outputs:	Nothing.
+ * Modifies:	byLabel and trie.
+ * Returns:	Nothing.
+ * Assumptions:	The item is in under this label.
+ * Bugs:	Trie nodes are never freed, only emptied, so the trie
+ *		holds every label ever used.  They are reused if the
+ *		label comes back.
+ * Notes:	None.
+ */
+
+void
+LabelIndex::remove(QObject * key, QString label)
+{
+    QHash<QString, QSet<QObject *>>::iterator it = byLabel.find(label);
+    it->remove(key);
+    if (it->isEmpty())
+	byLabel.erase(it);
+
+    int n = 0;
+    trie[n].below--;
+    for (int i = 0; i < label.length(); i++)
+    {
+	n = trie.at(n).children.value(label.at(i));
+	trie[n].below--;
+    }
+    trie[n].here--;
+}
+
+
+
+/*
+ * Name:	forget()
+ * Purpose:	Drop a destroyed item from the index.
+ * Arguments:	The item, as a QObject.
+ * Outputs:	Nothing.
+ * Modifies:	The index.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Connected to QObject::destroyed(), by which time the
+ *		item is no longer a Node or Edge, so it is only used
+ *		as a key.
+ */
+
+void
+LabelIndex::forget(QObject * key)
+{
+    if (!entries.contains(key))
+	return;
+
+    Entry entry = entries.take(key);
+    if (entry.indexed && !entry.label.isEmpty())
+	remove(key, entry.label);
+}
+
+
+
+/*
+ * Name:	onCanvas()
+ * Purpose:	Tell whether an item belongs in the lookups.
+ * Arguments:	The item.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	True iff the item is in a CanvasScene.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+bool
+LabelIndex::onCanvas(QGraphicsObject * item)
+{
+    return qobject_cast<CanvasScene *>(item->scene()) != nullptr;
+}
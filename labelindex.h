@@ -0,0 +1,83 @@
+/*
+ * File:	labelindex.h
+ * Author:	Jim Diamond
+ * Date:	2026-10-19
+ * Version:	1.1
+ *
+ * Purpose:	Define the LabelIndex class, an index of the labels of
+ *		all nodes and edges, for finding items by label.
+ *
+ * Notes:	There is a hash from each label to the items which have
+ *		it, for exact lookups, and a prefix trie over the labels,
+ *		for search-as-you-type.  Both are kept up to date by
+ *		Node::setNodeLabel() and Edge::setEdgeLabel() (and their
+ *		...Html() variants), and an item is dropped from the
+ *		index when it is destroyed.
+ *		Only items in the canvas scene are in the lookups: the
+ *		labels of other items (e.g., those in the preview, or
+ *		collapsed into a meta-node) are remembered, and the
+ *		items are put in the lookups when they join the canvas
+ *		(see sceneChanged(), which Node::itemChange() and
+ *		Edge::itemChange() call).
+ *		Lookups are case-sensitive, as labels are TeX.
+ *		Only to be used from the GUI thread.
+ *
+ * Modification history:
+ * Oct 19, 2026 (JD V1.0)
+ *  (a) Initial version.
+ * Oct 19, 2026 (JD V1.1)
+ *  (a) Keep a QSet of items per label, so that remove() is O(1).
+ *  (b) Add sceneChanged() and Entry.indexed: only canvas items are
+ *	in the lookups.
+ */
+
+#ifndef LABELINDEX_H
+#define LABELINDEX_H
+
+#include <QChar>
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+class QGraphicsObject;
+class QObject;
+
+class LabelIndex
+{
+  public:
+    static void setLabel(QGraphicsObject * item, QString label);
+    static void sceneChanged(QGraphicsObject * item);
+    static QList<QGraphicsObject *> find(QString label);
+    static QList<QGraphicsObject *> findPrefix(QString prefix, int limit);
+
+  private:
+    typedef struct
+    {
+	QGraphicsObject * item;
+	QString label;
+	bool indexed;			// In byLabel and trie?
+    } Entry;
+
+    typedef struct
+    {
+	QMap<QChar, int> children;	// Indices into trie.
+	int here;			// Items with exactly this label.
+	int below;			// Items with this label or longer.
+    } TrieNode;
+
+    static void insert(QObject * key, QString label);
+    static void remove(QObject * key, QString label);
+    static void forget(QObject * key);
+    static bool onCanvas(QGraphicsObject * item);
+    static void collect(int trieNode, QString label, int limit,
+			QList<QGraphicsObject *> * found);
+
+    static QHash<QObject *, Entry> entries;
+    static QHash<QString, QSet<QObject *>> byLabel;
+    static QVector<TrieNode> trie;
+};
+
+#endif // LABELINDEX_H
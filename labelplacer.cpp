@@ -0,0 +1,252 @@
+/*
+ * File:	labelplacer.cpp
+ * Author:	Jim Diamond
+ * Date:	2026-10-19
+ * Version:	1.2
+ *
+ * Purpose:	Implement the LabelPlacer class (see labelplacer.h).
+ *
+ * Modification history:
+ * Oct 19, 2026 (JD V1.0)
+ *  (a) Initial version.
+ * Oct 19, 2026 (JD V1.1)
+ *  (a) Use RectGrid (see rectgrid.h) rather than a private grid.
+ * Oct 19, 2026 (JD V1.2)
+ *  (a) placeNear() keeps the edges in the order it found them,
+ *	rather than in QSet order, and place() sorts them with
+ *	std::stable_sort(), so that the same move always gives the
+ *	same placements.
+ */
+
+#include "labelplacer.h"
+#include "edge.h"
+#include "html-label.h"
+#include "node.h"
+#include "rectgrid.h"
+
+#include <QGraphicsScene>
+#include <QSet>
+
+#include <algorithm>
+
+// The size (in pixels) of a square of the overlap grid.
+#define GRID_CELL_SIZE	50
+
+// What a candidate costs for each step away from the preferred
+// placement, in square pixels of overlap.  Small, so it only breaks ties.
+#define RANK_PENALTY	0.01
+
+// The candidate places, in order of preference.
+static const qreal candidatePos[] = { 0.5, 0.35, 0.65, 0.2, 0.8 };
+static const int candidateSide[] = { 0, 1, -1 };
+
+bool LabelPlacer::enabled = false;
+
+
+
+/*
+ * Name:	placeAll()
+ * Purpose:	Place every edge label on the canvas.
+ * Arguments:	The scene.
+ * Outputs:	Nothing.
+ * Modifies:	The label placement of every labelled edge.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Unlabelled edges are left alone.
+ */
+
+void
+LabelPlacer::placeAll(QGraphicsScene * scene)
+{
+    RectGrid grid(GRID_CELL_SIZE);
+    QList<Edge *> edges;
+
+    foreach (QGraphicsItem * item, scene->items())
+    {
+	if (item->type() == Node::Type)
+	    grid.insert(item->sceneBoundingRect());
+	else if (item->type() == Edge::Type)
+	{
+	    Edge * edge = qgraphicsitem_cast<Edge *>(item);
+	    if (!edge->getLabel().isEmpty())
+		edges.append(edge);
+	}
+    }
+
+    place(edges, &grid);
+}
+
+
+
+/*
+ * Name:	placeNear()
+ * Purpose:	Re-place the edge labels affected by moving some nodes.
+ * Arguments:	The nodes which moved.
+ * Outputs:	Nothing.
+ * Modifies:	The label placement of the nodes' labelled edges and
+ *		of any edge whose label the nodes now cover.
+ * Returns:	Nothing.
+ * Assumptions:	The nodes are all in the same scene.
+ * Bugs:	A label may be moved onto one which is outside the area
+ *		looked at, but only if that label is a long way from
+ *		its own edge.
+ * Notes:	Only the items near the edges being re-placed are put
+ *		in the grid.
+ *		The edges are listed in the order of the nodes and of
+ *		their edgeLists, then of the scene's items, so that
+ *		equally long edges are always placed in the same order.
+ */
+
+void
+LabelPlacer::placeNear(QList<Node *> nodes)
+{
+    if (nodes.isEmpty() || nodes.first()->scene() == nullptr)
+	return;
+
+    QGraphicsScene * scene = nodes.first()->scene();
+    QSet<Edge *> moving;
+    QList<Edge *> movingInOrder;
+    QRectF moved;
+
+    foreach (Node * node, nodes)
+    {
+	moved |= node->sceneBoundingRect();
+	foreach (Edge * edge, node->edgeList)
+	{
+	    if (!edge->getLabel().isEmpty() && !moving.contains(edge))
+	    {
+		moving.insert(edge);
+		movingInOrder.append(edge);
+	    }
+	}
+    }
+
+    // Labels which the nodes have been dropped on have to move too.
+    foreach (QGraphicsItem * item, scene->items(moved))
+    {
+	if (item->type() == HTML_Label::Type && item->parentItem() != nullptr
+	    && item->parentItem()->type() == Edge::Type)
+	{
+	    Edge * edge = qgraphicsitem_cast<Edge *>(item->parentItem());
+	    if (!edge->getLabel().isEmpty() && !moving.contains(edge))
+	    {
+		moving.insert(edge);
+		movingInOrder.append(edge);
+	    }
+	}
+    }
+    if (moving.isEmpty())
+	return;
+
+    // Everything which any candidate of these edges could overlap.
+    QRectF area;
+    foreach (Edge * edge, movingInOrder)
+    {
+	QLineF line = edge->getLine();
+	QRectF box = edge->htmlLabel->boundingRect();
+	area |= edge->mapRectToScene(QRectF(line.p1(), line.p2()).normalized()
+				     .adjusted(-box.width(), -box.height(),
+					       box.width(), box.height()));
+    }
+
+    RectGrid grid(GRID_CELL_SIZE);
+    foreach (QGraphicsItem * item, scene->items(area))
+    {
+	if (item->type() == Node::Type)
+	    grid.insert(item->sceneBoundingRect());
+	else if (item->type() == HTML_Label::Type
+		 && item->parentItem() != nullptr
+		 && item->parentItem()->type() == Edge::Type
+		 && !moving.contains(qgraphicsitem_cast<Edge *>
+				     (item->parentItem())))
+	    grid.insert(item->sceneBoundingRect());
+    }
+
+    place(movingInOrder, &grid);
+}
+
+
+
+/*
+ * Name:	resetAll()
+ * Purpose:	Put every edge label back in the middle of its edge.
+ * Arguments:	The scene.
+ * Outputs:	Nothing.
+ * Modifies:	The label placement of every edge.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+void
+LabelPlacer::resetAll(QGraphicsScene * scene)
+{
+    foreach (QGraphicsItem * item, scene->items())
+    {
+	if (item->type() == Edge::Type)
+	    qgraphicsitem_cast<Edge *>(item)->setLabelPlacement(0.5, 0);
+    }
+}
+
+
+
+/*
+ * Name:	place()
+ * Purpose:	Greedily place some edge labels.
+ * Arguments:	The edges and a grid holding what the labels should
+ *		stay off.
+ * Outputs:	Nothing.
+ * Modifies:	The edges' label placements, and *grid, which gets each
+ *		label as it is placed.
+ * Returns:	Nothing.
+ * Assumptions:	The edges have labels.
+ * Bugs:	None known.
+ * Notes:	Short edges go first, since they have the least room;
+ *		the sort is stable, so equally long edges keep the
+ *		caller's order.  The search for an edge stops at the first candidate
+ *		which overlaps nothing.
+ */
+
+void
+LabelPlacer::place(QList<Edge *> edges, RectGrid * grid)
+{
+    std::stable_sort(edges.begin(), edges.end(), [](Edge * a, Edge * b) {
+	return a->getLine().length() < b->getLine().length();
+    });
+
+    foreach (Edge * edge, edges)
+    {
+	qreal bestCost = -1;
+	qreal bestPos = 0.5;
+	int bestSide = 0;
+	QRectF bestRect;
+	int rank = 0;
+	bool clear = false;
+
+	for (unsigned p = 0;
+	     p < sizeof(candidatePos) / sizeof(qreal) && !clear; p++)
+	{
+	    for (unsigned s = 0;
+		 s < sizeof(candidateSide) / sizeof(int) && !clear; s++)
+	    {
+		QRectF r = edge->mapRectToScene(
+		    edge->labelRect(candidatePos[p], candidateSide[s]));
+		qreal overlap = grid->overlap(r);
+		qreal cost = overlap + rank++ * RANK_PENALTY;
+		if (bestCost < 0 || cost < bestCost)
+		{
+		    bestCost = cost;
+		    bestPos = candidatePos[p];
+		    bestSide = candidateSide[s];
+		    bestRect = r;
+		}
+		clear = overlap == 0;
+	    }
+	}
+
+	edge->setLabelPlacement(bestPos, bestSide);
+	grid->insert(bestRect);
+    }
+}
@@ -0,0 +1,57 @@
+/*
+ * File:	labelplacer.h
+ * Author:	Jim Diamond
+ * Date:	2026-10-19
+ * Version:	1.1
+ *
+ * Purpose:	Define the LabelPlacer class, which moves edge labels
+ *		along and beside their edges so that they do not cover
+ *		nodes or each other.
+ *
+ * Notes:	Each labelled edge has a few candidate places: centred
+ *		on the line, or just to one side of it, at the middle
+ *		of the edge or a bit towards either end.  Edges are
+ *		placed one at a time, shortest first, each taking the
+ *		candidate which overlaps the least node and label area;
+ *		ties go to the candidate nearest the middle of the
+ *		line.  Overlaps are found with a RectGrid of the node
+ *		and already-placed label rectangles.
+ *		placeNear() only re-places the labels of the edges of
+ *		some moved nodes and the labels those nodes now cover,
+ *		looking only at the items around them.
+ *		The placements are kept in the edges (see
+ *		Edge::setLabelPlacement()), so the TikZ output uses
+ *		them too.
+ *
+ * Modification history:
+ * Oct 19, 2026 (JD V1.0)
+ *  (a) Initial version.
+ * Oct 19, 2026 (JD V1.1)
+ *  (a) Use RectGrid (see rectgrid.h) rather than a private grid.
+ */
+
+#ifndef LABELPLACER_H
+#define LABELPLACER_H
+
+#include <QList>
+
+class Edge;
+class Node;
+class QGraphicsScene;
+class RectGrid;
+
+class LabelPlacer
+{
+  public:
+    static void setEnabled(bool on) { enabled = on; }
+    static bool isEnabled() { return enabled; }
+    static void placeAll(QGraphicsScene * scene);
+    static void placeNear(QList<Node *> nodes);
+    static void resetAll(QGraphicsScene * scene);
+
+  private:
+    static void place(QList<Edge *> edges, RectGrid * grid);
+    static bool enabled;
+};
+
+#endif // LABELPLACER_H
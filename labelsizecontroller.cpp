@@ -2,7 +2,7 @@
  * File:    labelsizecontroller.cpp
  * Author:  Rachel Bood
  * Date:    2014/11/07 (?)
- * Version: 1.5
+ * Version: 1.6
  *
  * Purpose: Initializes a QGraphicsView that is used to house the QGraphicsScene
  *
@@ -28,9 +28,12 @@
  *  (a) Changed QDoubleSpinBox to QSpinBox and Double to Int where applicable.
  * Aug 21, 2020 (IC V1.5)
  *  (a) Use new name of the function which sets an edge label.
+ * Oct 19, 2026 (JD V1.6)
+ *  (a) Tell the session recorder about label size changes.
  */
 
 #include "labelsizecontroller.h"
+#include "sessionrecorder.h"
 
 
 /*
@@ -105,7 +108,11 @@ LabelSizeController::LabelSizeController(Node * aNode, QSpinBox * aBox)
 void LabelSizeController::setNodeLabelSize(int ptSize)
 {
     if (node != nullptr)
+    {
         node->setNodeLabelSize(ptSize);
+        SessionRecorder::styleChanged(QList<QGraphicsItem *>() << node,
+                                      "labelSize");
+    }
 }
 
 
@@ -133,5 +140,9 @@ void
 LabelSizeController::setEdgeLabelSize(int ptSize)
 {
     if (edge != nullptr)
+    {
         edge->setEdgeLabelSize(ptSize);
+        SessionRecorder::styleChanged(QList<QGraphicsItem *>() << edge,
+                                      "labelSize");
+    }
 }
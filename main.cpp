@@ -2,7 +2,7 @@
  * File:    main.cpp
  * Author:  Rachel Bood 100088769
  * Date:    2014/11/07
- * Version: 1.6
+ * Version: 1.9
  *
  * Purpose: executes the mainwindow.ui.
  *
@@ -24,23 +24,88 @@
  *  (a) Replace (most of) cmr10, cmmi10 and cmsy10 with cmzsd10.
  *      See corresponding simplifications of html-label.cpp
  *	and comment about why I still embed cmr10.
+ * Oct 19, 2026 (JD V1.7)
+ *  (a) Add "--script file.js [args ...]", which runs a script with
+ *      no main window (see scriptengine.h) and exits.
+ *  (b) Move the font loading into addFonts() so both modes share it.
+ * Oct 19, 2026 (JD V1.8)
+ *  (a) Add "--serve [name]", which runs the render service (see
+ *      renderservice.h) until killed.
+ * Oct 19, 2026 (JD V1.9)
+ *  (a) Add "--replay file.session [timings.tsv]", which replays a
+ *      recorded session (see sessionreplayer.h), prints how long
+ *      each kind of operation took, and exits.
  */
 
 #include "mainwindow.h"
+#include "renderservice.h"
+#include "scriptengine.h"
+#include "sessionreplayer.h"
 #include <QApplication>
 #include <QFileSystemModel>
 #include <QTreeView>
 #include <QFontDatabase>
 
-int
-main(int argc, char * argv[])
-{
-    QApplication a(argc, argv);
+#include <cstring>
 
+static void
+addFonts()
+{
     QFontDatabase::addApplicationFont(":/fonts/arimo.ttf");
     QFontDatabase::addApplicationFont(":/fonts/cmr10.ttf");
     QFontDatabase::addApplicationFont(":/fonts/cmtt10.ttf");
     QFontDatabase::addApplicationFont(":/fonts/cmzsd10.ttf");
+}
+
+
+
+int
+main(int argc, char * argv[])
+{
+    // "Graphic --script file.js [args ...]" runs the script,
+    // "Graphic --serve [name]" runs the render service, and
+    // "Graphic --replay file.session [timings.tsv]" replays a session,
+    // without opening a window, so they must not need a display either.
+    bool script = argc >= 3 && strcmp(argv[1], "--script") == 0;
+    bool serve = argc >= 2 && strcmp(argv[1], "--serve") == 0;
+    bool replay = argc >= 3 && strcmp(argv[1], "--replay") == 0;
+    if ((script || serve || replay)
+        && qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    if (replay)
+    {
+        QApplication a(argc, argv);
+        addFonts();
+        return SessionReplayer::runHeadless(QString::fromLocal8Bit(argv[2]),
+                                            argc >= 4
+                                            ? QString::fromLocal8Bit(argv[3])
+                                            : QString());
+    }
+
+    if (serve)
+    {
+        QApplication a(argc, argv);
+        addFonts();
+        return RenderService::runHeadless(argc >= 3
+                                          ? QString::fromLocal8Bit(argv[2])
+                                          : RENDER_SERVICE_NAME);
+    }
+
+    if (script)
+    {
+        QApplication a(argc, argv);
+        addFonts();
+
+        QStringList args;
+        for (int i = 3; i < argc; i++)
+            args.append(QString::fromLocal8Bit(argv[i]));
+        return ScriptEngine::runHeadless(QString::fromLocal8Bit(argv[2]),
+                                         args);
+    }
+
+    QApplication a(argc, argv);
+    addFonts();
 
     MainWindow w;
     w.show();
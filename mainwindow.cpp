@@ -2,7 +2,7 @@
  * File:	mainwindow.cpp
  * Author:	Rachel Bood
  * Date:	January 25, 2015.
- * Version:	1.68
+ * Version:	1.87
  *
  * Purpose:	Implement the main window and functions called from there.
  *
@@ -455,6 +455,79 @@
  * Nov 16, 2020 (JD V1.68)
  *  (a) Remove a now-bogus comment that was misleading enough to
  *	deserve a commit.
+ * Oct 19, 2026 (JD V1.69)
+ *  (a) Put a label, progress bar and cancel button for background
+ *	jobs (see jobscheduler.h) in the status bar.  They are only
+ *	visible while some job is running.
+ *  (b) Shut the job scheduler down in the destructor, before the
+ *	widgets that jobs may hand results back to are deleted.
+ * Oct 19, 2026 (JD V1.70)
+ *  (a) style_Canvas_Graph() now sets (re)numbered labels via a
+ *	LabelBatch, so the HTML conversion is done on worker threads.
+ * Oct 19, 2026 (JD V1.71)
+ *  (a) Read the resolution settings from the AppSettings cache, and
+ *	reload that cache when the settings dialog is OK'd.
+ * Oct 19, 2026 (JD V1.72)
+ *  (a) Add collapseSelectedNodes() and expandSelectedNodes(), hooked
+ *	up to the new Edit menu actions, to collapse selected nodes into
+ *	a meta-node and expand meta-nodes (see metanode.h).
+ *  (b) Expand all meta-nodes before dumping TikZ or graph-ic code.
+ * Oct 19, 2026 (JD V1.73)
+ *  (a) Add filterView() and clearViewFilter(), hooked up to the new
+ *	View menu, to show only the canvas items matching a filter
+ *	(see viewfilter.h).
+ *  (b) Clear the view filter before dumping TikZ or graph-ic code.
+ * Oct 19, 2026 (JD V1.74)
+ *  (a) Add an "Overview" dock holding a Minimap of the canvas (see
+ *	minimap.h), which can be shown or hidden from the View menu.
+ *	Remember whether it was shown.
+ * Oct 19, 2026 (JD V1.75)
+ *  (a) Add a find box to the tool bar (Ctrl+F) which highlights the
+ *	canvas nodes and edges whose labels start with what has been
+ *	typed so far, and centres the view on them (see labelindex.h).
+ * Oct 19, 2026 (JD V1.76)
+ *  (a) Add the Arrange menu and arrangeSelectedNodes() (see arrange.h).
+ * Oct 19, 2026 (JD V1.77)
+ *  (a) Add Edit menu actions and editGraphStructure() to contract or
+ *	subdivide an edge, identify two nodes, split a node, and copy an
+ *	induced subgraph (see graphops.h).
+ * Oct 19, 2026 (JD V1.78)
+ *  (a) Add the "Place Edge Labels Automatically" View menu item and
+ *	placeEdgeLabels() (see labelplacer.h).
+ * Oct 19, 2026 (JD V1.79)
+ *  (a) Add "Check Edges Through Nodes..." and "Check Edges While
+ *	Moving" to the Arrange menu, with checkEdges(),
+ *	checkEdgesWhileMoving() and showClashes() (see edgechecker.h).
+ * Oct 19, 2026 (JD V1.80)
+ *  (a) Add "New Style Class From Selection...", "Apply Style
+ *	Class..." and "Edit Style Class..." to the Edit menu, with
+ *	newStyleClass(), applyStyleClass() and editStyleClass() (see
+ *	styleclass.h).
+ * Oct 19, 2026 (JD V1.81)
+ *  (a) Add File > Run Script... and runScript(), which runs a
+ *	JavaScript program on the canvas (see scriptengine.h).
+ * Oct 19, 2026 (JD V1.82)
+ *  (a) Scene coordinates no longer depend on the screen resolution
+ *	(see SCENE_DPI in defuns.h); the resolution is given to the
+ *	canvas and preview views as a transform, so a change in
+ *	updateDpiAndPreview() no longer regenerates the preview.
+ * Oct 19, 2026 (JD V1.83)
+ *  (a) closeEvent() uses the canvas scene's content bounds.
+ * Oct 19, 2026 (JD V1.84)
+ *  (a) Add File > Open Huge Graph..., openHugeGraph() and
+ *	editHugeGraphSelection(), which show an edge list too big for
+ *	the canvas in a viewer, and copy a region of it to the canvas
+ *	(see hugegraphview.h).
+ * Oct 19, 2026 (JD V1.85)
+ *  (a) Add File > Record Session... and recordSession() (see
+ *	sessionrecorder.h); style_Canvas_Graph() tells the recorder
+ *	what it changed.
+ * Oct 19, 2026 (JD V1.86)
+ *  (a) dumpTikZ() and dumpGraphIc() reveal the meta-nodes while
+ *	they write, rather than expanding them (see metanode.h).
+ * Oct 19, 2026 (JD V1.87)
+ *  (a) dumpTikZ() and dumpGraphIc() no longer clear the view filter,
+ *	which now just hides items (see viewfilter.h).
  */
 
 #include "mainwindow.h"
@@ -467,10 +540,30 @@
 #include "labelcontroller.h"
 #include "labelsizecontroller.h"
 #include "colourfillcontroller.h"
+#include "jobscheduler.h"
+#include "appsettings.h"
+#include "labelbatch.h"
+#include "metanode.h"
+#include "viewfilter.h"
+#include "minimap.h"
+#include "labelindex.h"
+#include "arrange.h"
+#include "graphops.h"
+#include "labelplacer.h"
+#include "edgechecker.h"
+#include "styleclass.h"
+#include "scriptengine.h"
+#include "hugegraph.h"
+#include "hugegraphview.h"
+#include "sessionrecorder.h"
 
 #include <QDesktopWidget>
 #include <QColorDialog>
+#include <QDockWidget>
+#include <QFileDialog>
+#include <QFileInfo>
 #include <QGraphicsItem>
+#include <QInputDialog>
 #include <QMessageBox>
 #include <QShortcut>
 #include <qmath.h>
@@ -480,11 +573,18 @@
 // The tab order is set in mainwindow.ui.  If it changes, so must this:
 enum tab_IDs { previewTab = 0, editCanvasGraphTab, editNodesAndEdgesTab };
 
+// The most nodes of a huge graph which may be copied to the canvas
+// for editing at once.
+#define HUGE_GRAPH_EDIT_LIMIT	20000
+
 // The unit of these is points:
 #define TITLE_SIZE	    20
 #define SUB_TITLE_SIZE	    18
 #define SUB_SUB_TITLE_SIZE  12
 
+// The find box highlights at most this many matching labels.
+#define FIND_LIMIT	1000
+
 
 QSettings settings("Acadia", "Graphic");
 qreal currentPhysicalDPI, currentPhysicalDPI_X, currentPhysicalDPI_Y;
@@ -562,6 +662,76 @@ QMainWindow(parent),
     connect(ui->actionSave, SIGNAL(triggered()), this, SLOT(saveGraph()));
     connect(ui->actionOpen_File, SIGNAL(triggered()),
 	    this, SLOT(loadGraphicFile()));
+    connect(ui->actionRun_Script, SIGNAL(triggered()),
+	    this, SLOT(runScript()));
+    connect(ui->actionOpen_Huge_Graph, SIGNAL(triggered()),
+	    this, SLOT(openHugeGraph()));
+    connect(ui->actionRecord_Session, SIGNAL(toggled(bool)),
+	    this, SLOT(recordSession(bool)));
+    connect(ui->actionCollapse_Nodes, SIGNAL(triggered()),
+	    this, SLOT(collapseSelectedNodes()));
+    connect(ui->actionExpand_Nodes, SIGNAL(triggered()),
+	    this, SLOT(expandSelectedNodes()));
+    connect(ui->actionFilter_View, SIGNAL(triggered()),
+	    this, SLOT(filterView()));
+    connect(ui->actionClear_Filter, SIGNAL(triggered()),
+	    this, SLOT(clearViewFilter()));
+    LabelPlacer::setEnabled(settings.value("placeEdgeLabels", false).toBool());
+    ui->actionPlace_Edge_Labels->setChecked(LabelPlacer::isEnabled());
+    connect(ui->actionPlace_Edge_Labels, SIGNAL(toggled(bool)),
+	    this, SLOT(placeEdgeLabels(bool)));
+    connect(ui->actionCheck_Edges, SIGNAL(triggered()),
+	    this, SLOT(checkEdges()));
+    EdgeChecker::setEnabled(settings.value("checkEdges", false).toBool());
+    ui->actionCheck_Edges_While_Moving->setChecked(EdgeChecker::isEnabled());
+    connect(ui->actionCheck_Edges_While_Moving, SIGNAL(toggled(bool)),
+	    this, SLOT(checkEdgesWhileMoving(bool)));
+
+    // Structural edits (see graphops.h).
+    connect(ui->actionContract_Edge, &QAction::triggered,
+	    this, [this]() { editGraphStructure(GraphOps::ContractEdge); });
+    connect(ui->actionSubdivide_Edge, &QAction::triggered,
+	    this, [this]() { editGraphStructure(GraphOps::SubdivideEdge); });
+    connect(ui->actionIdentify_Nodes, &QAction::triggered,
+	    this, [this]() { editGraphStructure(GraphOps::IdentifyNodes); });
+    connect(ui->actionSplit_Node, &QAction::triggered,
+	    this, [this]() { editGraphStructure(GraphOps::SplitNode); });
+    connect(ui->actionCopy_Induced_Subgraph, &QAction::triggered,
+	    this, [this]() { editGraphStructure(GraphOps::InducedSubgraph); });
+
+    // Style classes (see styleclass.h).
+    connect(ui->actionNew_Style_Class, SIGNAL(triggered()),
+	    this, SLOT(newStyleClass()));
+    connect(ui->actionApply_Style_Class, SIGNAL(triggered()),
+	    this, SLOT(applyStyleClass()));
+    connect(ui->actionEdit_Style_Class, SIGNAL(triggered()),
+	    this, SLOT(editStyleClass()));
+
+    // The Arrange menu.
+    connect(ui->actionAlign_Left, &QAction::triggered,
+	    this, [this]() { arrangeSelectedNodes(Arrange::AlignLeft); });
+    connect(ui->actionAlign_Right, &QAction::triggered,
+	    this, [this]() { arrangeSelectedNodes(Arrange::AlignRight); });
+    connect(ui->actionAlign_Top, &QAction::triggered,
+	    this, [this]() { arrangeSelectedNodes(Arrange::AlignTop); });
+    connect(ui->actionAlign_Bottom, &QAction::triggered,
+	    this, [this]() { arrangeSelectedNodes(Arrange::AlignBottom); });
+    connect(ui->actionAlign_Centres_Horizontally, &QAction::triggered,
+	    this, [this]() { arrangeSelectedNodes(Arrange::AlignHCentre); });
+    connect(ui->actionAlign_Centres_Vertically, &QAction::triggered,
+	    this, [this]() { arrangeSelectedNodes(Arrange::AlignVCentre); });
+    connect(ui->actionDistribute_Horizontally, &QAction::triggered,
+	    this, [this]() { arrangeSelectedNodes(Arrange::DistributeH); });
+    connect(ui->actionDistribute_Vertically, &QAction::triggered,
+	    this, [this]() { arrangeSelectedNodes(Arrange::DistributeV); });
+    connect(ui->actionArrange_On_Circle, &QAction::triggered,
+	    this, [this]() { arrangeSelectedNodes(Arrange::OnCircle); });
+    connect(ui->actionArrange_On_Line, &QAction::triggered,
+	    this, [this]() { arrangeSelectedNodes(Arrange::OnLine); });
+    connect(ui->actionMirror_Horizontally, &QAction::triggered,
+	    this, [this]() { arrangeSelectedNodes(Arrange::MirrorH); });
+    connect(ui->actionMirror_Vertically, &QAction::triggered,
+	    this, [this]() { arrangeSelectedNodes(Arrange::MirrorV); });
 
     // Ctrl-Q quits.
     new QShortcut(QKeySequence(Qt::CTRL + Qt::Key_Q), this, SLOT(close()));
@@ -723,6 +893,8 @@ QMainWindow(parent),
 	    this, SLOT(scheduleUpdate()));
     connect(ui->canvas->scene(), SIGNAL(graphSeparated()),
 	    this, SLOT(scheduleUpdate()));
+    connect(ui->canvas->scene(), SIGNAL(clashesChanged(int)),
+	    this, SLOT(showClashes(int)));
     connect(ui->canvas, SIGNAL(nodeCreated()),
 	    this, SLOT(scheduleUpdate()));
     connect(ui->canvas, SIGNAL(edgeCreated()),
@@ -845,11 +1017,12 @@ QMainWindow(parent),
     on_graphType_ComboBox_currentIndexChanged(-1);
 
     QScreen * screen = QGuiApplication::primaryScreen();
-    if (settings.value("useDefaultResolution") == false)
+    AppSettings * appSettings = AppSettings::instance();
+    if (!appSettings->useDefaultResolution())
     {
-	currentPhysicalDPI = settings.value("customResolution").toReal();
-	currentPhysicalDPI_X = settings.value("customResolution").toReal();
-	currentPhysicalDPI_Y = settings.value("customResolution").toReal();
+	currentPhysicalDPI = appSettings->customResolution();
+	currentPhysicalDPI_X = appSettings->customResolution();
+	currentPhysicalDPI_Y = appSettings->customResolution();
     }
     else
     {
@@ -858,21 +1031,78 @@ QMainWindow(parent),
 	currentPhysicalDPI_Y = screen->physicalDotsPerInchY();
     }
     screenLogicalDPI_X = screen->logicalDotsPerInchX();
+    ui->canvas->setResolution(currentPhysicalDPI_X, currentPhysicalDPI_Y);
+    ui->preview->setResolution(currentPhysicalDPI_X, currentPhysicalDPI_Y);
 
     loadWinSizeSettings();
 
-    // Unfortunately qreal QVariants can't convert... so we store an int...
-    int defaultDPI = screen->physicalDotsPerInch();
-    settings.setValue("defaultResolution", defaultDPI);
+    appSettings->setDefaultResolution(screen->physicalDotsPerInch());
 
     settingsDialog = new SettingsDialog(this);
 
+    // The settings cache must be reloaded before anything which
+    // uses it, so this connect must come first.  The canvas scene
+    // looks after its own grid via AppSettings::gridChanged().
     connect(ui->actionGraph_settings, SIGNAL(triggered()),
 	    settingsDialog, SLOT(open()));
     connect(settingsDialog, SIGNAL(saveDone()),
-	    this, SLOT(updateDpiAndPreview()));
+	    appSettings, SLOT(reload()));
     connect(settingsDialog, SIGNAL(saveDone()),
-	    ui->canvas->scene(), SLOT(updateCellSize()));
+	    this, SLOT(updateDpiAndPreview()));
+
+    // Background jobs report what they are doing in the status bar,
+    // and can be cancelled from there.
+    currentJobID = 0;
+    jobLabel = new QLabel;
+    jobProgressBar = new QProgressBar;
+    jobProgressBar->setRange(0, 100);
+    jobProgressBar->setMaximumWidth(200);
+    jobCancelButton = new QToolButton;
+    jobCancelButton->setText(tr("Cancel"));
+    jobCancelButton->setToolTip(tr("Cancel all background jobs"));
+    ui->statusBar->addPermanentWidget(jobLabel);
+    ui->statusBar->addPermanentWidget(jobProgressBar);
+    ui->statusBar->addPermanentWidget(jobCancelButton);
+    jobsBusyChanged(false);
+
+    JobScheduler * scheduler = JobScheduler::instance();
+    connect(scheduler, SIGNAL(jobStarted(int, QString)),
+	    this, SLOT(jobStarted(int, QString)));
+    connect(scheduler, SIGNAL(jobProgress(int, int)),
+	    this, SLOT(jobProgress(int, int)));
+    connect(scheduler, SIGNAL(busyChanged(bool)),
+	    this, SLOT(jobsBusyChanged(bool)));
+    connect(jobCancelButton, SIGNAL(clicked()),
+	    scheduler, SLOT(cancelAll()));
+
+    // An overview of the whole canvas, for getting around big ones.
+    minimapDock = new QDockWidget(tr("Overview"), this);
+    minimapDock->setObjectName("minimapDock");
+    minimapDock->setWidget(new Minimap(ui->canvas, minimapDock));
+    addDockWidget(Qt::RightDockWidgetArea, minimapDock);
+    minimapDock->setVisible(settings.value("minimapVisible", true).toBool());
+    ui->menuView->addSeparator();
+    ui->menuView->addAction(minimapDock->toggleViewAction());
+
+    // Find nodes and edges by label as the user types.  Ctrl-F goes
+    // to the find box, and Return moves on to the next match.
+    findEdit = new QLineEdit;
+    findEdit->setPlaceholderText(tr("Find label"));
+    findEdit->setToolTip(tr("Highlight the nodes and edges whose labels "
+			    "start with this (Ctrl+F)"));
+    findEdit->setClearButtonEnabled(true);
+    findEdit->setMaximumWidth(200);
+    ui->mainToolBar->addWidget(findEdit);
+    foundIndex = -1;
+    connect(findEdit, SIGNAL(textChanged(QString)),
+	    this, SLOT(findLabels(QString)));
+    connect(findEdit, SIGNAL(returnPressed()), this, SLOT(showNextFound()));
+    QShortcut * findShortcut
+	= new QShortcut(QKeySequence(Qt::CTRL + Qt::Key_F), this);
+    connect(findShortcut, &QShortcut::activated, [this]() {
+	findEdit->setFocus();
+	findEdit->selectAll();
+    });
 
 #ifdef DEBUG
     // Info to help with dealing with HiDPI issues
@@ -904,6 +1134,8 @@ QMainWindow(parent),
 
 MainWindow::~MainWindow()
 {
+    SessionRecorder::stop();
+    JobScheduler::instance()->shutdown();
     delete ui;
 }
 
@@ -2237,6 +2469,7 @@ MainWindow::dumpTikZ()
     QVector<Node *> nodes;
     int numOfNodes = 0;
 
+    MetaNode::revealAll();
     foreach (QGraphicsItem * item, ui->canvas->scene()->items())
     {
 	if (item->type() == Node::Type)
@@ -2250,6 +2483,7 @@ MainWindow::dumpTikZ()
     qDeb() << "%%========== TikZ dump of current graph follows: ============";
     QTextStream tty(stdout);
     File_IO::saveTikZ(tty, nodes);
+    MetaNode::concealAll();
 }
 
 
@@ -2277,6 +2511,7 @@ MainWindow::dumpGraphIc()
     QVector<Node *> nodes;
     int numOfNodes = 0;
 
+    MetaNode::revealAll();
     foreach (QGraphicsItem * item, ui->canvas->scene()->items())
     {
 	if (item->type() == Node::Type)
@@ -2290,6 +2525,7 @@ MainWindow::dumpGraphIc()
     qDeb() << "%%========= graphIc dump of current graph follows: ===========";
     QTextStream tty(stdout);
     File_IO::saveGraphIc(tty, nodes, true);
+    MetaNode::concealAll();
 }
 
 
@@ -2317,6 +2553,7 @@ MainWindow::saveWinSizeSettings()
 	settings.setValue("windowMaxed", false);
 	settings.setValue("windowSize", this->size());
     }
+    settings.setValue("minimapVisible", !minimapDock->isHidden());
 }
 
 
@@ -2325,8 +2562,9 @@ void
 MainWindow::updateDpiAndPreview()
 {
     QScreen * screen = QGuiApplication::primaryScreen();
-    if (settings.value("useDefaultResolution").toBool() == true
-	|| ! settings.contains("customResolution"))
+    AppSettings * appSettings = AppSettings::instance();
+    if (appSettings->useDefaultResolution()
+	|| ! appSettings->hasCustomResolution())
     {
 	currentPhysicalDPI = screen->physicalDotsPerInch();
 	currentPhysicalDPI_X = screen->physicalDotsPerInchX();
@@ -2334,14 +2572,15 @@ MainWindow::updateDpiAndPreview()
     }
     else
     {
-	currentPhysicalDPI = settings.value("customResolution").toReal();
-	currentPhysicalDPI_X = settings.value("customResolution").toReal();
-	currentPhysicalDPI_Y = settings.value("customResolution").toReal();
+	currentPhysicalDPI = appSettings->customResolution();
+	currentPhysicalDPI_X = appSettings->customResolution();
+	currentPhysicalDPI_Y = appSettings->customResolution();
     }
 
-    // Need to redraw the preview graph if the DPI changed.
-    // Pretending this widget changed is good enough for generateGraph().
-    generateGraph(nodeDiam_WGT);
+    // Scene coordinates don't depend on the DPI (see SCENE_DPI), so
+    // only the views' transforms need to change.
+    ui->canvas->setResolution(currentPhysicalDPI_X, currentPhysicalDPI_Y);
+    ui->preview->setResolution(currentPhysicalDPI_X, currentPhysicalDPI_Y);
 }
 
 
@@ -2364,7 +2603,7 @@ MainWindow::updateDpiAndPreview()
 void
 MainWindow::closeEvent(QCloseEvent * event)
 {
-    if (!ui->canvas->scene()->itemsBoundingRect().isEmpty()
+    if (!CanvasScene::contentBoundsOf(ui->canvas->scene()).isEmpty()
 	&& promptSave == true)
     {
 	QMessageBox::StandardButton closeBtn
@@ -2478,6 +2717,7 @@ MainWindow::style_Canvas_Graph(enum canvas_widget_ID what_changed,
     qDeb() << "MW::style_Canvas_Graph(........) called";
     int i = nodeNumStart;
     int j = edgeNumStart;
+    LabelBatch labels;
 
     foreach (QGraphicsItem * item, selectedList)
     {
@@ -2487,8 +2727,6 @@ MainWindow::style_Canvas_Graph(enum canvas_widget_ID what_changed,
 
 	    qDeb() << "   looking at node with label " << node->getLabel();
 
-	    node->physicalDotsPerInchX = currentPhysicalDPI_X;
-
 	    GUARD(cNodeThickness_WGT) node->setPenWidth(nodeThickness);
 	    GUARD(cNodeDiam_WGT) node->setDiameter(nodeDiameter);
 	    GUARD(cNodeFillColour_WGT) node->setFillColour(nodeFillColour);
@@ -2500,11 +2738,12 @@ MainWindow::style_Canvas_Graph(enum canvas_widget_ID what_changed,
 		|| what_changed == cNodeNumLabelStart_WGT)
 	    {
 		// Clear the node label, in case it was set previously.
-		node->setNodeLabel("");
+		QString newLabel = "";
 		if (nodeLabelsNumbered)
-		    node->setNodeLabel(i++);
+		    newLabel = QString::number(i++);
 		else if (nodeLabel.length() != 0)
-		    node->setNodeLabel(nodeLabel, i++);
+		    newLabel = LabelBatch::subscripted(nodeLabel, i++);
+		labels.add(node, newLabel);
 	    }
 	}
 	else if (item->type() == Edge::Type)
@@ -2522,11 +2761,12 @@ MainWindow::style_Canvas_Graph(enum canvas_widget_ID what_changed,
 		|| what_changed == cEdgeNumLabelStart_WGT)
 	    {
 		// Clear the edge label, in case it was set previously.
-		edge->setEdgeLabel("");
+		QString newLabel = "";
 		if (edgeLabelsNumbered)
-		    edge->setEdgeLabel(j++);
+		    newLabel = QString::number(j++);
 		else if (edgeLabel.length() != 0)
-		    edge->setEdgeLabel(edgeLabel, j++);
+		    newLabel = LabelBatch::subscripted(edgeLabel, j++);
+		labels.add(edge, newLabel);
 	    }
 	    GUARD(cNodeDiam_WGT) edge->setDestRadius(nodeDiameter / 2.);
 	    GUARD(cNodeDiam_WGT) edge->setSourceRadius(nodeDiameter / 2.);
@@ -2576,17 +2816,17 @@ MainWindow::style_Canvas_Graph(enum canvas_widget_ID what_changed,
 		
 		qreal widthScaleFactor = 1, heightScaleFactor = 1;
 		GUARD(cGraphWidth_WGT) widthScaleFactor
-		    = (totalWidth * currentPhysicalDPI_X - nodeDiamWidthSlop)
+		    = (totalWidth * SCENE_DPI - nodeDiamWidthSlop)
 		    / bb2.width();
 		GUARD(cGraphHeight_WGT) heightScaleFactor
-		    = (totalHeight *  currentPhysicalDPI_Y - nodeDiamHeightSlop)
+		    = (totalHeight *  SCENE_DPI - nodeDiamHeightSlop)
 		    / bb2.height();
 
 		qDeb() << "    Desired total width: " << totalWidth
-		       << "; width = " << bb.width() / currentPhysicalDPI_X
+		       << "; width = " << bb.width() / SCENE_DPI
 		       << "; widthScaleFactor = " << widthScaleFactor;
 		qDeb() << "    Desired total height: " << totalHeight
-		       << "; height = " << bb.height() / currentPhysicalDPI_Y
+		       << "; height = " << bb.height() / SCENE_DPI
 		       << "; heightScaleFactor = " << heightScaleFactor;
 
 		qreal xmid = RGcenter.x();
@@ -2618,6 +2858,83 @@ MainWindow::style_Canvas_Graph(enum canvas_widget_ID what_changed,
 	    }
 	}
     }
+    labels.apply();
+
+    // Record the new values of whatever was changed.
+    if (SessionRecorder::isRecording())
+    {
+	QString property;
+	int itemType = Node::Type;
+	switch (what_changed)
+	{
+	  case cNodeDiam_WGT:
+	    property = "diameter";
+	    break;
+	  case cNodeThickness_WGT:
+	    property = "pen";
+	    break;
+	  case cNodeFillColour_WGT:
+	    property = "fill";
+	    break;
+	  case cNodeOutlineColour_WGT:
+	    property = "outline";
+	    break;
+	  case cNodeLabelSize_WGT:
+	    property = "labelSize";
+	    break;
+	  case cNodeLabel1_WGT:
+	  case cNodeNumLabelCheckBox_WGT:
+	  case cNodeNumLabelStart_WGT:
+	    property = "label";
+	    break;
+	  case cEdgeThickness_WGT:
+	    property = "pen";
+	    itemType = Edge::Type;
+	    break;
+	  case cEdgeLineColour_WGT:
+	    property = "colour";
+	    itemType = Edge::Type;
+	    break;
+	  case cEdgeLabelSize_WGT:
+	    property = "labelSize";
+	    itemType = Edge::Type;
+	    break;
+	  case cEdgeLabel_WGT:
+	  case cEdgeNumLabelCheckBox_WGT:
+	  case cEdgeNumLabelStart_WGT:
+	    property = "label";
+	    itemType = Edge::Type;
+	    break;
+	  case cGraphRotation_WGT:
+	  case cGraphWidth_WGT:
+	  case cGraphHeight_WGT:
+	    property = "place";
+	    itemType = Graph::Type;
+	    break;
+	}
+
+	// A graph's changes are the new places of all of its nodes.
+	QList<QGraphicsItem *> items;
+	foreach (QGraphicsItem * item, selectedList)
+	{
+	    if (item->type() != itemType)
+		continue;
+	    if (itemType != Graph::Type)
+	    {
+		items.append(item);
+		continue;
+	    }
+	    QList<QGraphicsItem *> children = item->childItems();
+	    for (int k = 0; k < children.count(); k++)
+	    {
+		if (children.at(k)->type() == Node::Type)
+		    items.append(children.at(k));
+		else if (children.at(k)->type() == Graph::Type)
+		    children.append(children.at(k)->childItems());
+	    }
+	}
+	SessionRecorder::styleChanged(items, property);
+    }
 
     // If ever the pen width is taken into account for the boundingBox(),
     // that widget should be included here.
@@ -2679,12 +2996,12 @@ MainWindow::updateCanvasGraphList()
 
 	QRectF bb = graph->boundingBox(nullptr, true, nullptr);
 
-	qreal height = bb.height() / currentPhysicalDPI_Y;
+	qreal height = bb.height() / SCENE_DPI;
 	QLabel * heightLabel = new QLabel("Height: "
 					  + QString::number(height, 'g', 4));
 	ui->graphListLayout->addWidget(heightLabel, i, 1);
 
-	qreal width = bb.width() / currentPhysicalDPI_X;
+	qreal width = bb.width() / SCENE_DPI;
 	QLabel * widthLabel = new QLabel("Width: "
 					 + QString::number(width, 'g', 4));
 	ui->graphListLayout->addWidget(widthLabel, i, 2);
@@ -2814,11 +3131,11 @@ MainWindow::resetEditCanvasGraphTabWidgets()
 	if (num_graphs > 0)
 	{
 	    ui->cGraphHeight->setValue(total_ht
-				       / num_graphs / currentPhysicalDPI_Y);
+				       / num_graphs / SCENE_DPI);
 	    ui->cGraphHeight->setDisabled(false);
 
 	    ui->cGraphWidth->setValue(total_wd
-				      / num_graphs / currentPhysicalDPI_X);
+				      / num_graphs / SCENE_DPI);
 	    ui->cGraphWidth->setDisabled(false);
 
 	    ui->cGraphRotation->setValue(0);
@@ -2855,3 +3172,1023 @@ MainWindow::resetEditCanvasGraphTabWidgets()
 	selectedList = selectedListHold;
     }
 }
+
+
+
+/*
+ * Name:	jobStarted()
+ * Purpose:	Show the name of a background job which just started.
+ * Arguments:	The job ID and its name.
+ * Outputs:	Nothing.
+ * Modifies:	The status bar job widgets.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	With several jobs running at once only the most
+ *		recently started one is shown.
+ * Notes:	None.
+ */
+
+void
+MainWindow::jobStarted(int jobID, QString name)
+{
+    currentJobID = jobID;
+    jobLabel->setText(name);
+    jobProgressBar->setValue(0);
+}
+
+
+
+/*
+ * Name:	jobProgress()
+ * Purpose:	Update the status bar progress bar.
+ * Arguments:	The job ID and how much of it (%) is done.
+ * Outputs:	Nothing.
+ * Modifies:	jobProgressBar.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Progress of jobs other than the one being shown is ignored.
+ */
+
+void
+MainWindow::jobProgress(int jobID, int percent)
+{
+    if (jobID == currentJobID)
+	jobProgressBar->setValue(percent);
+}
+
+
+
+/*
+ * Name:	jobsBusyChanged()
+ * Purpose:	Show or hide the status bar job widgets.
+ * Arguments:	True iff at least one background job is queued or running.
+ * Outputs:	Nothing.
+ * Modifies:	The status bar job widgets.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+void
+MainWindow::jobsBusyChanged(bool busy)
+{
+    if (!busy)
+    {
+	currentJobID = 0;
+	jobLabel->clear();
+    }
+    jobLabel->setVisible(busy);
+    jobProgressBar->setVisible(busy);
+    jobCancelButton->setVisible(busy);
+}
+
+
+
+/*
+ * Name:	collapseSelectedNodes()
+ * Purpose:	Collapse the selected nodes into one meta-node.
+ * Arguments:	None.
+ * Outputs:	An error message if the nodes can't be collapsed.
+ * Modifies:	The canvas graph and selectedList.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	The nodes are selected in "select" mode.  Selected
+ *		edges and graphs are ignored.  See metanode.h.
+ */
+
+void
+MainWindow::collapseSelectedNodes()
+{
+    QList<Node *> nodes;
+    QString errorMessage;
+
+    foreach (QGraphicsItem * item, selectedList)
+	if (item->type() == Node::Type)
+	    nodes.append(qgraphicsitem_cast<Node *>(item));
+
+    if (MetaNode::collapse(nodes, &errorMessage) == nullptr)
+    {
+	QMessageBox::information(this, "Collapse Selected Nodes",
+				 errorMessage);
+	return;
+    }
+
+    // The selected nodes (and perhaps edges) are no longer on the
+    // canvas, so forget about them.
+    foreach (QGraphicsItem * item, selectedList)
+    {
+	if (item->type() == Edge::Type)
+	    qgraphicsitem_cast<Edge *>(item)->chosen(0);
+    }
+    selectedList.clear();
+    resetEditCanvasGraphTabWidgets();
+    somethingChanged();
+}
+
+
+
+/*
+ * Name:	expandSelectedNodes()
+ * Purpose:	Expand the selected meta-nodes, or all meta-nodes if
+ *		no meta-node is selected.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	The canvas graphs and selectedList.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	A meta-node can also be expanded by double-clicking it
+ *		(see CanvasView::mouseDoubleClickEvent()).
+ */
+
+void
+MainWindow::expandSelectedNodes()
+{
+    QList<Node *> metaNodes;
+
+    foreach (QGraphicsItem * item, selectedList)
+    {
+	if (item->type() == Node::Type)
+	{
+	    Node * node = qgraphicsitem_cast<Node *>(item);
+	    if (MetaNode::isMetaNode(node))
+		metaNodes.append(node);
+	}
+    }
+
+    if (metaNodes.isEmpty())
+    {
+	if (MetaNode::count() == 0)
+	    return;
+	MetaNode::expandAll();
+    }
+    else
+    {
+	// The meta-nodes are about to be deleted.
+	foreach (Node * node, metaNodes)
+	    selectedList.removeOne(node);
+	foreach (Node * node, metaNodes)
+	    MetaNode::expand(node);
+    }
+
+    resetEditCanvasGraphTabWidgets();
+    somethingChanged();
+}
+
+
+
+/*
+ * Name:	filterView()
+ * Purpose:	Ask the user for a filter and only show the canvas
+ *		items which match it.
+ * Arguments:	None.
+ * Outputs:	A dialog asking for the filter, and an error message if
+ *		the filter is no good.
+ * Modifies:	The canvas graphs and selectedList.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	The filter syntax is described in viewfilter.h.  The
+ *		dialog starts with the current filter, if any, so it
+ *		can be refined.  An empty filter clears the filter.
+ */
+
+void
+MainWindow::filterView()
+{
+    bool ok;
+    QString errorMessage;
+
+    QString spec = QInputDialog::getText(
+	this, "Filter View",
+	"Show only items matching (e.g., \"node.fill=red edge.label\"):",
+	QLineEdit::Normal, ViewFilter::currentSpec(), &ok);
+    if (!ok)
+	return;
+
+    if (!ViewFilter::apply(ui->canvas->scene(), spec, &errorMessage))
+    {
+	QMessageBox::information(this, "Filter View", errorMessage);
+	return;
+    }
+
+    // Some of the selected items may now be hidden.
+    foreach (QGraphicsItem * item, selectedList)
+    {
+	if (item->type() == Node::Type)
+	    qgraphicsitem_cast<Node *>(item)->chosen(0);
+	else if (item->type() == Edge::Type)
+	    qgraphicsitem_cast<Edge *>(item)->chosen(0);
+    }
+    selectedList.clear();
+    resetEditCanvasGraphTabWidgets();
+    somethingChanged();
+}
+
+
+
+/*
+ * Name:	clearViewFilter()
+ * Purpose:	Show everything the view filter hid.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	The canvas graphs.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+void
+MainWindow::clearViewFilter()
+{
+    if (!ViewFilter::isActive())
+	return;
+
+    ViewFilter::clear();
+    resetEditCanvasGraphTabWidgets();
+    somethingChanged();
+}
+
+
+
+/*
+ * Name:	placeEdgeLabels()
+ * Purpose:	Turn automatic edge label placement on or off.
+ * Arguments:	Whether it is to be on.
+ * Outputs:	Nothing.
+ * Modifies:	The LabelPlacer setting and the edge label placements.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Turning it on places every label now; after that they
+ *		are re-placed as nodes are moved (see canvasscene.cpp).
+ *		Turning it off puts the labels back in the middle of
+ *		their edges.
+ */
+
+void
+MainWindow::placeEdgeLabels(bool on)
+{
+    LabelPlacer::setEnabled(on);
+    settings.setValue("placeEdgeLabels", on);
+
+    if (on)
+	LabelPlacer::placeAll(ui->canvas->scene());
+    else
+	LabelPlacer::resetAll(ui->canvas->scene());
+    somethingChanged();
+}
+
+
+
+/*
+ * Name:	findLabels()
+ * Purpose:	Highlight the canvas nodes and edges whose labels start
+ *		with the given text, and show the first of them.
+ * Arguments:	The text in the find box.
+ * Outputs:	The number of matches, in the status bar.
+ * Modifies:	The pen style of the old and new matches; the view.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Connected to the find box's textChanged(), so this
+ *		runs on every keystroke; the lookup is done by
+ *		LabelIndex, so it doesn't depend on the canvas size.
+ *		Matches are highlighted with chosen(1), as selected
+ *		items are.  Items which are selected are left alone
+ *		when the highlighting is removed.
+ */
+
+void
+MainWindow::findLabels(QString text)
+{
+    foreach (QPointer<QGraphicsObject> item, foundItems)
+    {
+	if (item.isNull() || selectedList.contains(item.data()))
+	    continue;
+	if (item->type() == Node::Type)
+	    qgraphicsitem_cast<Node *>(item.data())->chosen(0);
+	else if (item->type() == Edge::Type)
+	    qgraphicsitem_cast<Edge *>(item.data())->chosen(0);
+    }
+    foundItems.clear();
+    foundIndex = -1;
+
+    if (text.isEmpty())
+    {
+	ui->statusBar->clearMessage();
+	return;
+    }
+
+    QGraphicsScene * canvasScene = ui->canvas->scene();
+    foreach (QGraphicsObject * item, LabelIndex::findPrefix(text, FIND_LIMIT))
+    {
+	if (item->scene() != canvasScene)
+	    continue;
+	if (item->type() == Node::Type)
+	    qgraphicsitem_cast<Node *>(item)->chosen(1);
+	else if (item->type() == Edge::Type)
+	    qgraphicsitem_cast<Edge *>(item)->chosen(1);
+	foundItems.append(item);
+    }
+
+    if (foundItems.isEmpty())
+	ui->statusBar->showMessage(tr("No labels start with \"%1\"")
+				   .arg(text));
+    else
+	ui->statusBar->showMessage(tr("%1 match(es)")
+				   .arg(foundItems.count()));
+    showNextFound();
+}
+
+
+
+/*
+ * Name:	showNextFound()
+ * Purpose:	Centre the view on the next item found by findLabels().
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	foundIndex and the view.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Wraps around after the last match.  Items deleted
+ *		since the search are skipped.
+ */
+
+void
+MainWindow::showNextFound()
+{
+    for (int tries = 0; tries < foundItems.count(); tries++)
+    {
+	foundIndex = (foundIndex + 1) % foundItems.count();
+	QGraphicsObject * item = foundItems.at(foundIndex);
+	if (item != nullptr && item->scene() == ui->canvas->scene())
+	{
+	    ui->canvas->centerOn(item);
+	    return;
+	}
+    }
+}
+
+
+
+/*
+ * Name:	arrangeSelectedNodes()
+ * Purpose:	Line up, space out, or otherwise arrange the selected
+ *		nodes.
+ * Arguments:	What to do (see arrange.h).
+ * Outputs:	A message if not enough nodes are selected.
+ * Modifies:	The positions of the selected nodes.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	All of the new positions are worked out first and then
+ *		the nodes are moved in one batch, which Escape undoes
+ *		as a whole (see CanvasScene::moveNodes()).
+ *		Selected edges and graphs are ignored.
+ */
+
+void
+MainWindow::arrangeSelectedNodes(Arrange::Operation op)
+{
+    QList<Node *> nodes;
+
+    foreach (QGraphicsItem * item, selectedList)
+	if (item->type() == Node::Type)
+	    nodes.append(qgraphicsitem_cast<Node *>(item));
+
+    if (nodes.count() < Arrange::minimumNodes(op))
+    {
+	QMessageBox::information(this, "Arrange",
+				 QString("Select at least %1 nodes "
+					 "(in select mode) first.")
+				 .arg(Arrange::minimumNodes(op)));
+	return;
+    }
+
+    CanvasScene * scene = qobject_cast<CanvasScene *>(ui->canvas->scene());
+    scene->moveNodes(nodes, Arrange::targets(nodes, op));
+}
+
+
+
+/*
+ * Name:	checkEdges()
+ * Purpose:	Find the edges drawn through nodes they are not
+ *		attached to, and offer to move those nodes.
+ * Arguments:	None.
+ * Outputs:	A message saying what was found.
+ * Modifies:	The clash highlighting, and maybe node positions.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	The nodes are moved with CanvasScene::moveNodes(), so
+ *		Escape puts them back.  Moving them can make new
+ *		clashes, so the canvas is checked again afterwards.
+ */
+
+void
+MainWindow::checkEdges()
+{
+    CanvasScene * scene = qobject_cast<CanvasScene *>(ui->canvas->scene());
+    QList<EdgeChecker::Clash> clashes = EdgeChecker::findAll(scene);
+
+    EdgeChecker::highlight(clashes);
+    if (clashes.isEmpty())
+    {
+	QMessageBox::information(this, "Check Edges",
+				 "No edge passes through a node it is "
+				 "not attached to.");
+	return;
+    }
+
+    int answer = QMessageBox::question(
+	this, "Check Edges",
+	QString("%1 edge(s) pass through nodes they are not attached to.\n"
+		"Move those nodes off the edges?")
+	.arg(EdgeChecker::highlightedEdges()));
+    if (answer != QMessageBox::Yes)
+	return;
+
+    QList<Node *> nodes;
+    QList<QPointF> positions;
+    EdgeChecker::fixes(clashes, &nodes, &positions);
+    scene->moveNodes(nodes, positions);
+
+    EdgeChecker::highlight(EdgeChecker::findAll(scene));
+    showClashes(EdgeChecker::highlightedEdges());
+}
+
+
+
+/*
+ * Name:	checkEdgesWhileMoving()
+ * Purpose:	Turn the check after each node move on or off.
+ * Arguments:	Whether it is to be on.
+ * Outputs:	Nothing.
+ * Modifies:	The EdgeChecker setting and the clash highlighting.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Turning it off takes the highlighting away.
+ */
+
+void
+MainWindow::checkEdgesWhileMoving(bool on)
+{
+    EdgeChecker::setEnabled(on);
+    settings.setValue("checkEdges", on);
+
+    if (on)
+	EdgeChecker::highlight(EdgeChecker::findAll(ui->canvas->scene()));
+    else
+	EdgeChecker::highlight(QList<EdgeChecker::Clash>());
+    showClashes(EdgeChecker::highlightedEdges());
+}
+
+
+
+/*
+ * Name:	showClashes()
+ * Purpose:	Say in the status bar how many edges pass through nodes.
+ * Arguments:	The number of edges.
+ * Outputs:	The status bar message.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+void
+MainWindow::showClashes(int edges)
+{
+    if (edges == 0)
+	ui->statusBar->clearMessage();
+    else
+	ui->statusBar->showMessage(
+	    tr("%1 edge(s) pass through nodes they are not attached to")
+	    .arg(edges));
+}
+
+
+
+/*
+ * Name:	editGraphStructure()
+ * Purpose:	Contract or subdivide the selected edge, identify the
+ *		two selected nodes, split the selected node, or copy
+ *		the subgraph induced by the selected nodes.
+ * Arguments:	Which of those to do.
+ * Outputs:	A message if the selection is wrong for the operation
+ *		or the operation fails.
+ * Modifies:	The canvas graph(s) and selectedList.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	The work is done by GraphOps (see graphops.h).  The
+ *		selection is cleared first, since the operation may
+ *		delete selected items.  For "identify", the node
+ *		selected first is kept.
+ */
+
+void
+MainWindow::editGraphStructure(GraphOps::Operation op)
+{
+    QList<Node *> nodes;
+    QList<Edge *> edges;
+    QString errorMessage;
+    QString title;
+    bool ok = true;
+
+    foreach (QGraphicsItem * item, selectedList)
+    {
+	if (item->type() == Node::Type)
+	    nodes.append(qgraphicsitem_cast<Node *>(item));
+	else if (item->type() == Edge::Type)
+	    edges.append(qgraphicsitem_cast<Edge *>(item));
+    }
+
+    switch (op)
+    {
+      case GraphOps::ContractEdge:
+	title = "Contract Edge";
+	if (edges.count() != 1)
+	    errorMessage = "Select exactly one edge to contract.";
+	break;
+      case GraphOps::SubdivideEdge:
+	title = "Subdivide Edge";
+	if (edges.count() != 1)
+	    errorMessage = "Select exactly one edge to subdivide.";
+	break;
+      case GraphOps::IdentifyNodes:
+	title = "Identify Nodes";
+	if (nodes.count() != 2)
+	    errorMessage = "Select exactly two nodes to identify.";
+	break;
+      case GraphOps::SplitNode:
+	title = "Split Node";
+	if (nodes.count() != 1)
+	    errorMessage = "Select exactly one node to split.";
+	break;
+      case GraphOps::InducedSubgraph:
+	title = "Copy Induced Subgraph";
+	if (nodes.isEmpty())
+	    errorMessage = "Select the nodes of the subgraph first.";
+	break;
+    }
+    if (!errorMessage.isEmpty())
+    {
+	QMessageBox::information(this, title, errorMessage);
+	return;
+    }
+
+    int k = 1;
+    if (op == GraphOps::SubdivideEdge)
+    {
+	k = QInputDialog::getInt(this, title, "Number of new nodes:",
+				 1, 1, 1000, 1, &ok);
+	if (!ok)
+	    return;
+    }
+
+    foreach (QGraphicsItem * item, selectedList)
+    {
+	if (item->type() == Node::Type)
+	    qgraphicsitem_cast<Node *>(item)->chosen(0);
+	else if (item->type() == Edge::Type)
+	    qgraphicsitem_cast<Edge *>(item)->chosen(0);
+    }
+    selectedList.clear();
+
+    switch (op)
+    {
+      case GraphOps::ContractEdge:
+	ok = GraphOps::contractEdge(edges.at(0), &errorMessage) != nullptr;
+	break;
+      case GraphOps::SubdivideEdge:
+	ok = !GraphOps::subdivideEdge(edges.at(0), k, &errorMessage).isEmpty();
+	break;
+      case GraphOps::IdentifyNodes:
+	ok = GraphOps::identifyNodes(nodes.at(0), nodes.at(1),
+				     &errorMessage) != nullptr;
+	break;
+      case GraphOps::SplitNode:
+	ok = GraphOps::splitNode(nodes.at(0), &errorMessage) != nullptr;
+	break;
+      case GraphOps::InducedSubgraph:
+	ok = GraphOps::inducedSubgraph(nodes, &errorMessage) != nullptr;
+	break;
+    }
+
+    if (!ok)
+	QMessageBox::information(this, title, errorMessage);
+    resetEditCanvasGraphTabWidgets();
+    somethingChanged();
+}
+
+
+
+/*
+ * Name:	newStyleClass()
+ * Purpose:	Make a style class which looks like the selected items,
+ *		and put them all in it.
+ * Arguments:	None.
+ * Outputs:	Dialogs asking for the name.
+ * Modifies:	The set of style classes and the selected items.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	The node values come from the first selected node (or
+ *		the first node of the first selected edge, if no node
+ *		is selected), and the edge colour from the first
+ *		selected edge (or that node's outline colour).
+ *		If the name is taken, a similar unused one is chosen.
+ */
+
+void
+MainWindow::newStyleClass()
+{
+    QList<Node *> nodes;
+    QList<Edge *> edges;
+
+    foreach (QGraphicsItem * item, selectedList)
+    {
+	if (item->type() == Node::Type)
+	    nodes.append(qgraphicsitem_cast<Node *>(item));
+	else if (item->type() == Edge::Type)
+	    edges.append(qgraphicsitem_cast<Edge *>(item));
+    }
+    if (nodes.isEmpty() && edges.isEmpty())
+    {
+	QMessageBox::information(this, "New Style Class",
+				 "Select the nodes and edges which are "
+				 "to be in the class first.");
+	return;
+    }
+
+    bool ok;
+    QString name = QInputDialog::getText(this, "New Style Class",
+					 "Class name:", QLineEdit::Normal,
+					 "", &ok);
+    if (!ok || name.simplified().isEmpty())
+	return;
+
+    Node * model = nodes.isEmpty() ? edges.at(0)->sourceNode() : nodes.at(0);
+    StyleClass::Values v;
+    v.fillColour = model->getFillColour();
+    v.lineColour = model->getLineColour();
+    v.diameter = model->getDiameter();
+    v.penWidth = model->getPenWidth();
+    v.labelSize = model->getLabelSize();
+    v.edgeColour = model->getLineColour();
+    if (!edges.isEmpty())
+    {
+	v.edgeColour = edges.at(0)->getColour();
+	if (nodes.isEmpty())
+	{
+	    v.penWidth = edges.at(0)->getPenWidth();
+	    v.labelSize = edges.at(0)->getLabelSize();
+	}
+    }
+
+    StyleClass * styleClass
+	= StyleClass::define(StyleClass::uniqueName(name), v);
+    foreach (Node * node, nodes)
+	node->setStyleClass(styleClass);
+    foreach (Edge * edge, edges)
+	edge->setStyleClass(styleClass);
+
+    ui->statusBar->showMessage("Made style class \"" + styleClass->name()
+			       + "\"", 5000);
+    somethingChanged();
+}
+
+
+
+/*
+ * Name:	applyStyleClass()
+ * Purpose:	Put the selected items into a style class, or take
+ *		them out of their classes.
+ * Arguments:	None.
+ * Outputs:	A dialog asking for the class.
+ * Modifies:	The selected items.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Taking an item out of its class leaves it looking the
+ *		same (see Node::setStyleClass()).
+ */
+
+void
+MainWindow::applyStyleClass()
+{
+    QStringList names = StyleClass::names();
+    if (selectedList.isEmpty() || names.isEmpty())
+    {
+	QMessageBox::information(this, "Apply Style Class",
+				 names.isEmpty()
+				 ? "There are no style classes yet."
+				 : "Select some nodes or edges first.");
+	return;
+    }
+
+    bool ok;
+    names.prepend("(none)");
+    QString name = QInputDialog::getItem(this, "Apply Style Class",
+					 "Class:", names, 1, false, &ok);
+    if (!ok)
+	return;
+
+    StyleClass * styleClass = StyleClass::find(name);
+    foreach (QGraphicsItem * item, selectedList)
+    {
+	if (item->type() == Node::Type)
+	    qgraphicsitem_cast<Node *>(item)->setStyleClass(styleClass);
+	else if (item->type() == Edge::Type)
+	    qgraphicsitem_cast<Edge *>(item)->setStyleClass(styleClass);
+    }
+    somethingChanged();
+}
+
+
+
+/*
+ * Name:	editStyleClass()
+ * Purpose:	Change one value of a style class.
+ * Arguments:	None.
+ * Outputs:	Dialogs asking for the class, the value to change and
+ *		its new value.
+ * Modifies:	The class, and so all of its members.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	The members are not visited (except for a new diameter
+ *		or label size, see StyleClass::setValues()); one
+ *		update of each scene redraws them.
+ */
+
+void
+MainWindow::editStyleClass()
+{
+    QStringList names = StyleClass::names();
+    if (names.isEmpty())
+    {
+	QMessageBox::information(this, "Edit Style Class",
+				 "There are no style classes yet.");
+	return;
+    }
+
+    bool ok;
+    QString name = QInputDialog::getItem(this, "Edit Style Class",
+					 "Class:", names, 0, false, &ok);
+    if (!ok)
+	return;
+
+    QStringList what = { "Fill colour", "Outline colour", "Diameter",
+			 "Pen width", "Label size", "Edge colour" };
+    QString which = QInputDialog::getItem(this, "Edit Style Class \"" + name
+					  + "\"", "Change:", what, 0, false,
+					  &ok);
+    if (!ok)
+	return;
+
+    StyleClass * styleClass = StyleClass::find(name);
+    StyleClass::Values v = styleClass->values();
+    QColor * colour = nullptr;
+    qreal * number = nullptr;
+    qreal max = 0;
+    int decimals = 0;
+
+    switch (what.indexOf(which))
+    {
+      case 0: colour = &v.fillColour; break;
+      case 1: colour = &v.lineColour; break;
+      case 2: number = &v.diameter; max = 10; decimals = 3; break;
+      case 3: number = &v.penWidth; max = 100; decimals = 1; break;
+      case 4: number = &v.labelSize; max = 100; decimals = 0; break;
+      case 5: colour = &v.edgeColour; break;
+    }
+
+    if (colour != nullptr)
+    {
+	QColor c = QColorDialog::getColor(*colour, this, which);
+	if (!c.isValid())
+	    return;
+	*colour = c;
+    }
+    else
+    {
+	*number = QInputDialog::getDouble(this, "Edit Style Class \"" + name
+					  + "\"", which + ":", *number,
+					  0, max, decimals, &ok);
+	if (!ok)
+	    return;
+    }
+
+    styleClass->setValues(v);
+    ui->canvas->scene()->update();
+    ui->preview->scene()->update();
+    somethingChanged();
+}
+
+
+
+/*
+ * Name:	runScript()
+ * Purpose:	Run a JavaScript program on the canvas.
+ * Arguments:	None.
+ * Outputs:	A file dialog, and a message box if the script fails.
+ * Modifies:	Whatever the script does to the canvas.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	See scriptengine.h for what scripts can do.  Whatever
+ *		the script did before an error is kept.
+ */
+
+void
+MainWindow::runScript()
+{
+    QString fileName = QFileDialog::getOpenFileName(
+	this, "Run Script", settings.value("scriptDirectory").toString(),
+	"JavaScript (*.js)");
+    if (fileName.isEmpty())
+	return;
+    settings.setValue("scriptDirectory", QFileInfo(fileName).absolutePath());
+
+    ScriptEngine scriptEngine(ui->canvas->scene());
+    QString errorMessage;
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    bool ok = scriptEngine.runFile(fileName, &errorMessage);
+    QApplication::restoreOverrideCursor();
+    if (!ok)
+	QMessageBox::warning(this, "Run Script", errorMessage);
+
+    updateCanvasGraphList();
+    somethingChanged();
+}
+
+
+
+/*
+ * Name:	openHugeGraph()
+ * Purpose:	Open an edge list too big for the canvas in a viewer
+ *		window.
+ * Arguments:	None.
+ * Outputs:	A file dialog, and a message box if the file can't be
+ *		read.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	The file is read and laid out as a job (which shows in
+ *		the status bar and can be cancelled there), and the
+ *		viewer (see hugegraphview.h) opens when it is done.
+ *		Any number of viewers may be open at once.
+ */
+
+void
+MainWindow::openHugeGraph()
+{
+    QString fileName = QFileDialog::getOpenFileName(
+	this, "Open Huge Graph", settings.value("hugeGraphDirectory").toString(),
+	"Edge list (*.edges);;All files (*)");
+    if (fileName.isEmpty())
+	return;
+    settings.setValue("hugeGraphDirectory",
+		      QFileInfo(fileName).absolutePath());
+
+    typedef struct
+    {
+	QSharedPointer<HugeGraph> graph;
+	QString errorMessage;
+    } Loaded;
+    QSharedPointer<Loaded> loaded(new Loaded);
+
+    JobScheduler::instance()->submit(
+	"Loading " + QFileInfo(fileName).fileName(),
+	JobScheduler::NormalPriority,
+	[fileName, loaded](JobToken & token) {
+	    loaded->graph = QSharedPointer<HugeGraph>(
+		HugeGraph::loadEdgelist(fileName, &token,
+					&loaded->errorMessage));
+	    return QVariant();
+	},
+	this,
+	[this, loaded](const QVariant &) {
+	    if (loaded->graph.isNull())
+	    {
+		QMessageBox::warning(this, "Open Huge Graph",
+				     loaded->errorMessage);
+		return;
+	    }
+	    HugeGraphView * view = new HugeGraphView(loaded->graph);
+	    view->setAttribute(Qt::WA_DeleteOnClose);
+	    connect(view, SIGNAL(promote()),
+		    this, SLOT(editHugeGraphSelection()));
+	    view->show();
+	});
+}
+
+
+
+/*
+ * Name:	editHugeGraphSelection()
+ * Purpose:	Copy the nodes selected in a huge graph viewer (and the
+ *		edges between them) onto the canvas.
+ * Arguments:	None.
+ * Outputs:	A message box if too many nodes are selected.
+ * Modifies:	The canvas.
+ * Returns:	Nothing.
+ * Assumptions:	The sender is a HugeGraphView.
+ * Bugs:	None known.
+ * Notes:	The copy is an ordinary graph, with no connection to
+ *		the huge graph; it is put to the right of whatever is
+ *		already on the canvas.
+ */
+
+void
+MainWindow::editHugeGraphSelection()
+{
+    HugeGraphView * view = qobject_cast<HugeGraphView *>(sender());
+    if (view == nullptr)
+	return;
+
+    QVector<int> nodes = view->getSelection();
+    if (nodes.count() > HUGE_GRAPH_EDIT_LIMIT)
+    {
+	QMessageBox::warning(view, "Edit Selection",
+			     QString("%1 nodes are selected, but at most %2 "
+				     "can be put on the canvas.  Please "
+				     "select a smaller region.")
+			     .arg(nodes.count()).arg(HUGE_GRAPH_EDIT_LIMIT));
+	return;
+    }
+
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    Graph * graph = view->getGraph()->toGraph(nodes);
+    QRectF others = CanvasScene::contentBoundsOf(ui->canvas->scene());
+    QRectF bounds = graph->childrenBoundingRect();
+    if (!others.isEmpty())
+	graph->setPos(others.right() + HUGE_NODE_SPACING * SCENE_DPI
+		      + bounds.width() / 2, others.center().y());
+    ui->canvas->scene()->addItem(graph);
+    canvasGraphList.append(graph);
+    QApplication::restoreOverrideCursor();
+
+    ui->canvas->centerOn(graph);
+    updateCanvasGraphList();
+    somethingChanged();
+    activateWindow();
+}
+
+
+
+/*
+ * Name:	recordSession()
+ * Purpose:	Start or stop recording what the user does on the
+ *		canvas.
+ * Arguments:	Whether to record.
+ * Outputs:	A file dialog, and a message box if the file can't be
+ *		written.
+ * Modifies:	The session recorder's state, and the check mark on
+ *		the menu item if recording doesn't start.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	Menu commands other than Save (arranging, graph
+ *		operations, scripts, ...) are not recorded, so a
+ *		session which uses them won't replay faithfully.
+ * Notes:	See sessionrecorder.h for what is recorded, and
+ *		"Graphic --replay" (sessionreplayer.h) for replaying.
+ */
+
+void
+MainWindow::recordSession(bool on)
+{
+    if (!on)
+    {
+	SessionRecorder::stop();
+	return;
+    }
+
+    QString fileName = QFileDialog::getSaveFileName(
+	this, "Record Session", settings.value("sessionDirectory").toString(),
+	SESSION_SAVE_FILE);
+    QString errorMessage;
+    if (fileName.isEmpty()
+	|| !SessionRecorder::start(fileName, ui->canvas, &errorMessage))
+    {
+	if (!fileName.isEmpty())
+	    QMessageBox::warning(this, "Record Session", errorMessage);
+	ui->actionRecord_Session->blockSignals(true);
+	ui->actionRecord_Session->setChecked(false);
+	ui->actionRecord_Session->blockSignals(false);
+	return;
+    }
+    settings.setValue("sessionDirectory", QFileInfo(fileName).absolutePath());
+}
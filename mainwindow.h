@@ -2,7 +2,7 @@
  * File:	mainwindow.h
  * Author:	Rachel Bood
  * Date:	January 25, 2015.
- * Version:	1.25
+ * Version:	1.38
  *
  * Purpose:	Define the MainWindow class.
  *
@@ -86,6 +86,34 @@
  *	reflect the fact that many functions were moved to file-io.
  * Nov 12, 2020 (JD V1.25)
  *  (a) Rename resetCanvasGraphTab() to resetEditCanvasGraphTabWidgets()
+ * Oct 19, 2026 (JD V1.26)
+ *  (a) Add the status bar widgets and slots which show the progress
+ *	of background jobs (see jobscheduler.h) and allow them to be
+ *	cancelled.
+ * Oct 19, 2026 (JD V1.27)
+ *  (a) Add collapseSelectedNodes() and expandSelectedNodes().
+ * Oct 19, 2026 (JD V1.28)
+ *  (a) Add filterView() and clearViewFilter().
+ * Oct 19, 2026 (JD V1.29)
+ *  (a) Add minimapDock.
+ * Oct 19, 2026 (JD V1.30)
+ *  (a) Add findLabels(), showNextFound() and their members.
+ * Oct 19, 2026 (JD V1.31)
+ *  (a) Add arrangeSelectedNodes().
+ * Oct 19, 2026 (JD V1.32)
+ *  (a) Add editGraphStructure().
+ * Oct 19, 2026 (JD V1.33)
+ *  (a) Add placeEdgeLabels().
+ * Oct 19, 2026 (JD V1.34)
+ *  (a) Add checkEdges(), checkEdgesWhileMoving() and showClashes().
+ * Oct 19, 2026 (JD V1.35)
+ *  (a) Add newStyleClass(), applyStyleClass() and editStyleClass().
+ * Oct 19, 2026 (JD V1.36)
+ *  (a) Add runScript().
+ * Oct 19, 2026 (JD V1.37)
+ *  (a) Add openHugeGraph() and editHugeGraphSelection().
+ * Oct 19, 2026 (JD V1.38)
+ *  (a) Add recordSession().
  */
 
 
@@ -97,7 +125,14 @@
 #include <QtGui>
 #include <QGridLayout>
 #include <QScrollArea>
+#include <QLabel>
+#include <QProgressBar>
+#include <QToolButton>
+#include <QDockWidget>
+#include <QPointer>
 
+#include "arrange.h"
+#include "graphops.h"
 #include "defuns.h"
 #include "graph.h"
 #include "settingsdialog.h"
@@ -182,7 +217,33 @@ class MainWindow : public QMainWindow
 			    qreal nodeThickness,    bool edgeLabelsNumbered,
 			    qreal edgeNumStart);
 
+    void jobStarted(int jobID, QString name);
+    void jobProgress(int jobID, int percent);
+    void jobsBusyChanged(bool busy);
+
+    void collapseSelectedNodes();
+    void expandSelectedNodes();
+
+    void filterView();
+    void clearViewFilter();
+    void placeEdgeLabels(bool on);
+    void checkEdges();
+    void checkEdgesWhileMoving(bool on);
+    void showClashes(int edges);
+    void newStyleClass();
+    void applyStyleClass();
+    void editStyleClass();
+    void runScript();
+    void openHugeGraph();
+    void editHugeGraphSelection();
+    void recordSession(bool on);
+
+    void findLabels(QString text);
+    void showNextFound();
+
   private:
+    void arrangeSelectedNodes(Arrange::Operation op);
+    void editGraphStructure(GraphOps::Operation op);
     void loadWinSizeSettings();
     void saveWinSizeSettings();
 
@@ -192,6 +253,14 @@ class MainWindow : public QMainWindow
     bool promptSave = false;
     SettingsDialog * settingsDialog;
     QLineEdit * offsets;
+    QLabel * jobLabel;
+    QProgressBar * jobProgressBar;
+    QToolButton * jobCancelButton;
+    int currentJobID;
+    QDockWidget * minimapDock;
+    QLineEdit * findEdit;
+    QList<QPointer<QGraphicsObject>> foundItems;
+    int foundIndex;
 };
 
 #endif // MAINWINDOW_H
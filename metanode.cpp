@@ -0,0 +1,613 @@
+/*
+ * File:	metanode.cpp
+ * Author:	Jim Diamond
+ * Date:	2026-10-19
+ * Version:	1.2
+ *
+ * Purpose:	Implement the MetaNode class (see metanode.h).
+ *
+ * Modification history:
+ * Oct 19, 2026 (JD V1.0)
+ *  (a) Initial version.
+ * Oct 19, 2026 (JD V1.1)
+ *  (a) Add revealAll(), concealAll(), reveal() and conceal().
+ *  (b) collapse() takes the collapsed nodes and edges off selectedList
+ *	and out of the canvas scene's undo list.
+ * Oct 19, 2026 (JD V1.2)
+ *  (a) expand() and reveal() move any edges added to the meta-node
+ *	(e.g., in edge mode) to the nearest member, and conceal()
+ *	moves them back, so that no edge is left joined to a deleted
+ *	node or to one which isn't in the scene.  Add nearestMember()
+ *	and moveEnd().
+ */
+
+#include "metanode.h"
+#include "canvasscene.h"
+#include "defuns.h"
+#include "edge.h"
+#include "graph.h"
+#include "node.h"
+
+#include <QGraphicsScene>
+#include <QSet>
+
+QHash<Node *, MetaNode *> MetaNode::metaNodes;
+QList<MetaNode *> MetaNode::revealed;
+
+
+
+/*
+ * Name:	collapse()
+ * Purpose:	Replace the given nodes by a single meta-node.
+ * Arguments:	The nodes to collapse, and a place to put an error
+ *		message.
+ * Outputs:	Nothing.
+ * Modifies:	The nodes' graph and the scene.
+ * Returns:	The new meta-node, or nullptr (with *errorMessage set)
+ *		if the nodes can't be collapsed.
+ * Assumptions:	The nodes are on the canvas.
+ * Bugs:	None known.
+ * Notes:	The collapsed nodes and edges are taken off
+ *		selectedList, and the scene forgets any moves of the
+ *		nodes which Escape could undo, since neither may refer
+ *		to items which aren't in the scene.
+ *		The meta-node is put at the centroid of the nodes,
+ *		takes its colours and label size from the first node,
+ *		and is labelled with the number of nodes it stands
+ *		for.  Its outline is twice as thick as the thickest
+ *		collapsed node's, so it stands out.
+ *		Each aggregate edge takes its style from the first
+ *		hidden edge to the same outside node.
+ */
+
+Node *
+MetaNode::collapse(QList<Node *> nodes, QString * errorMessage)
+{
+    if (nodes.count() < 2)
+    {
+	*errorMessage = "Select at least two nodes to collapse.";
+	return nullptr;
+    }
+
+    Graph * graph = qgraphicsitem_cast<Graph *>(nodes.at(0)->parentItem());
+    if (graph == nullptr || graph->scene() == nullptr)
+    {
+	*errorMessage = "Only nodes on the canvas can be collapsed.";
+	return nullptr;
+    }
+    foreach (Node * node, nodes)
+    {
+	if (node->parentItem() != graph)
+	{
+	    *errorMessage = "All of the nodes to be collapsed must be "
+		"in the same graph.";
+	    return nullptr;
+	}
+    }
+    QGraphicsScene * scene = graph->scene();
+
+    // Work out where the meta-node goes and how big it is.
+    QPointF centroid(0, 0);
+    qreal diameter = 0;
+    qreal penWidth = 0;
+    QSet<Node *> memberSet;
+    foreach (Node * node, nodes)
+    {
+	centroid += node->pos();
+	diameter = qMax(diameter, node->getDiameter());
+	penWidth = qMax(penWidth, node->getPenWidth());
+	memberSet.insert(node);
+    }
+    centroid /= nodes.count();
+
+    // Sort out which edges are hidden, and which outside nodes the
+    // meta-node must be joined to.
+    MetaNode * meta = new MetaNode;
+    QSet<Edge *> seen;
+    QList<Node *> neighbours;
+    QList<Edge *> neighbourStyles;
+    foreach (Node * node, nodes)
+    {
+	foreach (Edge * edge, node->edgeList)
+	{
+	    if (seen.contains(edge))
+		continue;
+	    seen.insert(edge);
+
+	    Node * other = (edge->sourceNode() == node)
+		? edge->destNode() : edge->sourceNode();
+	    meta->hiddenEdges.append(edge);
+	    meta->edgeOffsets.append(edge->pos() - centroid);
+	    meta->isBoundaryEdge.append(!memberSet.contains(other));
+	    if (memberSet.contains(other))
+		meta->outsideEnds.append(nullptr);
+	    else
+	    {
+		meta->outsideEnds.append(other);
+		if (!neighbours.contains(other))
+		{
+		    neighbours.append(other);
+		    neighbourStyles.append(edge);
+		}
+	    }
+	}
+    }
+
+    // Take the members and their edges out of the scene.
+    CanvasScene::forgetNodes(scene, nodes);
+    for (int i = 0; i < meta->hiddenEdges.count(); i++)
+    {
+	Edge * edge = meta->hiddenEdges.at(i);
+	if (selectedList.removeOne(edge))
+	    edge->chosen(0);
+	if (meta->isBoundaryEdge.at(i))
+	    meta->outsideEnds.at(i)->removeEdge(edge);
+	edge->setParentItem(nullptr);
+	scene->removeItem(edge);
+    }
+    foreach (Node * node, nodes)
+    {
+	meta->members.append(node);
+	meta->memberOffsets.append(node->pos() - centroid);
+	selectedList.removeOne(node);
+	node->chosen(0);
+	node->setParentItem(nullptr);
+	scene->removeItem(node);
+    }
+
+    // Make the meta-node and its edges.
+    Node * first = nodes.at(0);
+    Node * metaNode = new Node();
+    metaNode->setDiameter(diameter * META_NODE_SCALE);
+    metaNode->setPenWidth(penWidth > 0 ? penWidth * 2 : 1);
+    metaNode->setFillColour(first->getFillColour());
+    metaNode->setLineColour(first->getLineColour());
+    metaNode->setNodeLabelSize(first->getLabelSize());
+    metaNode->setNodeLabel(QString::number(nodes.count()));
+    metaNode->setRotation(first->getRotation());
+    metaNode->setParentItem(graph);
+    metaNode->setPos(centroid);
+
+    for (int i = 0; i < neighbours.count(); i++)
+    {
+	Node * neighbour = neighbours.at(i);
+	Edge * style = neighbourStyles.at(i);
+	Edge * edge = new Edge(metaNode, neighbour);
+	edge->setPenWidth(style->getPenWidth());
+	edge->setColour(style->getColour());
+	edge->setEdgeLabelSize(style->getLabelSize());
+	edge->setSourceRadius(metaNode->getDiameter() / 2.);
+	edge->setDestRadius(neighbour->getDiameter() / 2.);
+	edge->setRotation(style->getRotation());
+	edge->setParentItem(graph);
+	edge->adjust();
+	meta->aggregateEdges.append(edge);
+    }
+
+    meta->node = metaNode;
+    meta->revealedIn = nullptr;
+    metaNodes.insert(metaNode, meta);
+
+    // If the meta-node is deleted other than by expand() (e.g., the
+    // canvas is cleared), the nodes it stands for go with it.
+    QObject::connect(metaNode, &QObject::destroyed, [metaNode]() {
+	MetaNode * gone = metaNodes.take(metaNode);
+	if (gone == nullptr)
+	    return;
+	qDeleteAll(gone->hiddenEdges);
+	qDeleteAll(gone->members);
+	delete gone;
+    });
+
+    qDeb() << "MetaNode::collapse(): " << nodes.count() << " nodes and "
+	   << meta->hiddenEdges.count() << " edges replaced by 1 node and "
+	   << neighbours.count() << " edges";
+
+    return metaNode;
+}
+
+
+
+/*
+ * Name:	expand()
+ * Purpose:	Put the nodes a meta-node stands for back on the canvas.
+ * Arguments:	The meta-node.
+ * Outputs:	Nothing.
+ * Modifies:	The meta-node's graph and the scene.
+ * Returns:	True if the meta-node was expanded (and deleted),
+ *		false if it isn't a meta-node or isn't on the canvas.
+ * Assumptions:	None.
+ * Bugs:	If the graph was rotated after the collapse, the
+ *		members come back in their unrotated arrangement.
+ * Notes:	The members are put back relative to where the
+ *		meta-node is now, so moving the meta-node moves them.
+ *		Aggregate edges which the user has deleted in the
+ *		meantime are simply gone.  Other edges which the user
+ *		has added to the meta-node go to the member nearest
+ *		their other end.  If an outside node has been
+ *		deleted, the hidden edges to it are deleted here.
+ */
+
+bool
+MetaNode::expand(Node * node)
+{
+    MetaNode * meta = metaNodes.value(node, nullptr);
+    if (meta == nullptr)
+	return false;
+
+    Graph * graph = qgraphicsitem_cast<Graph *>(node->parentItem());
+    if (graph == nullptr || graph->scene() == nullptr)
+	return false;
+    QGraphicsScene * scene = graph->scene();
+    QPointF centre = node->pos();
+
+    foreach (QPointer<Edge> edge, meta->aggregateEdges)
+    {
+	if (edge.isNull())
+	    continue;
+	edge->sourceNode()->removeEdge(edge);
+	edge->destNode()->removeEdge(edge);
+	edge->setParentItem(nullptr);
+	scene->removeItem(edge);
+	delete edge;
+    }
+
+    for (int i = 0; i < meta->members.count(); i++)
+    {
+	Node * member = meta->members.at(i);
+	member->setParentItem(graph);
+	member->setPos(centre + meta->memberOffsets.at(i));
+    }
+    for (int i = 0; i < meta->hiddenEdges.count(); i++)
+    {
+	Edge * edge = meta->hiddenEdges.at(i);
+	if (meta->isBoundaryEdge.at(i))
+	{
+	    // If the outside node has been deleted, so is the edge.
+	    Node * outside = meta->outsideEnds.at(i);
+	    if (outside == nullptr)
+	    {
+		// Only compare the pointers: the other end is gone.
+		Node * member = meta->members.contains(edge->sourceNode())
+		    ? edge->sourceNode() : edge->destNode();
+		member->removeEdge(edge);
+		delete edge;
+		continue;
+	    }
+	    outside->addEdge(edge);
+	}
+	edge->setParentItem(graph);
+	edge->setPos(centre + meta->edgeOffsets.at(i));
+	edge->adjust();
+    }
+
+    // Only the edges added since the collapse are left.
+    foreach (Edge * edge, node->edgeList)
+	moveEnd(edge, node, meta->nearestMember(edge));
+
+    metaNodes.remove(node);
+    node->setParentItem(nullptr);
+    scene->removeItem(node);
+    delete node;
+    delete meta;
+
+    return true;
+}
+
+
+
+/*
+ * Name:	expandAll()
+ * Purpose:	Expand every meta-node, including nested ones.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	The canvas graphs and the scene.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Only meta-nodes on the canvas can be expanded, so keep
+ *		going until a pass expands nothing.
+ */
+
+void
+MetaNode::expandAll()
+{
+    bool expandedOne = true;
+
+    while (expandedOne && !metaNodes.isEmpty())
+    {
+	expandedOne = false;
+	foreach (Node * node, metaNodes.keys())
+	    if (expand(node))
+		expandedOne = true;
+    }
+}
+
+
+
+/*
+ * Name:	revealAll()
+ * Purpose:	Put the nodes and edges which every meta-node
+ *		(including nested ones) stands for back in the scene
+ *		for a while, without expanding any meta-node.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	The canvas graphs, the scene and revealed.
+ * Returns:	Nothing.
+ * Assumptions:	concealAll() is called before anything else changes
+ *		the canvas.
+ * Bugs:	None known.
+ * Notes:	Called before the canvas is written out, so that what
+ *		is written is the whole graph.  As for expandAll(),
+ *		an inner meta-node is only in the scene once the outer
+ *		one has been revealed, so keep going until a pass
+ *		reveals nothing.
+ */
+
+void
+MetaNode::revealAll()
+{
+    bool revealedOne = true;
+
+    while (revealedOne)
+    {
+	revealedOne = false;
+	foreach (MetaNode * meta, metaNodes)
+	{
+	    if (!revealed.contains(meta) && meta->reveal())
+	    {
+		revealed.append(meta);
+		revealedOne = true;
+	    }
+	}
+    }
+}
+
+
+
+/*
+ * Name:	concealAll()
+ * Purpose:	Undo revealAll().
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	The canvas graphs, the scene and revealed.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	The meta-nodes are concealed in the opposite order to
+ *		that in which they were revealed, so that an inner
+ *		meta-node is back in the scene when the outer one
+ *		takes it out again.
+ */
+
+void
+MetaNode::concealAll()
+{
+    while (!revealed.isEmpty())
+	revealed.takeLast()->conceal();
+}
+
+
+
+/*
+ * Name:	reveal()
+ * Purpose:	Swap this meta-node (and its aggregate edges) for the
+ *		nodes and edges it stands for.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	The meta-node's graph, the scene, the edgeLists of
+ *		the outside nodes, and revealedIn.
+ * Returns:	True if the meta-node was revealed, false if it isn't
+ *		on the canvas.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	The same as expand(), except that nothing is created
+ *		or deleted, and what is taken out of the scene is kept
+ *		so conceal() can put it back.  A hidden edge to an
+ *		outside node which has since been deleted would be
+ *		deleted by expand(), so it is deleted here too.
+ */
+
+bool
+MetaNode::reveal()
+{
+    Graph * graph = qgraphicsitem_cast<Graph *>(node->parentItem());
+    if (graph == nullptr || graph->scene() == nullptr)
+	return false;
+    QGraphicsScene * scene = graph->scene();
+    QPointF centre = node->pos();
+
+    foreach (QPointer<Edge> edge, aggregateEdges)
+    {
+	if (edge.isNull())
+	    continue;
+	edge->sourceNode()->removeEdge(edge);
+	edge->destNode()->removeEdge(edge);
+	edge->setParentItem(nullptr);
+	scene->removeItem(edge);
+    }
+
+    for (int i = 0; i < members.count(); i++)
+    {
+	Node * member = members.at(i);
+	member->setParentItem(graph);
+	member->setPos(centre + memberOffsets.at(i));
+    }
+    for (int i = hiddenEdges.count() - 1; i >= 0; i--)
+    {
+	Edge * edge = hiddenEdges.at(i);
+	if (isBoundaryEdge.at(i))
+	{
+	    Node * outside = outsideEnds.at(i);
+	    if (outside == nullptr)
+	    {
+		// Only compare the pointers: the other end is gone.
+		Node * member = members.contains(edge->sourceNode())
+		    ? edge->sourceNode() : edge->destNode();
+		member->removeEdge(edge);
+		delete edge;
+		hiddenEdges.removeAt(i);
+		edgeOffsets.removeAt(i);
+		isBoundaryEdge.removeAt(i);
+		outsideEnds.removeAt(i);
+		continue;
+	    }
+	    outside->addEdge(edge);
+	}
+	edge->setParentItem(graph);
+	edge->setPos(centre + edgeOffsets.at(i));
+	edge->adjust();
+    }
+
+    // As in expand(), the edges added since the collapse go to the
+    // nearest member, for now.
+    foreach (Edge * edge, node->edgeList)
+    {
+	Node * member = nearestMember(edge);
+	moveEnd(edge, node, member);
+	movedEdges.append(edge);
+	movedTo.append(member);
+    }
+
+    node->setParentItem(nullptr);
+    scene->removeItem(node);
+    revealedIn = graph;
+
+    return true;
+}
+
+
+
+/*
+ * Name:	conceal()
+ * Purpose:	Undo reveal().
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	The meta-node's graph, the scene, the edgeLists of
+ *		the outside nodes, and revealedIn.
+ * Returns:	Nothing.
+ * Assumptions:	reveal() returned true, and nothing has changed the
+ *		canvas since.
+ * Bugs:	None known.
+ * Notes:	The members' positions are not kept, since expand()
+ *		puts them back relative to the meta-node anyway.
+ */
+
+void
+MetaNode::conceal()
+{
+    QGraphicsScene * scene = revealedIn->scene();
+
+    for (int i = 0; i < hiddenEdges.count(); i++)
+    {
+	Edge * edge = hiddenEdges.at(i);
+	if (isBoundaryEdge.at(i))
+	    outsideEnds.at(i)->removeEdge(edge);
+	edge->setParentItem(nullptr);
+	scene->removeItem(edge);
+    }
+    foreach (Node * member, members)
+    {
+	member->setParentItem(nullptr);
+	scene->removeItem(member);
+    }
+
+    node->setParentItem(revealedIn);
+    foreach (QPointer<Edge> edge, aggregateEdges)
+    {
+	if (edge.isNull())
+	    continue;
+	edge->sourceNode()->addEdge(edge);
+	edge->destNode()->addEdge(edge);
+	edge->setParentItem(revealedIn);
+	edge->adjust();
+    }
+    for (int i = 0; i < movedEdges.count(); i++)
+	moveEnd(movedEdges.at(i), movedTo.at(i), node);
+    movedEdges.clear();
+    movedTo.clear();
+    revealedIn = nullptr;
+}
+
+
+
+/*
+ * Name:	nearestMember()
+ * Purpose:	Find the member to give an edge of the meta-node to.
+ * Arguments:	The edge.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The member nearest the edge's other end.
+ * Assumptions:	The members are in the scene, and the edge has the
+ *		meta-node at one end.
+ * Bugs:	None known.
+ * Notes:	There are at least two members (see collapse()).
+ */
+
+Node *
+MetaNode::nearestMember(Edge * edge)
+{
+    Node * other = (edge->sourceNode() == node)
+	? edge->destNode() : edge->sourceNode();
+    QPointF there = other->scenePos();
+    Node * nearest = nullptr;
+    qreal nearestDist = 0;
+
+    foreach (Node * member, members)
+    {
+	QPointF d = member->scenePos() - there;
+	qreal dist = d.x() * d.x() + d.y() * d.y();
+	if (nearest == nullptr || dist < nearestDist)
+	{
+	    nearest = member;
+	    nearestDist = dist;
+	}
+    }
+    return nearest;
+}
+
+
+
+/*
+ * Name:	moveEnd()
+ * Purpose:	Move one end of an edge from one node to another.
+ * Arguments:	The edge, the node it leaves and the node it goes to.
+ * Outputs:	Nothing.
+ * Modifies:	The edge and both nodes' edgeLists.
+ * Returns:	Nothing.
+ * Assumptions:	"from" is one end of the edge.
+ * Bugs:	None known.
+ * Notes:	As in GraphOps::identifyNodes().
+ */
+
+void
+MetaNode::moveEnd(Edge * edge, Node * from, Node * to)
+{
+    from->removeEdge(edge);
+    if (edge->sourceNode() == from)
+	edge->setSourceNode(to);
+    else
+	edge->setDestNode(to);
+    to->addEdge(edge);
+    edge->adjust();
+}
+
+
+
+/*
+ * Name:	isMetaNode()
+ * Purpose:	Tell whether a node is a meta-node.
+ * Arguments:	The node.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	True iff the node is a meta-node.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+bool
+MetaNode::isMetaNode(Node * node)
+{
+    return metaNodes.contains(node);
+}
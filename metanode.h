@@ -0,0 +1,97 @@
+/*
+ * File:	metanode.h
+ * Author:	Jim Diamond
+ * Date:	2026-10-19
+ * Version:	1.2
+ *
+ * Purpose:	Define the MetaNode class, which collapses a set of
+ *		nodes of a canvas graph into a single stand-in node
+ *		(a "meta-node") and expands it again on demand.
+ *
+ * Notes:	The collapsed nodes, and every edge with at least one
+ *		end among them, are taken out of the scene entirely, so
+ *		they cost nothing to draw or to hit-test.  Their places
+ *		are taken by the meta-node and one "aggregate" edge from
+ *		the meta-node to each outside neighbour.
+ *		Edges between a collapsed node and an outside node are
+ *		also taken off the outside node's edgeList, so that code
+ *		which walks the graph (e.g., searchAndSeparate()) only
+ *		sees what is on the canvas.
+ *		A meta-node is an ordinary Node as far as the rest of
+ *		the program is concerned; deleting it deletes the nodes
+ *		it stands for.  However, the collapsed nodes are not in
+ *		the scene, so anything which writes out the whole
+ *		canvas must call revealAll() first and concealAll()
+ *		once it is done.  These put the collapsed nodes and
+ *		edges back in the scene, and take the meta-nodes and
+ *		aggregate edges out of it, without creating or
+ *		deleting anything, so the canvas is exactly as it was
+ *		afterwards.
+ *		Edges which are added to a meta-node after it is made
+ *		(e.g., in edge mode) are moved to the member nearest
+ *		their other end when it is expanded, and while it is
+ *		revealed.
+ *		Meta-nodes may be nested; an inner one can only be
+ *		expanded once the outer one has been.
+ *
+ * Modification history:
+ * Oct 19, 2026 (JD V1.0)
+ *  (a) Initial version.
+ * Oct 19, 2026 (JD V1.1)
+ *  (a) Add revealAll() and concealAll(), so that the canvas can be
+ *	written out without expanding the meta-nodes for good.
+ * Oct 19, 2026 (JD V1.2)
+ *  (a) Add nearestMember(), moveEnd(), movedEdges and movedTo, so
+ *	that edges added to a meta-node survive its expansion.
+ */
+
+#ifndef METANODE_H
+#define METANODE_H
+
+#include <QHash>
+#include <QList>
+#include <QPointer>
+#include <QPointF>
+#include <QString>
+
+class Edge;
+class Graph;
+class Node;
+
+// The meta-node is this much bigger than the biggest collapsed node.
+#define META_NODE_SCALE	1.5
+
+class MetaNode
+{
+  public:
+    static Node * collapse(QList<Node *> nodes, QString * errorMessage);
+    static bool expand(Node * node);
+    static void expandAll();
+    static void revealAll();
+    static void concealAll();
+    static bool isMetaNode(Node * node);
+    static int count() { return metaNodes.count(); }
+
+  private:
+    Node * node;			// The stand-in node.
+    QList<Node *> members;		// The collapsed nodes...
+    QList<QPointF> memberOffsets;	// ... and where they were wrt node.
+    QList<Edge *> hiddenEdges;		// Edges touching a member...
+    QList<QPointF> edgeOffsets;		// ... and where they were.
+    QList<bool> isBoundaryEdge;		// Does it join a member to an
+    QList<QPointer<Node>> outsideEnds;	// outside node?  Which one?
+    QList<QPointer<Edge>> aggregateEdges; // Edges from node to outside.
+    Graph * revealedIn;			// Set by reveal(), for conceal().
+    QList<Edge *> movedEdges;		// Added edges moved by reveal()...
+    QList<Node *> movedTo;		// ... and the members they went to.
+
+    bool reveal();
+    void conceal();
+    Node * nearestMember(Edge * edge);
+    static void moveEnd(Edge * edge, Node * from, Node * to);
+
+    static QHash<Node *, MetaNode *> metaNodes;
+    static QList<MetaNode *> revealed;	// In the order of revealing.
+};
+
+#endif // METANODE_H
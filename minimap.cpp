@@ -0,0 +1,357 @@
+/*
+ * File:	minimap.cpp
+ * Author:	Jim Diamond
+ * Date:	2026-10-19
+ * Version:	1.2
+ *
+ * Purpose:	Implement the Minimap class (see minimap.h).
+ *
+ * Modification history:
+ * Oct 19, 2026 (JD V1.0)
+ *  (a) Initial version.
+ * Oct 19, 2026 (JD V1.1)
+ *  (a) Use the canvas scene's content bounds instead of
+ *	itemsBoundingRect().
+ * Oct 19, 2026 (JD V1.2)
+ *  (a) rebuildCache() fills the new image before rendering into it,
+ *	so the letterbox margins (or the whole image, for an empty
+ *	canvas) aren't left uninitialized.
+ */
+
+#include "minimap.h"
+#include "canvasscene.h"
+#include "defuns.h"
+
+#include <QGraphicsScene>
+#include <QGraphicsView>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QScrollBar>
+#include <QTimer>
+
+// Leave this fraction of the covered area around the scene, so that
+// a graph dragged a little past the edge doesn't force a rebuild.
+#define MINIMAP_MARGIN	0.1
+
+
+
+/*
+ * Name:	Minimap()
+ * Purpose:	Constructor.
+ * Arguments:	The view to give an overview of, and the parent widget.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	The view's scene is set and is never replaced.
+ * Bugs:	None known.
+ * Notes:	The cache is built the first time the minimap is shown.
+ */
+
+Minimap::Minimap(QGraphicsView * view, QWidget * parent)
+    : QWidget(parent), view(view), needsRebuild(true)
+{
+    setMinimumSize(100, 75);
+    setCursor(Qt::PointingHandCursor);
+    setToolTip(tr("Click or drag to move around the canvas"));
+
+    updateTimer = new QTimer(this);
+    updateTimer->setSingleShot(true);
+    updateTimer->setInterval(MINIMAP_UPDATE_DELAY);
+    connect(updateTimer, SIGNAL(timeout()), this, SLOT(updateCache()));
+
+    connect(view->scene(), SIGNAL(changed(const QList<QRectF> &)),
+	    this, SLOT(sceneChanged(const QList<QRectF> &)));
+
+    // Scrolling and zooming only move the viewport rectangle.
+    connect(view->horizontalScrollBar(), SIGNAL(valueChanged(int)),
+	    this, SLOT(update()));
+    connect(view->verticalScrollBar(), SIGNAL(valueChanged(int)),
+	    this, SLOT(update()));
+    connect(view->horizontalScrollBar(), SIGNAL(rangeChanged(int, int)),
+	    this, SLOT(update()));
+    connect(view->verticalScrollBar(), SIGNAL(rangeChanged(int, int)),
+	    this, SLOT(update()));
+}
+
+
+
+QSize
+Minimap::sizeHint() const
+{
+    return QSize(200, 150);
+}
+
+
+
+/*
+ * Name:	sceneChanged()
+ * Purpose:	Note which parts of the scene need to be re-rendered.
+ * Arguments:	The changed areas, in scene coordinates.
+ * Outputs:	Nothing.
+ * Modifies:	dirtyArea, needsRebuild.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	Two small changes far apart re-render everything
+ *		between them.
+ * Notes:	Connected to QGraphicsScene::changed().  The actual
+ *		work is put off until the timer fires.
+ */
+
+void
+Minimap::sceneChanged(const QList<QRectF> & region)
+{
+    foreach (QRectF rect, region)
+    {
+	if (rect.isEmpty())
+	    continue;
+	dirtyArea |= rect;
+	if (!cachedArea.contains(rect))
+	    needsRebuild = true;
+    }
+
+    if (!updateTimer->isActive()
+	&& (needsRebuild || !dirtyArea.isEmpty()))
+	updateTimer->start();
+}
+
+
+
+/*
+ * Name:	updateCache()
+ * Purpose:	Bring the cached image up to date.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	The cache.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Nothing is done while the minimap is hidden; the
+ *		changes are remembered and dealt with when it is next
+ *		painted.
+ */
+
+void
+Minimap::updateCache()
+{
+    if (!isVisible())
+	return;
+
+    if (needsRebuild || cache.size() != size())
+	rebuildCache();
+    else if (!dirtyArea.isEmpty())
+	renderArea(dirtyArea);
+
+    dirtyArea = QRectF();
+    update();
+}
+
+
+
+/*
+ * Name:	rebuildCache()
+ * Purpose:	Re-render the whole cache.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	cache, cachedArea, needsRebuild.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	The area covered is everything in the scene, plus the
+ *		view's scene rect, plus a margin.
+ *		This is only done when the scene outgrows the cache,
+ *		since rendering the whole scene is slow; the bounds
+ *		themselves are kept up to date by the canvas scene.
+ */
+
+void
+Minimap::rebuildCache()
+{
+    QRectF area = view->sceneRect()
+	| CanvasScene::contentBoundsOf(view->scene());
+    qreal dx = area.width() * MINIMAP_MARGIN / 2;
+    qreal dy = area.height() * MINIMAP_MARGIN / 2;
+
+    cachedArea = area.adjusted(-dx, -dy, dx, dy);
+    cache = QImage(size(), QImage::Format_ARGB32_Premultiplied);
+    cache.fill(palette().base().color());
+    needsRebuild = false;
+    if (cache.isNull() || cachedArea.isEmpty())
+	return;
+
+    renderArea(cachedArea);
+}
+
+
+
+/*
+ * Name:	renderArea()
+ * Purpose:	Render part of the scene into the cache.
+ * Arguments:	The part of the scene to render.
+ * Outputs:	Nothing.
+ * Modifies:	The cache.
+ * Returns:	Nothing.
+ * Assumptions:	The area lies within cachedArea.
+ * Bugs:	None known.
+ * Notes:	The area is widened to whole cache pixels, so that
+ *		no seams are left between updates.  No antialiasing is
+ *		done; at this scale it would not be noticed.
+ */
+
+void
+Minimap::renderArea(const QRectF & sceneArea)
+{
+    QTransform transform = sceneToCache();
+    QRect target = transform.mapRect(sceneArea).toAlignedRect()
+	& cache.rect();
+    if (target.isEmpty())
+	return;
+    QRectF source = transform.inverted().mapRect(QRectF(target));
+
+    QPainter painter(&cache);
+    painter.setClipRect(target);
+    painter.fillRect(target, palette().base());
+    view->scene()->render(&painter, QRectF(target), source,
+			  Qt::IgnoreAspectRatio);
+}
+
+
+
+/*
+ * Name:	sceneToCache()
+ * Purpose:	Work out how scene coordinates map onto the cache.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The transform.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	The scene area is scaled to fit the cache, keeping its
+ *		aspect ratio, and centred.
+ */
+
+QTransform
+Minimap::sceneToCache() const
+{
+    QTransform transform;
+
+    if (cachedArea.isEmpty())
+	return transform;
+
+    qreal scale = qMin(width() / cachedArea.width(),
+		       height() / cachedArea.height());
+    transform.translate((width() - cachedArea.width() * scale) / 2,
+			(height() - cachedArea.height() * scale) / 2);
+    transform.scale(scale, scale);
+    transform.translate(-cachedArea.left(), -cachedArea.top());
+    return transform;
+}
+
+
+
+/*
+ * Name:	paintEvent()
+ * Purpose:	Draw the cached overview and the viewport rectangle.
+ * Arguments:	The paint event.
+ * Outputs:	The minimap.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	If changes were held back while the minimap was hidden,
+ *		they are rendered now.
+ */
+
+void
+Minimap::paintEvent(QPaintEvent * event)
+{
+    Q_UNUSED(event);
+
+    if (needsRebuild || cache.size() != size() || !dirtyArea.isEmpty())
+    {
+	updateTimer->stop();
+	if (needsRebuild || cache.size() != size())
+	    rebuildCache();
+	else
+	    renderArea(dirtyArea);
+	dirtyArea = QRectF();
+    }
+
+    QPainter painter(this);
+    painter.fillRect(rect(), palette().window());
+    painter.drawImage(0, 0, cache);
+
+    QRectF visible = view->mapToScene(view->viewport()->rect())
+	.boundingRect();
+    QColor colour = palette().highlight().color();
+    painter.setPen(colour);
+    colour.setAlpha(40);
+    painter.setBrush(colour);
+    painter.drawRect(sceneToCache().mapRect(visible)
+		     .adjusted(0, 0, -1, -1));
+}
+
+
+
+/*
+ * Name:	resizeEvent()
+ * Purpose:	Note that the cache no longer fits.
+ * Arguments:	The resize event.
+ * Outputs:	Nothing.
+ * Modifies:	needsRebuild.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	The rebuild itself happens on the next paint.
+ */
+
+void
+Minimap::resizeEvent(QResizeEvent * event)
+{
+    QWidget::resizeEvent(event);
+    needsRebuild = true;
+}
+
+
+
+/*
+ * Name:	mousePressEvent(), mouseMoveEvent()
+ * Purpose:	Centre the view on the point the user clicks or drags to.
+ * Arguments:	The mouse event.
+ * Outputs:	Nothing.
+ * Modifies:	The view's scroll position.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+void
+Minimap::mousePressEvent(QMouseEvent * event)
+{
+    if (event->button() == Qt::LeftButton)
+	centreViewOn(event->pos());
+    else
+	QWidget::mousePressEvent(event);
+}
+
+
+
+void
+Minimap::mouseMoveEvent(QMouseEvent * event)
+{
+    if (event->buttons() & Qt::LeftButton)
+	centreViewOn(event->pos());
+    else
+	QWidget::mouseMoveEvent(event);
+}
+
+
+
+void
+Minimap::centreViewOn(QPoint minimapPos)
+{
+    if (cachedArea.isEmpty())
+	return;
+
+    view->centerOn(sceneToCache().inverted().map(QPointF(minimapPos)));
+}
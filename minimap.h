@@ -0,0 +1,75 @@
+/*
+ * File:	minimap.h
+ * Author:	Jim Diamond
+ * Date:	2026-10-19
+ * Version:	1.0
+ *
+ * Purpose:	Define the Minimap class, a small overview of the whole
+ *		canvas which shows the part currently visible in the
+ *		canvas view and lets the user click (or drag) to pan.
+ *
+ * Notes:	The overview is drawn from a cached low-resolution
+ *		image of the scene.  The scene's changed() signal says
+ *		which areas of the scene are out of date; these are
+ *		collected and, after a short delay, only they are
+ *		re-rendered into the cache.  The whole cache is only
+ *		re-rendered when the minimap is resized or the scene
+ *		grows beyond the area the cache covers.
+ *		Rendering goes into the cache image, never to the
+ *		canvas view, so the minimap doesn't cause the view to
+ *		be redrawn.  Moving the viewport rectangle only
+ *		repaints the minimap widget from the cache.
+ *
+ * Modification history:
+ * Oct 19, 2026 (JD V1.0)
+ *  (a) Initial version.
+ */
+
+#ifndef MINIMAP_H
+#define MINIMAP_H
+
+#include <QImage>
+#include <QList>
+#include <QRectF>
+#include <QWidget>
+
+class QGraphicsView;
+class QTimer;
+
+// How long (ms) to wait after a scene change before updating the
+// cache, so that a burst of changes (e.g., dragging) costs one update.
+#define MINIMAP_UPDATE_DELAY	200
+
+class Minimap : public QWidget
+{
+    Q_OBJECT
+
+  public:
+    Minimap(QGraphicsView * view, QWidget * parent = nullptr);
+    QSize sizeHint() const;
+
+  protected:
+    void paintEvent(QPaintEvent * event);
+    void resizeEvent(QResizeEvent * event);
+    void mousePressEvent(QMouseEvent * event);
+    void mouseMoveEvent(QMouseEvent * event);
+
+  private slots:
+    void sceneChanged(const QList<QRectF> & region);
+    void updateCache();
+
+  private:
+    void rebuildCache();
+    void renderArea(const QRectF & sceneArea);
+    void centreViewOn(QPoint minimapPos);
+    QTransform sceneToCache() const;
+
+    QGraphicsView * view;
+    QImage cache;			// Low-resolution picture of...
+    QRectF cachedArea;			// ... this part of the scene.
+    QRectF dirtyArea;			// What needs re-rendering.
+    bool needsRebuild;			// Re-render all of the cache?
+    QTimer * updateTimer;
+};
+
+#endif // MINIMAP_H
@@ -2,7 +2,7 @@
  * File:    node.cpp
  * Author:  Rachel Bood
  * Date:    2014/11/07
- * Version: 1.20
+ * Version: 1.28
  *
  * Purpose: creates a node for the users graph
  *
@@ -101,13 +101,45 @@
  *  (d) Cleaned up comments.
  *  (e) Removed the long-commented-out setNodeLabel(QString, qreal, QString)
  *      and nodeDeleted() functions.  (The latter had no code anyway.)
+ * Oct 19, 2026 (JD V1.21)
+ *  (a) Add setNodeLabelHtml(), which takes an already-converted label
+ *	so that LabelBatch can do the conversions off the GUI thread.
+ * Oct 19, 2026 (JD V1.22)
+ *  (a) Allocate nodes from an ItemPool (see itempool.h).
+ * Oct 19, 2026 (JD V1.23)
+ *  (a) Add getPen(), split out of paint().
+ *  (b) paint() doesn't draw the circle if the node's graph is
+ *	batch painting (see Graph::paintBatched()).
+ * Oct 19, 2026 (JD V1.24)
+ *  (a) Keep the LabelIndex up to date when the label is set.
+ * Oct 19, 2026 (JD V1.25)
+ *  (a) Add style classes (see styleclass.h): setStyleClass(),
+ *	getStyleClass(), leaveStyleClass() and a destructor.  The colour
+ *	and pen width getters, getPen() and paint() use the class's
+ *	values while the node is in one.
+ * Oct 19, 2026 (JD V1.26)
+ *  (a) Store the diameter in scene units (SCENE_DPI per inch) rather
+ *	than in pixels at whatever resolution was current when the node
+ *	was made; physicalDotsPerInchX is gone.
+ * Oct 19, 2026 (JD V1.27)
+ *  (a) Add sceneExtent().  itemChange() tells the graph how the
+ *	node's extent changed when it moves (see Graph::childMoved()),
+ *	and changes to the diameter or label invalidate the graph's
+ *	extent.
+ * Oct 19, 2026 (JD V1.28)
+ *  (a) itemChange() tells the label index (see labelindex.h) when
+ *	the node joins or leaves a scene.
  */
 
 #include "defuns.h"
 #include "edge.h"
+#include "graph.h"
 #include "node.h"
 #include "canvasview.h"
 #include "preview.h"
+#include "itempool.h"
+#include "labelindex.h"
+#include "styleclass.h"
 
 #include <QTextDocument>
 #include <QKeyEvent>
@@ -146,9 +178,10 @@ Node::Node()
     penStyle = 0;	// What type of pen style to use when drawing outline.
     penSize = 1;        // Size of node outline
     nodeDiameter = 1;
+    styleClass = nullptr;
+    reparenting = false;
     htmlLabel = new HTML_Label(this);
     setHandlesChildEvents(true);
-    physicalDotsPerInchX = currentPhysicalDPI_X;
     checked = 0;
 
     connect(htmlLabel, SIGNAL(editDone(QString)),
@@ -157,6 +190,55 @@ Node::Node()
 
 
 
+/*
+ * Name:        ~Node
+ * Purpose:     Destructor for Node class.
+ * Arguments:   None.
+ * Outputs:     Nothing.
+ * Modifies:    The node's style class, if any.
+ * Returns:     Nothing.
+ * Assumptions: None.
+ * Bugs:        None known.
+ * Notes:       The children (label) are deleted by ~QGraphicsItem().
+ */
+
+Node::~Node()
+{
+    if (styleClass != nullptr)
+        styleClass->removeMember(this);
+}
+
+
+
+/*
+ * Name:        operator new / operator delete
+ * Purpose:     Allocate and free Node objects from a pool.
+ * Arguments:   The size (and, for delete, the pointer).
+ * Outputs:     Nothing.
+ * Modifies:    The Node pool.
+ * Returns:     new: the storage.
+ * Assumptions: Only called on the GUI thread.
+ * Bugs:        None known.
+ * Notes:       See itempool.h.  Generating and clearing large
+ *              graphs creates and destroys thousands of these.
+ */
+
+void *
+Node::operator new(size_t size)
+{
+    return ItemPool<Node>::allocate(size);
+}
+
+
+
+void
+Node::operator delete(void * p, size_t size)
+{
+    ItemPool<Node>::release(p, size);
+}
+
+
+
 /*
  * Name:        addEdge
  * Purpose:     Adds an Edge to the pointer QList of edges.
@@ -217,17 +299,20 @@ Node::removeEdge(Edge * edge)
  * Assumptions: None.
  * Bugs:        None.
  * Notes:       The argument diameter is the diameter in inches, therefore
- *              the value must be converted back to pixels in order for the
- *              node to be drawn correctly.
+ *              the value must be converted to scene units (SCENE_DPI
+ *              per inch) in order for the node to be drawn correctly.
  */
 
 void
 Node::setDiameter(qreal diameter)
 {
-    nodeDiameter = diameter * physicalDotsPerInchX;
+    if (styleClass != nullptr && styleClass->values().diameter != diameter)
+        leaveStyleClass();
+    nodeDiameter = diameter * SCENE_DPI;
     foreach (Edge * edge, edgeList)
 	edge->adjust();
     update();
+    Graph::invalidateExtentOf(this);
 }
 
 
@@ -241,7 +326,7 @@ Node::setDiameter(qreal diameter)
  * Returns:     The node diameter, in inches.
  * Assumptions: None.
  * Bugs:        None.
- * Notes:       nodeDiamter is stored in pixels, it needs to be converted back
+ * Notes:       nodeDiamter is stored in scene units, it needs to be converted back
  *              to inches before it is returned.
  *              FUTURE WORK: create multiple getDiameter() functions to return
  *              different values....or create one function that will return
@@ -251,7 +336,7 @@ Node::setDiameter(qreal diameter)
 qreal
 Node::getDiameter()
 {
-    return nodeDiameter / physicalDotsPerInchX;
+    return nodeDiameter / SCENE_DPI;
 }
 
 
@@ -313,6 +398,8 @@ Node::getRotation()
 void
 Node::setFillColour(QColor fillColour)
 {
+    if (styleClass != nullptr && styleClass->values().fillColour != fillColour)
+        leaveStyleClass();
     nodeFill = fillColour;
     update();
 }
@@ -334,6 +421,8 @@ Node::setFillColour(QColor fillColour)
 QColor
 Node::getFillColour()
 {
+    if (styleClass != nullptr)
+        return styleClass->values().fillColour;
     return nodeFill;
 }
 
@@ -354,6 +443,8 @@ Node::getFillColour()
 void
 Node::setLineColour(QColor lineColour)
 {
+    if (styleClass != nullptr && styleClass->values().lineColour != lineColour)
+        leaveStyleClass();
     nodeLine = lineColour;
     update();
 }
@@ -375,6 +466,8 @@ Node::setLineColour(QColor lineColour)
 QColor
 Node::getLineColour()
 {
+    if (styleClass != nullptr)
+        return styleClass->values().lineColour;
     return nodeLine;
 }
 
@@ -546,11 +639,38 @@ void
 Node::setNodeLabel(QString aLabel)
 {
     label = aLabel;
+    LabelIndex::setLabel(this, aLabel);
     htmlLabel->texLabelText = aLabel;
     labelToHtml();
 }
 
 
+
+/*
+ * Name:        setNodeLabelHtml()
+ * Purpose:     Sets the label of the node, given its HTML version.
+ * Arguments:   The label and HTML_Label::strToHtml() of the label.
+ * Outputs:     Nothing.
+ * Modifies:    The text in the node label (both "text" and "label" fields).
+ * Returns:     Nothing.
+ * Assumptions: html really is strToHtml(aLabel).
+ * Bugs:        None.
+ * Notes:       Used by LabelBatch, which does the (comparatively
+ *		expensive) conversion to HTML for many labels at once
+ *		on other threads.
+ */
+
+void
+Node::setNodeLabelHtml(QString aLabel, QString html)
+{
+    label = aLabel;
+    LabelIndex::setLabel(this, aLabel);
+    htmlLabel->texLabelText = aLabel;
+    htmlLabel->setHtml(html);
+    Graph::invalidateExtentOf(this);
+}
+
+
 /*
  * Name:	labelToHtml()
  * Purpose:	Call lbelToHtml2 to parse the label string, turn it
@@ -577,6 +697,7 @@ Node::labelToHtml()
 
     QString html = HTML_Label::strToHtml(label);
     htmlLabel->setHtml(html);
+    Graph::invalidateExtentOf(this);
 
     qDeb() <<  "labelToHtml setting htmlLabel to /" << html
 	   << "/ for /" << label << "/";
@@ -599,9 +720,12 @@ Node::labelToHtml()
 void
 Node::setNodeLabelSize(qreal labelSize)
 {
+    if (styleClass != nullptr && styleClass->values().labelSize != labelSize)
+        leaveStyleClass();
     QFont font = htmlLabel->font();
     font.setPointSize(labelSize);
     htmlLabel->setFont(font);
+    Graph::invalidateExtentOf(this);
 }
 
 
@@ -756,6 +880,8 @@ Node::editLabel(bool edit)
 void
 Node::setPenWidth(qreal aPenWidth)
 {
+    if (styleClass != nullptr && styleClass->values().penWidth != aPenWidth)
+        leaveStyleClass();
     penSize = aPenWidth;
     update();
 }
@@ -779,11 +905,137 @@ Node::setPenWidth(qreal aPenWidth)
 qreal
 Node::getPenWidth()
 {
+    if (styleClass != nullptr)
+        return styleClass->values().penWidth;
     return penSize;
 }
 
 
 
+/*
+ * Name:        getPen()
+ * Purpose:     Returns the pen used to draw the outline of the node.
+ * Arguments:   None.
+ * Outputs:     Nothing.
+ * Modifies:    Nothing.
+ * Returns:     A QPen.
+ * Assumptions: None.
+ * Bugs:        None.
+ * Notes:       Used by paint() and by Graph::paint() when the graph
+ *              draws its nodes in batches.
+ */
+
+QPen
+Node::getPen() const
+{
+    QPen pen;
+
+    if (penStyle == 1)
+        pen.setStyle(Qt::DotLine);
+    else if (penStyle == 2)
+        pen.setStyle(Qt::DashLine);
+    else
+        pen.setStyle(Qt::SolidLine);
+
+    if (styleClass != nullptr)
+    {
+        pen.setColor(styleClass->values().lineColour);
+        pen.setWidthF(styleClass->values().penWidth);
+    }
+    else
+    {
+        pen.setColor(nodeLine);
+        pen.setWidthF(penSize);
+    }
+
+    return pen;
+}
+
+
+
+/*
+ * Name:        setStyleClass()
+ * Purpose:     Put this node into a style class (or take it out).
+ * Arguments:   The class, or nullptr for none.
+ * Outputs:     Nothing.
+ * Modifies:    The node's class and, from the class, its diameter
+ *              and label size.
+ * Returns:     Nothing.
+ * Assumptions: None.
+ * Bugs:        None known.
+ * Notes:       While the node is in a class, its colours and pen
+ *              width come from the class (see styleclass.h).
+ *              Taking the node out of its class keeps the class's
+ *              look, so nothing visibly changes.
+ */
+
+void
+Node::setStyleClass(StyleClass * aStyleClass)
+{
+    if (aStyleClass == styleClass)
+        return;
+
+    if (styleClass != nullptr)
+        leaveStyleClass();
+    if (aStyleClass == nullptr)
+        return;
+
+    styleClass = aStyleClass;
+    styleClass->addMember(this);
+    setDiameter(styleClass->values().diameter);
+    setNodeLabelSize(styleClass->values().labelSize);
+    update();
+}
+
+
+
+/*
+ * Name:        getStyleClass()
+ * Purpose:     Returns the style class of this node.
+ * Arguments:   None.
+ * Outputs:     Nothing.
+ * Modifies:    Nothing.
+ * Returns:     The class, or nullptr if the node is not in one.
+ * Assumptions: None.
+ * Bugs:        None.
+ * Notes:       None.
+ */
+
+StyleClass *
+Node::getStyleClass() const
+{
+    return styleClass;
+}
+
+
+
+/*
+ * Name:        leaveStyleClass()
+ * Purpose:     Take this node out of its style class.
+ * Arguments:   None.
+ * Outputs:     Nothing.
+ * Modifies:    The node's class, colours and pen width.
+ * Returns:     Nothing.
+ * Assumptions: The node is in a class.
+ * Bugs:        None known.
+ * Notes:       The class's colours and pen width are copied into
+ *              the node first; the diameter and label size are
+ *              already the class's.  Called by the setters when they
+ *              are given a value other than the class's.
+ */
+
+void
+Node::leaveStyleClass()
+{
+    nodeFill = styleClass->values().fillColour;
+    nodeLine = styleClass->values().lineColour;
+    penSize = styleClass->values().penWidth;
+    styleClass->removeMember(this);
+    styleClass = nullptr;
+}
+
+
+
 /*
  * Name:        paint()
  * Purpose:     Paints a node.
@@ -794,6 +1046,8 @@ Node::getPenWidth()
  * Assumptions: None.
  * Bugs:        None.
  * Notes:       Currently only draws nodes as circles.
+ *              If the node's graph is batch painting, the circle is
+ *              drawn by Graph::paint(), not here.
  */
 
 void
@@ -802,27 +1056,18 @@ Node::paint(QPainter * painter, const QStyleOptionGraphicsItem * option,
 {
     Q_UNUSED(option);
     Q_UNUSED(widget);
-    QColor brushColour;
-
-    brushColour = nodeFill;
-    painter->setBrush(brushColour);
-
-    QPen pen;
 
-    if (penStyle == 1)
-        pen.setStyle(Qt::DotLine);
-    else if (penStyle == 2)
-        pen.setStyle(Qt::DashLine);
-    else
-        pen.setStyle(Qt::SolidLine);
-
-    pen.setColor(nodeLine);
-    pen.setWidthF(penSize);
-    painter->setPen(pen);
-
-    painter->drawEllipse(-1 * nodeDiameter / 2,
-                         -1 * nodeDiameter / 2,
-                         nodeDiameter, nodeDiameter);
+    // If our graph draws all of its nodes in one go, there is
+    // nothing to do here except put the label in the right place.
+    Graph * graph = qgraphicsitem_cast<Graph *>(parentItem());
+    if (graph == nullptr || !graph->isBatchPainting())
+    {
+	painter->setBrush(getFillColour());
+	painter->setPen(getPen());
+	painter->drawEllipse(-1 * nodeDiameter / 2,
+			     -1 * nodeDiameter / 2,
+			     nodeDiameter, nodeDiameter);
+    }
 
     htmlLabel->setPos(this->boundingRect().center().x()
 		      - htmlLabel->boundingRect().width() / 2.,
@@ -832,6 +1077,34 @@ Node::paint(QPainter * painter, const QStyleOptionGraphicsItem * option,
 
 
 
+/*
+ * Name:        sceneExtent()
+ * Purpose:     Find the scene bounds of this node, its label, and its
+ *              edges (and their labels).
+ * Arguments:   None.
+ * Outputs:     Nothing.
+ * Modifies:    Nothing.
+ * Returns:     The bounds.
+ * Assumptions: None.
+ * Bugs:        None known.
+ * Notes:       These are the things whose bounds change when the
+ *              node moves; see Graph::childMoved().
+ */
+
+QRectF
+Node::sceneExtent()
+{
+    QRectF extent = sceneBoundingRect() | htmlLabel->sceneBoundingRect();
+
+    foreach (Edge * edge, edgeList)
+        extent |= edge->sceneBoundingRect()
+            | edge->htmlLabel->sceneBoundingRect();
+
+    return extent;
+}
+
+
+
 /*
  * Name:        itemChange()
  * Purpose:     Send a signal to the node's edges to re-adjust their
@@ -846,6 +1119,11 @@ Node::paint(QPainter * painter, const QStyleOptionGraphicsItem * option,
  *		If I don't execute that code, I get the whinage from
  *		the "else qDeb() << does not have parent" message below,
  *		but in quick tests nothing else seemed to be a problem.
+ *		The graph is told about the move (see
+ *		Graph::childMoved()), but not about the node leaving
+ *		and rejoining it, hence "reparenting".
+ *		The label index (see labelindex.h) is told when the
+ *		node joins or leaves a scene.
  */
 
 QVariant
@@ -854,8 +1132,15 @@ Node::itemChange(GraphicsItemChange change, const QVariant &value)
     qDeb() << "N::itemChange(" << change << ") called; "
 	   << "node label is /" << label << "/";
 
+    Graph * parentGraph = qgraphicsitem_cast<Graph *>(parentItem());
+
     switch (change)
     {
+      case ItemPositionChange:
+        if (parentGraph != nullptr)
+            extentBeforeMove = sceneExtent();
+        break;
+
       case ItemPositionHasChanged:
         if (parentItem() != 0)
         {
@@ -864,8 +1149,10 @@ Node::itemChange(GraphicsItemChange change, const QVariant &value)
                 Graph * graph = qgraphicsitem_cast<Graph*>(parentItem());
                 Graph * tempGraph = graph;
                 graph = qgraphicsitem_cast<Graph*>(graph->getRootParent());
+                reparenting = true;
                 this->setParentItem(nullptr);  // ???????????
                 this->setParentItem(tempGraph);// Whats the point of this?
+                reparenting = false;
             }
 	    else
 		qDeb() << "itemChange(): node does not have a "
@@ -873,6 +1160,8 @@ Node::itemChange(GraphicsItemChange change, const QVariant &value)
         }
         foreach (Edge * edge, edgeList)
             edge->adjust();
+        if (parentGraph != nullptr)
+            parentGraph->childMoved(extentBeforeMove, sceneExtent());
         break;
 
       case ItemRotationChange:
@@ -880,6 +1169,10 @@ Node::itemChange(GraphicsItemChange change, const QVariant &value)
             edge->adjust();
         break;
 
+      case ItemSceneHasChanged:
+        LabelIndex::sceneChanged(this);
+        break;
+
       default:
         break;
     };
@@ -2,7 +2,7 @@
  * File:    node.cpp
  * Author:  Rachel Bood
  * Date:    2014/11/07
- * Version: 1.14
+ * Version: 1.20
  *
  * Purpose: Declare the node class.
  * 
@@ -53,6 +53,19 @@
  *  (b) Renamed tempPenStyle to savedPenStyle.
  *  (c) Removed mousePressEvent() and mouseReleaseEvent(), which are
  *	not needed.
+ * Oct 19, 2026 (JD V1.15)
+ *  (a) Add setNodeLabelHtml().
+ * Oct 19, 2026 (JD V1.16)
+ *  (a) Add class-specific operator new and delete (see itempool.h).
+ * Oct 19, 2026 (JD V1.17)
+ *  (a) Add getPen().
+ * Oct 19, 2026 (JD V1.18)
+ *  (a) Add ~Node(), setStyleClass(), getStyleClass(),
+ *	leaveStyleClass() and styleClass.
+ * Oct 19, 2026 (JD V1.19)
+ *  (a) Remove physicalDotsPerInchX (see SCENE_DPI in defuns.h).
+ * Oct 19, 2026 (JD V1.20)
+ *  (a) Add sceneExtent(), isReparenting() and their members.
  */
 
 
@@ -64,11 +77,13 @@
 
 #include <QGraphicsItem>
 #include <QList>
+#include <QPen>
 #include <QTextDocument>
 
 class Edge;
 class CanvasView;
 class PreView;
+class StyleClass;
 
 class Node : public QGraphicsObject
 {
@@ -76,6 +91,10 @@ class Node : public QGraphicsObject
 
   public:
     Node();
+    ~Node();
+
+    static void * operator new(size_t size);
+    static void operator delete(void * p, size_t size);
 
     void addEdge(Edge * edge);
 
@@ -95,6 +114,11 @@ class Node : public QGraphicsObject
 
     void setLineColour(QColor lColor);
     QColor getLineColour();
+    QPen getPen() const;
+
+    void setStyleClass(StyleClass * aStyleClass);
+    StyleClass * getStyleClass() const;
+
     QGraphicsItem * findRootParent();
     void setID(int id);
     int getID();
@@ -102,6 +126,7 @@ class Node : public QGraphicsObject
     void setNodeLabel(int number);
     void setNodeLabel(QString aLabel, int number);
     void setNodeLabel(QString aLabel, QString subscript);
+    void setNodeLabelHtml(QString aLabel, QString html);
     void setNodeLabelSize(qreal labelSize);
 
     void setPreviewCoords(qreal x, qreal y);
@@ -122,11 +147,12 @@ class Node : public QGraphicsObject
     void chosen(int group1);
 
     void editLabel(bool edit);
+    bool isReparenting() const { return reparenting; }
+    QRectF sceneExtent();
     // ~Node();
 
     HTML_Label * htmlLabel;
     int checked;
-    qreal physicalDotsPerInchX; // This should be private with getter/setter.
 
   public slots:
     void setNodeLabel(QString aLabel);
@@ -148,9 +174,13 @@ class Node : public QGraphicsObject
     int		nodeID;		    // The (internal) number of the node.
     int		penStyle, savedPenStyle;
     qreal	penSize;
+    StyleClass	* styleClass;
     void	labelToHtml();
+    void	leaveStyleClass();
     qreal	previewX;
     qreal	previewY;
+    QRectF	extentBeforeMove;   // sceneExtent() when a move started.
+    bool	reparenting;	    // See itemChange().
 };
 
 #endif // NODE_H
@@ -2,7 +2,7 @@
  * File:    preview.cpp
  * Author:  Rachel Bood 100088769
  * Date:    2014/11/07
- * Version: 1.17
+ * Version: 1.19
  *
  * Purpose: Initializes a QGraphicsView that is used to house the QGraphicsScene
  *
@@ -87,6 +87,12 @@
  * Oct 18, 2020 (JD V1.17)
  *  (a) Fix spurious error message when no graph is selected.
  *  (b) Fix spelling of "colour" throughout, where possible.
+ * Oct 19, 2026 (JD V1.18)
+ *  (a) Style_Graph() now collects the new node and edge labels in a
+ *	LabelBatch and converts them all at once, off the GUI thread.
+ * Oct 19, 2026 (JD V1.19)
+ *  (a) Add setResolution().  Style_Graph() positions nodes in scene
+ *	units (SCENE_DPI per inch), not screen pixels.
  */
 
 #include "basicgraphs.h"
@@ -95,6 +101,7 @@
 #include "node.h"
 #include "graph.h"
 #include "graphmimedata.h"
+#include "labelbatch.h"
 #include "preview.h"
 
 #include <math.h>
@@ -137,6 +144,7 @@ static QString zoomDisplayText = "Zoom: " + QString::number(zoomValue) + "%";
 PreView::PreView(QWidget * parent)
     : QGraphicsView(parent)
 {
+    resolutionScaleX = resolutionScaleY = 1;
     PV_Scene = new QGraphicsScene();
     PV_Scene->setSceneRect(0, 0, this->width(), this->height());
     
@@ -230,7 +238,8 @@ PreView::wheelEvent(QWheelEvent * event)
  * Returns:     Nothing.
  * Assumptions: None.
  * Bugs:        ?
- * Notes:       None.
+ * Notes:       The zoom limits are relative to the current resolution
+ *              (see setResolution()).
  */
 
 void
@@ -239,7 +248,7 @@ PreView::scaleView(qreal scaleFactor)
     qDeb() << "PV::scaleView(" << scaleFactor << ") called";
 
     qreal factor = transform().scale(scaleFactor, scaleFactor)
-                .mapRect(QRectF(0, 0, 1, 1)).width();
+                .mapRect(QRectF(0, 0, 1, 1)).width() / resolutionScaleX;
     if (factor < MIN_ZOOM_LEVEL || factor > MAX_ZOOM_LEVEL)
         return;
 
@@ -361,6 +370,31 @@ PreView::zoomOut()
 
 
 
+/*
+ * Name:        setResolution()
+ * Purpose:     Show the preview at the given screen resolution.
+ * Arguments:   The horizontal and vertical dots per inch.
+ * Outputs:     Nothing.
+ * Modifies:    The view's transform.
+ * Returns:     Nothing.
+ * Assumptions: dpiX and dpiY are positive.
+ * Bugs:        None known.
+ * Notes:       See CanvasView::setResolution().
+ */
+
+void
+PreView::setResolution(qreal dpiX, qreal dpiY)
+{
+    qreal scaleX = dpiX / SCENE_DPI;
+    qreal scaleY = dpiY / SCENE_DPI;
+
+    scale(scaleX / resolutionScaleX, scaleY / resolutionScaleY);
+    resolutionScaleX = scaleX;
+    resolutionScaleY = scaleY;
+}
+
+
+
 /*
  * Name:	Create_Basic_Graph
  * Purpose:	Create a "basic graph" and add it to the preview scene.
@@ -523,20 +557,23 @@ PreView::Style_Graph(Graph * graph,		    int graphType,
     int i = nodeNumStart;
     int j = nodeNumStart;
     int k = edgeNumStart;
+    // The new labels are collected here and converted to HTML in
+    // one go (on the worker threads) after the loop.
+    LabelBatch labels;
 
     // The w & h args are *total* w & h for the graph, but we need to
     // locate the center of the nodes.  So first calculate the
     // nodecenter-to-nodecenter dimensions, then calculate the scale
-    // factors, and finally factor in the inch->screen mapping; this
+    // factors, and finally factor in the inch->scene mapping; this
     // will be used to set the position of the nodes.
     qreal centerWidth = totalWidth - nodeDiameter;
     if (centerWidth < 0.1)
 	centerWidth = 0.1;
-    qreal widthScaleFactor = centerWidth * currentPhysicalDPI_X;
+    qreal widthScaleFactor = centerWidth * SCENE_DPI;
     qreal centerHeight = totalHeight - nodeDiameter;
     if (centerHeight < 0.1)
 	centerHeight = 0.1;
-    qreal heightScaleFactor = centerHeight * currentPhysicalDPI_Y;
+    qreal heightScaleFactor = centerHeight * SCENE_DPI;
 
     qDeb() << "    Desired total width: " << totalWidth
 	   << "; desired center width " << centerWidth
@@ -552,8 +589,6 @@ PreView::Style_Graph(Graph * graph,		    int graphType,
 	    Node * node = qgraphicsitem_cast<Node *>(item);
 	    node->setParentItem(nullptr);	    // ?? Eh?
 
-	    node->physicalDotsPerInchX = currentPhysicalDPI_X;
-
 	    GUARD(nodeThickness_WGT) node->setPenWidth(nodeThickness);
 	    GUARD(nodeDiam_WGT) node->setDiameter(nodeDiameter);
 	    GUARD(nodeFillColour_WGT) node->setFillColour(nodeFillColour);
@@ -569,24 +604,26 @@ PreView::Style_Graph(Graph * graph,		    int graphType,
 		|| what_changed == nodeNumLabelStart_WGT)
 	    {
 		// Clear the node label, in case it was set previously.
-		node->setNodeLabel("");
+		QString newLabel = "";
 		if (nodeLabelsNumbered)
-		    node->setNodeLabel(i++);
+		    newLabel = QString::number(i++);
 		else if (graphType == BasicGraphs::Bipartite)
 		{
 		    // Special case for labeling bipartite graphs.
 		    if (bottomNodeLabels.length() != 0
 			&& graph->nodes.bipartite_bottom.contains(node))
-			node->setNodeLabel(bottomNodeLabels, j++);
+			newLabel = LabelBatch::subscripted(bottomNodeLabels,
+							   j++);
 		    else if (topNodeLabels.length() != 0
 			     && graph->nodes.bipartite_top.contains(node))
-			node->setNodeLabel(topNodeLabels, i++);
+			newLabel = LabelBatch::subscripted(topNodeLabels, i++);
 		    else if (topNodeLabels.length() != 0
 			     && graph->nodes.bipartite_bottom.contains(node))
-			node->setNodeLabel(topNodeLabels, i++);
+			newLabel = LabelBatch::subscripted(topNodeLabels, i++);
 		}
 		else if (topNodeLabels.length() != 0)
-		    node->setNodeLabel(topNodeLabels, i++);
+		    newLabel = LabelBatch::subscripted(topNodeLabels, i++);
+		labels.add(node, newLabel);
 	    }
 
 	    qDeb() << "    nodes[" << node->getLabel()
@@ -609,11 +646,12 @@ PreView::Style_Graph(Graph * graph,		    int graphType,
 		|| what_changed == edgeNumLabelStart_WGT)
 	    {
 		// Clear the edge label, in case it was set previously.
-		edge->setEdgeLabel("");
+		QString newLabel = "";
 		if (edgeLabelsNumbered)
-		    edge->setEdgeLabel(k++);
+		    newLabel = QString::number(k++);
 		else if (edgeLabel.length() != 0)
-		    edge->setEdgeLabel(edgeLabel, k++);
+		    newLabel = LabelBatch::subscripted(edgeLabel, k++);
+		labels.add(edge, newLabel);
 	    }
 	    GUARD(nodeDiam_WGT) edge->setDestRadius(nodeDiameter / 2.);
 	    // Q: why did RB do this?  It gives a bizarre value.
@@ -622,6 +660,8 @@ PreView::Style_Graph(Graph * graph,		    int graphType,
 	    edge->setParentItem(graph);
         }
     }
+    labels.apply();
+
     qDeb() << "   graph currently located at " << graph->x() << ", "
 	   << graph->y(); 
     graph->setPos(mapToScene(viewport()->rect().center()));
@@ -2,7 +2,7 @@
  * File:    preview.h
  * Author:  Rachel Bood 100088769
  * Date:    2014/11/07 (?)
- * Version: 1.9
+ * Version: 1.10
  *
  * Purpose: define the fields of the preview class.
  *
@@ -41,6 +41,8 @@
  *  (a) For circulant graphs added the offsets param to Create_Basic_Graph().
  * Oct 18, 2020 (JD V1.9)
  *  (a) Fix spelling.
+ * Oct 19, 2026 (JD V1.10)
+ *  (a) Add setResolution() and the resolution scale members.
  */
 
 #ifndef PREVIEW_H
@@ -58,6 +60,7 @@ class PreView: public QGraphicsView
     Q_OBJECT
   public:
     PreView(QWidget * parent = 0);
+    void setResolution(qreal dpiX, qreal dpiY);
 
     public slots:
       void zoomIn();
@@ -89,6 +92,8 @@ class PreView: public QGraphicsView
 
   private:
     QGraphicsScene * PV_Scene;
+    qreal resolutionScaleX;		// Screen pixels per scene unit...
+    qreal resolutionScaleY;		// ... at 100% zoom.
 };
 
 #endif // PREVIEW_H
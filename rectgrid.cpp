@@ -0,0 +1,228 @@
+/*
+ * File:	rectgrid.cpp
+ * Author:	Jim Diamond
+ * Date:	2026-10-19
+ * Version:	1.0
+ *
+ * Purpose:	Implement the RectGrid class (see rectgrid.h).
+ *
+ * Modification history:
+ * Oct 19, 2026 (JD V1.0)
+ *  (a) Initial version.
+ */
+
+#include "rectgrid.h"
+
+#include <qmath.h>
+
+
+
+/*
+ * Name:	RectGrid()
+ * Purpose:	Make an empty grid.
+ * Arguments:	The width (and height) of a cell, in scene pixels.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	cellSize > 0.
+ * Bugs:	None known.
+ * Notes:	A cell should be a bit bigger than a typical rectangle.
+ */
+
+RectGrid::RectGrid(qreal cellSize)
+{
+    size = cellSize;
+    query = 0;
+}
+
+
+
+/*
+ * Name:	insert()
+ * Purpose:	Add a rectangle to the grid.
+ * Arguments:	The rectangle, in scene coordinates.
+ * Outputs:	Nothing.
+ * Modifies:	The grid.
+ * Returns:	The rectangle's index.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+int
+RectGrid::insert(QRectF rect)
+{
+    int index = rects.count();
+
+    rects.append(rect);
+    seen.append(-1);
+
+    int left = qFloor(rect.left() / size);
+    int right = qFloor(rect.right() / size);
+    int top = qFloor(rect.top() / size);
+    int bottom = qFloor(rect.bottom() / size);
+    for (int column = left; column <= right; column++)
+	for (int row = top; row <= bottom; row++)
+	    cells[key(column, row)].append(index);
+
+    return index;
+}
+
+
+
+/*
+ * Name:	near()
+ * Purpose:	Find the rectangles in the cells a rectangle touches.
+ * Arguments:	The rectangle, in scene coordinates.
+ * Outputs:	Nothing.
+ * Modifies:	seen and query (bookkeeping only).
+ * Returns:	Their indices, each once, in no particular order.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Some of them may not actually intersect the rectangle.
+ */
+
+QVector<int>
+RectGrid::near(QRectF rect)
+{
+    QVector<int> found;
+
+    query++;
+    int left = qFloor(rect.left() / size);
+    int right = qFloor(rect.right() / size);
+    int top = qFloor(rect.top() / size);
+    int bottom = qFloor(rect.bottom() / size);
+    for (int column = left; column <= right; column++)
+	for (int row = top; row <= bottom; row++)
+	    visit(column, row, &found);
+
+    return found;
+}
+
+
+
+/*
+ * Name:	along()
+ * Purpose:	Find the rectangles in the cells a line passes through.
+ * Arguments:	The line, in scene coordinates.
+ * Outputs:	Nothing.
+ * Modifies:	seen and query (bookkeeping only).
+ * Returns:	Their indices, each once, in no particular order.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Goes a column of cells at a time, working out which
+ *		rows the line is in within that column, so a long
+ *		diagonal line only visits the cells it crosses.
+ */
+
+QVector<int>
+RectGrid::along(QLineF line)
+{
+    QVector<int> found;
+
+    query++;
+    QPointF a = line.p1(), b = line.p2();
+    if (a.x() > b.x())
+	qSwap(a, b);
+
+    int first = qFloor(a.x() / size);
+    int last = qFloor(b.x() / size);
+    for (int column = first; column <= last; column++)
+    {
+	qreal ya = a.y(), yb = b.y();
+	if (b.x() > a.x())
+	{
+	    qreal slope = (b.y() - a.y()) / (b.x() - a.x());
+	    qreal xa = qMax(a.x(), column * size);
+	    qreal xb = qMin(b.x(), (column + 1) * size);
+	    ya = a.y() + (xa - a.x()) * slope;
+	    yb = a.y() + (xb - a.x()) * slope;
+	}
+	int top = qFloor(qMin(ya, yb) / size);
+	int bottom = qFloor(qMax(ya, yb) / size);
+	for (int row = top; row <= bottom; row++)
+	    visit(column, row, &found);
+    }
+
+    return found;
+}
+
+
+
+/*
+ * Name:	overlap()
+ * Purpose:	Find how much of a rectangle is covered by the grid's.
+ * Arguments:	The rectangle, in scene coordinates.
+ * Outputs:	Nothing.
+ * Modifies:	seen and query (bookkeeping only).
+ * Returns:	The total area of its overlaps with the grid's
+ *		rectangles.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+qreal
+RectGrid::overlap(QRectF rect)
+{
+    qreal area = 0;
+
+    foreach (int index, near(rect))
+    {
+	QRectF common = rect & rects.at(index);
+	area += common.width() * common.height();
+    }
+
+    return area;
+}
+
+
+
+/*
+ * Name:	visit()
+ * Purpose:	Collect the rectangles in one cell.
+ * Arguments:	The cell's column and row, and where to put them.
+ * Outputs:	Nothing.
+ * Modifies:	*found, and seen.
+ * Returns:	Nothing.
+ * Assumptions:	query has been bumped for this search.
+ * Bugs:	None known.
+ * Notes:	Rectangles already found in this search are skipped.
+ */
+
+void
+RectGrid::visit(int column, int row, QVector<int> * found)
+{
+    QHash<quint64, QVector<int>>::const_iterator it
+	= cells.constFind(key(column, row));
+
+    if (it == cells.constEnd())
+	return;
+    foreach (int index, *it)
+    {
+	if (seen.at(index) == query)
+	    continue;
+	seen[index] = query;
+	found->append(index);
+    }
+}
+
+
+
+/*
+ * Name:	key()
+ * Purpose:	Make the hash key of a grid cell.
+ * Arguments:	The cell's column and row.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The key.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+quint64
+RectGrid::key(int column, int row)
+{
+    return (quint64(quint32(column)) << 32) | quint32(row);
+}
@@ -0,0 +1,54 @@
+/*
+ * File:	rectgrid.h
+ * Author:	Jim Diamond
+ * Date:	2026-10-19
+ * Version:	1.0
+ *
+ * Purpose:	Define the RectGrid class, a uniform grid of rectangles
+ *		for quickly finding the ones near a rectangle or a line.
+ *
+ * Notes:	The canvas scene has no item index (see canvasscene.cpp),
+ *		so things which need to test many items against each
+ *		other build one of these over just the items they care
+ *		about.  Each rectangle goes in every cell it touches,
+ *		and queries visit only the cells they touch, so the
+ *		cost depends on how crowded the area is, not on how big
+ *		the canvas is.
+ *		Rectangles are known by the index insert() returns.
+ *
+ * Modification history:
+ * Oct 19, 2026 (JD V1.0)
+ *  (a) Initial version.
+ */
+
+#ifndef RECTGRID_H
+#define RECTGRID_H
+
+#include <QHash>
+#include <QLineF>
+#include <QRectF>
+#include <QVector>
+
+class RectGrid
+{
+  public:
+    explicit RectGrid(qreal cellSize);
+
+    int insert(QRectF rect);
+    QRectF rect(int index) const { return rects.at(index); }
+    QVector<int> near(QRectF rect);
+    QVector<int> along(QLineF line);
+    qreal overlap(QRectF rect);
+
+  private:
+    static quint64 key(int column, int row);
+    void visit(int column, int row, QVector<int> * found);
+
+    qreal size;
+    QHash<quint64, QVector<int>> cells;
+    QVector<QRectF> rects;
+    QVector<int> seen;			// Last query which found a rect.
+    int query;
+};
+
+#endif // RECTGRID_H
@@ -0,0 +1,579 @@
+/*
+ * File:	renderservice.cpp
+ * Author:	Jim Diamond
+ * Date:	2026-10-19
+ * Version:	1.2
+ *
+ * Purpose:	Implement the RenderService class (see renderservice.h).
+ *
+ * Modification history:
+ * Oct 19, 2026 (JD V1.0)
+ *  (a) Initial version.
+ * Oct 19, 2026 (JD V1.1)
+ *  (a) Add the "dpi" option for images.
+ * Oct 19, 2026 (JD V1.2)
+ *  (a) Reject edge lists with more than MAX_REQUEST_NODES nodes,
+ *	since the node count costs the client nothing to send.
+ */
+
+#include "renderservice.h"
+#include "defuns.h"
+#include "file-io.h"
+#include "graph.h"
+#include "jobscheduler.h"
+#include "scriptengine.h"
+
+#include <QApplication>
+#include <QBuffer>
+#include <QGraphicsScene>
+#include <QImageWriter>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QTextStream>
+
+// Don't let one client make us hold more than this much input.
+#define MAX_REQUEST_SIZE	(64 * 1024 * 1024)
+
+// Nor make a graph with more nodes than this from an edge list,
+// whose first line alone says how many nodes to make.
+#define MAX_REQUEST_NODES	100000
+
+// Hand replies to the socket in pieces of this size, so that one
+// large reply doesn't sit in the socket's buffer all at once.
+#define WRITE_CHUNK_SIZE	(64 * 1024)
+
+
+
+/*
+ * Name:	RenderService()
+ * Purpose:	Constructor.
+ * Arguments:	The QObject parent.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Call listen() to start serving.
+ */
+
+RenderService::RenderService(QObject * parent)
+    : QObject(parent)
+{
+    server = new QLocalServer(this);
+    scene = new QGraphicsScene(this);
+    processNextQueued = false;
+
+    connect(server, SIGNAL(newConnection()), this, SLOT(newConnection()));
+}
+
+
+
+/*
+ * Name:	listen()
+ * Purpose:	Start accepting clients.
+ * Arguments:	The server name and where to put an error message.
+ * Outputs:	Nothing.
+ * Modifies:	*errorMessage, on failure.
+ * Returns:	True iff the server is listening.
+ * Assumptions:	None.
+ * Bugs:	A socket left behind by a service which crashed is
+ *		removed first, but so is one belonging to a service
+ *		which is still running.
+ * Notes:	None.
+ */
+
+bool
+RenderService::listen(QString name, QString * errorMessage)
+{
+    QLocalServer::removeServer(name);
+    if (!server->listen(name))
+    {
+	*errorMessage = "Unable to listen on " + name + ": "
+	    + server->errorString();
+	return false;
+    }
+    return true;
+}
+
+
+
+/*
+ * Name:	runHeadless()
+ * Purpose:	Run the service until the program is killed.
+ * Arguments:	The server name.
+ * Outputs:	Where it is listening (on stdout) or why it can't (on
+ *		stderr).
+ * Modifies:	Nothing.
+ * Returns:	The program's exit status.
+ * Assumptions:	A QApplication exists, and the fonts have been added.
+ * Bugs:	None known.
+ * Notes:	See ScriptEngine::setHeadlessResolution() for the DPI.
+ */
+
+int
+RenderService::runHeadless(QString name)
+{
+    ScriptEngine::setHeadlessResolution();
+
+    RenderService service;
+    QString errorMessage;
+    if (!service.listen(name, &errorMessage))
+    {
+	QTextStream(stderr) << errorMessage << endl;
+	return 1;
+    }
+    QTextStream(stdout) << "Listening on " << service.server->fullServerName()
+			<< endl;
+
+    return QApplication::exec();
+}
+
+
+
+void
+RenderService::newConnection()
+{
+    while (server->hasPendingConnections())
+    {
+	QLocalSocket * socket = server->nextPendingConnection();
+	Connection c;
+	c.outPos = 0;
+	connections.insert(socket, c);
+	connect(socket, SIGNAL(readyRead()), this, SLOT(readRequests()));
+	connect(socket, SIGNAL(bytesWritten(qint64)),
+		this, SLOT(socketWritten()));
+	connect(socket, SIGNAL(disconnected()), this, SLOT(dropConnection()));
+	qDeb() << "RS::newConnection(): " << connections.count()
+	       << " clients";
+    }
+}
+
+
+
+/*
+ * Name:	readRequests()
+ * Purpose:	Take in what a client has sent, and queue any complete
+ *		requests.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	The connection's input buffer and the queue.
+ * Returns:	Nothing.
+ * Assumptions:	Called via a socket's readyRead() signal.
+ * Bugs:	None known.
+ * Notes:	A client which sends something unreadable gets an error
+ *		reply and is disconnected, since there is no telling
+ *		where its next request starts.
+ */
+
+void
+RenderService::readRequests()
+{
+    QLocalSocket * socket = qobject_cast<QLocalSocket *>(sender());
+    if (socket == nullptr || !connections.contains(socket))
+	return;
+
+    connections[socket].in.append(socket->readAll());
+    if (!parseRequests(socket))
+	socket->disconnectFromServer();
+
+    if (!pending.isEmpty() && !processNextQueued)
+    {
+	processNextQueued = true;
+	QMetaObject::invokeMethod(this, "processNext", Qt::QueuedConnection);
+    }
+}
+
+
+
+/*
+ * Name:	parseRequests()
+ * Purpose:	Move the complete requests in a connection's input
+ *		buffer to the queue.
+ * Arguments:	The client's socket.
+ * Outputs:	An error reply for a bad request.
+ * Modifies:	The connection's input buffer and the queue.
+ * Returns:	False iff the client sent something unreadable.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	See renderservice.h for the request format.
+ */
+
+bool
+RenderService::parseRequests(QLocalSocket * socket)
+{
+    Connection & c = connections[socket];
+
+    for (;;)
+    {
+	int eol = c.in.indexOf('\n');
+	if (eol < 0)
+	    return c.in.size() <= MAX_REQUEST_SIZE;
+
+	QStringList words = QString::fromUtf8(c.in.left(eol)).simplified()
+	    .split(' ');
+	QString id = words.count() > 1 ? words.at(1) : "-";
+	bool ok = false;
+	int length = words.count() > 4 ? words.at(4).toInt(&ok) : 0;
+	if (words.at(0) != "render" || !ok || length < 0
+	    || length > MAX_REQUEST_SIZE)
+	{
+	    replyError(socket, id, "bad request \""
+		       + QString::fromUtf8(c.in.left(qMin(eol, 80))) + "\"");
+	    c.in.clear();
+	    return false;
+	}
+	if (c.in.size() < eol + 1 + length)
+	    return true;
+
+	Request request;
+	request.socket = socket;
+	request.id = id;
+	request.input = words.at(2);
+	request.output = words.at(3).toLower();
+	request.options = parseOptions(words.mid(5));
+	request.data = c.in.mid(eol + 1, length);
+	c.in.remove(0, eol + 1 + length);
+	pending.enqueue(request);
+    }
+}
+
+
+
+/*
+ * Name:	processNext()
+ * Purpose:	Handle the request at the front of the queue.
+ * Arguments:	None.
+ * Outputs:	Its reply (or the start of it).
+ * Modifies:	The queue.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Only one request is handled per trip through the event
+ *		loop, so that sockets are read and written in between.
+ */
+
+void
+RenderService::processNext()
+{
+    processNextQueued = false;
+    if (pending.isEmpty())
+	return;
+
+    handle(pending.dequeue());
+
+    if (!pending.isEmpty())
+    {
+	processNextQueued = true;
+	QMetaObject::invokeMethod(this, "processNext", Qt::QueuedConnection);
+    }
+}
+
+
+
+/*
+ * Name:	handle()
+ * Purpose:	Render one request and reply to it.
+ * Arguments:	The request.
+ * Outputs:	The reply, now or (for images) when it has been encoded.
+ * Modifies:	The scene, which is left empty.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	Style classes defined by .grphc inputs stay defined
+ *		(see StyleClass), so a service which sees many
+ *		different ones slowly grows.
+ * Notes:	Images are drawn here, but compressed on a worker, so
+ *		that the next request can be drawn in the meantime.
+ *		The "dpi" option sets an image's resolution; changing
+ *		it only changes the scale it is drawn at.
+ */
+
+void
+RenderService::handle(const Request & request)
+{
+    if (request.socket.isNull())
+	return;		// The client has gone away.
+
+    QString errorMessage;
+    Graph * graph = buildGraph(request, &errorMessage);
+    if (graph == nullptr)
+    {
+	replyError(request.socket, request.id, errorMessage);
+	return;
+    }
+
+    QString format = request.output;
+    if (format == "svg" || format == "tikz" || format == "edges"
+	|| format == GRAPHiCS_FILE_EXTENSION)
+    {
+	QByteArray result;
+	QBuffer buffer(&result);
+	buffer.open(QIODevice::WriteOnly);
+	if (File_IO::writeGraph(scene, format, &buffer, &errorMessage))
+	    reply(request.socket, request.id, result);
+	else
+	    replyError(request.socket, request.id, errorMessage);
+    }
+    else if (!QImageWriter::supportedImageFormats()
+	     .contains(format.toLatin1()))
+	replyError(request.socket, request.id,
+		   "unknown output format \"" + format + "\"");
+    else
+    {
+	qreal dpi = request.options.value("dpi", currentPhysicalDPI_X).toReal();
+	if (dpi <= 0)
+	    dpi = currentPhysicalDPI_X;
+	QImage image = File_IO::renderImage(scene,
+					    format == "jpg" || format == "jpeg",
+					    dpi);
+	QPointer<QLocalSocket> socket = request.socket;
+	QString id = request.id;
+	JobScheduler::instance()->submit(
+	    QString(), JobScheduler::NormalPriority,
+	    [image, format](JobToken &) -> QVariant
+	    {
+		QByteArray result;
+		QBuffer buffer(&result);
+		buffer.open(QIODevice::WriteOnly);
+		if (!image.save(&buffer, format.toLatin1().constData()))
+		    return QVariant();
+		return result;
+	    },
+	    this,
+	    [this, socket, id, format](const QVariant & result)
+	    {
+		if (result.isValid())
+		    reply(socket, id, result.toByteArray());
+		else
+		    replyError(socket, id,
+			       "unable to make a " + format + " image");
+	    });
+    }
+
+    scene->clear();
+}
+
+
+
+/*
+ * Name:	buildGraph()
+ * Purpose:	Turn a request's input into a graph in the scene.
+ * Arguments:	The request and where to put an error message.
+ * Outputs:	Nothing.
+ * Modifies:	The scene, or *errorMessage.
+ * Returns:	The graph, or nullptr.
+ * Assumptions:	The scene is empty.
+ * Bugs:	None known.
+ * Notes:	A .grphc graph keeps its own layout and style, apart
+ *		from what the options change; an edge list is laid out
+ *		on a circle and given the default style, as the script
+ *		engine would.
+ */
+
+Graph *
+RenderService::buildGraph(const Request & request, QString * errorMessage)
+{
+    QTextStream in(request.data);
+    QString name = "request " + request.id;
+    Graph * graph = nullptr;
+
+    if (request.input == GRAPHiCS_FILE_EXTENSION)
+    {
+	// See File_IO::inputCustomGraph().
+	QStringList toks = in.readLine().simplified().split(" ");
+	if (toks.count() < 3 || toks.at(1) != "Version")
+	{
+	    *errorMessage = "not a versioned graph-ic file";
+	    return nullptr;
+	}
+	qreal width, height;
+	graph = File_IO::readGraphIc(in, name, 1, &width, &height,
+				     errorMessage);
+	if (graph == nullptr)
+	    return nullptr;
+	scene->addItem(graph);
+    }
+    else if (request.input == "edges")
+    {
+	graph = File_IO::readEdgelist(in, name, MAX_REQUEST_NODES,
+				      errorMessage);
+	if (graph == nullptr)
+	    return nullptr;
+	ScriptEngine::layOut(scene, graph, request.options);
+    }
+    else
+    {
+	*errorMessage = "unknown input format \"" + request.input + "\"";
+	return nullptr;
+    }
+
+    if (!ScriptEngine::applyStyle(graph, request.options, errorMessage))
+    {
+	scene->clear();
+	return nullptr;
+    }
+    return graph;
+}
+
+
+
+/*
+ * Name:	reply(), replyError()
+ * Purpose:	Send a result or an error message to a client.
+ * Arguments:	The client's socket, the request id, and the result or
+ *		message.
+ * Outputs:	The reply, to the socket (eventually).
+ * Modifies:	The connection's output buffer.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Does nothing if the client has gone away.
+ */
+
+void
+RenderService::reply(QPointer<QLocalSocket> socket, QString id,
+		     QByteArray result)
+{
+    if (socket.isNull() || !connections.contains(socket))
+	return;
+
+    Connection & c = connections[socket];
+    c.out.append("ok " + id.toUtf8() + " "
+		 + QByteArray::number(result.size()) + "\n");
+    c.out.append(result);
+    flush(socket);
+}
+
+
+
+void
+RenderService::replyError(QPointer<QLocalSocket> socket, QString id,
+			  QString message)
+{
+    if (socket.isNull() || !connections.contains(socket))
+	return;
+
+    qDeb() << "RS::replyError(" << id << "): " << message;
+    message.replace('\n', ' ');
+    connections[socket].out.append("error " + id.toUtf8() + " "
+				   + message.toUtf8() + "\n");
+    flush(socket);
+}
+
+
+
+/*
+ * Name:	flush()
+ * Purpose:	Give the socket more of a connection's pending output.
+ * Arguments:	The socket.
+ * Outputs:	Up to a chunk of output.
+ * Modifies:	The connection's output buffer.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Called again (via socketWritten()) each time the socket
+ *		has sent something, so a large reply goes out as the
+ *		client reads it rather than being copied into the
+ *		socket all at once.
+ */
+
+void
+RenderService::flush(QLocalSocket * socket)
+{
+    Connection & c = connections[socket];
+
+    while (c.outPos < c.out.size()
+	   && socket->bytesToWrite() < WRITE_CHUNK_SIZE)
+    {
+	qint64 n = socket->write(c.out.constData() + c.outPos,
+				 qMin(c.out.size() - c.outPos,
+				      WRITE_CHUNK_SIZE));
+	if (n <= 0)
+	    break;
+	c.outPos += n;
+    }
+
+    if (c.outPos == c.out.size())
+    {
+	c.out.clear();
+	c.outPos = 0;
+    }
+}
+
+
+
+void
+RenderService::socketWritten()
+{
+    QLocalSocket * socket = qobject_cast<QLocalSocket *>(sender());
+    if (socket != nullptr && connections.contains(socket))
+	flush(socket);
+}
+
+
+
+/*
+ * Name:	dropConnection()
+ * Purpose:	Forget a client which has disconnected.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	The connections.
+ * Returns:	Nothing.
+ * Assumptions:	Called via a socket's disconnected() signal.
+ * Bugs:	None known.
+ * Notes:	Its queued requests and images being encoded are
+ *		dropped when they come up, since they hold QPointers
+ *		to the (deleted) socket.
+ */
+
+void
+RenderService::dropConnection()
+{
+    QLocalSocket * socket = qobject_cast<QLocalSocket *>(sender());
+    if (socket == nullptr)
+	return;
+
+    connections.remove(socket);
+    socket->deleteLater();
+}
+
+
+
+/*
+ * Name:	parseOptions()
+ * Purpose:	Turn a request's "key=value" words into options.
+ * Arguments:	The words.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The options.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	"true" and "false" become booleans and numbers become
+ *		numbers, as they would be in a script; anything else
+ *		(e.g. "red", "#ff8000", "v") stays a string.  Words
+ *		without an '=' are ignored.
+ */
+
+QVariantMap
+RenderService::parseOptions(QStringList words)
+{
+    QVariantMap options;
+
+    foreach (QString word, words)
+    {
+	int eq = word.indexOf('=');
+	if (eq <= 0)
+	    continue;
+
+	QString key = word.left(eq);
+	QString value = word.mid(eq + 1);
+	bool isNumber;
+	double number = value.toDouble(&isNumber);
+	if (value == "true" || value == "false")
+	    options.insert(key, value == "true");
+	else if (isNumber)
+	    options.insert(key, number);
+	else
+	    options.insert(key, value);
+    }
+    return options;
+}
@@ -0,0 +1,131 @@
+/*
+ * File:	renderservice.h
+ * Author:	Jim Diamond
+ * Date:	2026-10-19
+ * Version:	1.2
+ *
+ * Purpose:	Define the RenderService class, a long-running headless
+ *		server ("Graphic --serve [name]") which turns graph-ic
+ *		files and edge lists into SVG, TikZ, PNG, ... for other
+ *		programs, such as a documentation build, without a new
+ *		process (and Qt start-up) per figure.
+ *
+ * Notes:	Clients connect to the QLocalServer (a Unix domain
+ *		socket, or a named pipe on Windows) called "name"
+ *		(RENDER_SERVICE_NAME by default) and send any number
+ *		of requests, each of which is a line
+ *		    render <id> <input> <output> <length> [<key>=<value> ...]
+ *		followed by exactly <length> bytes of input.
+ *		  <id>		is anything (without spaces) the client
+ *				wants to match replies to requests;
+ *		  <input>	is "grphc" (a versioned graph-ic file)
+ *				or "edges" (an edge list, see
+ *				File_IO::readEdgelist(), of at most
+ *				MAX_REQUEST_NODES nodes);
+ *		  <output>	is "svg", "tikz", "grphc", "edges", or an
+ *				image format such as "png" or "jpg";
+ *		  key=value	are style options, as for the script
+ *				engine's style() (and, for edge lists,
+ *				width, height and diameter, and for
+ *				images, dpi); values are numbers,
+ *				"true", "false", or strings.
+ *		Each reply is either a line
+ *		    ok <id> <length>
+ *		followed by <length> bytes of output, or a line
+ *		    error <id> <message>
+ *		Replies are sent as soon as each one is ready, so they
+ *		may come back in a different order than the requests
+ *		were sent.
+ *
+ *		Graphics items and fonts may only be used on the GUI
+ *		thread, so the requests are built and drawn there one
+ *		at a time, going back to the event loop in between so
+ *		that every client's socket keeps moving.  The slow
+ *		parts which don't need the GUI thread are spread over
+ *		the job scheduler's workers: label conversion (via
+ *		LabelBatch, whose cache stays warm between requests),
+ *		TikZ output, and image encoding, which overlaps with
+ *		drawing the next request.  The fonts are loaded once,
+ *		when the service starts.
+ *
+ * Modification history:
+ * Oct 19, 2026 (JD V1.0)
+ *  (a) Initial version.
+ * Oct 19, 2026 (JD V1.1)
+ *  (a) Document the "dpi" option.
+ * Oct 19, 2026 (JD V1.2)
+ *  (a) Document the limit on the size of an edge list.
+ */
+
+#ifndef RENDERSERVICE_H
+#define RENDERSERVICE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QQueue>
+#include <QString>
+#include <QStringList>
+#include <QVariantMap>
+
+class Graph;
+class QGraphicsScene;
+class QLocalServer;
+class QLocalSocket;
+
+#define RENDER_SERVICE_NAME	"graphic-render"
+
+class RenderService : public QObject
+{
+    Q_OBJECT
+
+  public:
+    explicit RenderService(QObject * parent = nullptr);
+
+    bool listen(QString name, QString * errorMessage);
+
+    static int runHeadless(QString name);
+
+  private slots:
+    void newConnection();
+    void readRequests();
+    void socketWritten();
+    void dropConnection();
+    void processNext();
+
+  private:
+    typedef struct
+    {
+	QPointer<QLocalSocket> socket;
+	QString id;
+	QString input;
+	QString output;
+	QVariantMap options;
+	QByteArray data;
+    } Request;
+
+    typedef struct
+    {
+	QByteArray in;		// Received but not yet parsed.
+	QByteArray out;		// Replies not yet given to the socket...
+	int outPos;		// ... from here on.
+    } Connection;
+
+    bool parseRequests(QLocalSocket * socket);
+    void handle(const Request & request);
+    Graph * buildGraph(const Request & request, QString * errorMessage);
+    void reply(QPointer<QLocalSocket> socket, QString id, QByteArray result);
+    void replyError(QPointer<QLocalSocket> socket, QString id,
+		    QString message);
+    void flush(QLocalSocket * socket);
+    static QVariantMap parseOptions(QStringList words);
+
+    QLocalServer * server;
+    QGraphicsScene * scene;		// Re-used for every request.
+    QHash<QLocalSocket *, Connection> connections;
+    QQueue<Request> pending;
+    bool processNextQueued;
+};
+
+#endif // RENDERSERVICE_H
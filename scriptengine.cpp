@@ -0,0 +1,1257 @@
+/*
+ * File:	scriptengine.cpp
+ * Author:	Jim Diamond
+ * Date:	2026-10-19
+ * Version:	1.4
+ *
+ * Purpose:	Implement the ScriptEngine class (see scriptengine.h).
+ *
+ * Modification history:
+ * Oct 19, 2026 (JD V1.0)
+ *  (a) Initial version.
+ * Oct 19, 2026 (JD V1.1)
+ *  (a) Split layOut() and applyStyle() out of generate() and
+ *	style(), and setHeadlessResolution() out of runHeadless(),
+ *	for the render service (see renderservice.h).
+ * Oct 19, 2026 (JD V1.2)
+ *  (a) Lay out and move graphs in scene units (SCENE_DPI per inch).
+ * Oct 19, 2026 (JD V1.3)
+ *  (a) Use CanvasScene::contentBoundsOf() to find where other graphs are.
+ * Oct 19, 2026 (JD V1.4)
+ *  (a) nodeFor() and addEdge() used to list a graph's children on
+ *	every call, which made long scripts quadratic.  Keep each
+ *	handle's node list and style edge (see nodeListOf()), and
+ *	forget them when identify(), join() or remove() changes
+ *	the graph.
+ */
+
+#include "scriptengine.h"
+#include "appsettings.h"
+#include "arrange.h"
+#include "basicgraphs.h"
+#include "canvasscene.h"
+#include "defuns.h"
+#include "edge.h"
+#include "file-io.h"
+#include "graph.h"
+#include "graphops.h"
+#include "labelbatch.h"
+#include "node.h"
+#include "styleclass.h"
+
+#include <QFile>
+#include <QGraphicsScene>
+#include <QGuiApplication>
+#include <QJSEngine>
+#include <QQmlEngine>
+#include <QScreen>
+#include <QTextStream>
+#include <qmath.h>
+
+// The defaults for generated graphs, the same as the "Create Graph"
+// tab's initial values.
+#define DEFAULT_SIZE		2.5	// inches
+#define DEFAULT_DIAMETER	0.2	// inches
+#define DEFAULT_LABEL_SIZE	12	// points
+#define DEFAULT_PEN_WIDTH	1	// pixels
+
+// Graphs placed without an x or y option go to the right of
+// everything else, this far (in inches) from it.
+#define PLACEMENT_GAP		0.25
+
+// Used by the headless runner if the screen doesn't know its own DPI.
+#define FALLBACK_DPI		96
+
+
+
+/*
+ * Name:	ScriptEngine()
+ * Purpose:	Constructor.
+ * Arguments:	The scene that scripts work on, and the QObject parent.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	The engine must not delete this object when the script's
+ *		"graphic" global goes away, hence CppOwnership.
+ */
+
+ScriptEngine::ScriptEngine(QGraphicsScene * aScene, QObject * parent)
+    : QObject(parent)
+{
+    scene = aScene;
+    engine = new QJSEngine(this);
+    engine->installExtensions(QJSEngine::ConsoleExtension);
+
+    QQmlEngine::setObjectOwnership(this, QQmlEngine::CppOwnership);
+    engine->globalObject().setProperty("graphic", engine->newQObject(this));
+}
+
+
+
+/*
+ * Name:	~ScriptEngine()
+ * Purpose:	Destructor.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	The graphs a script made stay in the scene.
+ */
+
+ScriptEngine::~ScriptEngine()
+{
+    delete engine;
+}
+
+
+
+/*
+ * Name:	run()
+ * Purpose:	Run a script.
+ * Arguments:	The program, the file name to use in error messages,
+ *		and where to put an error message.
+ * Outputs:	Whatever the script logs.
+ * Modifies:	The scene, and *errorMessage on failure.
+ * Returns:	True iff the script ran without an uncaught exception.
+ * Assumptions:	None.
+ * Bugs:	A script which never returns hangs the program.
+ * Notes:	The user may have edited the graphs since the last run,
+ *		so the node lists are rebuilt as needed.
+ */
+
+bool
+ScriptEngine::run(QString program, QString fileName, QString * errorMessage)
+{
+    nodeLists.clear();
+    styleEdges.clear();
+
+    QJSValue result = engine->evaluate(program, fileName);
+
+    if (result.isError())
+    {
+	*errorMessage = fileName + ":"
+	    + result.property("lineNumber").toString() + ": "
+	    + result.toString();
+	return false;
+    }
+    return true;
+}
+
+
+
+/*
+ * Name:	runFile()
+ * Purpose:	Run the script in a file.
+ * Arguments:	The file name and where to put an error message.
+ * Outputs:	Whatever the script logs.
+ * Modifies:	The scene, and *errorMessage on failure.
+ * Returns:	True iff the file could be read and the script ran
+ *		without an uncaught exception.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+bool
+ScriptEngine::runFile(QString fileName, QString * errorMessage)
+{
+    QFile file(fileName);
+
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+	*errorMessage = "Unable to open " + fileName + " for reading!";
+	return false;
+    }
+
+    QTextStream in(&file);
+    QString program = in.readAll();
+    file.close();
+
+    return run(program, fileName, errorMessage);
+}
+
+
+
+/*
+ * Name:	runHeadless()
+ * Purpose:	Run a script with no main window.
+ * Arguments:	The script's file name and its arguments.
+ * Outputs:	Error messages, on stderr.
+ * Modifies:	Whatever files the script saves.
+ * Returns:	The program's exit status.
+ * Assumptions:	A QApplication exists.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+int
+ScriptEngine::runHeadless(QString fileName, QStringList arguments)
+{
+    setHeadlessResolution();
+
+    QGraphicsScene scene;
+    ScriptEngine scriptEngine(&scene);
+    QString errorMessage;
+
+    scriptEngine.setArgs(arguments);
+    bool ok = scriptEngine.runFile(fileName, &errorMessage);
+    if (!ok)
+	QTextStream(stderr) << errorMessage << endl;
+
+    // The scene is about to go, so don't leave its graphs in the list.
+    scriptEngine.clear();
+    return ok ? 0 : 1;
+}
+
+
+
+/*
+ * Name:	setHeadlessResolution()
+ * Purpose:	Set the DPI globals when there is no main window.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	currentPhysicalDPI, currentPhysicalDPI_X and _Y.
+ * Returns:	Nothing.
+ * Assumptions:	A QApplication exists.
+ * Bugs:	None known.
+ * Notes:	The DPI is chosen the same way as in
+ *		MainWindow::updateDpiAndPreview(), except that a
+ *		screen which doesn't know its size (such as the
+ *		"offscreen" platform's) gets FALLBACK_DPI.  Only the
+ *		size of saved images depends on it (see SCENE_DPI);
+ *		set a custom resolution in the settings to get the
+ *		same images on every machine.
+ */
+
+void
+ScriptEngine::setHeadlessResolution()
+{
+    QScreen * screen = QGuiApplication::primaryScreen();
+    AppSettings * appSettings = AppSettings::instance();
+    if (appSettings->useDefaultResolution()
+	|| ! appSettings->hasCustomResolution())
+    {
+	currentPhysicalDPI = screen ? screen->physicalDotsPerInch() : 0;
+	currentPhysicalDPI_X = screen ? screen->physicalDotsPerInchX() : 0;
+	currentPhysicalDPI_Y = screen ? screen->physicalDotsPerInchY() : 0;
+	if (!qIsFinite(currentPhysicalDPI) || currentPhysicalDPI <= 0
+	    || !qIsFinite(currentPhysicalDPI_X) || currentPhysicalDPI_X <= 0
+	    || !qIsFinite(currentPhysicalDPI_Y) || currentPhysicalDPI_Y <= 0)
+	    currentPhysicalDPI = currentPhysicalDPI_X
+		= currentPhysicalDPI_Y = FALLBACK_DPI;
+    }
+    else
+    {
+	currentPhysicalDPI = appSettings->customResolution();
+	currentPhysicalDPI_X = appSettings->customResolution();
+	currentPhysicalDPI_Y = appSettings->customResolution();
+    }
+}
+
+
+
+/*
+ * Name:	types()
+ * Purpose:	List the graph types generate() knows.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The names of the types.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+QStringList
+ScriptEngine::types()
+{
+    BasicGraphs basicG;
+    QStringList names;
+
+    for (int i = BasicGraphs::Nothing + 1; i < BasicGraphs::Count; i++)
+	names.append(basicG.getGraphName(i));
+    return names;
+}
+
+
+
+/*
+ * Name:	generate()
+ * Purpose:	Make a basic graph and put it in the scene.
+ * Arguments:	The type (see types()) and the options:
+ *		  nodes, nodes2	 the size(s) of the graph (nodes2 is
+ *				 the second number for bipartite,
+ *				 grid, Dutch windmill and Petersen)
+ *		  offsets	 for circulant graphs
+ *		  edges		 false to make just the nodes
+ *		  width, height	 the size of the drawing
+ *		  x, y		 where to put its centre
+ *		and any of the options for style().
+ * Outputs:	Nothing.
+ * Modifies:	The scene.
+ * Returns:	The handle of the new graph.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	The type may be given as the full name or just the part
+ *		before any " (", in any case; e.g. "gear" or "Petersen".
+ *		The nodes are placed the way PreView::Style_Graph()
+ *		does, but all at once.
+ */
+
+int
+ScriptEngine::generate(QString type, QVariantMap options)
+{
+    BasicGraphs basicG;
+    int graphType = BasicGraphs::Nothing;
+
+    for (int i = BasicGraphs::Nothing + 1; i < BasicGraphs::Count; i++)
+    {
+	QString name = basicG.getGraphName(i);
+	if (type.compare(name, Qt::CaseInsensitive) == 0
+	    || type.compare(name.section(" (", 0, 0), Qt::CaseInsensitive) == 0)
+	    graphType = i;
+    }
+    if (graphType == BasicGraphs::Nothing)
+    {
+	fail("generate(): unknown graph type \"" + type + "\"");
+	return -1;
+    }
+
+    int n1 = options.value("nodes", 5).toInt();
+    int n2 = options.value("nodes2", 3).toInt();
+    bool drawEdges = options.value("edges", true).toBool();
+    if (n1 < 1 || n2 < 1)
+    {
+	fail("generate(): the number of nodes must be positive");
+	return -1;
+    }
+
+    Graph * g = new Graph();
+    switch (graphType)
+    {
+      case BasicGraphs::Antiprism:
+	basicG.generate_antiprism(g, n1, drawEdges);
+	break;
+      case BasicGraphs::BBTree:
+	basicG.generate_balanced_binary_tree(g, n1, drawEdges);
+	break;
+      case BasicGraphs::Bipartite:
+	basicG.generate_bipartite(g, n1, n2, drawEdges);
+	break;
+      case BasicGraphs::Circulant:
+	basicG.generate_circulant(g, n1, options.value("offsets", "1").toString(),
+				  drawEdges);
+	break;
+      case BasicGraphs::Complete:
+	basicG.generate_complete(g, n1, drawEdges);
+	break;
+      case BasicGraphs::Crown:
+	basicG.generate_crown(g, n1, drawEdges);
+	break;
+      case BasicGraphs::Cycle:
+	basicG.generate_cycle(g, n1, drawEdges);
+	break;
+      case BasicGraphs::Dutch_Windmill:
+	basicG.generate_dutch_windmill(g, n1, n2, drawEdges);
+	break;
+      case BasicGraphs::Gear:
+	basicG.generate_gear(g, n1, drawEdges);
+	break;
+      case BasicGraphs::Grid:
+	basicG.generate_grid(g, n1, n2, drawEdges);
+	break;
+      case BasicGraphs::Helm:
+	basicG.generate_helm(g, n1, drawEdges);
+	break;
+      case BasicGraphs::Path:
+	basicG.generate_path(g, n1, drawEdges);
+	break;
+      case BasicGraphs::Petersen:
+	basicG.generate_petersen(g, n1, n2, drawEdges);
+	break;
+      case BasicGraphs::Prism:
+	basicG.generate_prism(g, n1, drawEdges);
+	break;
+      case BasicGraphs::Star:
+	basicG.generate_star(g, n1, drawEdges);
+	break;
+      case BasicGraphs::Wheel:
+	basicG.generate_wheel(g, n1, drawEdges);
+	break;
+    }
+
+    layOut(scene, g, options);
+    canvasGraphList.append(g);
+    g->isMoved();
+
+    int handle = addHandle(g);
+    style(handle, options);
+    return handle;
+}
+
+
+
+/*
+ * Name:	layOut()
+ * Purpose:	Give a new graph the default style, position its nodes
+ *		from their preview coordinates, and put it in a scene.
+ * Arguments:	The scene, the graph, and the options: width, height,
+ *		x and y (see generate()) and diameter.
+ * Outputs:	Nothing.
+ * Modifies:	The graph and the scene.
+ * Returns:	Nothing.
+ * Assumptions:	The nodes' preview coordinates are set, as for basic
+ *		graphs.
+ * Bugs:	None known.
+ * Notes:	Also used by the render service for edge lists (see
+ *		renderservice.h).
+ */
+
+void
+ScriptEngine::layOut(QGraphicsScene * scene, Graph * g, QVariantMap options)
+{
+    // Give everything the default style first, so that the edges know
+    // the node radii before they are adjusted.
+    qreal diameter = options.value("diameter", DEFAULT_DIAMETER).toReal();
+    QList<Node *> nodes = nodesOf(g);
+    foreach (Node * node, nodes)
+    {
+	node->setDiameter(diameter);
+	node->setPenWidth(DEFAULT_PEN_WIDTH);
+	node->setFillColour(Qt::white);
+	node->setLineColour(Qt::black);
+	node->setNodeLabelSize(DEFAULT_LABEL_SIZE);
+    }
+    foreach (Edge * edge, edgesOf(g))
+    {
+	edge->setPenWidth(DEFAULT_PEN_WIDTH);
+	edge->setColour(Qt::black);
+	edge->setEdgeLabelSize(DEFAULT_LABEL_SIZE);
+	edge->setSourceRadius(diameter / 2.);
+	edge->setDestRadius(diameter / 2.);
+    }
+
+    // See PreView::Style_Graph() for the scaling.
+    qreal width = options.value("width", DEFAULT_SIZE).toReal();
+    qreal height = options.value("height", DEFAULT_SIZE).toReal();
+    qreal widthScale = qMax(width - diameter, 0.1) * SCENE_DPI;
+    qreal heightScale = qMax(height - diameter, 0.1) * SCENE_DPI;
+    QList<QPointF> positions;
+    foreach (Node * node, nodes)
+	positions.append(QPointF(node->getPreviewX() * widthScale,
+				 node->getPreviewY() * heightScale));
+    CanvasScene::setNodePositions(nodes, positions);
+
+    QPointF centre;
+    QRectF others = CanvasScene::contentBoundsOf(scene);
+    if (options.contains("x"))
+	centre.setX(options.value("x").toReal() * SCENE_DPI);
+    else if (others.isEmpty())
+	centre.setX(width / 2 * SCENE_DPI);
+    else
+	centre.setX(others.right()
+		    + (PLACEMENT_GAP + width / 2) * SCENE_DPI);
+    if (options.contains("y"))
+	centre.setY(options.value("y").toReal() * SCENE_DPI);
+    else if (others.isEmpty())
+	centre.setY(height / 2 * SCENE_DPI);
+    else
+	centre.setY(others.center().y());
+
+    g->setPos(centre);
+    scene->addItem(g);
+}
+
+
+
+/*
+ * Name:	style()
+ * Purpose:	Style every node and edge of a graph.
+ * Arguments:	The graph's handle and the options, any of:
+ *		  fill, outline		 node colours
+ *		  diameter		 node diameter
+ *		  nodePen		 node outline width
+ *		  nodeLabelSize
+ *		  nodeLabels		 true for numbers, or a string
+ *					 to be subscripted by numbers,
+ *					 or "" for no labels
+ *		  firstNumber		 the first node number (0)
+ *		  edgeColour, edgePen, edgeLabelSize
+ *		  edgeLabels		 like nodeLabels
+ *		  firstEdgeNumber	 the first edge number (0)
+ *		  styleClass		 the name of a style class
+ *					 (see defineStyle()) to put
+ *					 everything in
+ * Outputs:	Nothing.
+ * Modifies:	The graph.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	See applyStyle().
+ */
+
+void
+ScriptEngine::style(int handle, QVariantMap options)
+{
+    Graph * g = graphFor(handle);
+    QString errorMessage;
+
+    if (g != nullptr && !applyStyle(g, options, &errorMessage))
+	fail("style(): " + errorMessage);
+}
+
+
+
+/*
+ * Name:	applyStyle()
+ * Purpose:	Style every node and edge of a graph.
+ * Arguments:	The graph, the options (see style()) and where to put
+ *		an error message.
+ * Outputs:	Nothing.
+ * Modifies:	The graph, or *errorMessage.
+ * Returns:	True, or false if an option is bad (in which case
+ *		nothing is changed).
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Options not given are left alone.  The labels are all
+ *		made in one LabelBatch.  styleClass is applied last, so
+ *		it wins over any other options.
+ *		Also used by the render service (see renderservice.h).
+ */
+
+bool
+ScriptEngine::applyStyle(Graph * g, QVariantMap options,
+			 QString * errorMessage)
+{
+    StyleClass * styleClass = nullptr;
+    if (options.contains("styleClass"))
+    {
+	QString name = options.value("styleClass").toString();
+	styleClass = StyleClass::find(name);
+	if (styleClass == nullptr)
+	{
+	    *errorMessage = "there is no style class \"" + name + "\"";
+	    return false;
+	}
+    }
+
+    bool ok = true;
+    QColor fill = colourOption(options, "fill", QColor(), &ok);
+    QColor outline = colourOption(options, "outline", QColor(), &ok);
+    QColor edgeColour = colourOption(options, "edgeColour", QColor(), &ok);
+    if (!ok)
+    {
+	*errorMessage = "unknown colour";
+	return false;
+    }
+
+    QList<Node *> nodes = nodesOf(g);
+    QList<Edge *> edges = edgesOf(g);
+    LabelBatch labels;
+
+    QVariant nodeLabels = options.value("nodeLabels");
+    int i = options.value("firstNumber", 0).toInt();
+    foreach (Node * node, nodes)
+    {
+	if (fill.isValid())
+	    node->setFillColour(fill);
+	if (outline.isValid())
+	    node->setLineColour(outline);
+	if (options.contains("diameter"))
+	    node->setDiameter(options.value("diameter").toReal());
+	if (options.contains("nodePen"))
+	    node->setPenWidth(options.value("nodePen").toReal());
+	if (options.contains("nodeLabelSize"))
+	    node->setNodeLabelSize(options.value("nodeLabelSize").toReal());
+	if (nodeLabels.type() == QVariant::Bool)
+	    labels.add(node, nodeLabels.toBool() ? QString::number(i++) : "");
+	else if (nodeLabels.isValid())
+	    labels.add(node, nodeLabels.toString().isEmpty() ? ""
+		       : LabelBatch::subscripted(nodeLabels.toString(), i++));
+	if (styleClass != nullptr)
+	    node->setStyleClass(styleClass);
+    }
+
+    QVariant edgeLabels = options.value("edgeLabels");
+    int k = options.value("firstEdgeNumber", 0).toInt();
+    foreach (Edge * edge, edges)
+    {
+	if (edgeColour.isValid())
+	    edge->setColour(edgeColour);
+	if (options.contains("edgePen"))
+	    edge->setPenWidth(options.value("edgePen").toReal());
+	if (options.contains("edgeLabelSize"))
+	    edge->setEdgeLabelSize(qMax(options.value("edgeLabelSize")
+					.toReal(), 1.));
+	if (options.contains("diameter"))
+	{
+	    edge->setSourceRadius(edge->sourceNode()->getDiameter() / 2.);
+	    edge->setDestRadius(edge->destNode()->getDiameter() / 2.);
+	}
+	if (edgeLabels.type() == QVariant::Bool)
+	    labels.add(edge, edgeLabels.toBool() ? QString::number(k++) : "");
+	else if (edgeLabels.isValid())
+	    labels.add(edge, edgeLabels.toString().isEmpty() ? ""
+		       : LabelBatch::subscripted(edgeLabels.toString(), k++));
+	if (styleClass != nullptr)
+	    edge->setStyleClass(styleClass);
+    }
+
+    labels.apply();
+    return true;
+}
+
+
+
+/*
+ * Name:	defineStyle()
+ * Purpose:	Make a style class, or change an existing one.
+ * Arguments:	The class name and the options, any of fill, outline,
+ *		diameter, pen, labelSize and edgeColour.
+ * Outputs:	Nothing.
+ * Modifies:	The class and all of its members.
+ * Returns:	The class's name, which may differ from the one asked
+ *		for (see StyleClass::define()).
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Values not given are taken from the existing class, or
+ *		from the defaults for a new one.  Changing a class with
+ *		thousands of members costs one update of the scene.
+ */
+
+QString
+ScriptEngine::defineStyle(QString name, QVariantMap options)
+{
+    StyleClass::Values v;
+    StyleClass * existing = StyleClass::find(name);
+
+    if (existing != nullptr)
+	v = existing->values();
+    else
+    {
+	v.fillColour = Qt::white;
+	v.lineColour = Qt::black;
+	v.diameter = DEFAULT_DIAMETER;
+	v.penWidth = DEFAULT_PEN_WIDTH;
+	v.labelSize = DEFAULT_LABEL_SIZE;
+	v.edgeColour = Qt::black;
+    }
+
+    bool ok = true;
+    v.fillColour = colourOption(options, "fill", v.fillColour, &ok);
+    v.lineColour = colourOption(options, "outline", v.lineColour, &ok);
+    v.edgeColour = colourOption(options, "edgeColour", v.edgeColour, &ok);
+    if (!ok)
+    {
+	fail("defineStyle(): unknown colour");
+	return QString();
+    }
+    v.diameter = options.value("diameter", v.diameter).toReal();
+    v.penWidth = options.value("pen", v.penWidth).toReal();
+    v.labelSize = options.value("labelSize", v.labelSize).toReal();
+
+    StyleClass * styleClass = StyleClass::define(name, v);
+    scene->update();
+    return styleClass->name();
+}
+
+
+
+/*
+ * Name:	copy()
+ * Purpose:	Make a copy of a graph.
+ * Arguments:	The graph's handle.
+ * Outputs:	Nothing.
+ * Modifies:	The scene.
+ * Returns:	The handle of the copy.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	The copy goes just to the right of the original (see
+ *		GraphOps::inducedSubgraph()).
+ */
+
+int
+ScriptEngine::copy(int handle)
+{
+    Graph * g = graphFor(handle);
+    if (g == nullptr)
+	return -1;
+
+    QString errorMessage;
+    Graph * copy = GraphOps::inducedSubgraph(nodesOf(g), &errorMessage);
+    if (copy == nullptr)
+    {
+	fail("copy(): " + errorMessage);
+	return -1;
+    }
+    copy->isMoved();
+    return addHandle(copy);
+}
+
+
+
+/*
+ * Name:	move()
+ * Purpose:	Move a graph.
+ * Arguments:	The graph's handle and how far to move it (in inches).
+ * Outputs:	Nothing.
+ * Modifies:	The graph's position.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+void
+ScriptEngine::move(int handle, qreal dx, qreal dy)
+{
+    Graph * g = graphFor(handle);
+    if (g != nullptr)
+	g->moveBy(dx * SCENE_DPI, dy * SCENE_DPI);
+}
+
+
+
+/*
+ * Name:	rotate()
+ * Purpose:	Rotate a graph.
+ * Arguments:	The graph's handle and the angle (clockwise degrees).
+ * Outputs:	Nothing.
+ * Modifies:	The graph.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+void
+ScriptEngine::rotate(int handle, qreal degrees)
+{
+    Graph * g = graphFor(handle);
+    if (g != nullptr)
+	g->setRotation(degrees, true);
+}
+
+
+
+/*
+ * Name:	arrange()
+ * Purpose:	Arrange all of a graph's nodes, as the Arrange menu does.
+ * Arguments:	The graph's handle and the arrangement: one of "left",
+ *		"right", "top", "bottom", "hcentre", "vcentre",
+ *		"distributeH", "distributeV", "circle", "line",
+ *		"mirrorH" or "mirrorV".
+ * Outputs:	Nothing.
+ * Modifies:	The node positions.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Graphs with too few nodes for the arrangement are left
+ *		alone.
+ */
+
+void
+ScriptEngine::arrange(int handle, QString how)
+{
+    static const QStringList names = {
+	"left", "right", "top", "bottom", "hcentre", "vcentre",
+	"distributeh", "distributev", "circle", "line", "mirrorh", "mirrorv"
+    };
+    static const Arrange::Operation ops[] = {
+	Arrange::AlignLeft, Arrange::AlignRight, Arrange::AlignTop,
+	Arrange::AlignBottom, Arrange::AlignHCentre, Arrange::AlignVCentre,
+	Arrange::DistributeH, Arrange::DistributeV, Arrange::OnCircle,
+	Arrange::OnLine, Arrange::MirrorH, Arrange::MirrorV
+    };
+
+    Graph * g = graphFor(handle);
+    if (g == nullptr)
+	return;
+
+    int which = names.indexOf(how.toLower());
+    if (which < 0)
+    {
+	fail("arrange(): unknown arrangement \"" + how + "\"");
+	return;
+    }
+
+    QList<Node *> nodes = nodesOf(g);
+    if (nodes.count() < Arrange::minimumNodes(ops[which]))
+	return;
+
+    QList<QPointF> positions = Arrange::targets(nodes, ops[which]);
+    for (int i = 0; i < positions.count(); i++)
+	positions[i] = g->mapFromScene(positions.at(i));
+    CanvasScene::setNodePositions(nodes, positions);
+}
+
+
+
+/*
+ * Name:	join()
+ * Purpose:	Make two graphs into one.
+ * Arguments:	The two handles.
+ * Outputs:	Nothing.
+ * Modifies:	The scene.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	This is what CanvasView::addEdgeToScene() does when an
+ *		edge joins two graphs, without the edge; use addEdge()
+ *		to connect them.  The joined graph keeps the first
+ *		handle and the second one is no longer valid.
+ *		The nodes of the second graph come after those of the
+ *		first, so its node i becomes node nodeCount(handle1) + i
+ *		(with nodeCount() from before the join).
+ */
+
+void
+ScriptEngine::join(int handle1, int handle2)
+{
+    Graph * g1 = graphFor(handle1);
+    Graph * g2 = graphFor(handle2);
+    if (g1 == nullptr || g2 == nullptr)
+	return;
+    if (g1 == g2)
+    {
+	fail("join(): can't join a graph to itself");
+	return;
+    }
+
+    Graph * root = new Graph();
+    // Nodes first, so that node indices are as documented above.
+    foreach (Graph * g, QList<Graph *>({ g1, g2 }))
+    {
+	QList<QGraphicsItem *> children;
+	foreach (Node * node, nodesOf(g))
+	    children.append(node);
+	foreach (Edge * edge, edgesOf(g))
+	    children.append(edge);
+	foreach (QGraphicsItem * item, children)
+	{
+	    QPointF itemPos = item->scenePos();
+	    item->setParentItem(root);
+	    item->setPos(itemPos);
+	    item->setRotation(0);
+	}
+    }
+    root->setHandlesChildEvents(false);
+    scene->addItem(root);
+    canvasGraphList.append(root);
+
+    deleteGraph(g1);
+    deleteGraph(g2);
+    graphs[handle1] = root;
+    forgetNodes(handle1);
+    forgetNodes(handle2);
+}
+
+
+
+/*
+ * Name:	addEdge()
+ * Purpose:	Join two nodes of a graph with an edge.
+ * Arguments:	The graph's handle and the two node indices.
+ * Outputs:	Nothing.
+ * Modifies:	The graph.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	The new edge looks like the graph's first edge, if it
+ *		has one, otherwise it gets the default style.  Asking
+ *		for an edge which is already there is an error, since
+ *		the graphs are simple.
+ */
+
+void
+ScriptEngine::addEdge(int handle, int from, int to)
+{
+    Graph * g = graphFor(handle);
+    if (g == nullptr)
+	return;
+
+    Node * source = nodeFor(handle, from);
+    Node * dest = nodeFor(handle, to);
+    if (source == nullptr || dest == nullptr)
+	return;
+    if (source == dest)
+    {
+	fail("addEdge(): can't join a node to itself");
+	return;
+    }
+    foreach (Edge * edge, source->edgeList)
+    {
+	if (edge->sourceNode() == dest || edge->destNode() == dest)
+	{
+	    fail("addEdge(): nodes " + QString::number(from) + " and "
+		 + QString::number(to) + " are already adjacent");
+	    return;
+	}
+    }
+
+    // nodeFor() has filled in styleEdges for this handle.
+    Edge * model = styleEdges.value(handle);
+    Edge * edge = new Edge(source, dest);
+    if (model == nullptr)
+    {
+	edge->setPenWidth(DEFAULT_PEN_WIDTH);
+	edge->setColour(Qt::black);
+	edge->setEdgeLabelSize(DEFAULT_LABEL_SIZE);
+	styleEdges[handle] = edge;
+    }
+    else if (model->getStyleClass() != nullptr)
+	edge->setStyleClass(model->getStyleClass());
+    else
+    {
+	edge->setPenWidth(model->getPenWidth());
+	edge->setColour(model->getColour());
+	edge->setEdgeLabelSize(model->getLabelSize());
+    }
+    edge->setSourceRadius(source->getDiameter() / 2.);
+    edge->setDestRadius(dest->getDiameter() / 2.);
+    edge->setZValue(-1);
+    edge->setParentItem(g);
+    edge->adjust();
+}
+
+
+
+/*
+ * Name:	identify()
+ * Purpose:	Make two nodes of a graph into one.
+ * Arguments:	The graph's handle and the indices of the node to keep
+ *		and the node to get rid of.
+ * Outputs:	Nothing.
+ * Modifies:	The graph.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	See GraphOps::identifyNodes().  The nodes after "gone"
+ *		move down one index.
+ */
+
+void
+ScriptEngine::identify(int handle, int keep, int gone)
+{
+    Graph * g = graphFor(handle);
+    if (g == nullptr)
+	return;
+
+    Node * keepNode = nodeFor(handle, keep);
+    Node * goneNode = nodeFor(handle, gone);
+    if (keepNode == nullptr || goneNode == nullptr)
+	return;
+
+    QString errorMessage;
+    forgetNodes(handle);
+    if (GraphOps::identifyNodes(keepNode, goneNode, &errorMessage) == nullptr)
+	fail("identify(): " + errorMessage);
+}
+
+
+
+int
+ScriptEngine::nodeCount(int handle)
+{
+    Graph * g = graphFor(handle);
+    return g == nullptr ? 0 : nodeListOf(handle).count();
+}
+
+
+
+int
+ScriptEngine::edgeCount(int handle)
+{
+    Graph * g = graphFor(handle);
+    return g == nullptr ? 0 : edgesOf(g).count();
+}
+
+
+
+/*
+ * Name:	remove()
+ * Purpose:	Delete a graph.
+ * Arguments:	The graph's handle.
+ * Outputs:	Nothing.
+ * Modifies:	The scene.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	The handle is no longer valid afterwards.
+ */
+
+void
+ScriptEngine::remove(int handle)
+{
+    Graph * g = graphFor(handle);
+    if (g != nullptr)
+	deleteGraph(g);
+    forgetNodes(handle);
+}
+
+
+
+/*
+ * Name:	clear()
+ * Purpose:	Delete every graph this script made.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	The scene.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Anything else on the canvas is left alone.
+ */
+
+void
+ScriptEngine::clear()
+{
+    foreach (QPointer<Graph> g, graphs)
+	if (!g.isNull())
+	    deleteGraph(g);
+    graphs.clear();
+    nodeLists.clear();
+    styleEdges.clear();
+}
+
+
+
+/*
+ * Name:	save()
+ * Purpose:	Save everything in the scene.
+ * Arguments:	The file name; its extension says what kind of file to
+ *		write (see File_IO::exportGraph()).
+ * Outputs:	The file.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	A relative file name is relative to the current
+ *		directory.
+ */
+
+void
+ScriptEngine::save(QString fileName)
+{
+    QString errorMessage;
+
+    if (!File_IO::exportGraph(scene, fileName, &errorMessage))
+	fail("save(): " + errorMessage);
+}
+
+
+
+/*
+ * Name:	graphFor()
+ * Purpose:	Look up a handle.
+ * Arguments:	The handle.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The graph, or nullptr (after throwing a script error).
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	A graph deleted from the canvas by the user (or joined
+ *		to another one there) makes its handle invalid.
+ */
+
+Graph *
+ScriptEngine::graphFor(int handle)
+{
+    if (handle < 0 || handle >= graphs.count() || graphs.at(handle).isNull())
+    {
+	fail("no graph with handle " + QString::number(handle));
+	return nullptr;
+    }
+    return graphs.at(handle);
+}
+
+
+
+/*
+ * Name:	nodeFor()
+ * Purpose:	Look up a node of a graph.
+ * Arguments:	The graph's (valid) handle and the node's index.
+ * Outputs:	Nothing.
+ * Modifies:	nodeLists and styleEdges, if they are rebuilt.
+ * Returns:	The node, or nullptr (after throwing a script error).
+ * Assumptions:	graphFor(handle) succeeded.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+Node *
+ScriptEngine::nodeFor(int handle, int index)
+{
+    const QVector<Node *> & nodes = nodeListOf(handle);
+
+    if (index < 0 || index >= nodes.count())
+    {
+	fail("no node " + QString::number(index) + " (the graph has "
+	     + QString::number(nodes.count()) + " nodes)");
+	return nullptr;
+    }
+    return nodes.at(index);
+}
+
+
+
+/*
+ * Name:	nodeListOf()
+ * Purpose:	Get the nodes of a handle's graph, in index order.
+ * Arguments:	The graph's (valid) handle.
+ * Outputs:	Nothing.
+ * Modifies:	nodeLists and styleEdges, if the handle has no entry.
+ * Returns:	The nodes.
+ * Assumptions:	graphFor(handle) succeeded.
+ * Bugs:	None known.
+ * Notes:	Both are built in one pass over the graph's children and
+ *		kept until forgetNodes() (or run() or clear()) drops
+ *		them; so anything which adds, removes or reorders the
+ *		graph's nodes must call forgetNodes().  New edges are
+ *		added after the nodes, so addEdge() doesn't need to.
+ *		styleEdges holds the graph's first edge, the one
+ *		addEdge() copies the style of.
+ */
+
+const QVector<Node *> &
+ScriptEngine::nodeListOf(int handle)
+{
+    if (!nodeLists.contains(handle))
+    {
+	QVector<Node *> nodes;
+	Edge * first = nullptr;
+
+	foreach (QGraphicsItem * item, graphs.at(handle)->childItems())
+	{
+	    if (item->type() == Node::Type)
+		nodes.append(qgraphicsitem_cast<Node *>(item));
+	    else if (first == nullptr && item->type() == Edge::Type)
+		first = qgraphicsitem_cast<Edge *>(item);
+	}
+	nodeLists.insert(handle, nodes);
+	styleEdges.insert(handle, first);
+    }
+    return nodeLists[handle];
+}
+
+
+
+void
+ScriptEngine::forgetNodes(int handle)
+{
+    nodeLists.remove(handle);
+    styleEdges.remove(handle);
+}
+
+
+
+int
+ScriptEngine::addHandle(Graph * graph)
+{
+    graphs.append(graph);
+    return graphs.count() - 1;
+}
+
+
+
+/*
+ * Name:	deleteGraph()
+ * Purpose:	Take a graph out of the scene and delete it.
+ * Arguments:	The graph.
+ * Outputs:	Nothing.
+ * Modifies:	The scene and canvasGraphList.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Its handle becomes invalid, since graphs holds QPointers.
+ */
+
+void
+ScriptEngine::deleteGraph(Graph * graph)
+{
+    if (graph->scene() != nullptr)
+	graph->scene()->removeItem(graph);
+    canvasGraphList.removeOne(graph);
+    delete graph;
+}
+
+
+
+void
+ScriptEngine::fail(QString message)
+{
+    engine->throwError(message);
+}
+
+
+
+/*
+ * Name:	nodesOf(), edgesOf()
+ * Purpose:	List the nodes or edges of a graph.
+ * Arguments:	The graph.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The nodes (edges), in the order of the graph's children.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	This order is what node indices refer to.
+ */
+
+QList<Node *>
+ScriptEngine::nodesOf(Graph * graph)
+{
+    QList<Node *> nodes;
+
+    foreach (QGraphicsItem * item, graph->childItems())
+	if (item->type() == Node::Type)
+	    nodes.append(qgraphicsitem_cast<Node *>(item));
+    return nodes;
+}
+
+
+
+QList<Edge *>
+ScriptEngine::edgesOf(Graph * graph)
+{
+    QList<Edge *> edges;
+
+    foreach (QGraphicsItem * item, graph->childItems())
+	if (item->type() == Edge::Type)
+	    edges.append(qgraphicsitem_cast<Edge *>(item));
+    return edges;
+}
+
+
+
+/*
+ * Name:	colourOption()
+ * Purpose:	Get a colour out of a script's options.
+ * Arguments:	The options, the key, the colour to use if the key is
+ *		not there, and a flag to clear if the colour is bad.
+ * Outputs:	Nothing.
+ * Modifies:	*ok, if the colour is bad.
+ * Returns:	The colour.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+QColor
+ScriptEngine::colourOption(QVariantMap options, QString key, QColor colour,
+			   bool * ok)
+{
+    if (!options.contains(key))
+	return colour;
+
+    QColor c(options.value(key).toString());
+    if (!c.isValid())
+    {
+	*ok = false;
+	return colour;
+    }
+    return c;
+}
@@ -0,0 +1,126 @@
+/*
+ * File:	scriptengine.h
+ * Author:	Jim Diamond
+ * Date:	2026-10-19
+ * Version:	1.2
+ *
+ * Purpose:	Define the ScriptEngine class, which runs JavaScript
+ *		programs which generate, style, arrange, join and save
+ *		graphs, either on the canvas (File > Run Script...) or
+ *		with no window at all ("Graphic --script file.js").
+ *
+ * Notes:	A script sees one object, "graphic", whose methods are
+ *		the Q_INVOKABLE functions below, plus console.log().
+ *		Graphs are referred to by the small integer "handles"
+ *		which generate() and copy() return; nodes within a
+ *		graph are referred to by their index (0, 1, ...).
+ *		Lengths and positions are in inches, colours are
+ *		anything QColor understands ("red", "#ff8000", ...).
+ *		Options are passed as JavaScript objects, e.g.
+ *		    var h = graphic.generate("cycle", { nodes: 12 });
+ *		    graphic.style(h, { fill: "yellow", nodeLabels: "v" });
+ *		    graphic.save("c12.tikz");
+ *		Errors (bad handles, unknown graph types, ...) are
+ *		thrown as JavaScript exceptions, so a script can catch
+ *		them; an uncaught one stops the script.
+ *		Every call goes through the same bulk code paths the
+ *		GUI uses for a whole graph at once: node positions are
+ *		set with CanvasScene::setNodePositions(), labels are
+ *		made with a LabelBatch, style classes restyle their
+ *		members without visiting them, and saving uses the
+ *		parallel File_IO writers.  Since a script runs to
+ *		completion before control returns to the event loop,
+ *		the canvas is repainted once, at the end.
+ *		Building this needs "QT += qml".
+ *
+ * Modification history:
+ * Oct 19, 2026 (JD V1.0)
+ *  (a) Initial version.
+ * Oct 19, 2026 (JD V1.1)
+ *  (a) Add layOut(), applyStyle() and setHeadlessResolution().
+ * Oct 19, 2026 (JD V1.2)
+ *  (a) Keep each handle's node list (and the edge new edges are
+ *	styled like) in nodeLists and styleEdges.
+ */
+
+#ifndef SCRIPTENGINE_H
+#define SCRIPTENGINE_H
+
+#include <QColor>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QString>
+#include <QStringList>
+#include <QVariantMap>
+#include <QVector>
+
+class Edge;
+class Graph;
+class Node;
+class QGraphicsScene;
+class QJSEngine;
+
+class ScriptEngine : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(QStringList args READ getArgs)
+
+  public:
+    ScriptEngine(QGraphicsScene * scene, QObject * parent = nullptr);
+    ~ScriptEngine();
+
+    bool run(QString program, QString fileName, QString * errorMessage);
+    bool runFile(QString fileName, QString * errorMessage);
+    void setArgs(QStringList arguments) { args = arguments; }
+    QStringList getArgs() const { return args; }
+
+    static int runHeadless(QString fileName, QStringList arguments);
+    static void setHeadlessResolution();
+    static void layOut(QGraphicsScene * scene, Graph * g,
+		       QVariantMap options);
+    static bool applyStyle(Graph * g, QVariantMap options,
+			   QString * errorMessage);
+
+    // The scripting interface.
+    Q_INVOKABLE QStringList types();
+    Q_INVOKABLE int generate(QString type, QVariantMap options);
+    Q_INVOKABLE void style(int handle, QVariantMap options);
+    Q_INVOKABLE QString defineStyle(QString name, QVariantMap options);
+    Q_INVOKABLE int copy(int handle);
+    Q_INVOKABLE void move(int handle, qreal dx, qreal dy);
+    Q_INVOKABLE void rotate(int handle, qreal degrees);
+    Q_INVOKABLE void arrange(int handle, QString how);
+    Q_INVOKABLE void join(int handle1, int handle2);
+    Q_INVOKABLE void addEdge(int handle, int from, int to);
+    Q_INVOKABLE void identify(int handle, int keep, int gone);
+    Q_INVOKABLE int nodeCount(int handle);
+    Q_INVOKABLE int edgeCount(int handle);
+    Q_INVOKABLE void remove(int handle);
+    Q_INVOKABLE void clear();
+    Q_INVOKABLE void save(QString fileName);
+
+  private:
+    Graph * graphFor(int handle);
+    Node * nodeFor(int handle, int index);
+    const QVector<Node *> & nodeListOf(int handle);
+    void forgetNodes(int handle);
+    int addHandle(Graph * graph);
+    void deleteGraph(Graph * graph);
+    void fail(QString message);
+
+    static QList<Node *> nodesOf(Graph * graph);
+    static QList<Edge *> edgesOf(Graph * graph);
+    static QColor colourOption(QVariantMap options, QString key,
+			       QColor colour, bool * ok);
+
+    QGraphicsScene * scene;
+    QJSEngine * engine;
+    QStringList args;
+    QVector<QPointer<Graph>> graphs;	// Indexed by handle.
+    QHash<int, QVector<Node *>> nodeLists;	// Built as needed.
+    QHash<int, QPointer<Edge>> styleEdges;	// Ditto.
+};
+
+#endif // SCRIPTENGINE_H
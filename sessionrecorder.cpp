@@ -0,0 +1,607 @@
+/*
+ * File:	sessionrecorder.cpp
+ * Author:	Jim Diamond
+ * Date:	2026-10-19
+ * Version:	1.0
+ *
+ * Purpose:	Implement the SessionRecorder class.  See
+ *		sessionrecorder.h for the file format.
+ *
+ * Modification history:
+ * Oct 19, 2026 (JD V1.0)
+ *  (a) Initial version.
+ */
+
+#include "sessionrecorder.h"
+#include "canvasview.h"
+#include "defuns.h"
+#include "edge.h"
+#include "file-io.h"
+#include "graph.h"
+#include "html-label.h"
+#include "node.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QGraphicsScene>
+#include <QKeyEvent>
+#include <QMouseEvent>
+#include <QTextStream>
+
+QFile * SessionRecorder::file = nullptr;
+QTextStream * SessionRecorder::out = nullptr;
+QElapsedTimer SessionRecorder::clock;
+QHash<Node *, int> SessionRecorder::ids;
+QVector<QPointer<Node>> SessionRecorder::nodes;
+QPointF SessionRecorder::pressPos;
+
+
+
+/*
+ * Name:	start()
+ * Purpose:	Start recording a session.
+ * Arguments:	The session file name, the canvas, and where to put an
+ *		error message.
+ * Outputs:	The header and the current state of the canvas, to the
+ *		file.
+ * Modifies:	The recorder's state, or *errorMessage.
+ * Returns:	True iff the file could be opened.
+ * Assumptions:	None.
+ * Bugs:	Graph rotations are baked into the node positions.
+ * Notes:	A session already being recorded is stopped first.
+ */
+
+bool
+SessionRecorder::start(QString fileName, CanvasView * view,
+		       QString * errorMessage)
+{
+    stop();
+
+    file = new QFile(fileName);
+    if (!file->open(QIODevice::WriteOnly | QIODevice::Truncate
+		    | QIODevice::Text))
+    {
+	*errorMessage = "Can't write " + fileName + ": "
+	    + file->errorString();
+	delete file;
+	file = nullptr;
+	return false;
+    }
+    out = new QTextStream(file);
+    *out << SESSION_FILE_HEADER << "\n";
+    *out << "# Recorded " << QDateTime::currentDateTime()
+	.toString("yyyy-MM-dd hh:mm:ss") << "\n";
+    clock.start();
+
+    nodeParamsChanged(view);
+    edgeParamsChanged(view);
+    modeChanged(view->getMode());
+
+    // The nodes of each top-level graph, in the order they are drawn.
+    foreach (QGraphicsItem * item, view->scene()->items(Qt::AscendingOrder))
+	if (item->type() == Graph::Type && item->parentItem() == nullptr)
+	    writeGraph(qgraphicsitem_cast<Graph *>(item));
+    out->flush();
+    return true;
+}
+
+
+
+/*
+ * Name:	stop()
+ * Purpose:	Stop recording.
+ * Arguments:	None.
+ * Outputs:	Anything not yet written, to the file.
+ * Modifies:	The recorder's state.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Does nothing if no session is being recorded.
+ */
+
+void
+SessionRecorder::stop()
+{
+    if (!isRecording())
+	return;
+
+    out->flush();
+    delete out;
+    out = nullptr;
+    file->close();
+    delete file;
+    file = nullptr;
+    ids.clear();
+    nodes.clear();
+}
+
+
+
+/*
+ * Name:	modeChanged(), nodeParamsChanged(), edgeParamsChanged()
+ * Purpose:	Record a change of the canvas mode, or of the style of
+ *		new freestyle nodes or edges.
+ * Arguments:	The new mode, or the canvas.
+ * Outputs:	A "mode", "nodeparams" or "edgeparams" line.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	The labels are last, since they may be empty.
+ */
+
+void
+SessionRecorder::modeChanged(int mode)
+{
+    if (isRecording())
+	write("mode " + CanvasView::getModeName(mode));
+}
+
+
+
+void
+SessionRecorder::nodeParamsChanged(CanvasView * view)
+{
+    if (!isRecording())
+	return;
+
+    const CanvasView::Node_Params & p = view->getNodeParams();
+    write(QString("nodeparams %1 %2 %3 %4 %5 %6 %7")
+	  .arg(p.diameter).arg(p.isNumbered ? 1 : 0).arg(p.labelSize)
+	  .arg(p.fillColour.name(QColor::HexArgb))
+	  .arg(p.outlineColour.name(QColor::HexArgb))
+	  .arg(p.nodeThickness).arg(encode(p.label)));
+}
+
+
+
+void
+SessionRecorder::edgeParamsChanged(CanvasView * view)
+{
+    if (!isRecording())
+	return;
+
+    const CanvasView::Edge_Params & p = view->getEdgeParams();
+    write(QString("edgeparams %1 %2 %3 %4 %5")
+	  .arg(p.size).arg(p.LabelSize).arg(p.colour.name(QColor::HexArgb))
+	  .arg(p.isNumbered ? 1 : 0).arg(encode(p.label)));
+}
+
+
+
+/*
+ * Name:	mouseEvent()
+ * Purpose:	Record a mouse event on the canvas.
+ * Arguments:	The canvas and the event.
+ * Outputs:	A "press", "double", "move" or "release" line.
+ * Modifies:	pressPos.
+ * Returns:	Nothing.
+ * Assumptions:	Called before the canvas handles the event, so that
+ *		the item under the mouse is the one it will act on.
+ * Bugs:	None known.
+ * Notes:	Moves with no button down do nothing on the canvas, so
+ *		they are not recorded.
+ */
+
+void
+SessionRecorder::mouseEvent(CanvasView * view, QMouseEvent * event)
+{
+    if (!isRecording())
+	return;
+
+    QPointF scenePos = view->mapToScene(event->pos());
+    QString modifiers = QString::number(int(event->modifiers()));
+    switch (event->type())
+    {
+      case QEvent::MouseButtonPress:
+      case QEvent::MouseButtonDblClick:
+      {
+	QGraphicsItem * item = nullptr;
+	foreach (QGraphicsItem * i, view->items(event->pos()))
+	{
+	    if (!target(i).isEmpty())
+	    {
+		item = i;
+		break;
+	    }
+	}
+	QPointF offset = item != nullptr ? scenePos - anchor(item) : scenePos;
+	pressPos = scenePos;
+	write(QString("%1 %2 %3 %4 %5 %6")
+	      .arg(event->type() == QEvent::MouseButtonPress
+		   ? "press" : "double")
+	      .arg(int(event->button())).arg(modifiers)
+	      .arg(item != nullptr ? target(item) : QString("-"))
+	      .arg(offset.x(), 0, 'f', 2).arg(offset.y(), 0, 'f', 2));
+	break;
+      }
+
+      case QEvent::MouseMove:
+	if (event->buttons() == Qt::NoButton)
+	    break;
+	write(QString("move %1 %2 %3 %4")
+	      .arg(int(event->buttons())).arg(modifiers)
+	      .arg(scenePos.x() - pressPos.x(), 0, 'f', 2)
+	      .arg(scenePos.y() - pressPos.y(), 0, 'f', 2));
+	break;
+
+      case QEvent::MouseButtonRelease:
+	write(QString("release %1 %2 %3 %4")
+	      .arg(int(event->button())).arg(modifiers)
+	      .arg(scenePos.x() - pressPos.x(), 0, 'f', 2)
+	      .arg(scenePos.y() - pressPos.y(), 0, 'f', 2));
+	break;
+
+      default:
+	break;
+    }
+}
+
+
+
+/*
+ * Name:	keyEvent()
+ * Purpose:	Record a key press or release on the canvas.
+ * Arguments:	The event.
+ * Outputs:	A "keypress" or "keyrelease" line.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	The text is left off if there is none.
+ */
+
+void
+SessionRecorder::keyEvent(QKeyEvent * event)
+{
+    if (!isRecording())
+	return;
+
+    write(QString("%1 %2 %3 %4")
+	  .arg(event->type() == QEvent::KeyPress ? "keypress" : "keyrelease")
+	  .arg(event->key()).arg(int(event->modifiers()))
+	  .arg(encode(event->text())).trimmed());
+}
+
+
+
+/*
+ * Name:	graphAdded()
+ * Purpose:	Record a graph being dropped on the canvas.
+ * Arguments:	The graph, already in the scene where it was dropped.
+ * Outputs:	A "graph" record.
+ * Modifies:	ids, nodes.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+void
+SessionRecorder::graphAdded(Graph * graph)
+{
+    if (isRecording())
+	writeGraph(graph);
+}
+
+
+
+/*
+ * Name:	styleChanged()
+ * Purpose:	Record the new value of a property of some items, after
+ *		an edit tab changed it.
+ * Arguments:	The items, and the property: "diameter", "pen", "fill",
+ *		"outline", "colour", "labelSize", "label" or "place".
+ * Outputs:	A "style" line.
+ * Modifies:	ids, nodes (if a node is named).
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	The values, not the edits, are recorded, so (e.g.) a
+ *		change of a graph's width is recorded as the new
+ *		"place" of each of its nodes.  Items which don't have
+ *		the property are skipped.
+ */
+
+void
+SessionRecorder::styleChanged(QList<QGraphicsItem *> items, QString property)
+{
+    if (!isRecording())
+	return;
+
+    QString line = "style " + property;
+    int count = 0;
+    foreach (QGraphicsItem * item, items)
+    {
+	QString value = valueOf(item, property);
+	if (value.isNull())
+	    continue;
+	line += " " + target(item) + "=" + value;
+	count++;
+    }
+    if (count > 0)
+	write(line);
+}
+
+
+
+/*
+ * Name:	saved()
+ * Purpose:	Record the canvas being saved.
+ * Arguments:	The format (file name extension) it was saved in.
+ * Outputs:	A "save" line, and everything so far, to the file.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+void
+SessionRecorder::saved(QString format)
+{
+    if (!isRecording())
+	return;
+
+    write("save " + format);
+    out->flush();
+}
+
+
+
+/*
+ * Name:	anchor()
+ * Purpose:	Find the point which mouse positions on an item are
+ *		relative to.
+ * Arguments:	A node, an edge or a label.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The point, in scene coordinates.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Used by the replayer too, so both agree.
+ */
+
+QPointF
+SessionRecorder::anchor(QGraphicsItem * item)
+{
+    if (item->type() == Node::Type)
+	return item->scenePos();
+    if (item->type() == Edge::Type)
+    {
+	Edge * edge = qgraphicsitem_cast<Edge *>(item);
+	return edge->mapToScene(edge->getLine().center());
+    }
+    return item->sceneBoundingRect().center();
+}
+
+
+
+/*
+ * Name:	encode(), decode()
+ * Purpose:	Percent-encode a string, or decode one.
+ * Arguments:	The string.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The encoded or decoded string.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	An encoded string has no spaces or '=' characters.
+ */
+
+QString
+SessionRecorder::encode(QString text)
+{
+    return QString::fromLatin1(text.toUtf8().toPercentEncoding());
+}
+
+
+
+QString
+SessionRecorder::decode(QString text)
+{
+    return QString::fromUtf8(QByteArray::fromPercentEncoding(text.toLatin1()));
+}
+
+
+
+/*
+ * Name:	write()
+ * Purpose:	Write one line of the session, with the time.
+ * Arguments:	The line, without the time.
+ * Outputs:	The line.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	A session is being recorded.
+ * Bugs:	None known.
+ * Notes:	The stream is only flushed by saved() and stop(), so
+ *		the file lags a little behind the canvas.
+ */
+
+void
+SessionRecorder::write(QString line)
+{
+    *out << clock.elapsed() << " " << line << "\n";
+}
+
+
+
+/*
+ * Name:	writeGraph()
+ * Purpose:	Write a "graph" record and number its nodes.
+ * Arguments:	The graph.
+ * Outputs:	The record.
+ * Modifies:	ids, nodes, and the nodes' IDs.
+ * Returns:	Nothing.
+ * Assumptions:	A session is being recorded.
+ * Bugs:	None known.
+ * Notes:	saveGraphIc() moves the graph to be centred on (0, 0),
+ *		so the scene position of the first node is given too;
+ *		the replayer moves the graph back to put it there.
+ *		Graphs with no nodes (e.g., the freestyle graph before
+ *		anything is drawn) are skipped.
+ */
+
+void
+SessionRecorder::writeGraph(Graph * graph)
+{
+    QVector<Node *> graphNodes;
+    QList<QGraphicsItem *> items = graph->childItems();
+    for (int i = 0; i < items.count(); i++)
+    {
+	QGraphicsItem * item = items.at(i);
+	if (item->type() == Node::Type)
+	    graphNodes.append(qgraphicsitem_cast<Node *>(item));
+	else if (item->type() == Graph::Type)
+	    items.append(item->childItems());
+    }
+    if (graphNodes.isEmpty())
+	return;
+
+    for (int i = 0; i < graphNodes.count(); i++)
+    {
+	Node * node = graphNodes.at(i);
+	node->setID(i);			// saveGraphIc() needs these.
+	ids.insert(node, nodes.count());
+	nodes.append(node);
+    }
+
+    QString text;
+    QTextStream stream(&text);
+    File_IO::saveGraphIc(stream, graphNodes, false);
+    stream.flush();
+    if (!text.endsWith("\n"))
+	text += "\n";
+
+    QPointF first = graphNodes.at(0)->scenePos();
+    write(QString("graph %1 %2 %3").arg(text.count("\n"))
+	  .arg(first.x(), 0, 'f', 2).arg(first.y(), 0, 'f', 2));
+    *out << text;
+}
+
+
+
+/*
+ * Name:	target()
+ * Purpose:	Name an item for the session file.
+ * Arguments:	The item.
+ * Outputs:	A "name" line, if a node is named for the first time.
+ * Modifies:	ids, nodes.
+ * Returns:	"n<id>", "e<id>-<id>", or "l" and one of those, or an
+ *		empty string if the item isn't a node, an edge or one
+ *		of their labels.
+ * Assumptions:	A session is being recorded.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+QString
+SessionRecorder::target(QGraphicsItem * item)
+{
+    switch (item->type())
+    {
+      case Node::Type:
+	return "n" + QString::number(idOf(qgraphicsitem_cast<Node *>(item)));
+
+      case Edge::Type:
+      {
+	Edge * edge = qgraphicsitem_cast<Edge *>(item);
+	return QString("e%1-%2").arg(idOf(edge->sourceNode()))
+	    .arg(idOf(edge->destNode()));
+      }
+
+      case HTML_Label::Type:
+	if (item->parentItem() != nullptr
+	    && (item->parentItem()->type() == Node::Type
+		|| item->parentItem()->type() == Edge::Type))
+	    return "l" + target(item->parentItem());
+	return QString();
+
+      default:
+	return QString();
+    }
+}
+
+
+
+/*
+ * Name:	idOf()
+ * Purpose:	Find a node's number, giving it one if it has none.
+ * Arguments:	The node.
+ * Outputs:	A "name" line, if the node is given a number.
+ * Modifies:	ids, nodes.
+ * Returns:	The number.
+ * Assumptions:	A session is being recorded.
+ * Bugs:	None known.
+ * Notes:	A node which was deleted may have left its address to
+ *		a new node, so the number is only trusted if it still
+ *		refers to the same (live) node.
+ */
+
+int
+SessionRecorder::idOf(Node * node)
+{
+    int id = ids.value(node, -1);
+    if (id >= 0 && nodes.at(id) == node)
+	return id;
+
+    id = nodes.count();
+    ids.insert(node, id);
+    nodes.append(node);
+    QPointF pos = node->scenePos();
+    write(QString("name %1 %2 %3").arg(id)
+	  .arg(pos.x(), 0, 'f', 2).arg(pos.y(), 0, 'f', 2));
+    return id;
+}
+
+
+
+/*
+ * Name:	valueOf()
+ * Purpose:	Format an item's value of a property.
+ * Arguments:	The item and the property (see styleChanged()).
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The value, or a null string if the item doesn't have
+ *		the property.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+QString
+SessionRecorder::valueOf(QGraphicsItem * item, QString property)
+{
+    if (item->type() == Node::Type)
+    {
+	Node * node = qgraphicsitem_cast<Node *>(item);
+	if (property == "diameter")
+	    return QString::number(node->getDiameter());
+	if (property == "pen")
+	    return QString::number(node->getPenWidth());
+	if (property == "fill")
+	    return node->getFillColour().name(QColor::HexArgb);
+	if (property == "outline")
+	    return node->getLineColour().name(QColor::HexArgb);
+	if (property == "labelSize")
+	    return QString::number(node->getLabelSize());
+	if (property == "label")
+	    return encode(node->getLabel());
+	if (property == "place")
+	    return QString("%1,%2").arg(node->scenePos().x(), 0, 'f', 2)
+		.arg(node->scenePos().y(), 0, 'f', 2);
+    }
+    else if (item->type() == Edge::Type)
+    {
+	Edge * edge = qgraphicsitem_cast<Edge *>(item);
+	if (property == "pen")
+	    return QString::number(edge->getPenWidth());
+	if (property == "colour")
+	    return edge->getColour().name(QColor::HexArgb);
+	if (property == "labelSize")
+	    return QString::number(edge->getLabelSize());
+	if (property == "label")
+	    return encode(edge->getLabel());
+    }
+    return QString();
+}
@@ -0,0 +1,120 @@
+/*
+ * File:	sessionrecorder.h
+ * Author:	Jim Diamond
+ * Date:	2026-10-19
+ * Version:	1.0
+ *
+ * Purpose:	Define the SessionRecorder class, which logs what the
+ *		user does on the canvas (File > Record Session...) so
+ *		that a slow editing session can be replayed and timed
+ *		later, with no window (see sessionreplayer.h).
+ *
+ * Notes:	A session file starts with SESSION_FILE_HEADER and the
+ *		canvas as it was when recording started, then has one
+ *		line per operation, each starting with the time (ms)
+ *		since recording started:
+ *		    graph <n>	    followed by n lines of a graph-ic
+ *				    file: a graph on the canvas at the
+ *				    start, or dropped on it later
+ *		    mode <name>	    the canvas mode was changed
+ *		    nodeparams ..., edgeparams ...
+ *				    the style for freestyle nodes and
+ *				    edges was changed
+ *		    press <button> <modifiers> <target> <dx> <dy>
+ *		    double <button> <modifiers> <target> <dx> <dy>
+ *		    move <buttons> <modifiers> <dx> <dy>
+ *		    release <button> <modifiers> <dx> <dy>
+ *				    mouse events on the canvas
+ *		    keypress <key> <modifiers> <text>
+ *		    keyrelease <key> <modifiers> <text>
+ *		    style <property> <target>=<value> ...
+ *				    the edit tabs changed some items
+ *		    save <format>   the canvas was saved
+ *		    name <id> <x> <y>
+ *				    a node which wasn't in the file
+ *				    (e.g., a freestyle node) is first
+ *				    referred to; it is at (x, y)
+ *		Nodes are referred to by number: the nodes of each
+ *		"graph" are numbered in the order they are in it,
+ *		following on from the previous graphs, and other nodes
+ *		are given the next number by a "name" line.  Targets
+ *		are "n<id>" for a node, "e<id>-<id>" for the edge
+ *		between two nodes, "l" followed by one of those for its
+ *		label, or "-" for none.
+ *		Mouse positions are scene offsets from the target
+ *		(from a node's centre, an edge's midpoint or the centre
+ *		of a label), or scene positions if there is no target;
+ *		moves and releases are offsets from the press.  So a
+ *		press is replayed on the same item even if it has been
+ *		moved since, or the replay's view is zoomed or
+ *		scrolled differently.
+ *		Strings (labels, key text) are percent-encoded so that
+ *		they have no spaces.
+ *		When no session is being recorded, each hook costs one
+ *		test of isRecording().
+ *
+ * Modification history:
+ * Oct 19, 2026 (JD V1.0)
+ *  (a) Initial version.
+ */
+
+#ifndef SESSIONRECORDER_H
+#define SESSIONRECORDER_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QPointF>
+#include <QPointer>
+#include <QString>
+#include <QVector>
+
+class CanvasView;
+class Graph;
+class Node;
+class QFile;
+class QGraphicsItem;
+class QKeyEvent;
+class QMouseEvent;
+class QTextStream;
+
+#define SESSION_FILE_HEADER	"# Graphic session, version 1"
+#define SESSION_SAVE_FILE	"Graphic session (*.session)"
+
+class SessionRecorder
+{
+  public:
+    static bool start(QString fileName, CanvasView * view,
+		      QString * errorMessage);
+    static void stop();
+    static bool isRecording() { return out != nullptr; }
+
+    static void modeChanged(int mode);
+    static void nodeParamsChanged(CanvasView * view);
+    static void edgeParamsChanged(CanvasView * view);
+    static void mouseEvent(CanvasView * view, QMouseEvent * event);
+    static void keyEvent(QKeyEvent * event);
+    static void graphAdded(Graph * graph);
+    static void styleChanged(QList<QGraphicsItem *> items, QString property);
+    static void saved(QString format);
+
+    static QPointF anchor(QGraphicsItem * item);
+    static QString encode(QString text);
+    static QString decode(QString text);
+
+  private:
+    static void write(QString line);
+    static void writeGraph(Graph * graph);
+    static QString target(QGraphicsItem * item);
+    static int idOf(Node * node);
+    static QString valueOf(QGraphicsItem * item, QString property);
+
+    static QFile * file;
+    static QTextStream * out;
+    static QElapsedTimer clock;
+    static QHash<Node *, int> ids;
+    static QVector<QPointer<Node>> nodes;	// Indexed by ID.
+    static QPointF pressPos;			// Scene position.
+};
+
+#endif // SESSIONRECORDER_H
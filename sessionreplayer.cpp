@@ -0,0 +1,890 @@
+/*
+ * File:	sessionreplayer.cpp
+ * Author:	Jim Diamond
+ * Date:	2026-10-19
+ * Version:	1.2
+ *
+ * Purpose:	Implement the SessionReplayer class.
+ *
+ * Modification history:
+ * Oct 19, 2026 (JD V1.0)
+ *  (a) Initial version.
+ * Oct 19, 2026 (JD V1.1)
+ *  (a) save() no longer clears the view filter (see viewfilter.h).
+ * Oct 19, 2026 (JD V1.2)
+ *  (a) save() reveals the meta-nodes while it writes, as
+ *	File_IO::saveGraph() does, rather than expanding them, so the
+ *	rest of the session is replayed on the canvas it was recorded
+ *	on.
+ */
+
+#include "sessionreplayer.h"
+#include "canvasscene.h"
+#include "canvasview.h"
+#include "defuns.h"
+#include "edge.h"
+#include "file-io.h"
+#include "graph.h"
+#include "html-label.h"
+#include "labelbatch.h"
+#include "metanode.h"
+#include "node.h"
+#include "scriptengine.h"
+#include "sessionrecorder.h"
+
+#include <QApplication>
+#include <QBuffer>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QKeyEvent>
+#include <QMouseEvent>
+#include <QTextStream>
+#include <QTimer>
+
+#include <algorithm>
+
+
+
+/*
+ * Name:	runHeadless()
+ * Purpose:	Replay a session with no main window.
+ * Arguments:	The session's file name, and the name of the file to
+ *		write every operation's time to (or an empty string).
+ * Outputs:	The report, on stdout, and error messages, on stderr.
+ * Modifies:	The timings file.
+ * Returns:	The program's exit status: 0 if every operation was
+ *		replayed, otherwise 1.
+ * Assumptions:	A QApplication exists.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+int
+SessionReplayer::runHeadless(QString fileName, QString timingsFileName)
+{
+    ScriptEngine::setHeadlessResolution();
+
+    QFile timingsFile(timingsFileName);
+    QTextStream timingsOut(&timingsFile);
+    if (!timingsFileName.isEmpty())
+    {
+	if (!timingsFile.open(QIODevice::WriteOnly | QIODevice::Truncate
+			      | QIODevice::Text))
+	{
+	    QTextStream(stderr) << "Can't write " << timingsFileName << ": "
+				<< timingsFile.errorString() << endl;
+	    return 1;
+	}
+	timingsOut << "line\tkind\tms\n";
+    }
+
+    SessionReplayer replayer;
+    QString errorMessage;
+    bool ok = replayer.run(fileName,
+			   timingsFileName.isEmpty() ? nullptr : &timingsOut,
+			   &errorMessage);
+    if (!ok)
+	QTextStream(stderr) << errorMessage << endl;
+    return ok ? 0 : 1;
+}
+
+
+
+/*
+ * Name:	SessionReplayer()
+ * Purpose:	Set up an offscreen canvas to replay a session on.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	A QApplication exists.
+ * Bugs:	None known.
+ * Notes:	A scene ignores mouse and key events until its window
+ *		is activated, which an offscreen window may never be,
+ *		so the scene is told that it is active.
+ */
+
+SessionReplayer::SessionReplayer()
+{
+    view = new CanvasView();
+    view->resize(REPLAY_VIEW_WIDTH, REPLAY_VIEW_HEIGHT);
+    view->show();
+    QCoreApplication::processEvents();
+
+    QEvent activate(QEvent::WindowActivate);
+    QApplication::sendEvent(view->scene(), &activate);
+    buttons = Qt::NoButton;
+}
+
+
+
+SessionReplayer::~SessionReplayer()
+{
+    // The canvas is about to go, so don't leave its items in the lists.
+    canvasGraphList.clear();
+    selectedList.clear();
+    delete view;
+}
+
+
+
+/*
+ * Name:	run()
+ * Purpose:	Replay a session file and report on it.
+ * Arguments:	The file name, the stream to write every operation's
+ *		time to (or nullptr), and where to put an error
+ *		message.
+ * Outputs:	The report, on stdout, and a warning for each operation
+ *		which can't be replayed, on stderr.
+ * Modifies:	The canvas, timings, operations, and *errorMessage.
+ * Returns:	True iff every operation was replayed.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	A file which isn't a session file, or a line with no
+ *		time, stops the replay; an operation which can't be
+ *		replayed is skipped.
+ */
+
+bool
+SessionReplayer::run(QString fileName, QTextStream * timingsOut,
+		     QString * errorMessage)
+{
+    static const QStringList inputOperations = {
+	"press", "double", "move", "release", "keypress", "keyrelease"
+    };
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+	*errorMessage = "Can't read " + fileName + ": " + file.errorString();
+	return false;
+    }
+    QTextStream in(&file);
+    int lineNum = 1;
+    if (in.readLine() != SESSION_FILE_HEADER)
+    {
+	*errorMessage = fileName + " is not a Graphic session file";
+	return false;
+    }
+
+    QElapsedTimer elapsed;
+    QElapsedTimer timer;
+    qint64 previous = 0;
+    int failures = 0;
+    elapsed.start();
+    while (!in.atEnd())
+    {
+	QString line = in.readLine();
+	lineNum++;
+	if (line.isEmpty() || line.startsWith("#"))
+	    continue;
+
+	QStringList fields = line.split(" ", QString::SkipEmptyParts);
+	bool isTime = false;
+	qint64 when = fields.isEmpty() ? 0 : fields.at(0).toLongLong(&isTime);
+	if (fields.count() < 2 || !isTime)
+	{
+	    *errorMessage = QString("%1, line %2: no time in \"%3\"")
+		.arg(fileName).arg(lineNum).arg(line);
+	    return false;
+	}
+	pause(qBound((qint64)0, when - previous, (qint64)REPLAY_MAX_PAUSE));
+	previous = when;
+	fields.removeFirst();
+
+	// What a click or a key does depends on the mode.
+	QString kind = fields.at(0);
+	if (inputOperations.contains(kind))
+	    kind += " (" + CanvasView::getModeName(view->getMode()) + ")";
+
+	int opLineNum = lineNum;
+	QString warning;
+	timer.start();
+	bool ok = perform(fields, in, &lineNum, &warning);
+	QCoreApplication::processEvents();
+	qint64 time = timer.nsecsElapsed();
+	if (!ok)
+	{
+	    QTextStream(stderr) << fileName << ", line " << opLineNum << ": "
+				<< warning << endl;
+	    failures++;
+	    continue;
+	}
+
+	Timing & timing = timings[kind];
+	timing.count++;
+	timing.total += time;
+	timing.max = qMax(timing.max, time);
+
+	Operation operation;
+	operation.lineNum = opLineNum;
+	operation.kind = kind;
+	operation.time = time;
+	operations.append(operation);
+	if (timingsOut != nullptr)
+	    *timingsOut << opLineNum << "\t" << kind << "\t"
+			<< QString::number(time / 1e6, 'f', 3) << "\n";
+    }
+
+    report(fileName, elapsed.elapsed());
+    if (failures > 0)
+    {
+	*errorMessage = QString("%1 operation(s) could not be replayed")
+	    .arg(failures);
+	return false;
+    }
+    return true;
+}
+
+
+
+/*
+ * Name:	perform()
+ * Purpose:	Replay one operation.
+ * Arguments:	The operation's fields (without the time), the session
+ *		file (for "graph" records), the current line number,
+ *		and where to put a warning.
+ * Outputs:	Nothing.
+ * Modifies:	The canvas, *lineNum (for "graph" records), or
+ *		*warning.
+ * Returns:	True iff the operation was replayed.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+bool
+SessionReplayer::perform(QStringList fields, QTextStream & in, int * lineNum,
+			 QString * warning)
+{
+    QString op = fields.at(0);
+
+    if (op == "graph")
+	return addGraph(fields, in, lineNum, warning);
+    if (op == "mode" && fields.count() == 2)
+	return setMode(fields.at(1), warning);
+    if (op == "nodeparams")
+	return setNodeParams(fields, warning);
+    if (op == "edgeparams")
+	return setEdgeParams(fields, warning);
+    if (op == "press" || op == "double" || op == "move" || op == "release")
+	return sendMouse(fields, warning);
+    if (op == "keypress" || op == "keyrelease")
+	return sendKey(fields, warning);
+    if (op == "style")
+	return setStyle(fields, warning);
+    if (op == "save" && fields.count() == 2)
+	return save(fields.at(1), warning);
+    if (op == "name")
+	return name(fields, warning);
+
+    *warning = "unknown operation \"" + fields.join(" ") + "\"";
+    return false;
+}
+
+
+
+/*
+ * Name:	addGraph()
+ * Purpose:	Put a graph from a "graph" record on the canvas.
+ * Arguments:	The fields of the "graph" line, the session file, the
+ *		current line number, and where to put a warning.
+ * Outputs:	Nothing.
+ * Modifies:	The canvas, nodes, ids, *lineNum, or *warning.
+ * Returns:	True iff the graph could be read.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	The graph is moved so that its first node is where it
+ *		was when it was recorded.  Its nodes get the next
+ *		numbers, in the order they are in the record, as the
+ *		recorder gave them.
+ */
+
+bool
+SessionReplayer::addGraph(QStringList fields, QTextStream & in, int * lineNum,
+			  QString * warning)
+{
+    bool ok = fields.count() == 4;
+    int count = ok ? fields.at(1).toInt(&ok) : 0;
+    if (!ok || count <= 0)
+    {
+	*warning = "bad graph record \"" + fields.join(" ") + "\"";
+	return false;
+    }
+    QPointF first(fields.at(2).toDouble(), fields.at(3).toDouble());
+
+    int firstLineNum = *lineNum + 1;
+    QString text;
+    for (int i = 0; i < count && !in.atEnd(); i++)
+	text += in.readLine() + "\n";
+    *lineNum += count;
+
+    // See File_IO::inputCustomGraph().
+    QTextStream graphIn(&text);
+    QStringList toks = graphIn.readLine().simplified().split(" ");
+    if (toks.count() < 3 || toks.at(1) != "Version")
+    {
+	*warning = "the graph is not a versioned graph-ic file";
+	return false;
+    }
+    qreal width, height;
+    Graph * graph = File_IO::readGraphIc(
+	graphIn, "session line " + QString::number(firstLineNum), 1,
+	&width, &height, warning);
+    if (graph == nullptr)
+	return false;
+
+    view->scene()->addItem(graph);
+    canvasGraphList.append(graph);
+
+    QVector<Node *> graphNodes;
+    foreach (QGraphicsItem * item, graph->childItems())
+	if (item->type() == Node::Type)
+	    graphNodes.append(qgraphicsitem_cast<Node *>(item));
+    std::sort(graphNodes.begin(), graphNodes.end(),
+	      [](Node * a, Node * b) { return a->getID() < b->getID(); });
+    if (!graphNodes.isEmpty())
+	graph->setPos(graph->pos() + first - graphNodes.at(0)->scenePos());
+    graph->isMoved();
+
+    foreach (Node * node, graphNodes)
+    {
+	ids.insert(node, nodes.count());
+	nodes.append(node);
+    }
+    return true;
+}
+
+
+
+/*
+ * Name:	setMode()
+ * Purpose:	Change the canvas mode.
+ * Arguments:	The name of the mode (see CanvasView::getModeName()),
+ *		and where to put a warning.
+ * Outputs:	Nothing.
+ * Modifies:	The canvas mode, or *warning.
+ * Returns:	True iff the mode is known.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+bool
+SessionReplayer::setMode(QString name, QString * warning)
+{
+    for (int m = CanvasView::drag; m <= CanvasView::select; m++)
+    {
+	if (CanvasView::getModeName(m) == name)
+	{
+	    view->setMode(m);
+	    return true;
+	}
+    }
+    *warning = "unknown mode \"" + name + "\"";
+    return false;
+}
+
+
+
+/*
+ * Name:	setNodeParams(), setEdgeParams()
+ * Purpose:	Set the style of new freestyle nodes or edges.
+ * Arguments:	The fields of a "nodeparams" or "edgeparams" line (see
+ *		SessionRecorder::nodeParamsChanged()), and where to put
+ *		a warning.
+ * Outputs:	Nothing.
+ * Modifies:	The canvas's parameters, or *warning.
+ * Returns:	True iff the line has the right number of fields.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	An empty label is left off the line.
+ */
+
+bool
+SessionReplayer::setNodeParams(QStringList fields, QString * warning)
+{
+    if (fields.count() < 7 || fields.count() > 8)
+    {
+	*warning = "bad nodeparams line";
+	return false;
+    }
+    view->setUpNodeParams(fields.at(1).toDouble(), fields.at(2) == "1",
+			  SessionRecorder::decode(fields.value(7)),
+			  fields.at(3).toDouble(), QColor(fields.at(4)),
+			  QColor(fields.at(5)), fields.at(6).toDouble());
+    return true;
+}
+
+
+
+bool
+SessionReplayer::setEdgeParams(QStringList fields, QString * warning)
+{
+    if (fields.count() < 5 || fields.count() > 6)
+    {
+	*warning = "bad edgeparams line";
+	return false;
+    }
+    view->setUpEdgeParams(fields.at(1).toDouble(),
+			  SessionRecorder::decode(fields.value(5)),
+			  fields.at(2).toDouble(), QColor(fields.at(3)),
+			  fields.at(4) == "1");
+    return true;
+}
+
+
+
+/*
+ * Name:	sendMouse()
+ * Purpose:	Send a recorded mouse event to the canvas.
+ * Arguments:	The fields of a "press", "double", "move" or "release"
+ *		line, and where to put a warning.
+ * Outputs:	Nothing.
+ * Modifies:	pressPos, buttons, whatever the event does, or
+ *		*warning.
+ * Returns:	True iff the event could be sent.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	If a press is outside the view, the view is scrolled
+ *		to it first, as the user must have done.
+ */
+
+bool
+SessionReplayer::sendMouse(QStringList fields, QString * warning)
+{
+    QString op = fields.at(0);
+    bool isPress = op == "press" || op == "double";
+    if (fields.count() != (isPress ? 6 : 5))
+    {
+	*warning = "bad " + op + " line";
+	return false;
+    }
+
+    int button = fields.at(1).toInt();
+    Qt::KeyboardModifiers modifiers(fields.at(2).toInt());
+    QPointF offset(fields.at(isPress ? 4 : 3).toDouble(),
+		   fields.at(isPress ? 5 : 4).toDouble());
+    QEvent::Type type;
+    QPointF scenePos;
+
+    if (isPress)
+    {
+	QPointF anchor;
+	if (fields.at(3) != "-")
+	{
+	    QGraphicsItem * item = resolve(fields.at(3));
+	    if (item == nullptr)
+	    {
+		*warning = "can't find " + fields.at(3);
+		return false;
+	    }
+	    anchor = SessionRecorder::anchor(item);
+	}
+	scenePos = anchor + offset;
+	pressPos = scenePos;
+	if (!view->viewport()->rect().contains(view->mapFromScene(scenePos)))
+	    view->centerOn(scenePos);
+	type = op == "press" ? QEvent::MouseButtonPress
+	    : QEvent::MouseButtonDblClick;
+	buttons |= button;
+    }
+    else
+    {
+	scenePos = pressPos + offset;
+	if (op == "move")
+	{
+	    type = QEvent::MouseMove;
+	    buttons = button;
+	    button = Qt::NoButton;
+	}
+	else
+	{
+	    type = QEvent::MouseButtonRelease;
+	    buttons &= ~button;
+	}
+    }
+
+    QPoint pos = view->mapFromScene(scenePos);
+    QMouseEvent event(type, pos, view->viewport()->mapToGlobal(pos),
+		      Qt::MouseButton(button), Qt::MouseButtons(buttons),
+		      modifiers);
+    QApplication::sendEvent(view->viewport(), &event);
+    return true;
+}
+
+
+
+/*
+ * Name:	sendKey()
+ * Purpose:	Send a recorded key event to the canvas.
+ * Arguments:	The fields of a "keypress" or "keyrelease" line, and
+ *		where to put a warning.
+ * Outputs:	Nothing.
+ * Modifies:	Whatever the event does, or *warning.
+ * Returns:	True iff the line has the right number of fields.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+bool
+SessionReplayer::sendKey(QStringList fields, QString * warning)
+{
+    if (fields.count() < 3 || fields.count() > 4)
+    {
+	*warning = "bad " + fields.at(0) + " line";
+	return false;
+    }
+
+    QKeyEvent event(fields.at(0) == "keypress"
+		    ? QEvent::KeyPress : QEvent::KeyRelease,
+		    fields.at(1).toInt(),
+		    Qt::KeyboardModifiers(fields.at(2).toInt()),
+		    SessionRecorder::decode(fields.value(3)));
+    QApplication::sendEvent(view, &event);
+    return true;
+}
+
+
+
+/*
+ * Name:	setStyle()
+ * Purpose:	Give some items the values recorded by a "style" line.
+ * Arguments:	The fields of the line, and where to put a warning.
+ * Outputs:	Nothing.
+ * Modifies:	The items, or *warning.
+ * Returns:	True iff every item was found and has the property.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Labels and places are set all at once, as the edit
+ *		tabs do (via LabelBatch and setNodePositions()).
+ */
+
+bool
+SessionReplayer::setStyle(QStringList fields, QString * warning)
+{
+    if (fields.count() < 3)
+    {
+	*warning = "bad style line";
+	return false;
+    }
+
+    QString property = fields.at(1);
+    LabelBatch labels;
+    QList<Node *> placed;
+    QList<QPointF> places;
+    for (int i = 2; i < fields.count(); i++)
+    {
+	int equals = fields.at(i).indexOf('=');
+	QString target = fields.at(i).left(equals);
+	QString value = fields.at(i).mid(equals + 1);
+	QGraphicsItem * item = equals > 0 ? resolve(target) : nullptr;
+	if (item == nullptr)
+	{
+	    *warning = "can't find " + target;
+	    return false;
+	}
+
+	Node * node = qgraphicsitem_cast<Node *>(item);
+	Edge * edge = qgraphicsitem_cast<Edge *>(item);
+	if (node != nullptr && property == "diameter")
+	    node->setDiameter(value.toDouble());
+	else if (node != nullptr && property == "pen")
+	    node->setPenWidth(value.toDouble());
+	else if (node != nullptr && property == "fill")
+	    node->setFillColour(QColor(value));
+	else if (node != nullptr && property == "outline")
+	    node->setLineColour(QColor(value));
+	else if (node != nullptr && property == "labelSize")
+	    node->setNodeLabelSize(value.toDouble());
+	else if (node != nullptr && property == "label")
+	    labels.add(node, SessionRecorder::decode(value));
+	else if (node != nullptr && property == "place")
+	{
+	    QPointF pos(value.section(',', 0, 0).toDouble(),
+			value.section(',', 1, 1).toDouble());
+	    placed.append(node);
+	    places.append(node->parentItem() != nullptr
+			  ? node->parentItem()->mapFromScene(pos) : pos);
+	}
+	else if (edge != nullptr && property == "pen")
+	    edge->setPenWidth(value.toDouble());
+	else if (edge != nullptr && property == "colour")
+	    edge->setColour(QColor(value));
+	else if (edge != nullptr && property == "labelSize")
+	    edge->setEdgeLabelSize(value.toDouble());
+	else if (edge != nullptr && property == "label")
+	    labels.add(edge, SessionRecorder::decode(value));
+	else
+	{
+	    *warning = "can't set the " + property + " of " + target;
+	    return false;
+	}
+    }
+
+    labels.apply();
+    if (!placed.isEmpty())
+	CanvasScene::setNodePositions(placed, places);
+    return true;
+}
+
+
+
+/*
+ * Name:	save()
+ * Purpose:	Save the canvas, as File_IO::saveGraph() would have.
+ * Arguments:	The format (see File_IO::writeGraph()), and where to
+ *		put a warning.
+ * Outputs:	Nothing; the output is thrown away.
+ * Modifies:	*warning, on failure.
+ * Returns:	True iff the canvas could be written in that format.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+bool
+SessionReplayer::save(QString format, QString * warning)
+{
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    MetaNode::revealAll();
+    bool success = File_IO::writeGraph(view->scene(), format, &buffer,
+				       warning);
+    MetaNode::concealAll();
+    return success;
+}
+
+
+
+/*
+ * Name:	name()
+ * Purpose:	Give a node the number given by a "name" line.
+ * Arguments:	The fields of the line, and where to put a warning.
+ * Outputs:	Nothing.
+ * Modifies:	nodes, ids, or *warning.
+ * Returns:	True iff there is a node to give it to.
+ * Assumptions:	None.
+ * Bugs:	If two unnumbered nodes are on top of each other, the
+ *		wrong one may be chosen.
+ * Notes:	The number goes to the unnumbered node nearest to the
+ *		recorded position (within an inch).
+ */
+
+bool
+SessionReplayer::name(QStringList fields, QString * warning)
+{
+    bool ok = fields.count() == 4;
+    int id = ok ? fields.at(1).toInt(&ok) : -1;
+    if (!ok || id < 0)
+    {
+	*warning = "bad name line";
+	return false;
+    }
+    QPointF pos(fields.at(2).toDouble(), fields.at(3).toDouble());
+
+    Node * nearest = nullptr;
+    qreal nearestDistance = 0;
+    QRectF area(pos - QPointF(SCENE_DPI, SCENE_DPI),
+		QSizeF(2 * SCENE_DPI, 2 * SCENE_DPI));
+    foreach (QGraphicsItem * item, view->scene()->items(area))
+    {
+	if (item->type() != Node::Type)
+	    continue;
+	Node * node = qgraphicsitem_cast<Node *>(item);
+	if (idOf(node) >= 0)
+	    continue;
+	QPointF d = node->scenePos() - pos;
+	qreal distance = d.x() * d.x() + d.y() * d.y();
+	if (nearest == nullptr || distance < nearestDistance)
+	{
+	    nearest = node;
+	    nearestDistance = distance;
+	}
+    }
+    if (nearest == nullptr)
+    {
+	*warning = QString("no node near (%1, %2) to be n%3")
+	    .arg(pos.x()).arg(pos.y()).arg(id);
+	return false;
+    }
+
+    if (id >= nodes.count())
+	nodes.resize(id + 1);
+    nodes[id] = nearest;
+    ids.insert(nearest, id);
+    return true;
+}
+
+
+
+/*
+ * Name:	resolve()
+ * Purpose:	Find the item a session file refers to.
+ * Arguments:	The target (see sessionrecorder.h).
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The node, edge or label, or nullptr if there is no
+ *		such item (any more).
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+QGraphicsItem *
+SessionReplayer::resolve(QString target)
+{
+    if (target.startsWith("l"))
+    {
+	QGraphicsItem * item = resolve(target.mid(1));
+	if (item == nullptr)
+	    return nullptr;
+	if (item->type() == Node::Type)
+	    return qgraphicsitem_cast<Node *>(item)->htmlLabel;
+	return qgraphicsitem_cast<Edge *>(item)->htmlLabel;
+    }
+
+    if (target.startsWith("n"))
+	return nodeOf(target.mid(1));
+
+    if (target.startsWith("e"))
+    {
+	QStringList ends = target.mid(1).split("-");
+	if (ends.count() != 2)
+	    return nullptr;
+	Node * source = nodeOf(ends.at(0));
+	Node * dest = nodeOf(ends.at(1));
+	if (source == nullptr || dest == nullptr)
+	    return nullptr;
+	foreach (Edge * edge, source->edgeList)
+	    if (edge->sourceNode() == source && edge->destNode() == dest)
+		return edge;
+    }
+    return nullptr;
+}
+
+
+
+/*
+ * Name:	nodeOf(), idOf()
+ * Purpose:	Find the node with a number, or the number of a node.
+ * Arguments:	The number (as a string), or the node.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The node (or nullptr), or the number (or -1).
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	A deleted node's number refers to nothing, as in
+ *		SessionRecorder::idOf().
+ */
+
+Node *
+SessionReplayer::nodeOf(QString id)
+{
+    bool ok;
+    int i = id.toInt(&ok);
+    if (!ok || i < 0 || i >= nodes.count())
+	return nullptr;
+    return nodes.at(i).data();
+}
+
+
+
+int
+SessionReplayer::idOf(Node * node) const
+{
+    int id = ids.value(node, -1);
+    if (id >= 0 && nodes.at(id) == node)
+	return id;
+    return -1;
+}
+
+
+
+/*
+ * Name:	pause()
+ * Purpose:	Let the event loop run for a while.
+ * Arguments:	How long, in ms.
+ * Outputs:	Nothing.
+ * Modifies:	Whatever pending events and timers do.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+void
+SessionReplayer::pause(qint64 ms)
+{
+    if (ms <= 0)
+    {
+	QCoreApplication::processEvents();
+	return;
+    }
+
+    QEventLoop loop;
+    QTimer::singleShot(ms, &loop, SLOT(quit()));
+    loop.exec();
+}
+
+
+
+/*
+ * Name:	report()
+ * Purpose:	Print how long the operations took.
+ * Arguments:	The session's file name, and how long the whole replay
+ *		took (ms).
+ * Outputs:	The report, on stdout.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	The kinds of operation are listed from the one which
+ *		took the most time in all to the one which took the
+ *		least.
+ */
+
+void
+SessionReplayer::report(QString fileName, qint64 elapsed)
+{
+    QTextStream out(stdout);
+
+    qint64 total = 0;
+    foreach (const Timing & timing, timings)
+	total += timing.total;
+    out << "Replayed " << fileName << ": " << operations.count()
+	<< " operations in " << elapsed << " ms ("
+	<< QString::number(total / 1e6, 'f', 1)
+	<< " ms in the operations themselves)\n\n";
+
+    QStringList kinds = timings.keys();
+    std::sort(kinds.begin(), kinds.end(), [this](QString a, QString b) {
+	return timings.value(a).total > timings.value(b).total;
+    });
+    out << QString("%1 %2 %3 %4 %5\n").arg("operation", -24)
+	.arg("count", 8).arg("total ms", 12).arg("mean ms", 10)
+	.arg("max ms", 10);
+    foreach (QString kind, kinds)
+    {
+	const Timing & timing = timings[kind];
+	out << QString("%1 %2 %3 %4 %5\n").arg(kind, -24)
+	    .arg(timing.count, 8).arg(timing.total / 1e6, 12, 'f', 2)
+	    .arg(timing.total / 1e6 / timing.count, 10, 'f', 3)
+	    .arg(timing.max / 1e6, 10, 'f', 2);
+    }
+
+    QVector<Operation> slowest = operations;
+    int count = qMin(slowest.count(), REPLAY_SLOWEST);
+    std::partial_sort(slowest.begin(), slowest.begin() + count, slowest.end(),
+		      [](const Operation & a, const Operation & b) {
+			  return a.time > b.time;
+		      });
+    if (count > 0)
+	out << "\nThe slowest operations:\n";
+    for (int i = 0; i < count; i++)
+	out << QString("  line %1: %2, %3 ms\n").arg(slowest.at(i).lineNum, 6)
+	    .arg(slowest.at(i).kind).arg(slowest.at(i).time / 1e6, 0, 'f', 2);
+    out.flush();
+}
@@ -0,0 +1,113 @@
+/*
+ * File:	sessionreplayer.h
+ * Author:	Jim Diamond
+ * Date:	2026-10-19
+ * Version:	1.0
+ *
+ * Purpose:	Define the SessionReplayer class, which replays a
+ *		session recorded by SessionRecorder (see
+ *		sessionrecorder.h) with no window ("Graphic --replay
+ *		file.session [timings.tsv]"), and reports how long
+ *		each operation took.
+ *
+ * Notes:	The operations are replayed on a real (offscreen)
+ *		canvas, as mouse and key events sent to the view, so
+ *		that they go through the same code as when they were
+ *		recorded: a "press" on "e3-7" is a press on wherever
+ *		that edge now is.  Each operation is timed from when
+ *		its event is sent until the events it caused
+ *		(including repainting the view) have been handled.
+ *		Between operations, the replayer lets the event loop
+ *		run for as long as the user paused, up to
+ *		REPLAY_MAX_PAUSE ms, so that timers (e.g., the one
+ *		which ends draft quality drawing) fire as they did;
+ *		that time is not counted.
+ *		The report (on stdout) gives the count, total, mean
+ *		and maximum time for each kind of operation (mouse and
+ *		key events are split up by the canvas mode), and the
+ *		slowest REPLAY_SLOWEST operations with their line
+ *		numbers.  If a timings file is given, every operation
+ *		is written to it too, one per line, as tab-separated
+ *		line number, kind and milliseconds.
+ *		Operations which can't be replayed (e.g., a press on a
+ *		node which no longer exists, because the session used
+ *		a menu command which isn't recorded) are reported on
+ *		stderr and skipped.
+ *
+ * Modification history:
+ * Oct 19, 2026 (JD V1.0)
+ *  (a) Initial version.
+ */
+
+#ifndef SESSIONREPLAYER_H
+#define SESSIONREPLAYER_H
+
+#include <QHash>
+#include <QPointF>
+#include <QPointer>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class CanvasView;
+class Node;
+class QGraphicsItem;
+class QTextStream;
+
+#define REPLAY_MAX_PAUSE	50	// ms
+#define REPLAY_SLOWEST		10	// operations
+#define REPLAY_VIEW_WIDTH	1280	// pixels
+#define REPLAY_VIEW_HEIGHT	1024	// pixels
+
+class SessionReplayer
+{
+  public:
+    static int runHeadless(QString fileName, QString timingsFileName);
+
+  private:
+    typedef struct
+    {
+	int count;
+	qint64 total;			// ns
+	qint64 max;			// ns
+    } Timing;
+
+    typedef struct
+    {
+	int lineNum;
+	QString kind;
+	qint64 time;			// ns
+    } Operation;
+
+    SessionReplayer();
+    ~SessionReplayer();
+    bool run(QString fileName, QTextStream * timingsOut,
+	     QString * errorMessage);
+    bool perform(QStringList fields, QTextStream & in, int * lineNum,
+		 QString * warning);
+    bool addGraph(QStringList fields, QTextStream & in, int * lineNum,
+		  QString * warning);
+    bool setMode(QString name, QString * warning);
+    bool setNodeParams(QStringList fields, QString * warning);
+    bool setEdgeParams(QStringList fields, QString * warning);
+    bool sendMouse(QStringList fields, QString * warning);
+    bool sendKey(QStringList fields, QString * warning);
+    bool setStyle(QStringList fields, QString * warning);
+    bool save(QString format, QString * warning);
+    bool name(QStringList fields, QString * warning);
+    QGraphicsItem * resolve(QString target);
+    Node * nodeOf(QString id);
+    int idOf(Node * node) const;
+    void pause(qint64 ms);
+    void report(QString fileName, qint64 elapsed);
+
+    CanvasView * view;
+    QVector<QPointer<Node>> nodes;	// Indexed by ID.
+    QHash<Node *, int> ids;
+    QPointF pressPos;			// Scene position.
+    int buttons;			// Mouse buttons down.
+    QHash<QString, Timing> timings;	// By kind of operation.
+    QVector<Operation> operations;
+};
+
+#endif // SESSIONREPLAYER_H
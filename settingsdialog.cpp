@@ -2,7 +2,7 @@
  * File:    settingsdialog.cpp
  * Author:  Ian Cathcart
  * Date:    2020/08/05
- * Version: 1.5
+ * Version: 1.9
  *
  * Purpose: Implements the settings dialog.
  *
@@ -34,9 +34,19 @@
  *  (c) Some code tidying; some new function comments.
  *  (d) Rename customSpinBox->customDpiSpinBox and customButton ->
  *	customDpiButton for clarity.
+ * Oct 19, 2026 (JD V1.6)
+ *  (a) Set the background colours through AppSettings so that the
+ *	cached copies stay in step with "settings".
+ * Oct 19, 2026 (JD V1.7)
+ *  (a) Load and save the new "Draw graphs in batches" setting.
+ * Oct 19, 2026 (JD V1.8)
+ *  (a) Load and save the draft quality settings.
+ * Oct 19, 2026 (JD V1.9)
+ *  (a) Load and save the edgeBundling setting.
  */
 
 #include "settingsdialog.h"
+#include "appsettings.h"
 #include "ui_settingsdialog.h"
 #include "defuns.h"
 #include "mainwindow.h"
@@ -103,6 +113,19 @@ SettingsDialog::loadSettings()
     if (settings.contains("gridCellSize"))
 	ui->gridCellSize->setValue(settings.value("gridCellSize").toInt());
 
+    ui->batchPaintingCheckBox
+	->setChecked(settings.value("batchPainting", false).toBool());
+    ui->edgeBundlingCheckBox
+	->setChecked(settings.value("edgeBundling", false).toBool());
+    ui->draftThresholdSpinBox
+	->setValue(settings.value("draftItemThreshold",
+				  DEFAULT_DRAFT_ITEM_THRESHOLD).toInt());
+    ui->draftDelaySpinBox
+	->setValue(settings.value("draftSettleDelay",
+				  DEFAULT_DRAFT_SETTLE_DELAY).toInt());
+    ui->draftHideLabelsCheckBox
+	->setChecked(settings.value("draftHideLabels", true).toBool());
+
     if (settings.contains("jpgBgColour"))
     {
 	qDeb() << "... settings contains jpgBgColour = "
@@ -126,6 +149,12 @@ SettingsDialog::saveSettings()
     settings.setValue("useDefaultResolution", ui->defaultDpiButton->isChecked());
     settings.setValue("customResolution", ui->customDpiSpinBox->value());
     settings.setValue("gridCellSize", ui->gridCellSize->value());
+    settings.setValue("batchPainting", ui->batchPaintingCheckBox->isChecked());
+    settings.setValue("edgeBundling", ui->edgeBundlingCheckBox->isChecked());
+    settings.setValue("draftItemThreshold", ui->draftThresholdSpinBox->value());
+    settings.setValue("draftSettleDelay", ui->draftDelaySpinBox->value());
+    settings.setValue("draftHideLabels",
+		      ui->draftHideLabelsCheckBox->isChecked());
 
     emit saveDone();
 }
@@ -161,7 +190,7 @@ SettingsDialog::on_jpgBgColour_clicked()
 	return;
 
     QString newStyle("background: " + newColour.name() + "; " BUTTON_STYLE);
-    settings.setValue("jpgBgColour", newColour.name());
+    AppSettings::instance()->setJpgBgColour(newColour);
     ui->jpgBgColour->setStyleSheet(newStyle);
 
     ui->jpgBgColour->update();
@@ -199,7 +228,7 @@ SettingsDialog::on_otherImageBgColour_clicked()
     if (!newColour.isValid())
 	return;
 
-    settings.setValue("otherImageBgColour", newColour.name(QColor::HexArgb));
+    AppSettings::instance()->setOtherImageBgColour(newColour);
 
     setOtherImageButtonStyle();
 }
@@ -2,7 +2,7 @@
  * File:    sizecontroller.cpp
  * Author:  Rachel Bood
  * Date:    2014/??/??
- * Version: 1.2
+ * Version: 1.3
  *
  * Purpose: ?
  *
@@ -18,10 +18,13 @@
  * Aug 24, 2020 (IC V1.2)
  *  (a) Added a few restraints to the size widgets including minimum value
  *      and alignment.
+ * Oct 19, 2026 (JD V1.3)
+ *  (a) Tell the session recorder about size changes.
  */
 
 
 #include "sizecontroller.h"
+#include "sessionrecorder.h"
 
 
 SizeController::SizeController(Edge * anEdge, QDoubleSpinBox * aBox)
@@ -74,19 +77,29 @@ SizeController::SizeController(Node * aNode, QDoubleSpinBox * diamBox,
 void SizeController::setEdgeSize(double value)
 {
     if (edge != nullptr || edge != 0)
-    edge->setPenWidth(value);
+    {
+        edge->setPenWidth(value);
+        SessionRecorder::styleChanged(QList<QGraphicsItem *>() << edge, "pen");
+    }
 }
 
 void SizeController::setNodeSize(double value)
 {
     if (node != nullptr || node != 0)
+    {
         node->setDiameter(value);
+        SessionRecorder::styleChanged(QList<QGraphicsItem *>() << node,
+                                      "diameter");
+    }
 }
 
 void SizeController::setNodeSize2(double value)
 {
     if (node != nullptr || node != 0)
+    {
         node->setPenWidth(value);
+        SessionRecorder::styleChanged(QList<QGraphicsItem *>() << node, "pen");
+    }
 }
 
 void SizeController::deletedEdgeBox()
@@ -0,0 +1,272 @@
+/*
+ * File:	styleclass.cpp
+ * Author:	Jim Diamond
+ * Date:	2026-10-19
+ * Version:	1.0
+ *
+ * Purpose:	Implement the StyleClass class (see styleclass.h).
+ *
+ * Modification history:
+ * Oct 19, 2026 (JD V1.0)
+ *  (a) Initial version.
+ */
+
+#include "styleclass.h"
+#include "edge.h"
+#include "node.h"
+
+QMap<QString, StyleClass *> StyleClass::classes;
+
+
+
+/*
+ * Name:	StyleClass()
+ * Purpose:	Constructor.
+ * Arguments:	The (sanitised) name and the values.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	Nothing.
+ * Assumptions:	Only called by define().
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+StyleClass::StyleClass(QString name, Values values)
+{
+    className = name;
+    classValues = values;
+}
+
+
+
+/*
+ * Name:	define()
+ * Purpose:	Create a style class, or change an existing one.
+ * Arguments:	The name and the values.
+ * Outputs:	Nothing.
+ * Modifies:	The set of classes.
+ * Returns:	The class.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	The name is sanitised first, so the class's name() may
+ *		not be exactly what was asked for.  Use uniqueName()
+ *		first to get a new class rather than changing an
+ *		existing one.
+ */
+
+StyleClass *
+StyleClass::define(QString name, Values values)
+{
+    name = sanitise(name);
+
+    StyleClass * styleClass = classes.value(name);
+    if (styleClass != nullptr)
+    {
+	styleClass->setValues(values);
+	return styleClass;
+    }
+
+    styleClass = new StyleClass(name, values);
+    classes.insert(name, styleClass);
+    return styleClass;
+}
+
+
+
+/*
+ * Name:	find()
+ * Purpose:	Look up a style class by name.
+ * Arguments:	The name.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The class, or nullptr if there is no such class.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+StyleClass *
+StyleClass::find(QString name)
+{
+    return classes.value(name);
+}
+
+
+
+/*
+ * Name:	names()
+ * Purpose:	List the style classes.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The names of all the classes, in alphabetical order.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+QStringList
+StyleClass::names()
+{
+    return classes.keys();
+}
+
+
+
+/*
+ * Name:	uniqueName()
+ * Purpose:	Find a name which no class has yet.
+ * Arguments:	The name wanted.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The sanitised name if it is not in use, otherwise the
+ *		sanitised name followed by "-2", "-3", ...
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Used when a file being read defines a class with the
+ *		same name as, but different values from, an existing
+ *		class.
+ */
+
+QString
+StyleClass::uniqueName(QString name)
+{
+    name = sanitise(name);
+    if (!classes.contains(name))
+	return name;
+
+    int n = 2;
+    while (classes.contains(name + "-" + QString::number(n)))
+	n++;
+    return name + "-" + QString::number(n);
+}
+
+
+
+/*
+ * Name:	setValues()
+ * Purpose:	Change the values of a class.
+ * Arguments:	The new values.
+ * Outputs:	Nothing.
+ * Modifies:	The class, and possibly its members.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Only a new diameter or label size is pushed to the
+ *		members; the caller must update() the scene(s) to
+ *		show the new colours and pen width.
+ *		The members stay in the class, since the values they
+ *		are given here are the class's values.
+ */
+
+void
+StyleClass::setValues(Values values)
+{
+    bool newDiameter = values.diameter != classValues.diameter;
+    bool newLabelSize = values.labelSize != classValues.labelSize;
+
+    classValues = values;
+
+    if (newDiameter || newLabelSize)
+    {
+	foreach (Node * node, nodes)
+	{
+	    if (newDiameter)
+		node->setDiameter(values.diameter);
+	    if (newLabelSize)
+		node->setNodeLabelSize(values.labelSize);
+	}
+    }
+    if (newLabelSize)
+    {
+	foreach (Edge * edge, edges)
+	    edge->setEdgeLabelSize(values.labelSize);
+    }
+}
+
+
+
+/*
+ * Name:	addMember()
+ * Purpose:	Record that a node or edge belongs to this class.
+ * Arguments:	The node or edge.
+ * Outputs:	Nothing.
+ * Modifies:	The members.
+ * Returns:	Nothing.
+ * Assumptions:	Only called from Node::setStyleClass() and
+ *		Edge::setStyleClass().
+ * Bugs:	None known.
+ * Notes:	None.
+ */
+
+void
+StyleClass::addMember(Node * node)
+{
+    nodes.insert(node, node);
+}
+
+
+
+void
+StyleClass::addMember(Edge * edge)
+{
+    edges.insert(edge, edge);
+}
+
+
+
+/*
+ * Name:	removeMember()
+ * Purpose:	Take a node or edge out of this class.
+ * Arguments:	The item, as a QObject.
+ * Outputs:	Nothing.
+ * Modifies:	The members.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Also called from the Node and Edge destructors, so the
+ *		item is only used as a key.
+ */
+
+void
+StyleClass::removeMember(QObject * item)
+{
+    nodes.remove(item);
+    edges.remove(item);
+}
+
+
+
+/*
+ * Name:	sanitise()
+ * Purpose:	Make a name usable as a class name.
+ * Arguments:	The name.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	The name with spaces turned into '_' and any other
+ *		character which isn't a letter, digit, '-' or '_'
+ *		removed; "style" if that leaves nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	TikZ and the .grphc reader would each choke on some
+ *		other characters (',', '/', '=', '<', ...).
+ */
+
+QString
+StyleClass::sanitise(QString name)
+{
+    QString clean;
+
+    foreach (QChar c, name.simplified())
+    {
+	if (c == ' ')
+	    clean += '_';
+	else if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')
+		 || (c >= '0' && c <= '9') || c == '-' || c == '_')
+	    clean += c;
+    }
+
+    if (clean.isEmpty())
+	clean = "style";
+    return clean;
+}
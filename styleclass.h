@@ -0,0 +1,91 @@
+/*
+ * File:	styleclass.h
+ * Author:	Jim Diamond
+ * Date:	2026-10-19
+ * Version:	1.0
+ *
+ * Purpose:	Define the StyleClass class, a named style which nodes
+ *		and edges can belong to.  Changing a class's values
+ *		restyles all of its members at once.
+ *
+ * Notes:	A node takes its fill colour, outline colour, diameter,
+ *		pen width and label size from its class; an edge takes
+ *		the edge colour, pen width and label size.
+ *		The colours and the pen width are not copied into the
+ *		members: Node and Edge read them from the class when
+ *		they are drawn, so changing them costs one repaint of
+ *		the scene no matter how many members there are.  The
+ *		diameter and the label size change the geometry of
+ *		each member (and its label), so those are pushed to
+ *		every member, but only when they actually change.
+ *		Setting a value on a member which differs from its
+ *		class takes the member out of the class (see
+ *		Node::setStyleClass()).
+ *		Classes live until the program exits; their names only
+ *		contain letters, digits, '-' and '_', so they can be
+ *		used unchanged as .grphc fields and TikZ style names.
+ *
+ * Modification history:
+ * Oct 19, 2026 (JD V1.0)
+ *  (a) Initial version.
+ */
+
+#ifndef STYLECLASS_H
+#define STYLECLASS_H
+
+#include <QColor>
+#include <QHash>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+
+class Edge;
+class Node;
+class QObject;
+
+class StyleClass
+{
+  public:
+    struct Values
+    {
+	QColor fillColour, lineColour;	// Node fill and outline.
+	qreal diameter;			// inches
+	qreal penWidth;			// pixels (!)
+	qreal labelSize;		// points
+	QColor edgeColour;
+
+	bool operator==(const Values & v) const
+	{
+	    return fillColour == v.fillColour && lineColour == v.lineColour
+		&& diameter == v.diameter && penWidth == v.penWidth
+		&& labelSize == v.labelSize && edgeColour == v.edgeColour;
+	}
+    };
+
+    static StyleClass * define(QString name, Values values);
+    static StyleClass * find(QString name);
+    static QStringList names();
+    static QString uniqueName(QString name);
+
+    QString name() const { return className; }
+    const Values & values() const { return classValues; }
+    void setValues(Values values);
+    int count() const { return nodes.count() + edges.count(); }
+
+    void addMember(Node * node);
+    void addMember(Edge * edge);
+    void removeMember(QObject * item);
+
+  private:
+    StyleClass(QString name, Values values);
+    static QString sanitise(QString name);
+
+    static QMap<QString, StyleClass *> classes;
+
+    QString className;
+    Values classValues;
+    QHash<QObject *, Node *> nodes;
+    QHash<QObject *, Edge *> edges;
+};
+
+#endif // STYLECLASS_H
@@ -0,0 +1,355 @@
+/*
+ * File:	viewfilter.cpp
+ * Author:	Jim Diamond
+ * Date:	2026-10-19
+ * Version:	1.1
+ *
+ * Purpose:	Implement the ViewFilter class (see viewfilter.h).
+ *
+ * Modification history:
+ * Oct 19, 2026 (JD V1.0)
+ *  (a) Initial version.
+ * Oct 19, 2026 (JD V1.1)
+ *  (a) Hide items with setVisible(false) rather than detaching them;
+ *	replace detach() with hide().
+ */
+
+#include "viewfilter.h"
+#include "defuns.h"
+#include "edge.h"
+#include "graph.h"
+#include "node.h"
+
+#include <QGraphicsScene>
+#include <QGraphicsView>
+#include <QSet>
+
+QList<QPointer<QGraphicsObject>> ViewFilter::hidden;
+QString ViewFilter::currentFilter;
+
+
+
+/*
+ * Name:	apply()
+ * Purpose:	Show only the canvas items which match a filter.
+ * Arguments:	The canvas scene, the filter (see viewfilter.h) and a
+ *		place to put an error message.
+ * Outputs:	Nothing.
+ * Modifies:	The visibility of the canvas items.
+ * Returns:	True if the filter was applied, false (with
+ *		*errorMessage set) if it could not be.
+ * Assumptions:	The caller takes anything which is hidden off
+ *		selectedList.
+ * Bugs:	None known.
+ * Notes:	Any previous filter is cleared first, so filters do
+ *		not accumulate.  An empty filter just clears.
+ *		Repaints are turned off while items are hidden, so
+ *		that the views are only redrawn once.
+ */
+
+bool
+ViewFilter::apply(QGraphicsScene * scene, QString spec, QString * errorMessage)
+{
+    Criteria criteria;
+
+    if (!parse(spec, &criteria, errorMessage))
+	return false;
+
+    clear();
+    if (spec.trimmed().isEmpty())
+	return true;
+
+    // Find the component(s) of the selected nodes, if asked for.
+    QSet<Node *> component;
+    if (criteria.component)
+    {
+	QList<Node *> toVisit;
+	foreach (QGraphicsItem * item, selectedList)
+	    if (item->type() == Node::Type)
+		toVisit.append(qgraphicsitem_cast<Node *>(item));
+	if (toVisit.isEmpty())
+	{
+	    *errorMessage = "\"component\" needs at least one selected node.";
+	    return false;
+	}
+	while (!toVisit.isEmpty())
+	{
+	    Node * node = toVisit.takeLast();
+	    if (component.contains(node))
+		continue;
+	    component.insert(node);
+	    foreach (Edge * edge, node->edgeList)
+	    {
+		toVisit.append(edge->sourceNode());
+		toVisit.append(edge->destNode());
+	    }
+	}
+    }
+
+    // Decide which nodes are shown.  Edges depend on their nodes,
+    // so this must be done for all graphs before looking at edges.
+    // Graphs inside other graphs are done separately.
+    QList<Graph *> graphs;
+    QSet<Node *> shownNodes;
+    foreach (QGraphicsItem * item, scene->items())
+    {
+	if (item->type() == Graph::Type)
+	    graphs.append(qgraphicsitem_cast<Graph *>(item));
+	else if (item->type() == Node::Type)
+	{
+	    Node * node = qgraphicsitem_cast<Node *>(item);
+	    if (nodePasses(node, criteria)
+		&& (!criteria.component || component.contains(node)))
+		shownNodes.insert(node);
+	}
+    }
+
+    currentFilter = spec.trimmed();
+    foreach (QGraphicsView * view, scene->views())
+	view->setUpdatesEnabled(false);
+
+    foreach (Graph * graph, graphs)
+    {
+	QList<QGraphicsObject *> toHide;
+	bool anyShown = false;
+
+	foreach (QGraphicsItem * child, graph->childItems())
+	{
+	    if (child->type() == Node::Type)
+	    {
+		Node * node = qgraphicsitem_cast<Node *>(child);
+		if (shownNodes.contains(node))
+		    anyShown = true;
+		else
+		    toHide.append(node);
+	    }
+	    else if (child->type() == Edge::Type)
+	    {
+		Edge * edge = qgraphicsitem_cast<Edge *>(child);
+		if (shownNodes.contains(edge->sourceNode())
+		    && shownNodes.contains(edge->destNode())
+		    && edgePasses(edge, criteria))
+		    anyShown = true;
+		else
+		    toHide.append(edge);
+	    }
+	    else
+		anyShown = true;
+	}
+
+	if (!anyShown)
+	{
+	    // Nothing left to see, so hide the graph in one go.
+	    hide(graph);
+	    continue;
+	}
+
+	foreach (QGraphicsObject * item, toHide)
+	    hide(item);
+    }
+
+    foreach (QGraphicsView * view, scene->views())
+	view->setUpdatesEnabled(true);
+
+    qDeb() << "ViewFilter::apply(" << currentFilter << "): hid "
+	   << hidden.count() << " items";
+
+    return true;
+}
+
+
+
+/*
+ * Name:	clear()
+ * Purpose:	Show everything hidden by the filter again.
+ * Arguments:	None.
+ * Outputs:	Nothing.
+ * Modifies:	The visibility of the canvas items.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Items which have been deleted meanwhile (e.g., by
+ *		clearing the canvas) are simply gone.
+ */
+
+void
+ViewFilter::clear()
+{
+    QList<QGraphicsView *> views;
+
+    foreach (QPointer<QGraphicsObject> item, hidden)
+    {
+	if (item.isNull())
+	    continue;
+	if (views.isEmpty() && item->scene() != nullptr)
+	{
+	    views = item->scene()->views();
+	    foreach (QGraphicsView * view, views)
+		view->setUpdatesEnabled(false);
+	}
+	item->setVisible(true);
+    }
+
+    foreach (QGraphicsView * view, views)
+	view->setUpdatesEnabled(true);
+
+    hidden.clear();
+    currentFilter.clear();
+}
+
+
+
+/*
+ * Name:	parse()
+ * Purpose:	Turn a filter string into Criteria.
+ * Arguments:	The filter string, the criteria to fill in and a place
+ *		to put an error message.
+ * Outputs:	Nothing.
+ * Modifies:	*criteria (and *errorMessage on failure).
+ * Returns:	True iff the filter string is valid.
+ * Assumptions:	None.
+ * Bugs:	Labels with spaces in them can't be matched.
+ * Notes:	"color" is accepted for "colour".
+ */
+
+bool
+ViewFilter::parse(QString spec, Criteria * criteria, QString * errorMessage)
+{
+    criteria->nodeFillSet = criteria->nodeOutlineSet = false;
+    criteria->nodeLabelled = criteria->nodeLabelSet = false;
+    criteria->edgeColourSet = false;
+    criteria->edgeLabelled = criteria->edgeLabelSet = false;
+    criteria->component = false;
+
+    foreach (QString term, spec.simplified().split(" "))
+    {
+	if (term.isEmpty())
+	    continue;
+	QString key = term.section('=', 0, 0).toLower();
+	QString value = term.section('=', 1);
+	bool hasValue = term.contains('=');
+	QColor colour(value);
+
+	if (key == "node.fill" && hasValue && colour.isValid())
+	{
+	    criteria->nodeFillSet = true;
+	    criteria->nodeFill = colour;
+	}
+	else if (key == "node.outline" && hasValue && colour.isValid())
+	{
+	    criteria->nodeOutlineSet = true;
+	    criteria->nodeOutline = colour;
+	}
+	else if (key == "node.label" && !hasValue)
+	    criteria->nodeLabelled = true;
+	else if (key == "node.label")
+	{
+	    criteria->nodeLabelSet = true;
+	    criteria->nodeLabel = value;
+	}
+	else if ((key == "edge.colour" || key == "edge.color")
+		 && hasValue && colour.isValid())
+	{
+	    criteria->edgeColourSet = true;
+	    criteria->edgeColour = colour;
+	}
+	else if (key == "edge.label" && !hasValue)
+	    criteria->edgeLabelled = true;
+	else if (key == "edge.label")
+	{
+	    criteria->edgeLabelSet = true;
+	    criteria->edgeLabel = value;
+	}
+	else if (key == "component" && !hasValue)
+	    criteria->component = true;
+	else
+	{
+	    *errorMessage = "I don't understand the filter term \""
+		+ term + "\".";
+	    return false;
+	}
+    }
+
+    return true;
+}
+
+
+
+/*
+ * Name:	nodePasses()
+ * Purpose:	Check a node against the node terms of a filter.
+ * Arguments:	The node and the criteria.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	True iff the node matches.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	The "component" term is dealt with by apply().
+ */
+
+bool
+ViewFilter::nodePasses(Node * node, const Criteria & criteria)
+{
+    if (criteria.nodeFillSet && node->getFillColour() != criteria.nodeFill)
+	return false;
+    if (criteria.nodeOutlineSet
+	&& node->getLineColour() != criteria.nodeOutline)
+	return false;
+    if (criteria.nodeLabelled && node->getLabel().isEmpty())
+	return false;
+    if (criteria.nodeLabelSet && node->getLabel() != criteria.nodeLabel)
+	return false;
+    return true;
+}
+
+
+
+/*
+ * Name:	edgePasses()
+ * Purpose:	Check an edge against the edge terms of a filter.
+ * Arguments:	The edge and the criteria.
+ * Outputs:	Nothing.
+ * Modifies:	Nothing.
+ * Returns:	True iff the edge matches.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	Whether its nodes are shown is checked by apply().
+ */
+
+bool
+ViewFilter::edgePasses(Edge * edge, const Criteria & criteria)
+{
+    if (criteria.edgeColourSet && edge->getColour() != criteria.edgeColour)
+	return false;
+    if (criteria.edgeLabelled && edge->getLabel().isEmpty())
+	return false;
+    if (criteria.edgeLabelSet && edge->getLabel() != criteria.edgeLabel)
+	return false;
+    return true;
+}
+
+
+
+/*
+ * Name:	hide()
+ * Purpose:	Hide one graph, node or edge, remembering that it was
+ *		the filter which hid it.
+ * Arguments:	The item.
+ * Outputs:	Nothing.
+ * Modifies:	The item and hidden.
+ * Returns:	Nothing.
+ * Assumptions:	None.
+ * Bugs:	None known.
+ * Notes:	A hidden node is also unhighlighted, since it can no
+ *		longer be selected.
+ */
+
+void
+ViewFilter::hide(QGraphicsObject * item)
+{
+    if (item->type() == Node::Type)
+	qgraphicsitem_cast<Node *>(item)->chosen(0);
+
+    hidden.append(item);
+    item->setVisible(false);
+}
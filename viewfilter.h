@@ -0,0 +1,88 @@
+/*
+ * File:	viewfilter.h
+ * Author:	Jim Diamond
+ * Date:	2026-10-19
+ * Version:	1.1
+ *
+ * Purpose:	Define the ViewFilter class, which temporarily hides the
+ *		canvas nodes and edges which do not match a filter, and
+ *		shows them again when the filter is cleared.
+ *
+ * Notes:	A filter is a string of space-separated terms, all of
+ *		which must hold for a node or edge to stay on the
+ *		canvas:
+ *		    node.fill=COLOUR	node fill colour
+ *		    node.outline=COLOUR	node outline colour
+ *		    node.label		node has a label
+ *		    node.label=TEXT	node label is exactly TEXT
+ *		    edge.colour=COLOUR	edge colour
+ *		    edge.label		edge has a label
+ *		    edge.label=TEXT	edge label is exactly TEXT
+ *		    component		in the same component as a
+ *					selected node
+ *		COLOUR is anything QColor understands, e.g. "red" or
+ *		"#ff0000".  An edge is only shown if both of its nodes
+ *		are.
+ *		Hidden items are neither drawn nor hit-tested, but they
+ *		stay in their graphs, in the scene and on their nodes'
+ *		edgeLists, so the graph itself is unchanged: saving
+ *		writes out everything (images only show what is shown),
+ *		and clearing the canvas deletes the hidden items along
+ *		with the rest.  A graph with nothing left to show is
+ *		hidden as a whole.
+ *
+ * Modification history:
+ * Oct 19, 2026 (JD V1.0)
+ *  (a) Initial version.
+ * Oct 19, 2026 (JD V1.1)
+ *  (a) Hide the items which don't match, instead of taking them out
+ *	of the scene, so that they are neither leaked nor left on
+ *	selectedList or the undo list, and saving no longer has to
+ *	clear the filter.
+ */
+
+#ifndef VIEWFILTER_H
+#define VIEWFILTER_H
+
+#include <QColor>
+#include <QGraphicsObject>
+#include <QList>
+#include <QPointer>
+#include <QString>
+
+class Edge;
+class Node;
+class QGraphicsScene;
+
+class ViewFilter
+{
+  public:
+    static bool apply(QGraphicsScene * scene, QString spec,
+		      QString * errorMessage);
+    static void clear();
+    static bool isActive() { return !hidden.isEmpty(); }
+    static QString currentSpec() { return currentFilter; }
+
+  private:
+    typedef struct
+    {
+	bool nodeFillSet, nodeOutlineSet, nodeLabelled, nodeLabelSet;
+	QColor nodeFill, nodeOutline;
+	QString nodeLabel;
+	bool edgeColourSet, edgeLabelled, edgeLabelSet;
+	QColor edgeColour;
+	QString edgeLabel;
+	bool component;
+    } Criteria;
+
+    static bool parse(QString spec, Criteria * criteria,
+		      QString * errorMessage);
+    static bool nodePasses(Node * node, const Criteria & criteria);
+    static bool edgePasses(Edge * edge, const Criteria & criteria);
+    static void hide(QGraphicsObject * item);
+
+    static QList<QPointer<QGraphicsObject>> hidden;
+    static QString currentFilter;
+};
+
+#endif // VIEWFILTER_H